@@ -29,6 +29,11 @@ class CCustomWallManager
     std::size_t _count{0};
     std::vector<CCustomWallHandle> _tempAliveHandles;
 
+    // Allocated on first use and never resized afterwards, so that pointers
+    // to their data can be handed out to Lua.
+    std::vector<double> _vertexPos4Batch;
+    std::vector<double> _vertexColor4Batch;
+
     [[nodiscard]] bool isValidHandle(const CCustomWallHandle h) const noexcept;
 
     [[nodiscard]] bool checkValidHandle(
@@ -43,6 +48,14 @@ class CCustomWallManager
     void destroyUnchecked(const CCustomWallHandle cwHandle);
 
 public:
+    // Batches are arrays of `batchCapacity` rows, laid out as
+    // `handle, x0, y0, ..., x3, y3` for positions and
+    // `handle, r0, g0, b0, a0, ..., r3, g3, b3, a3` for colors. Scripts fill
+    // them and commit the first rows with a single call.
+    static constexpr std::size_t batchCapacity = 4096;
+    static constexpr std::size_t vertexPos4BatchStride = 1 + 4 * 2;
+    static constexpr std::size_t vertexColor4BatchStride = 1 + 4 * 4;
+
     [[nodiscard]] CCustomWallHandle create(void (*fAfterCreate)(CCustomWall&));
 
     void destroy(const CCustomWallHandle cwHandle);
@@ -89,6 +102,12 @@ public:
 
     [[nodiscard]] std::uint8_t getKillingSide(const CCustomWallHandle cwHandle);
 
+    [[nodiscard]] double* getVertexPos4Batch();
+    [[nodiscard]] double* getVertexColor4Batch();
+
+    void commitVertexPos4Batch(const std::size_t count);
+    void commitVertexColor4Batch(const std::size_t count);
+
     void clear();
     void draw(Utils::FastVertexVectorTris& wallQuads);
 
@@ -60,26 +60,28 @@ public:
     struct EDeleteAccountFailure    { std::string error; };
     struct EReceivedTopScores       { std::string levelValidator; std::vector<Database::ProcessedScore> scores; };
     struct EReceivedOwnScore        { std::string levelValidator; Database::ProcessedScore score; };
+    struct EReceivedLeaderboardPage { std::string levelValidator; std::uint64_t version; std::uint64_t baseVersion; std::uint32_t offset; std::uint32_t size; std::vector<Database::ProcessedScore> scores; std::optional<Database::ProcessedScore> ownScore; };
     struct EGameVersionMismatch     { };
     struct EProtocolVersionMismatch { };
     // clang-format on
 
-    using Event = std::variant<  //
-        EConnectionSuccess,      //
-        EConnectionFailure,      //
-        EKicked,                 //
-        ERegistrationSuccess,    //
-        ERegistrationFailure,    //
-        ELoginSuccess,           //
-        ELoginFailure,           //
-        ELogoutSuccess,          //
-        ELogoutFailure,          //
-        EDeleteAccountSuccess,   //
-        EDeleteAccountFailure,   //
-        EReceivedTopScores,      //
-        EReceivedOwnScore,       //
-        EGameVersionMismatch,    //
-        EProtocolVersionMismatch //
+    using Event = std::variant<   //
+        EConnectionSuccess,       //
+        EConnectionFailure,       //
+        EKicked,                  //
+        ERegistrationSuccess,     //
+        ERegistrationFailure,     //
+        ELoginSuccess,            //
+        ELoginFailure,            //
+        ELogoutSuccess,           //
+        ELogoutFailure,           //
+        EDeleteAccountSuccess,    //
+        EDeleteAccountFailure,    //
+        EReceivedTopScores,       //
+        EReceivedOwnScore,        //
+        EReceivedLeaderboardPage, //
+        EGameVersionMismatch,     //
+        EProtocolVersionMismatch  //
         >;
 
 private:
@@ -138,6 +140,10 @@ private:
         const sf::Uint64 loginToken, const std::string& levelValidator);
     [[nodiscard]] bool sendRequestTopScoresAndOwnScore(
         const sf::Uint64 loginToken, const std::string& levelValidator);
+    [[nodiscard]] bool sendRequestLeaderboardPage(const sf::Uint64 loginToken,
+        const std::string& levelValidator, const std::uint32_t offset,
+        const std::uint32_t limit, const bool aroundOwnScore,
+        const std::uint64_t knownVersion);
     [[nodiscard]] bool sendStartedGame(
         const sf::Uint64 loginToken, const std::string& levelValidator);
     [[nodiscard]] bool sendCompressedReplay(const sf::Uint64 loginToken,
@@ -186,6 +192,9 @@ public:
     bool tryRequestTopScores(const std::string& levelValidator);
     bool tryRequestOwnScore(const std::string& levelValidator);
     bool tryRequestTopScoresAndOwnScore(const std::string& levelValidator);
+    bool tryRequestLeaderboardPage(const std::string& levelValidator,
+        const std::uint32_t offset, const std::uint32_t limit,
+        const bool aroundOwnScore, const std::uint64_t knownVersion);
     bool trySendStartedGame(const std::string& levelValidator);
     bool trySendCompressedReplay(const std::string& levelValidator,
         const compressed_replay_file& compressedReplayFile);
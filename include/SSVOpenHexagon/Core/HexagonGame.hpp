@@ -8,6 +8,7 @@
 #include "SSVOpenHexagon/Core/HGStatus.hpp"
 #include "SSVOpenHexagon/Core/RandomNumberGenerator.hpp"
 #include "SSVOpenHexagon/Core/Replay.hpp"
+#include "SSVOpenHexagon/Core/VertexPipeline.hpp"
 
 #include "SSVOpenHexagon/Data/LevelStatus.hpp"
 #include "SSVOpenHexagon/Data/MusicData.hpp"
@@ -17,7 +18,11 @@
 
 #include "SSVOpenHexagon/Utils/Utils.hpp"
 #include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+#include "SSVOpenHexagon/Utils/LuaPoolAllocator.hpp"
+#include "SSVOpenHexagon/Utils/LuaProfiler.hpp"
 #include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
+#include "SSVOpenHexagon/Utils/ParticlePool.hpp"
+#include "SSVOpenHexagon/Utils/TextBatch.hpp"
 #include "SSVOpenHexagon/Utils/Timeline2.hpp"
 
 #include "SSVOpenHexagon/Components/CCustomWallManager.hpp"
@@ -45,6 +50,7 @@
 #include <sstream>
 #include <unordered_set>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <vector>
 #include <string>
@@ -145,7 +151,12 @@ private:
 
     const sf::Vector2f centerPos{0.f, 0.f};
 
-    Lua::LuaContext lua;
+    // Shared by the contexts created on every restart.
+    std::shared_ptr<Utils::LuaPoolAllocator> luaAllocator{
+        std::make_shared<Utils::LuaPoolAllocator>()};
+
+    Lua::LuaContext lua{luaAllocator};
+    Utils::LuaProfiler luaProfiler;
     std::unordered_set<std::string> calledDeprecatedFunctions;
 
     LevelStatus levelStatus;
@@ -168,31 +179,13 @@ private:
 
     Utils::FastVertexVectorTris flashPolygon;
 
-    struct Particle
-    {
-        sf::Sprite sprite;
-        sf::Vector2f velocity;
-        float angularVelocity;
-    };
-
-    struct TrailParticle
-    {
-        sf::Sprite sprite;
-        float angle;
-    };
-
-    struct SwapParticle
-    {
-        sf::Sprite sprite;
-        sf::Vector2f velocity;
-    };
-
     sf::Texture* txStarParticle;
     sf::Texture* txSmallCircle;
 
-    std::vector<Particle> particles;
-    std::vector<TrailParticle> trailParticles;
-    std::vector<SwapParticle> swapParticles;
+    Utils::ParticlePool particles{512};
+    Utils::ParticlePool trailParticles{1024};
+    Utils::ParticlePool swapParticles{1024};
+    Utils::FastVertexVectorTris particleTris;
     bool mustSpawnPBParticles{false};
 
     struct SwapParticleSpawnInfo
@@ -264,6 +257,13 @@ private:
     sf::Text text;
     sf::Text replayText;
 
+    // Strings of the HUD texts above, drawn through `textBatch`.
+    std::string fpsString;
+    std::string timeString;
+    std::string statusString;
+    std::string replayString;
+    Utils::TextBatch textBatch;
+
     // Color of the polygon in the center.
     CapColor capColor;
 
@@ -300,6 +300,13 @@ public:
     bool executeRandomInputs{false};
     bool alwaysSpinRight{false};
 
+    // Upper bound for the Lua instruction budgets requested by levels. When
+    // set, scripts exceeding the budget abort the game deterministically,
+    // which is used to bound the cost of replay validation.
+    std::optional<Lua::LuaContext::InstructionBudget> luaInstructionBudgetLimit;
+
+    [[nodiscard]] bool isLuaInstructionBudgetExceeded() const noexcept;
+
     // ------------------------------------------------------------------------
     // Lua stuff
 
@@ -311,6 +318,15 @@ public:
     auto runLuaFunctionIfExists(const std::string& mName, const TArgs&... mArgs)
     try
     {
+        if(!luaProfiler.isEnabled() || !lua.doesVariableExist(mName))
+        {
+            return Utils::runLuaFunctionIfExists<T, TArgs...>(
+                lua, mName, mArgs...);
+        }
+
+        const Utils::LuaProfiler::Scope luaProfilerScope{&luaProfiler,
+            luaProfiler.getIndex(mName, Utils::LuaProfiler::Kind::Callback)};
+
         return Utils::runLuaFunctionIfExists<T, TArgs...>(lua, mName, mArgs...);
     }
     catch(...)
@@ -386,6 +402,9 @@ private:
     void drawParticles();
     void drawTrailParticles();
     void drawSwapParticles();
+    void drawParticlePool(const Utils::ParticlePool& pool,
+        const sf::Texture& texture, const sf::Vector2f& origin,
+        const Utils::ParticlePool::Rotation rotation);
     void drawImguiLuaConsole();
 
     // Data-related methods
@@ -426,13 +445,7 @@ private:
     void performPlayerKill();
 
     Utils::FastVertexVectorTris backgroundTris;
-    Utils::FastVertexVectorTris wallQuads;
-    Utils::FastVertexVectorTris pivotQuads;
-    Utils::FastVertexVectorTris playerTris;
-    Utils::FastVertexVectorTris capTris;
-    Utils::FastVertexVectorTris wallQuads3D;
-    Utils::FastVertexVectorTris pivotQuads3D;
-    Utils::FastVertexVectorTris playerTris3D;
+    VertexPipeline vertexPipeline;
 
 public:
     std::function<void(const bool)> fnGoToMenu;
@@ -477,8 +490,12 @@ public:
         double pausedTimeSeconds;
         double totalTimeSeconds;
         float customScore;
+        std::uint64_t ticks;
     };
 
+    // Runs a single fixed time step of the simulation, without drawing.
+    void executeTick(const float timescale);
+
     [[nodiscard]] std::optional<GameExecutionResult> executeGameUntilDeath(
         const int maxProcessingSeconds, const float timescale);
 
@@ -498,7 +515,7 @@ public:
         const std::string& mPackId, const std::string& mId);
 
     // Graphics-related methods
-    void render(sf::Drawable& mDrawable,
+    void render(const sf::Drawable& mDrawable,
         const sf::RenderStates& mStates = sf::RenderStates::Default);
 
     // Setters
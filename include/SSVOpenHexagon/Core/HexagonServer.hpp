@@ -6,10 +6,13 @@
 
 #include "SSVOpenHexagon/Global/ProtocolVersion.hpp"
 
+#include "SSVOpenHexagon/Utils/LatencyHistogram.hpp"
 #include "SSVOpenHexagon/Utils/Timestamp.hpp"
 
 #include "SSVOpenHexagon/Online/Sodium.hpp"
 #include "SSVOpenHexagon/Online/DatabaseRecords.hpp"
+#include "SSVOpenHexagon/Online/PacketFraming.hpp"
+#include "SSVOpenHexagon/Online/Shared.hpp"
 
 #include <SFML/Network/IpAddress.hpp>
 #include <SFML/Network/Packet.hpp>
@@ -18,12 +21,18 @@
 #include <SFML/Network/TcpSocket.hpp>
 #include <SFML/Network/UdpSocket.hpp>
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <iosfwd>
 #include <list>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <variant>
+#include <vector>
 
 namespace hg {
 
@@ -65,6 +74,8 @@ private:
         };
 
         sf::TcpSocket _socket;
+        IncomingFrameBuffer _incoming;
+        OutgoingFrameQueue _outgoing;
         Utils::SCTimePoint _lastActivity;
         int _consecutiveFailures;
         bool _mustDisconnect;
@@ -92,8 +103,11 @@ private:
 
         std::optional<GameStatus> _gameStatus;
 
-        explicit ConnectedClient(const Utils::SCTimePoint lastActivity)
+        explicit ConnectedClient(const Utils::SCTimePoint lastActivity,
+            const std::size_t maxPacketSize)
             : _socket{},
+              _incoming{maxPacketSize},
+              _outgoing{},
               _lastActivity{lastActivity},
               _consecutiveFailures{0},
               _mustDisconnect{false},
@@ -117,12 +131,54 @@ private:
 
     Utils::SCTimePoint _lastTokenPurge;
     Utils::SCTimePoint _lastLogsFlush;
+    Utils::SCTimePoint _lastScoresFlush;
+
+    struct Metrics
+    {
+        static constexpr std::size_t packetTypeCount =
+            std::variant_size_v<PVClientToServer>;
+
+        Utils::SCTimePoint _since;
+
+        // Indexed by `PVClientToServer` alternative.
+        std::array<Utils::LatencyHistogram, packetTypeCount> _packetHistograms;
+
+        Utils::LatencyHistogram _decodeHistogram;
+        Utils::LatencyHistogram _replayHistogram;
+        Utils::LatencyHistogram _iterationHistogram;
+        std::uint64_t _replayTicks;
+
+        void reset();
+    };
+
+    // Recently sent leaderboard pages of each level, to answer conditional
+    // page requests without querying the database and with only the entries
+    // that changed.
+    struct LeaderboardPageSnapshot
+    {
+        std::uint64_t _version;
+        std::uint32_t _offset;
+        std::uint32_t _limit;
+        std::vector<Database::ProcessedScore> _scores;
+    };
+
+    static constexpr std::size_t maxLeaderboardSnapshotsPerLevel = 4;
+    static constexpr std::uint32_t maxLeaderboardPageLimit = 50;
+
+    std::unordered_map<std::string, std::vector<LeaderboardPageSnapshot>>
+        _leaderboardSnapshots;
+
+    Metrics _metrics;
+    std::optional<std::chrono::seconds> _metricsDumpInterval;
+    Utils::SCTimePoint _lastMetricsDump;
 
     [[nodiscard]] bool initializeControlSocket();
     [[nodiscard]] bool initializeTcpListener();
     [[nodiscard]] bool initializeSocketSelector();
+    [[nodiscard]] bool initializeDatabase();
 
     [[nodiscard]] bool sendPacket(ConnectedClient& c, sf::Packet& p);
+    [[nodiscard]] bool flushOutgoing(ConnectedClient& c);
 
     template <typename T>
     [[nodiscard]] bool sendEncrypted(ConnectedClient& c, const T& data);
@@ -154,6 +210,12 @@ private:
     [[nodiscard]] bool sendServerStatus(ConnectedClient& c,
         const ProtocolVersion& protocolVersion, const GameVersion& gameVersion,
         const std::vector<std::string> supportedLevelValidators);
+    [[nodiscard]] bool sendLeaderboardPage(ConnectedClient& c,
+        const std::string& levelValidator, const std::uint64_t version,
+        const std::uint64_t baseVersion, const std::uint32_t offset,
+        const std::uint32_t size,
+        const std::vector<Database::ProcessedScore>& scores,
+        const std::optional<Database::ProcessedScore>& ownScore);
 
     void kickAndRemoveClient(ConnectedClient& c);
 
@@ -162,9 +224,15 @@ private:
     bool runIteration_Control();
     bool runIteration_TryAcceptingNewClient();
     void runIteration_LoopOverSockets();
+    [[nodiscard]] bool runIteration_ProcessReceivedPackets(ConnectedClient& c);
+    void runIteration_FlushOutgoing();
     void runIteration_PurgeClients();
     void runIteration_PurgeTokens();
     void runIteration_FlushLogs();
+    void runIteration_FlushScores();
+    void runIteration_DumpMetrics();
+
+    void printMetrics(std::ostream& os) const;
 
     [[nodiscard]] bool validateLogin(ConnectedClient& c, const char* context,
         const sf::Uint64 ctspLoginToken);
@@ -172,6 +240,9 @@ private:
     [[nodiscard]] bool processReplay(
         ConnectedClient& c, const sf::Uint64 loginToken, const replay_file& rf);
 
+    [[nodiscard]] bool processLeaderboardPageRequest(
+        ConnectedClient& c, const CTSPRequestLeaderboardPage& ctsp);
+
     template <typename T>
     void printCTSPDataVerbose(
         ConnectedClient& c, const char* title, const T& ctsp);
@@ -8,27 +8,66 @@
 
 #include "SSVOpenHexagon/Utils/Clock.hpp"
 
-#include <string>
-#include <sstream>
-#include <vector>
 #include <chrono>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace hg {
 
 class LeaderboardCache
 {
+public:
+    // Shown scores are requested again from the server after this long.
+    static constexpr std::chrono::seconds refreshInterval{6};
+
+    // Scores of levels that are not shown yet, such as the neighbours of the
+    // selected level, are only requested again after this long.
+    static constexpr std::chrono::seconds prefetchInterval{60};
+
+    // Scores received longer ago than this are not loaded from disk, and at
+    // most `maxPersistedLevels` levels are saved, most recently received
+    // first.
+    static constexpr std::chrono::hours persistedMaxAge{24 * 7};
+    static constexpr std::size_t maxPersistedLevels{512};
+
+    // Number of top scores requested and shown for a level.
+    static constexpr std::uint32_t pageSize{6};
+
+    // A score with its display strings, formatted once when received.
+    struct FormattedScore
+    {
+        std::string timestamp;
+        std::string position;
+        std::string score;
+        std::string userName;
+    };
+
 private:
     struct CachedScores
     {
         std::vector<Database::ProcessedScore> _scores;
         std::optional<Database::ProcessedScore> _ownScore;
+        std::vector<FormattedScore> _formattedScores;
+        std::optional<FormattedScore> _formattedOwnScore;
+
+        // Time of the last request or reply, to throttle requests.
         HRTimePoint _cacheTime;
+
+        // Seconds since epoch when scores were last received, zero if never.
+        std::uint64_t _receivedTimestamp{0};
+
+        // Server version of `_scores`, zero if unknown.
+        std::uint64_t _version{0};
     };
 
     std::unordered_map<std::string, CachedScores> _levelValidatorToScores;
 
+    static void formatScores(CachedScores& cs);
+
 public:
     void receivedScores(const std::string& levelValidator,
         const std::vector<Database::ProcessedScore>& scores);
@@ -36,19 +75,41 @@ public:
     void receivedOwnScore(const std::string& levelValidator,
         const Database::ProcessedScore& score);
 
+    // Applies a reply to a leaderboard page request, which might only
+    // contain the scores that changed since the version cached here.
+    void receivedPage(const std::string& levelValidator,
+        const std::uint64_t version, const std::uint64_t baseVersion,
+        const std::uint32_t offset, const std::uint32_t size,
+        const std::vector<Database::ProcessedScore>& scores,
+        const std::optional<Database::ProcessedScore>& ownScore);
+
     void requestedScores(const std::string& levelValidator);
 
+    // Version to send with the next page request, zero if unknown.
+    [[nodiscard]] std::uint64_t getVersion(
+        const std::string& levelValidator) const;
+
     [[nodiscard]] bool shouldRequestScores(
         const std::string& levelValidator) const;
 
-    [[nodiscard]] const std::vector<Database::ProcessedScore>& getScores(
+    [[nodiscard]] bool shouldPrefetchScores(
         const std::string& levelValidator) const;
 
-    [[nodiscard]] const Database::ProcessedScore* getOwnScore(
+    // Views into the cache, valid until scores for the same level are
+    // received or the cache is loaded.
+    [[nodiscard]] const std::vector<FormattedScore>& getScores(
+        const std::string& levelValidator) const;
+
+    [[nodiscard]] const FormattedScore* getOwnScore(
         const std::string& levelValidator) const;
 
     [[nodiscard]] bool getSupported(const std::string& levelValidator) const;
     [[nodiscard]] bool hasInformation(const std::string& levelValidator) const;
+
+    // Loaded scores are shown right away and requested again the first time
+    // they are shown. Returns `false` if the file could not be read.
+    bool loadFromFile(const std::string& path);
+    void saveToFile(const std::string& path) const;
 };
 
 } // namespace hg
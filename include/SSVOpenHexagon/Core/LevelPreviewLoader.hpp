@@ -0,0 +1,135 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Components/CCustomWallManager.hpp"
+
+#include "SSVOpenHexagon/Core/HGStatus.hpp"
+#include "SSVOpenHexagon/Core/RandomNumberGenerator.hpp"
+
+#include "SSVOpenHexagon/Data/LevelStatus.hpp"
+#include "SSVOpenHexagon/Data/StyleData.hpp"
+
+#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hg {
+
+class HGAssets;
+struct LevelData;
+struct PackData;
+
+// What the level selection menu shows for a level: its style and level
+// status right after running the level's script, `onInit` and `onLoad`.
+struct LevelPreview
+{
+    std::string levelId;
+    StyleData styleData;
+    LevelStatus levelStatus;
+
+    // Output of `u_log`, logs of the Lua bindings and Lua errors, to be
+    // reported when the preview is shown. Empty if the script ran without
+    // errors.
+    std::string log;
+    std::string errors;
+};
+
+// Prepares level previews on a worker thread with its own Lua context, so
+// that moving through the level list never waits for Lua. The most recently
+// prepared previews are cached.
+//
+// `HGAssets` must not be modified while the worker is running: call `clear`
+// before reloading any pack or level. `Config` values read by the script are
+// taken when the level is requested.
+class LevelPreviewLoader
+{
+public:
+    static constexpr std::size_t cacheCapacity = 16;
+
+private:
+    struct Job
+    {
+        std::string levelId;
+        const LevelData* levelData;
+        const PackData* packData;
+        const StyleData* styleData;
+        unsigned int width;
+        unsigned int height;
+    };
+
+    HGAssets& _assets;
+
+    // Only used by the worker thread once it has been started.
+    Lua::LuaContext _lua;
+    random_number_generator _rng;
+    CCustomWallManager _cwManager;
+    HexagonGameStatus _hexagonGameStatus;
+    StyleData _styleData;
+    const LevelStatus _initialLevelStatus;
+    LevelStatus _levelStatus;
+    std::vector<std::string> _execScriptPackPathContext;
+    const LevelData* _levelData;
+    const PackData* _packData;
+    unsigned int _width;
+    unsigned int _height;
+    std::string _log;
+    std::string _errors;
+
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Job> _queue;
+    std::string _runningLevelId;
+    bool _running{false};
+    bool _stopRequested{false};
+
+    // Least recently used first.
+    std::vector<std::shared_ptr<const LevelPreview>> _cache;
+
+    void initLua();
+    void runLuaFile(const std::string& fileName);
+    [[nodiscard]] LevelPreview prepare(const Job& job);
+
+    void workerLoop();
+
+    [[nodiscard]] Job makeJob(const std::string& levelId);
+    [[nodiscard]] bool isCachedOrPending(const std::string& levelId) const;
+    [[nodiscard]] std::shared_ptr<const LevelPreview> findCached(
+        const std::string& levelId);
+
+public:
+    explicit LevelPreviewLoader(HGAssets& assets);
+    ~LevelPreviewLoader();
+
+    LevelPreviewLoader(const LevelPreviewLoader&) = delete;
+    LevelPreviewLoader& operator=(const LevelPreviewLoader&) = delete;
+
+    // Replaces the levels waiting to be prepared with `levelIds`, most
+    // urgent first. Levels already cached or being prepared are skipped.
+    void request(const std::vector<std::string>& levelIds);
+
+    // Returns the preview of `levelId` if it has already been prepared.
+    [[nodiscard]] std::shared_ptr<const LevelPreview> find(
+        const std::string& levelId);
+
+    // Returns the preview of `levelId`, preparing it first if needed and
+    // blocking until it is ready.
+    [[nodiscard]] std::shared_ptr<const LevelPreview> wait(
+        const std::string& levelId);
+
+    // Waits for the level being prepared, if any, then drops all queued
+    // levels and cached previews.
+    void clear();
+};
+
+} // namespace hg
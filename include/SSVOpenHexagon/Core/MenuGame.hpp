@@ -12,7 +12,7 @@
 
 #include "SSVOpenHexagon/Utils/Clock.hpp"
 #include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
-#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+#include "SSVOpenHexagon/Utils/TextBatch.hpp"
 #include "SSVOpenHexagon/Utils/UniquePtr.hpp"
 
 #include <SSVStart/Camera/Camera.hpp>
@@ -57,6 +57,8 @@ class Audio;
 class HexagonGame;
 class HexagonClient;
 class LeaderboardCache;
+class LevelPreviewLoader;
+struct LevelPreview;
 class ProfileData;
 
 struct PackData;
@@ -114,8 +116,7 @@ private:
     HexagonDialogBox dialogBox;
     Utils::UniquePtr<LeaderboardCache> leaderboardCache;
 
-    Lua::LuaContext lua;
-    std::vector<std::string> execScriptPackPathContext;
+    Utils::UniquePtr<LevelPreviewLoader> levelPreviewLoader;
     const PackData* currentPack;
 
     //---------------------------------------
@@ -123,7 +124,6 @@ private:
 
     void initAssets();
     void initInput();
-    void initLua();
     void initMenus();
     void playLocally();
 
@@ -260,6 +260,7 @@ private:
     sf::Color dialogBoxTextColor;
     Utils::FastVertexVectorTris menuBackgroundTris;
     Utils::FastVertexVectorTris menuQuads;
+    Utils::TextBatch textBatch;
 
     // Mouse control
     HRTimePoint lastMouseClick{};
@@ -296,6 +297,12 @@ private:
     void draw();
     void render(sf::Drawable& mDrawable);
 
+    // Draws without flushing queued text first, which ends up on top. Only
+    // for drawables that do not overlap any queued text.
+    void renderBelowText(sf::Drawable& mDrawable);
+
+    void flushText();
+
     // Helper functions
     [[nodiscard]] float getFPSMult() const;
 
@@ -411,6 +418,16 @@ private:
 
     int diffMultIdx{0};
     bool firstLevelSelection{true};
+
+    // Level whose preview is shown once it has been prepared in the
+    // background, empty if the shown preview is up to date.
+    std::string pendingLevelPreviewId;
+    bool anyLevelPreviewApplied{false};
+
+    void requestLevelPreviews();
+    void requestLeaderboardPage(const std::string& levelValidator);
+    void prefetchLeaderboards();
+    void applyLevelPreview(const LevelPreview& preview);
     PackChange packChangeState{PackChange::Rest};
     float namesScroll[static_cast<int>(Label::ScrollsSize)]{0};
     std::vector<std::string> levelDescription;
@@ -437,6 +454,22 @@ private:
     void addRemoveFavoriteLevel();
     void switchToFromFavoriteLevels();
 
+    // Level search, opened with F5 in the level selection menu. While it is
+    // open typed text goes to the query and the level list is not navigable.
+    static inline constexpr std::size_t maxLevelSearchResults{50};
+    static inline constexpr std::size_t levelSearchQueryLimit{32};
+    bool levelSearchOpen{false};
+    std::string levelSearchQuery;
+    std::vector<std::string> levelSearchResults;
+    int levelSearchIdx{0};
+
+    void openCloseLevelSearch();
+    void closeLevelSearch();
+    void updateLevelSearchResults();
+    void moveLevelSearchSelection(const int dir);
+    void jumpToLevelSearchResult();
+    void drawLevelSearch();
+
     // Visual effects
     float difficultyBumpEffect{0.f};
     static inline constexpr float difficultyBumpEffectMax{24.f};
@@ -482,17 +515,18 @@ private:
     void drawLevelSelectionLeftSide(
         LevelDrawer& drawer, const bool revertOffset);
 
-    // Text rendering
-    void renderText(
+    // Text rendering, batched by `textBatch` until the next `render` call or
+    // the end of the frame. Returns the global bounds of the rendered text.
+    sf::FloatRect renderText(
         const std::string& mStr, sf::Text& mText, const sf::Vector2f& mPos);
 
-    void renderText(const std::string& mStr, sf::Text& mText,
+    sf::FloatRect renderText(const std::string& mStr, sf::Text& mText,
         const sf::Vector2f& mPos, const sf::Color& mColor);
 
-    void renderText(const std::string& mStr, sf::Text& mText,
+    sf::FloatRect renderText(const std::string& mStr, sf::Text& mText,
         const unsigned int mSize, const sf::Vector2f& mPos);
 
-    void renderText(const std::string& mStr, sf::Text& mText,
+    sf::FloatRect renderText(const std::string& mStr, sf::Text& mText,
         const unsigned int mSize, const sf::Vector2f& mPos,
         const sf::Color& mColor);
 
@@ -525,7 +559,6 @@ private:
     bool mustTakeScreenshot{false};
     std::string currentLeaderboard, enteredStr, leaderboardString;
 
-    void runLuaFile(const std::string& mFileName);
     void changeResolutionTo(unsigned int mWidth, unsigned int mHeight);
     void playSoundOverride(const std::string& assetId);
 
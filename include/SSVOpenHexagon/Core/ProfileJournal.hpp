@@ -0,0 +1,110 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace hg {
+
+class ProfileData;
+
+// Records changes to local profiles as lines appended to a journal file next
+// to the profile's JSON snapshot, so that saving a score does not rewrite the
+// whole profile. Compaction writes a new snapshot next to the old one, renames
+// it over the old one and only then empties the journal. All file writes
+// happen on a worker thread, in the order they were queued.
+//
+// Journal lines are `s <score> <levelId>`, `f <levelId>` (favorite added)
+// and `u <levelId>` (favorite removed). Every entry sets a value, so
+// replaying a journal over a snapshot that already contains some of its
+// entries gives the same profile.
+class ProfileJournal
+{
+public:
+    using SnapshotWriter = std::function<void(std::ostream&)>;
+
+private:
+    struct Job
+    {
+        std::string journalPath;
+
+        // Appended to the journal if `writeSnapshot` is empty, otherwise the
+        // snapshot is written to `snapshotPath` and the journal emptied.
+        std::string line;
+        std::string snapshotPath;
+        SnapshotWriter writeSnapshot;
+    };
+
+    // Only used by the main thread.
+    std::unordered_map<std::string, std::size_t> _entriesSinceCompaction;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::condition_variable _idleCv;
+    std::deque<Job> _queue;
+    std::string _runningJournalPath;
+    std::size_t _failedCompactions{0};
+    bool _running{false};
+    bool _stopRequested{false};
+
+    // Started last, once the members above are initialized.
+    std::thread _worker;
+
+    void workerLoop();
+    void push(Job&& job);
+
+    [[nodiscard]] static bool writeSnapshot(const Job& job);
+
+public:
+    ProfileJournal();
+    ~ProfileJournal();
+
+    ProfileJournal(const ProfileJournal&) = delete;
+    ProfileJournal& operator=(const ProfileJournal&) = delete;
+
+    void appendScore(const std::string& journalPath,
+        const std::string& levelId, const float score);
+
+    void appendFavorite(const std::string& journalPath,
+        const std::string& levelId, const bool favorite);
+
+    // Runs `writeSnapshot` on the worker thread once every entry queued
+    // before it has been appended, and replaces the file at `snapshotPath`
+    // with its output. The journal is only emptied if that succeeded. The
+    // snapshot must not refer to data the main thread can modify.
+    void compact(const std::string& journalPath,
+        const std::string& snapshotPath, SnapshotWriter&& writeSnapshot);
+
+    // Drops the queued writes of `journalPath`, waits for the one being
+    // done, if any, then deletes the journal and the snapshot. Returns
+    // `false` if the snapshot could not be deleted.
+    [[nodiscard]] bool remove(
+        const std::string& journalPath, const std::string& snapshotPath);
+
+    // Entries appended or replayed since the last compaction.
+    [[nodiscard]] std::size_t getEntriesSinceCompaction(
+        const std::string& journalPath) const;
+
+    // Blocks until all queued writes are done.
+    void flush();
+
+    // Compactions whose snapshot could not be written, since construction.
+    [[nodiscard]] std::size_t getFailedCompactionCount();
+
+    // Applies the entries of the journal at `journalPath` to `profileData`
+    // and returns their number. A line cut short by a crash is ignored.
+    std::size_t replay(
+        const std::string& journalPath, ProfileData& profileData);
+};
+
+} // namespace hg
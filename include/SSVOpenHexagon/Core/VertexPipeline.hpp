@@ -0,0 +1,102 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace hg {
+
+// Immutable snapshot of the style and camera state that drives the 3D effect
+// for a single frame. Colors are already darkened, per-layer alpha is applied
+// during extrusion.
+struct Extrusion3DParams
+{
+    std::size_t depth;
+    float spacing;
+    float perspectiveMult;
+    float effect;
+    float alphaMult;
+    float alphaFalloff;
+    float sinRot;
+    float cosRot;
+    sf::Color pivotColor;
+    sf::Color wallColor;
+    sf::Color playerColor;
+};
+
+// Appends `params.depth` copies of `source` to `target`, each one offset along
+// the camera direction and recolored with `layerColor`, from the farthest
+// layer to the nearest one. Every layer is written in a single vectorized pass
+// straight from `source`.
+void extrude3D(const Extrusion3DParams& params, const sf::Color& layerColor,
+    const Utils::FastVertexVectorTris& source,
+    Utils::FastVertexVectorTris& target);
+
+// All the vertices of the game world for one frame. The 2D buffers are filled
+// on the main thread from live game state, and together with `extrusion3D`
+// they are the only input needed to build the 3D buffers.
+struct FrameVertices
+{
+    Utils::FastVertexVectorTris wallQuads;
+    Utils::FastVertexVectorTris pivotQuads;
+    Utils::FastVertexVectorTris playerTris;
+    Utils::FastVertexVectorTris capTris;
+    Utils::FastVertexVectorTris wallQuads3D;
+    Utils::FastVertexVectorTris pivotQuads3D;
+    Utils::FastVertexVectorTris playerTris3D;
+
+    std::optional<Extrusion3DParams> extrusion3D;
+
+    void clear() noexcept;
+    void build3D();
+};
+
+// Double-buffered frame vertices. The main thread always fills the back
+// frame. In pipelined mode the 3D layers of that frame are built on a worker
+// thread while the main thread renders the previous frame and simulates the
+// next one, at the cost of one frame of display latency.
+class VertexPipeline
+{
+private:
+    std::array<FrameVertices, 2> _frames;
+    std::size_t _backIdx{0};
+
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::size_t _jobIdx{0};
+    bool _jobPending{false};
+    bool _stopRequested{false};
+
+    void workerLoop();
+    void waitForWorker();
+
+public:
+    explicit VertexPipeline();
+    ~VertexPipeline();
+
+    VertexPipeline(const VertexPipeline&) = delete;
+    VertexPipeline& operator=(const VertexPipeline&) = delete;
+
+    [[nodiscard]] FrameVertices& getBackFrame() noexcept;
+
+    // Builds the back frame on the calling thread and returns it.
+    [[nodiscard]] const FrameVertices& buildBackFrame();
+
+    // Hands the back frame to the worker thread and returns the frame
+    // submitted by the previous call, which stays valid until the next call.
+    [[nodiscard]] const FrameVertices& submitBackFrame();
+};
+
+} // namespace hg
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -39,6 +40,17 @@ struct LevelData
     std::unordered_map<float, std::string> validators;
     std::unordered_map<float, std::string> validatorsWithoutPackId;
 
+    // Lua instruction budgets requested by the level, used when validating
+    // replays. The server may enforce lower limits. The defaults stop a
+    // runaway script in well under a second of interpreted execution.
+    static constexpr std::uint64_t defaultLuaInstructionBudgetPerCall =
+        5'000'000;
+    static constexpr std::uint64_t defaultLuaInstructionBudgetTotal =
+        1'000'000'000;
+
+    std::uint64_t luaInstructionBudgetPerCall;
+    std::uint64_t luaInstructionBudgetTotal;
+
     LevelData(const ssvuj::Obj& mRoot, const std::string& mPackPath,
         const std::string& mPackId);
 
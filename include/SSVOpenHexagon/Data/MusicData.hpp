@@ -50,6 +50,9 @@ public:
 
     void playSeconds(
         const std::string& mPackId, Audio& mAudio, float mSeconds) const;
+
+    void prefetchSegment(
+        const std::string& mPackId, Audio& mAudio, std::size_t mIdx) const;
 };
 
 } // namespace hg
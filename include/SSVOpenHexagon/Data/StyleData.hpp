@@ -12,8 +12,12 @@
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/System/Vector2.hpp>
 
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace Json {
 
@@ -38,7 +42,27 @@ namespace hg {
 
 class StyleData
 {
+public:
+    // Colors beyond this many in a style's `colors` array are ignored.
+    static constexpr std::size_t maxColors = 64;
+
 private:
+    // Parts of a style that never change after loading. Shared by all
+    // copies, so that starting a level or selecting it in the menu does not
+    // copy them.
+    struct Definition
+    {
+        std::string id{};
+        sf::Color _3dOverrideColor{};
+        ColorData mainColorData{};
+        ColorData playerColor{};
+        ColorData textColor{};
+        ColorData wallColor{};
+        std::vector<ColorData> colorDatas{};
+    };
+
+    std::shared_ptr<const Definition> definition;
+
     float currentHue{0};
     float currentSwapTime{0};
     float pulseFactor{0};
@@ -47,7 +71,8 @@ private:
     sf::Color currentTextColor{sf::Color::Black};
     sf::Color currentWallColor{sf::Color::White};
     sf::Color current3DOverrideColor{sf::Color::Black};
-    std::vector<sf::Color> currentColors;
+    std::array<sf::Color, maxColors> currentColors{};
+    std::size_t currentColorCount{0};
 
     [[nodiscard]] static sf::Color calculateColor(const float mCurrentHue,
         const float mPulseFactor, const ColorData& mColorData);
@@ -56,6 +81,9 @@ private:
         const ssvuj::Obj& mRoot, const std::string& mKey,
         const ColorData& mDefault);
 
+    [[nodiscard]] static std::shared_ptr<const Definition> loadDefinition(
+        const ssvuj::Obj& mRoot);
+
     void drawBackgroundImpl(Utils::FastVertexVectorTris& vertices,
         const sf::Vector2f& mCenterPos, const unsigned int sides,
         const bool darkenUnevenBackgroundChunk, const bool blackAndWhite) const;
@@ -65,7 +93,6 @@ private:
         const bool fourByThree, const bool blackAndWhite) const;
 
 public:
-    std::string id{};
     float hueMin{};
     float hueMax{};
     float hueIncrement{};
@@ -92,16 +119,8 @@ public:
     float BGRotOff{0}; // In degrees
 
 private:
-    sf::Color _3dOverrideColor;
-    ColorData mainColorData;
-    ColorData playerColor;
-    ColorData textColor;
-    ColorData wallColor;
-
     CapColor capColor;
 
-    std::vector<ColorData> colorDatas;
-
 public:
     explicit StyleData();
     explicit StyleData(const ssvuj::Obj& mRoot);
@@ -121,11 +140,13 @@ public:
 
     void setCapColor(const CapColor& mCapColor);
 
+    [[nodiscard]] const std::string& getId() const noexcept;
+
     [[nodiscard]] const sf::Color& getMainColor() const noexcept;
     [[nodiscard]] const sf::Color& getPlayerColor() const noexcept;
     [[nodiscard]] const sf::Color& getTextColor() const noexcept;
     [[nodiscard]] const sf::Color& getWallColor() const noexcept;
-    [[nodiscard]] const std::vector<sf::Color>& getColors() const noexcept;
+    [[nodiscard]] std::span<const sf::Color> getColors() const noexcept;
     [[nodiscard]] const sf::Color& getColor(
         const std::size_t mIdx) const noexcept;
     [[nodiscard]] float getCurrentHue() const noexcept;
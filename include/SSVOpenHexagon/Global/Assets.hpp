@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "SSVOpenHexagon/Core/ProfileJournal.hpp"
+
 #include "SSVOpenHexagon/Data/LevelData.hpp"
 #include "SSVOpenHexagon/Data/PackData.hpp"
 #include "SSVOpenHexagon/Data/ProfileData.hpp"
@@ -11,6 +13,7 @@
 #include "SSVOpenHexagon/Data/LoadInfo.hpp"
 #include "SSVOpenHexagon/Data/PackInfo.hpp"
 
+#include "SSVOpenHexagon/Utils/TrigramIndex.hpp"
 #include "SSVOpenHexagon/Utils/UniquePtr.hpp"
 
 #include <SFML/Graphics/Shader.hpp>
@@ -19,6 +22,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -68,8 +72,21 @@ private:
     std::map<std::string, ProfileData> profileDataMap;
     ProfileData* currentProfilePtr{nullptr};
 
+    // Changes to local profiles are journaled, and the JSON snapshot of a
+    // profile is only rewritten once its journal has grown past
+    // `maxProfileJournalEntries` or when profiles are saved.
+    static constexpr std::size_t maxProfileJournalEntries = 256;
+    ProfileJournal profileJournal;
+
     std::unordered_set<std::string> packIdsWithMissingDependencies;
 
+    // Name, author, pack name and description of the levels of selectable
+    // packs, in menu order. `levelSearchIds` holds the level id of each
+    // document of the index.
+    Utils::TrigramIndex levelSearchIndex;
+    std::vector<std::string> levelSearchIds;
+    std::vector<Utils::TrigramIndex::DocId> levelSearchBuf;
+
     struct LoadedShader
     {
         Utils::UniquePtr<sf::Shader> shader;
@@ -111,7 +128,10 @@ private:
     void loadPackAssets_loadCustomSounds(
         const std::string& mPackId, const ssvufs::Path& mPath);
 
-    [[nodiscard]] std::string getCurrentLocalProfileFilePath();
+    void compactLocalProfile(const ProfileData& mProfileData);
+    void compactLocalProfileIfNeeded(const ProfileData& mProfileData);
+
+    void buildLevelSearchIndex();
 
 private:
     LoadInfo loadInfo;
@@ -155,6 +175,11 @@ public:
     [[nodiscard]] const std::vector<PackInfo>&
     getSelectablePackInfos() const noexcept;
 
+    // Ids of the levels of selectable packs matching every word of `mQuery`,
+    // most relevant first. See `Utils::TrigramIndex::search`.
+    [[nodiscard]] std::vector<std::string> searchLevels(
+        const std::string_view mQuery, const std::size_t mMaxResults);
+
     [[nodiscard]] const PackData* findPackData(
         const std::string& mPackDisambiguator, const std::string& mPackName,
         const std::string& mPackAuthor) const noexcept;
@@ -182,6 +207,9 @@ public:
     [[nodiscard]] float getLocalScore(const std::string& mId);
     void setLocalScore(const std::string& mId, float mScore);
 
+    void addFavoriteLevel(const std::string& mLevelId);
+    void removeFavoriteLevel(const std::string& mLevelId);
+
     void saveCurrentLocalProfile();
     void saveAllProfiles();
 
@@ -201,7 +229,9 @@ public:
     void pSaveAll();
     void pSetCurrent(const std::string& mName);
     void pCreate(const std::string& mName);
-    void pRemove(const std::string& mName);
+    // Deletes the files of the profile, then removes it from memory.
+    // Returns `false`, keeping the profile, if its file could not be deleted.
+    [[nodiscard]] bool pRemove(const std::string& mName);
 
     [[nodiscard]] sf::SoundBuffer* getSoundBuffer(const std::string& assetId);
 
@@ -63,6 +63,12 @@ public:
     [[nodiscard]] bool loadAndPlayMusic(const std::string& packId,
         const std::string& id, const float playingOffsetSeconds);
 
+    // Opens the music and decodes its first seconds from the given offset on
+    // a worker thread, so that a matching `loadAndPlayMusic` starts playing
+    // right away.
+    void prefetchMusic(const std::string& packId, const std::string& id,
+        const float playingOffsetSeconds);
+
     void setCurrentMusicPitch(const float pitch);
 };
 
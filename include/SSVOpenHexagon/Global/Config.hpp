@@ -93,6 +93,8 @@ void setPlayerTrailHasSwapColor(bool x);
 void setShowSwapParticles(bool x);
 void setPlaySwapReadySound(bool x);
 void setShowSwapBlinkingEffect(bool x);
+void setPipelinedVertexGeneration(bool x);
+void setLuaJitFfi(bool x);
 
 [[nodiscard]] bool getOfficial();
 [[nodiscard]] const std::string& getUneligibilityReason();
@@ -170,6 +172,8 @@ void setShowSwapBlinkingEffect(bool x);
 [[nodiscard]] bool getShowSwapParticles();
 [[nodiscard]] bool getPlaySwapReadySound();
 [[nodiscard]] bool getShowSwapBlinkingEffect();
+[[nodiscard]] bool getPipelinedVertexGeneration();
+[[nodiscard]] bool getLuaJitFfi();
 
 // keyboard binds
 
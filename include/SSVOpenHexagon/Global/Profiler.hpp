@@ -0,0 +1,78 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <vrm/pp/cat.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hg::Profiler {
+
+#ifdef SSVOH_ENABLE_PROFILER
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+// Per-frame timing of a named zone, aggregated by `markFrame`. Zones entered
+// multiple times during a frame are summed.
+struct ZoneStats
+{
+    const char* name;
+    double lastMs;
+    double avgMs;
+    double maxMs;
+    std::uint32_t lastCalls;
+};
+
+// Records the time spent between construction and destruction. `name` must
+// have static storage duration (e.g. a string literal).
+class ScopedZone
+{
+private:
+    const char* _name;
+    std::int64_t _startNs;
+
+public:
+    explicit ScopedZone(const char* name) noexcept;
+    ~ScopedZone() noexcept;
+
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+};
+
+// Collects the zones recorded by all threads since the previous call, updates
+// the per-zone statistics and streams them to the trace file if one is open.
+void markFrame();
+
+[[nodiscard]] std::vector<ZoneStats> getZoneStats();
+
+// Chrome trace-event JSON, viewable in `chrome://tracing` or Perfetto.
+[[nodiscard]] bool startTrace(const std::string& path);
+void stopTrace();
+[[nodiscard]] bool isTracing();
+
+void drawImguiWindow();
+
+} // namespace hg::Profiler
+
+#ifdef SSVOH_ENABLE_PROFILER
+
+#define SSVOH_PROFILE_SCOPE(name)                                   \
+    const ::hg::Profiler::ScopedZone VRM_PP_CAT(profZone, __LINE__) \
+    {                                                               \
+        name                                                        \
+    }
+
+#define SSVOH_PROFILE_FRAME() ::hg::Profiler::markFrame()
+
+#else
+
+#define SSVOH_PROFILE_SCOPE(name) static_cast<void>(0)
+#define SSVOH_PROFILE_FRAME() static_cast<void>(0)
+
+#endif
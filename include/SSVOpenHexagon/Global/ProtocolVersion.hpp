@@ -10,6 +10,6 @@ namespace hg {
 
 using ProtocolVersion = sf::Uint8;
 
-inline constexpr ProtocolVersion PROTOCOL_VERSION = 0;
+inline constexpr ProtocolVersion PROTOCOL_VERSION = 1;
 
 } // namespace hg
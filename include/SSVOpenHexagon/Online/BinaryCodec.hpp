@@ -0,0 +1,529 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <SFML/Config.hpp>
+
+#include <boost/pfr.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Binary codec for the online protocol, driven by `boost::pfr` reflection.
+//
+// The encoding is byte-for-byte identical to `sf::Packet`'s: integers are
+// big-endian, floating point values are copied as-is, `bool` is one byte,
+// strings are prefixed by a 32-bit length and vectors by a 64-bit length.
+// Values are written directly into a contiguous caller-provided buffer, and
+// the encoded size of fixed-size types is known at compile time.
+//
+// Types are supported by specializing `hg::Binary::Codec`. Aggregates are
+// handled field-by-field by the primary template.
+
+namespace hg::Binary {
+
+// Value of `fixedSizeOf<T>` for types whose encoded size depends on the value.
+inline constexpr std::size_t dynamicSize = static_cast<std::size_t>(-1);
+
+template <typename T>
+void storeBigEndian(sf::Uint8* out, const T x) noexcept
+{
+    using U = std::make_unsigned_t<T>;
+    const auto u = static_cast<U>(x);
+
+    for(std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        out[i] = static_cast<sf::Uint8>(u >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+template <typename T>
+[[nodiscard]] T loadBigEndian(const sf::Uint8* in) noexcept
+{
+    using U = std::make_unsigned_t<T>;
+    U u = 0;
+
+    for(std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        u = static_cast<U>((u << 8) | in[i]);
+    }
+
+    return static_cast<T>(u);
+}
+
+// Appends to the end of a byte vector. Reserve the buffer beforehand (see
+// `encodedSize`) to encode without reallocations.
+class Writer
+{
+private:
+    std::vector<sf::Uint8>& _buffer;
+
+public:
+    [[nodiscard]] explicit Writer(std::vector<sf::Uint8>& buffer) noexcept
+        : _buffer{buffer}
+    {}
+
+    // Returns a pointer to `n` newly appended bytes, valid until the next
+    // write.
+    [[nodiscard]] sf::Uint8* claim(const std::size_t n)
+    {
+        const std::size_t oldSize = _buffer.size();
+        _buffer.resize(oldSize + n);
+        return _buffer.data() + oldSize;
+    }
+
+    void writeBytes(const void* data, const std::size_t n)
+    {
+        if(n > 0)
+        {
+            std::memcpy(claim(n), data, n);
+        }
+    }
+
+    template <typename T>
+    void writeBigEndian(const T x)
+    {
+        storeBigEndian(claim(sizeof(T)), x);
+    }
+
+    [[nodiscard]] std::vector<sf::Uint8>& getBuffer() noexcept
+    {
+        return _buffer;
+    }
+
+    [[nodiscard]] std::size_t getSize() const noexcept
+    {
+        return _buffer.size();
+    }
+};
+
+// Reads from a contiguous range of bytes, never past its end.
+class Reader
+{
+private:
+    const sf::Uint8* _pos;
+    const sf::Uint8* _end;
+
+public:
+    [[nodiscard]] explicit Reader(
+        const void* data, const std::size_t size) noexcept
+        : _pos{static_cast<const sf::Uint8*>(data)}, _end{_pos + size}
+    {}
+
+    // Returns a pointer to the next `n` bytes and skips them, or `nullptr`
+    // if not enough bytes are left.
+    [[nodiscard]] const sf::Uint8* take(const std::size_t n) noexcept
+    {
+        if(getRemaining() < n)
+        {
+            return nullptr;
+        }
+
+        const sf::Uint8* result = _pos;
+        _pos += n;
+        return result;
+    }
+
+    [[nodiscard]] bool readBytes(void* out, const std::size_t n) noexcept
+    {
+        const sf::Uint8* data = take(n);
+
+        if(data == nullptr)
+        {
+            return false;
+        }
+
+        if(n > 0)
+        {
+            std::memcpy(out, data, n);
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool readBigEndian(T& out) noexcept
+    {
+        const sf::Uint8* data = take(sizeof(T));
+
+        if(data == nullptr)
+        {
+            return false;
+        }
+
+        out = loadBigEndian<T>(data);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t getRemaining() const noexcept
+    {
+        return static_cast<std::size_t>(_end - _pos);
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename T, typename = void>
+struct Codec;
+
+template <typename T>
+inline constexpr std::size_t fixedSizeOf = Codec<T>::fixedSize;
+
+template <typename T>
+[[nodiscard]] std::size_t encodedSize(const T& x)
+{
+    if constexpr(fixedSizeOf<T> != dynamicSize)
+    {
+        (void)x;
+        return fixedSizeOf<T>;
+    }
+    else
+    {
+        return Codec<T>::encodedSize(x);
+    }
+}
+
+template <typename T>
+void encode(Writer& w, const T& x)
+{
+    Codec<T>::encode(w, x);
+}
+
+template <typename T>
+[[nodiscard]] bool decode(Reader& r, T& x)
+{
+    return Codec<T>::decode(r, x);
+}
+
+// ----------------------------------------------------------------------------
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+{
+    static constexpr std::size_t fixedSize = sizeof(T);
+
+    static void encode(Writer& w, const T x)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+        {
+            w.writeBigEndian(static_cast<sf::Uint8>(x));
+        }
+        else if constexpr(std::is_floating_point_v<T>)
+        {
+            w.writeBytes(&x, sizeof(T));
+        }
+        else
+        {
+            w.writeBigEndian(x);
+        }
+    }
+
+    [[nodiscard]] static bool decode(Reader& r, T& x)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+        {
+            sf::Uint8 byte;
+
+            if(!r.readBigEndian(byte))
+            {
+                return false;
+            }
+
+            x = byte != 0;
+            return true;
+        }
+        else if constexpr(std::is_floating_point_v<T>)
+        {
+            return r.readBytes(&x, sizeof(T));
+        }
+        else
+        {
+            return r.readBigEndian(x);
+        }
+    }
+};
+
+template <>
+struct Codec<std::string>
+{
+    static constexpr std::size_t fixedSize = dynamicSize;
+
+    [[nodiscard]] static std::size_t encodedSize(const std::string& s)
+    {
+        return sizeof(sf::Uint32) + s.size();
+    }
+
+    static void encode(Writer& w, const std::string& s)
+    {
+        w.writeBigEndian(static_cast<sf::Uint32>(s.size()));
+        w.writeBytes(s.data(), s.size());
+    }
+
+    [[nodiscard]] static bool decode(Reader& r, std::string& s)
+    {
+        sf::Uint32 size;
+
+        if(!r.readBigEndian(size))
+        {
+            return false;
+        }
+
+        const sf::Uint8* data = r.take(size);
+
+        if(data == nullptr)
+        {
+            return false;
+        }
+
+        s.assign(reinterpret_cast<const char*>(data), size);
+        return true;
+    }
+};
+
+template <typename T, std::size_t N>
+struct Codec<std::array<T, N>>
+{
+    static constexpr bool isByteArray =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) == 1;
+
+    static constexpr std::size_t fixedSize =
+        fixedSizeOf<T> == dynamicSize ? dynamicSize : fixedSizeOf<T> * N;
+
+    [[nodiscard]] static std::size_t encodedSize(const std::array<T, N>& arr)
+    {
+        std::size_t result = 0;
+
+        for(const T& x : arr)
+        {
+            result += Binary::encodedSize(x);
+        }
+
+        return result;
+    }
+
+    static void encode(Writer& w, const std::array<T, N>& arr)
+    {
+        if constexpr(isByteArray)
+        {
+            w.writeBytes(arr.data(), N);
+        }
+        else
+        {
+            for(const T& x : arr)
+            {
+                Binary::encode(w, x);
+            }
+        }
+    }
+
+    [[nodiscard]] static bool decode(Reader& r, std::array<T, N>& arr)
+    {
+        if constexpr(isByteArray)
+        {
+            return r.readBytes(arr.data(), N);
+        }
+        else
+        {
+            for(T& x : arr)
+            {
+                if(!Binary::decode(r, x))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+};
+
+template <typename T>
+struct Codec<std::vector<T>>
+{
+    static constexpr std::size_t fixedSize = dynamicSize;
+
+    [[nodiscard]] static std::size_t encodedSize(const std::vector<T>& vec)
+    {
+        if constexpr(fixedSizeOf<T> != dynamicSize)
+        {
+            return sizeof(sf::Uint64) + vec.size() * fixedSizeOf<T>;
+        }
+        else
+        {
+            std::size_t result = sizeof(sf::Uint64);
+
+            for(const T& x : vec)
+            {
+                result += Binary::encodedSize(x);
+            }
+
+            return result;
+        }
+    }
+
+    static void encode(Writer& w, const std::vector<T>& vec)
+    {
+        w.writeBigEndian(static_cast<sf::Uint64>(vec.size()));
+
+        for(const T& x : vec)
+        {
+            Binary::encode(w, x);
+        }
+    }
+
+    [[nodiscard]] static bool decode(Reader& r, std::vector<T>& vec)
+    {
+        sf::Uint64 size;
+
+        if(!r.readBigEndian(size))
+        {
+            return false;
+        }
+
+        // Reject sizes that cannot possibly fit in the remaining bytes before
+        // allocating. Every dynamically-sized type takes at least one byte.
+        const std::size_t minElementSize =
+            fixedSizeOf<T> == dynamicSize ? 1 : fixedSizeOf<T>;
+
+        if(minElementSize > 0 && size > r.getRemaining() / minElementSize)
+        {
+            return false;
+        }
+
+        vec.resize(size);
+
+        for(T& x : vec)
+        {
+            if(!Binary::decode(r, x))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+template <typename T>
+struct Codec<std::optional<T>>
+{
+    static constexpr std::size_t fixedSize = dynamicSize;
+
+    [[nodiscard]] static std::size_t encodedSize(const std::optional<T>& opt)
+    {
+        return 1 + (opt.has_value() ? Binary::encodedSize(*opt) : 0);
+    }
+
+    static void encode(Writer& w, const std::optional<T>& opt)
+    {
+        Binary::encode(w, opt.has_value());
+
+        if(opt.has_value())
+        {
+            Binary::encode(w, *opt);
+        }
+    }
+
+    [[nodiscard]] static bool decode(Reader& r, std::optional<T>& opt)
+    {
+        bool set;
+
+        if(!Binary::decode(r, set))
+        {
+            return false;
+        }
+
+        if(!set)
+        {
+            opt.reset();
+            return true;
+        }
+
+        return Binary::decode(r, opt.emplace());
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+namespace Impl {
+
+template <typename T, std::size_t... Is>
+[[nodiscard]] constexpr std::size_t aggregateFixedSize(
+    std::index_sequence<Is...>)
+{
+    constexpr bool allFixed =
+        ((fixedSizeOf<boost::pfr::tuple_element_t<Is, T>> != dynamicSize) &&
+            ...);
+
+    if constexpr(allFixed)
+    {
+        return (fixedSizeOf<boost::pfr::tuple_element_t<Is, T>> + ... + 0);
+    }
+    else
+    {
+        return dynamicSize;
+    }
+}
+
+} // namespace Impl
+
+// Aggregates are encoded as the sequence of their fields.
+template <typename T, typename>
+struct Codec
+{
+    static_assert(std::is_aggregate_v<T>,
+        "Binary::Codec must be specialized for non-aggregate types");
+
+    static constexpr std::size_t fieldCount = boost::pfr::tuple_size_v<T>;
+
+    static constexpr std::size_t fixedSize =
+        Impl::aggregateFixedSize<T>(std::make_index_sequence<fieldCount>{});
+
+    [[nodiscard]] static std::size_t encodedSize(const T& x)
+    {
+        std::size_t result = 0;
+
+        if constexpr(fieldCount > 0)
+        {
+            boost::pfr::for_each_field(x,
+                [&](const auto& field)
+                { result += Binary::encodedSize(field); });
+        }
+
+        return result;
+    }
+
+    static void encode(Writer& w, const T& x)
+    {
+        if constexpr(fieldCount > 0)
+        {
+            boost::pfr::for_each_field(
+                x, [&](const auto& field) { Binary::encode(w, field); });
+        }
+    }
+
+    [[nodiscard]] static bool decode(Reader& r, T& x)
+    {
+        bool success = true;
+
+        if constexpr(fieldCount > 0)
+        {
+            boost::pfr::for_each_field(x,
+                [&](auto& field)
+                { success = success && Binary::decode(r, field); });
+        }
+
+        return success;
+    }
+};
+
+} // namespace hg::Binary
@@ -7,15 +7,24 @@
 #include "SSVOpenHexagon/Online/DatabaseRecords.hpp"
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <vector>
 #include <chrono>
+#include <iosfwd>
 
 // TODO (P2): remove reliance on steam ID for future platforms
 
 namespace hg::Database {
 
+// Must be called before any other function, defaults to `ohdb.sqlite`.
+void setStoragePath(const std::string& path);
+
+// Opens the storage and loads the in-memory login token cache. Called
+// eagerly by the server, otherwise happens lazily on first use.
+void initialize();
+
 void addUser(const User& user);
 
 void removeUser(const std::uint32_t id);
@@ -45,14 +54,40 @@ void removeAllStaleLoginTokens();
 [[nodiscard]] std::vector<ProcessedScore> getTopScores(
     const int topLimit, const std::string& levelValidator);
 
+// At most `limit` scores, best first, starting from position `offset`.
+[[nodiscard]] std::vector<ProcessedScore> getScoresPage(
+    const std::uint32_t offset, const std::uint32_t limit,
+    const std::string& levelValidator);
+
+// Changes whenever a score is queued or written for the level, never zero.
+// Versions from a previous run never match current ones.
+[[nodiscard]] std::uint64_t getLeaderboardVersion(
+    const std::string& levelValidator);
+
+// Served from the in-memory token cache, never queries the storage.
 [[nodiscard]] bool isLoginTokenValid(std::uint64_t token);
 
+// Scores are queued in memory and written in a single transaction by
+// `flushPendingScores`. Reads merge the queued scores in without writing them.
+// If the transaction fails, scores are written one at a time instead: the
+// ones failing because of a transient error stay queued, the others are
+// logged and dropped.
 void addScore(const std::string& levelValidator, const std::uint64_t timestamp,
     const std::uint64_t userSteamId, const double value);
 
+[[nodiscard]] std::size_t getPendingScoreCount();
+
+// False while waiting to retry scores that failed to be written.
+[[nodiscard]] bool isPendingScoreFlushDue();
+void flushPendingScores();
+
 [[nodiscard]] std::optional<ProcessedScore> getScore(
     const std::string& levelValidator, const std::uint64_t userSteamId);
 
+// Per-function query latency statistics.
+void printQueryStats(std::ostream& os);
+void resetQueryStats();
+
 [[nodiscard]] std::optional<std::string> execute(const std::string& query);
 
 } // namespace hg::Database
@@ -0,0 +1,27 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Online/DatabaseRecords.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace hg {
+
+// Entries of `newPage` that are missing from, or differ from, the entry at the
+// same position in `oldPage`. Both pages must start at the same position.
+[[nodiscard]] std::vector<Database::ProcessedScore> diffScores(
+    const std::vector<Database::ProcessedScore>& oldPage,
+    const std::vector<Database::ProcessedScore>& newPage);
+
+// Turns `page`, which starts at position `offset`, into the page of `size`
+// entries that `changed` was computed from by `diffScores`. Returns `false`,
+// leaving `page` unspecified, if `changed` does not fit in the page.
+[[nodiscard]] bool applyScoresDiff(std::vector<Database::ProcessedScore>& page,
+    const std::uint32_t offset, const std::uint32_t size,
+    const std::vector<Database::ProcessedScore>& changed);
+
+} // namespace hg
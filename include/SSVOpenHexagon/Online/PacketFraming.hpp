@@ -0,0 +1,82 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <SFML/Network/Socket.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sf {
+
+class Packet;
+class TcpSocket;
+
+} // namespace sf
+
+namespace hg {
+
+// Framing used on the wire is the same as `sf::TcpSocket::send(sf::Packet&)`:
+// a 32-bit big-endian payload size followed by the payload. This allows
+// non-blocking sockets to be driven with raw byte transfers while remaining
+// compatible with peers that use `sf::Packet` directly.
+
+// Accumulates bytes received from a non-blocking socket and splits them into
+// complete packets. Partial frames are kept until the rest arrives.
+class IncomingFrameBuffer
+{
+public:
+    enum class ExtractResult : std::uint8_t
+    {
+        NoPacket = 0,
+        Packet = 1,
+        Oversized = 2,
+    };
+
+private:
+    std::vector<char> _data;
+    std::size_t _readPos;
+    std::size_t _maxPacketSize;
+
+    void compact();
+
+public:
+    explicit IncomingFrameBuffer(const std::size_t maxPacketSize);
+
+    void append(const char* data, const std::size_t size);
+
+    // Receives everything currently available on `socket`, up to `maxBytes`.
+    // Returns `sf::Socket::Done` if the socket has been drained (or the limit
+    // reached), otherwise the status that stopped the transfer.
+    [[nodiscard]] sf::Socket::Status receiveFrom(
+        sf::TcpSocket& socket, const std::size_t maxBytes);
+
+    [[nodiscard]] ExtractResult extract(sf::Packet& p);
+
+    [[nodiscard]] std::size_t getBufferedBytes() const noexcept;
+};
+
+// Queues outgoing packets and sends as much as a non-blocking socket accepts,
+// keeping the unsent remainder for the next `flushTo` call.
+class OutgoingFrameQueue
+{
+private:
+    std::vector<char> _data;
+
+public:
+    explicit OutgoingFrameQueue();
+
+    void push(const sf::Packet& p);
+
+    // Returns `sf::Socket::Done` if everything was sent, `sf::Socket::NotReady`
+    // if data is still pending, otherwise the error status.
+    [[nodiscard]] sf::Socket::Status flushTo(sf::TcpSocket& socket);
+
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t getPendingBytes() const noexcept;
+};
+
+} // namespace hg
@@ -75,14 +75,22 @@ struct CTSPStartedGame                 { sf::Uint64 loginToken; std::string leve
 struct CTSPCompressedReplay            { sf::Uint64 loginToken; compressed_replay_file compressedReplayFile; };
 struct CTSPRequestServerStatus         { sf::Uint64 loginToken; };
 struct CTSPReady                       { sf::Uint64 loginToken; };
+struct CTSPRequestLeaderboardPage      { sf::Uint64 loginToken; std::string levelValidator; sf::Uint32 offset; sf::Uint32 limit; bool aroundOwnScore; sf::Uint64 knownVersion; };
 // clang-format on
 
+// `CTSPRequestLeaderboardPage` asks for `limit` scores starting at `offset`,
+// or centered on the player's own score if `aroundOwnScore` is set and the
+// player has one. `knownVersion` is the version of the page the client has
+// cached, zero if none. Page versions are opaque and also identify the page,
+// so a cached page is never reported unchanged for a different request.
+
 #define SSVOH_CTS_PACKETS                                         \
     VRM_PP_TPL_MAKE(CTSPHeartbeat, CTSPDisconnect, CTSPPublicKey, \
         CTSPRegister, CTSPLogin, CTSPLogout, CTSPDeleteAccount,   \
         CTSPRequestTopScores, CTSPReplay, CTSPRequestOwnScore,    \
         CTSPRequestTopScoresAndOwnScore, CTSPStartedGame,         \
-        CTSPCompressedReplay, CTSPRequestServerStatus, CTSPReady)
+        CTSPCompressedReplay, CTSPRequestServerStatus, CTSPReady, \
+        CTSPRequestLeaderboardPage)
 
 using PVClientToServer = std::variant<PInvalid, PEncryptedMsg,
     VRM_PP_TPL_EXPLODE(SSVOH_CTS_PACKETS)>;
@@ -117,14 +125,22 @@ struct STCPTopScores              { std::string levelValidator; std::vector<Data
 struct STCPOwnScore               { std::string levelValidator; Database::ProcessedScore score; };
 struct STCPTopScoresAndOwnScore   { std::string levelValidator; std::vector<Database::ProcessedScore> scores; std::optional<Database::ProcessedScore> ownScore; };
 struct STCPServerStatus           { ProtocolVersion protocolVersion; GameVersion gameVersion; std::vector<std::string> supportedLevelValidators; };
+struct STCPLeaderboardPage        { std::string levelValidator; sf::Uint64 version; sf::Uint64 baseVersion; sf::Uint32 offset; sf::Uint32 size; std::vector<Database::ProcessedScore> scores; std::optional<Database::ProcessedScore> ownScore; };
 // clang-format on
 
+// `STCPLeaderboardPage` is a reply to `CTSPRequestLeaderboardPage`:
+// - If `baseVersion` is zero, `scores` is the whole page.
+// - If `baseVersion` equals `version`, the cached page is unchanged and no
+//   scores are sent, not even the own score.
+// - Otherwise, `scores` only has the entries that differ from the cached page
+//   at `baseVersion`, see `applyScoresDiff`.
+
 #define SSVOH_STC_PACKETS                                               \
     VRM_PP_TPL_MAKE(STCPKick, STCPPublicKey, STCPRegistrationSuccess,   \
         STCPRegistrationFailure, STCPLoginSuccess, STCPLoginFailure,    \
         STCPLogoutSuccess, STCPLogoutFailure, STCPDeleteAccountSuccess, \
         STCPDeleteAccountFailure, STCPTopScores, STCPOwnScore,          \
-        STCPTopScoresAndOwnScore, STCPServerStatus)
+        STCPTopScoresAndOwnScore, STCPServerStatus, STCPLeaderboardPage)
 
 using PVServerToClient = std::variant<PInvalid, PEncryptedMsg,
     VRM_PP_TPL_EXPLODE(SSVOH_STC_PACKETS)>;
@@ -125,6 +125,20 @@ struct Converter<unsigned long>
     }
 };
 
+template <>
+struct Converter<unsigned long long>
+{
+    using T = unsigned long long;
+    static void fromObj(const Obj& mObj, T& mValue)
+    {
+        mValue = mObj.asUInt64();
+    }
+    static void toObj(Obj& mObj, const T& mValue)
+    {
+        mObj = Json::UInt64(mValue);
+    }
+};
+
 template <typename TItem, typename TAlloc>
 struct Converter<std::vector<TItem, TAlloc>>
 {
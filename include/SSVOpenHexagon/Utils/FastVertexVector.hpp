@@ -91,6 +91,20 @@ public:
         _size += rhs._size;
     }
 
+    // Extends the size by `n` and returns a pointer to the first new vertex.
+    // The new vertices are uninitialized and must be written by the caller.
+    [[nodiscard, gnu::always_inline]] sf::Vertex* unsafe_grow(
+        const std::size_t n) noexcept
+    {
+        SSVOH_ASSERT(_size + n <= _capacity);
+        SSVOH_ASSERT(_data != nullptr);
+
+        sf::Vertex* const result = &(_data[_size]._v);
+        _size += n;
+
+        return result;
+    }
+
     [[gnu::always_inline]] void clear() noexcept
     {
         _size = 0;
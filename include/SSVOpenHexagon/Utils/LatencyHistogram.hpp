@@ -0,0 +1,77 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Utils/Clock.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+namespace hg::Utils {
+
+// Histogram of durations with power-of-two microsecond buckets: bucket `i`
+// holds samples in `[2^(i-1), 2^i)` microseconds. Recording is a handful of
+// integer operations, so it can be done on every request.
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t bucketCount = 32;
+
+private:
+    std::array<std::uint64_t, bucketCount> _buckets;
+    std::uint64_t _count;
+    std::uint64_t _totalUs;
+    std::uint64_t _maxUs;
+
+public:
+    LatencyHistogram() noexcept;
+
+    void record(const std::uint64_t us) noexcept;
+
+    template <typename Rep, typename Period>
+    void record(const std::chrono::duration<Rep, Period> d) noexcept
+    {
+        record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(d).count()));
+    }
+
+    void reset() noexcept;
+
+    [[nodiscard]] std::uint64_t getCount() const noexcept;
+    [[nodiscard]] std::uint64_t getTotalUs() const noexcept;
+    [[nodiscard]] std::uint64_t getMaxUs() const noexcept;
+    [[nodiscard]] double getMeanUs() const noexcept;
+
+    // Upper bound of the bucket containing the `p`-th quantile.
+    [[nodiscard]] std::uint64_t getPercentileUs(const double p) const noexcept;
+
+    void print(std::ostream& os, const std::string_view name) const;
+};
+
+class ScopedLatency
+{
+private:
+    LatencyHistogram& _histogram;
+    const HRTimePoint _start;
+
+public:
+    [[nodiscard]] explicit ScopedLatency(LatencyHistogram& histogram) noexcept
+        : _histogram{histogram}, _start{HRClock::now()}
+    {}
+
+    ~ScopedLatency() noexcept
+    {
+        _histogram.record(HRClock::now() - _start);
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency(ScopedLatency&&) = delete;
+};
+
+} // namespace hg::Utils
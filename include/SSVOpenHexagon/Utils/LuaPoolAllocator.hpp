@@ -0,0 +1,93 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Utils/UniquePtrArray.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hg::Utils {
+
+// Allocator for Lua states. Blocks up to `maxPooledSize` bytes are carved out
+// of large chunks and recycled through per-size-class free lists, larger ones
+// go to `malloc`. Chunks are kept until `trim` is called or the allocator is
+// destroyed, so a state created after another one has been closed (e.g. on
+// level restart) reuses its memory instead of hitting `malloc` again.
+//
+// Not thread-safe: a pool must only be used by states that are run on the
+// same thread.
+class LuaPoolAllocator
+{
+public:
+    static constexpr std::size_t granularity = 16;
+    static constexpr std::size_t maxPooledSize = 512;
+    static constexpr std::size_t classCount = maxPooledSize / granularity;
+    static constexpr std::size_t chunkSize = 64 * 1024;
+
+    struct Stats
+    {
+        std::size_t bytesInUse;
+        std::size_t peakBytesInUse;
+        std::size_t bytesReserved;
+        std::uint64_t allocations;
+        std::uint64_t pooledAllocations;
+        std::uint64_t lastTickAllocations;
+    };
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    std::array<FreeBlock*, classCount> _freeLists;
+    std::vector<UniquePtrArray<std::byte>> _chunks;
+    std::size_t _usedChunkCount;
+    std::byte* _chunkCursor;
+    std::byte* _chunkEnd;
+
+    Stats _stats;
+    std::uint64_t _allocationsAtTickStart;
+
+    [[nodiscard]] static std::size_t sizeClassOf(
+        const std::size_t size) noexcept;
+
+    [[nodiscard]] void* allocatePooled(const std::size_t sizeClass) noexcept;
+    [[nodiscard]] bool refillChunk() noexcept;
+
+    void pushFreeBlock(void* ptr, const std::size_t sizeClass) noexcept;
+
+public:
+    LuaPoolAllocator();
+
+    LuaPoolAllocator(const LuaPoolAllocator&) = delete;
+    LuaPoolAllocator& operator=(const LuaPoolAllocator&) = delete;
+
+    // Same contract as `lua_Alloc`: frees `ptr` when `newSize` is zero,
+    // otherwise returns a block of `newSize` bytes holding the first
+    // `oldSize` bytes of `ptr`, or null on failure leaving `ptr` untouched.
+    // `oldSize` must be the size `ptr` was last allocated with.
+    [[nodiscard]] void* reallocate(
+        void* ptr, std::size_t oldSize, const std::size_t newSize) noexcept;
+
+    // Function to pass to `lua_newstate`, `ud` must point to the allocator.
+    [[nodiscard]] static void* luaAlloc(void* ud, void* ptr,
+        std::size_t oldSize, std::size_t newSize) noexcept;
+
+    // Once no block is in use anymore, i.e. all states using the allocator
+    // are closed, forgets all free blocks and releases the chunks beyond the
+    // first `retainedBytes`, which the next states start from.
+    void trim(const std::size_t retainedBytes) noexcept;
+
+    // Closes the current tick for the `lastTickAllocations` statistic.
+    void markTick() noexcept;
+
+    [[nodiscard]] const Stats& getStats() const noexcept;
+};
+
+} // namespace hg::Utils
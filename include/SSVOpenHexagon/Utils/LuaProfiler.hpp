@@ -0,0 +1,125 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Utils/Clock.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hg::Utils {
+
+// Call counts and cumulative time per Lua entry point: callbacks invoked by
+// the game (e.g. `onUpdate`), Lua code scheduled on timelines and C++
+// functions exposed to scripts. Disabled by default, in which case entering a
+// scope is a single branch.
+class LuaProfiler
+{
+public:
+    enum class Kind : std::uint8_t
+    {
+        Callback,
+        Timeline,
+        Binding
+    };
+
+    struct Entry
+    {
+        std::string name;
+        Kind kind;
+        std::uint64_t calls;
+
+        // `totalNs` includes nested entries, `selfNs` does not.
+        std::int64_t totalNs;
+        std::int64_t selfNs;
+        std::int64_t maxNs;
+    };
+
+    class Scope
+    {
+    private:
+        LuaProfiler* _profiler;
+        Scope* _parent;
+        std::size_t _index;
+        std::int64_t _childNs;
+        HRTimePoint _start;
+
+    public:
+        // Does nothing if `profiler` is null or disabled.
+        explicit Scope(LuaProfiler* profiler, const std::size_t index) noexcept;
+        ~Scope() noexcept;
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, std::size_t> _indices;
+    Scope* _current;
+    bool _enabled;
+
+public:
+    LuaProfiler();
+
+    void setEnabled(const bool enabled) noexcept;
+    [[nodiscard]] bool isEnabled() const noexcept;
+
+    // Returns a stable index for `name`, to be passed to `Scope`. Registering
+    // the same name twice returns the same index.
+    [[nodiscard]] std::size_t getIndex(
+        const std::string& name, const Kind kind);
+
+    // Zeroes all counters, indices remain valid.
+    void reset() noexcept;
+
+    // Entries that have been called at least once, by descending self time.
+    [[nodiscard]] std::vector<Entry> getSortedEntries() const;
+
+    void printCsv(std::ostream& os) const;
+    [[nodiscard]] bool dumpToFile(const std::string& path) const;
+};
+
+[[nodiscard]] const char* luaProfilerKindToStr(
+    const LuaProfiler::Kind kind) noexcept;
+
+namespace Impl {
+
+template <typename F, typename R, typename C, typename... Args>
+[[nodiscard]] auto makeProfiledLuaFn(LuaProfiler* profiler,
+    const std::size_t index, F&& f, R (C::*)(Args...) const)
+{
+    return [profiler, index, f = std::forward<F>(f)](Args... args) -> R
+    {
+        const LuaProfiler::Scope scope{profiler, index};
+        return f(std::forward<Args>(args)...);
+    };
+}
+
+} // namespace Impl
+
+// Wraps a function about to be exposed to Lua so that its calls are recorded
+// as a `Binding` entry of `profiler`, if any. The wrapper has the same
+// signature as `f`, which is needed by `LuaContext` to convert arguments.
+template <typename F>
+[[nodiscard]] auto makeProfiledLuaFn(
+    LuaProfiler* profiler, const std::string& name, F&& f)
+{
+    const std::size_t index =
+        profiler != nullptr
+            ? profiler->getIndex(name, LuaProfiler::Kind::Binding)
+            : 0;
+
+    return Impl::makeProfiledLuaFn(
+        profiler, index, std::forward<F>(f), &std::decay_t<F>::operator());
+}
+
+} // namespace hg::Utils
@@ -37,7 +37,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SSVOpenHexagon/Global/Assert.hpp"
 #include "SSVOpenHexagon/Global/Macros.hpp"
 
+#include "SSVOpenHexagon/Utils/LuaPoolAllocator.hpp"
+
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <memory>
@@ -52,6 +56,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <lua.hpp>
 
+namespace hg::Utils {
+class LuaProfiler;
+}
+
 namespace Lua {
 
 template <typename>
@@ -125,26 +133,23 @@ class LuaContext
 {
 public:
     explicit LuaContext(bool openDefaultLibs = true)
-    {
-        // we pass this allocator function to lua_newstate we use our custom
-        // allocator instead of luaL_newstate, to trace memory usage
-        struct Allocator
-        {
-            static void* allocator(
-                void*, void* ptr, std::size_t, std::size_t nsize)
-            {
-                if(nsize == 0)
-                {
-                    free(ptr);
-                    return nullptr;
-                }
+        : LuaContext{
+              std::make_shared<hg::Utils::LuaPoolAllocator>(), openDefaultLibs}
+    {}
 
-                return realloc(ptr, nsize);
-            }
-        };
+    /// \brief Creates a state allocating from `allocator`, which can be
+    /// shared with other contexts run on the same thread \details Memory
+    /// freed by a closed state is reused by the next one, e.g. when a level
+    /// is restarted.
+    explicit LuaContext(std::shared_ptr<hg::Utils::LuaPoolAllocator> allocator,
+        bool openDefaultLibs = true)
+        : _allocator(std::move(allocator))
+    {
+        SSVOH_ASSERT(_allocator != nullptr);
 
         // lua_newstate can return null if allocation failed
-        _state = lua_newstate(&Allocator::allocator, nullptr);
+        _state = lua_newstate(
+            &hg::Utils::LuaPoolAllocator::luaAlloc, _allocator.get());
 
         if(_state == nullptr)
         {
@@ -161,14 +166,21 @@ public:
     LuaContext(const LuaContext&) = delete;
     LuaContext& operator=(const LuaContext&) = delete;
 
-    LuaContext(LuaContext&& s) : _state(s._state)
+    LuaContext(LuaContext&& s)
+        : _allocator(std::move(s._allocator)),
+          _state(s._state),
+          _budgetState(std::move(s._budgetState)),
+          _profiler(s._profiler)
     {
         s._state = nullptr;
     }
 
     LuaContext& operator=(LuaContext&& s)
     {
+        std::swap(_allocator, s._allocator);
         std::swap(_state, s._state);
+        std::swap(_budgetState, s._budgetState);
+        std::swap(_profiler, s._profiler);
         return *this;
     }
 
@@ -223,6 +235,139 @@ public:
         {}
     };
 
+    /// \brief Limits on the number of Lua VM instructions that can be
+    /// executed, `perCall` applies to each call made from C++ and `total`
+    /// to the whole lifetime of the context
+    struct InstructionBudget
+    {
+        std::uint64_t perCall{std::numeric_limits<std::uint64_t>::max()};
+        std::uint64_t total{std::numeric_limits<std::uint64_t>::max()};
+    };
+
+    /// \brief Thrown when a call is aborted because the instruction budget
+    /// has been exhausted
+    struct InstructionBudgetExceededException : ExecutionErrorException
+    {
+        using ExecutionErrorException::ExecutionErrorException;
+    };
+
+    /// \brief Counts executed instructions with a debug hook and aborts
+    /// calls once `budget` is exceeded \details The JIT compiler is turned
+    /// off, as hooks are not invoked from compiled code. Counting is done in
+    /// steps of `budgetHookInterval` instructions, so results are identical
+    /// on every machine.
+    void setInstructionBudget(const InstructionBudget& budget)
+    {
+        if(_budgetState == nullptr)
+        {
+            _budgetState = std::make_unique<BudgetState>();
+        }
+
+        *_budgetState = BudgetState{};
+        _budgetState->budget = budget;
+
+        luaJIT_setmode(_state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+
+        lua_pushlightuserdata(_state, &_budgetRegistryKey);
+        lua_pushlightuserdata(_state, _budgetState.get());
+        lua_rawset(_state, LUA_REGISTRYINDEX);
+
+        lua_sethook(_state, &_budgetHook, LUA_MASKCOUNT, budgetHookInterval);
+    }
+
+    /// \brief Returns true if a call has been aborted because of the
+    /// instruction budget, all further calls will fail immediately
+    [[nodiscard]] bool isInstructionBudgetExceeded() const noexcept
+    {
+        return _budgetState != nullptr && _budgetState->exceeded;
+    }
+
+    /// \brief Returns the number of instructions executed since the budget
+    /// was set, rounded down to a multiple of `budgetHookInterval`
+    [[nodiscard]] std::uint64_t getExecutedInstructions() const noexcept
+    {
+        return _budgetState != nullptr ? _budgetState->totalUsed : 0;
+    }
+
+    static constexpr int budgetHookInterval = 1000;
+
+    /// \brief Allocator backing the state, whose statistics also cover the
+    /// other contexts sharing it
+    [[nodiscard]] const hg::Utils::LuaPoolAllocator&
+    getAllocator() const noexcept
+    {
+        return *_allocator;
+    }
+
+    /// \brief Profiler that functions registered from now on should report
+    /// their calls to, not owned by the context \details The wrapping is
+    /// done by the code registering the functions, see
+    /// `hg::Utils::makeProfiledLuaFn`.
+    void setProfiler(hg::Utils::LuaProfiler* profiler) noexcept
+    {
+        _profiler = profiler;
+    }
+
+    [[nodiscard]] hg::Utils::LuaProfiler* getProfiler() const noexcept
+    {
+        return _profiler;
+    }
+
+#ifdef SSVOH_ENABLE_LUAJIT_FFI
+    /// \brief Writes to the global `name` a table through which lua can
+    /// read and write the `size` doubles starting at `data` \details
+    /// Elements are accessed with 1-based integer indices, anything else
+    /// raises a lua error. The FFI library itself is never reachable from
+    /// lua, so `data` is the only memory exposed. It must outlive the
+    /// context.
+    void writeFfiArrayView(
+        const std::string& name, double* data, const std::size_t size)
+    {
+        _load(R"(
+local ffi, ptr, size = ...
+local data = ffi.cast("double*", ptr)
+local error, floor, tostring, type = error, math.floor, tostring, type
+
+local function checkIndex(i)
+    if type(i) ~= "number" or i < 1 or i > size or i ~= floor(i) then
+        error("array view index out of bounds: " .. tostring(i), 3)
+    end
+end
+
+return setmetatable({}, {
+    __index = function(_, i)
+        checkIndex(i)
+        return data[i - 1]
+    end,
+    __newindex = function(_, i, v)
+        checkIndex(i)
+        if type(v) ~= "number" then
+            error("array view value must be a number", 2)
+        end
+        data[i - 1] = v
+    end,
+    __metatable = false
+})
+)");
+
+        try
+        {
+            _pushFfiModule();
+        }
+        catch(...)
+        {
+            lua_pop(_state, 1);
+            throw;
+        }
+
+        lua_pushlightuserdata(_state, data);
+        lua_pushnumber(_state, static_cast<lua_Number>(size));
+        _pcallOrThrow(3, 1);
+
+        _setGlobal(name);
+    }
+#endif
+
     /// \brief Executes lua code from the stream \param code A stream that
     /// lua will read its code from
     [[gnu::always_inline]] inline void executeCode(std::istream& code)
@@ -418,6 +563,10 @@ public:
     }
 
 private:
+    // backs the allocations of the state, kept alive until the state is
+    // closed, possibly shared with other contexts
+    std::shared_ptr<hg::Utils::LuaPoolAllocator> _allocator;
+
     // the state is the most important variable in the class since it is our
     // interface with Lua
     // the mutex is here because the lua design is not thread safe (based on
@@ -427,6 +576,108 @@ private:
     // the mutex should be locked by all public functions that use the stack
     lua_State* _state;
 
+    // instruction counting state, heap-allocated so that the pointer stored
+    // in the registry for the debug hook survives moves of the context
+    struct BudgetState
+    {
+        InstructionBudget budget;
+        std::uint64_t totalUsed{0};
+        std::uint64_t callUsed{0};
+        int callDepth{0};
+        bool exceeded{false};
+    };
+
+    std::unique_ptr<BudgetState> _budgetState;
+
+    hg::Utils::LuaProfiler* _profiler{nullptr};
+
+    inline static char _budgetRegistryKey{};
+
+#ifdef SSVOH_ENABLE_LUAJIT_FFI
+    inline static char _ffiRegistryKey{};
+
+    // calls the function below its `nargs` arguments on top of the stack,
+    // which are always popped
+    void _pcallOrThrow(const int nargs, const int nresults)
+    {
+        const int pcallReturnValue = lua_pcall(_state, nargs, nresults, 0);
+
+        if(pcallReturnValue != 0)
+        {
+            const std::string errorMsg =
+                _readTopAndPop(1, (std::string*)nullptr);
+
+            if(pcallReturnValue == LUA_ERRMEM)
+            {
+                throw std::bad_alloc();
+            }
+
+            throw ExecutionErrorException(errorMsg);
+        }
+    }
+
+    // pushes the FFI module, loaded once and kept in the registry only
+    void _pushFfiModule()
+    {
+        lua_pushlightuserdata(_state, &_ffiRegistryKey);
+        lua_rawget(_state, LUA_REGISTRYINDEX);
+
+        if(!lua_isnil(_state, -1))
+        {
+            return;
+        }
+
+        lua_pop(_state, 1);
+
+        lua_pushcfunction(_state, &luaopen_ffi);
+        _pcallOrThrow(0, 1);
+
+        // `luaopen_ffi` also registers the module in `package.loaded`, from
+        // where lua could `require` it
+        lua_getfield(_state, LUA_REGISTRYINDEX, "_LOADED");
+
+        if(lua_istable(_state, -1))
+        {
+            lua_pushnil(_state);
+            lua_setfield(_state, -2, "ffi");
+        }
+
+        lua_pop(_state, 1);
+
+        lua_pushlightuserdata(_state, &_ffiRegistryKey);
+        lua_pushvalue(_state, -2);
+        lua_rawset(_state, LUA_REGISTRYINDEX);
+    }
+#endif
+
+    static void _budgetHook(lua_State* state, lua_Debug*)
+    {
+        lua_pushlightuserdata(state, &_budgetRegistryKey);
+        lua_rawget(state, LUA_REGISTRYINDEX);
+        auto* bs = static_cast<BudgetState*>(lua_touserdata(state, -1));
+        lua_pop(state, 1);
+
+        if(!bs->exceeded)
+        {
+            bs->totalUsed += budgetHookInterval;
+            bs->callUsed += budgetHookInterval;
+
+            if(bs->callUsed <= bs->budget.perCall &&
+                bs->totalUsed <= bs->budget.total)
+            {
+                return;
+            }
+
+            bs->exceeded = true;
+
+            // from now on the hook fires on every instruction, so that a
+            // script catching the error with `pcall` cannot keep running
+            lua_sethook(state, &_budgetHook, LUA_MASKCOUNT, 1);
+        }
+
+        luaL_error(state, "instruction budget exceeded");
+    }
+
     // all the user types in the _state must have the value of &typeid(T) in
     // their
     //   metatable at key "_typeid"
@@ -818,10 +1069,22 @@ private:
             throw;
         }
 
+        // the per-call budget is reset for calls made from C++, but not for
+        // nested calls made from bindings invoked by lua
+        if(_budgetState != nullptr && _budgetState->callDepth++ == 0)
+        {
+            _budgetState->callUsed = 0;
+        }
+
         // calling pcall automatically pops the parameters and pushes output
         const int pcallReturnValue =
             lua_pcall(_state, inArguments, outArguments, 0);
 
+        if(_budgetState != nullptr)
+        {
+            --_budgetState->callDepth;
+        }
+
         // if pcall failed, analyzing the problem and throwing
         if(pcallReturnValue != 0)
         {
@@ -834,6 +1097,10 @@ private:
             {
                 throw std::bad_alloc();
             }
+            else if(isInstructionBudgetExceeded())
+            {
+                throw InstructionBudgetExceededException(errorMsg);
+            }
             else if(pcallReturnValue == LUA_ERRRUN)
             {
                 throw ExecutionErrorException(errorMsg);
@@ -0,0 +1,103 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace hg::Utils {
+
+class FastVertexVectorTris;
+
+struct ParticleSpawnData
+{
+    sf::Vector2f position;
+    sf::Vector2f velocity;
+    float angle;
+    float angularVelocity;
+    float scale;
+    float alpha;
+    sf::Color color;
+};
+
+// Fixed-capacity structure-of-arrays particle storage. Every operation is a
+// tight loop over one or two arrays, and all live particles are emitted as a
+// single textured triangle batch, so drawing a whole pool is one draw call.
+//
+// `angle` is the sprite rotation in degrees when emitting with
+// `Rotation::Enabled`, or a polar angle in radians when positioning particles
+// with `placeOnCircle`.
+class ParticlePool
+{
+public:
+    enum class Rotation : bool
+    {
+        Disabled = false,
+        Enabled = true
+    };
+
+private:
+    std::size_t _capacity;
+    std::size_t _size;
+
+    std::vector<float> _xs;
+    std::vector<float> _ys;
+    std::vector<float> _velocityXs;
+    std::vector<float> _velocityYs;
+    std::vector<float> _angles;
+    std::vector<float> _angularVelocities;
+    std::vector<float> _scales;
+    std::vector<float> _alphas;
+    std::vector<sf::Color> _colors;
+
+    void moveParticle(const std::size_t from, const std::size_t to) noexcept;
+
+    template <typename F>
+    void eraseIfImpl(F&& f) noexcept;
+
+public:
+    explicit ParticlePool(const std::size_t capacity);
+
+    // Returns `false` and drops the particle if the pool is full.
+    bool spawn(const ParticleSpawnData& data) noexcept;
+
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    // Moves particles by their velocity and rotates them by their angular
+    // velocity.
+    void integrate(const float ft) noexcept;
+
+    // Moves alpha towards zero by `step`, truncating to whole values like an
+    // `sf::Uint8` color channel would.
+    void fade(const float step) noexcept;
+
+    void multiplyScale(const float mult) noexcept;
+
+    // Sets every position to `radius` units away from the origin, along the
+    // particle's `angle` in radians.
+    void placeOnCircle(const float radius) noexcept;
+
+    // Order-preserving removal of particles with alpha `<= minAlpha`.
+    void eraseFaded(const float minAlpha) noexcept;
+
+    // Order-preserving removal of particles outside of `[min, max]`.
+    void eraseOutside(
+        const sf::Vector2f& min, const sf::Vector2f& max) noexcept;
+
+    // Appends one textured quad per particle to `out`, transformed like an
+    // `sf::Sprite` with the given texture size and origin.
+    void appendQuads(FastVertexVectorTris& out,
+        const sf::Vector2f& textureSize, const sf::Vector2f& origin,
+        const Rotation rotation) const;
+};
+
+} // namespace hg::Utils
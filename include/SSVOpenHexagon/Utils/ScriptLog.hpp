@@ -0,0 +1,66 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace hg::Utils {
+
+// A log line written by code that Lua scripts can run. Once the statement
+// writing it ends, it goes to the buffer of the `ScriptLogCapture` active on
+// the calling thread, if any, and to `ssvu::lo(title)` otherwise.
+class ScriptLog
+{
+private:
+    const char* _title;
+    std::ostringstream _os;
+
+public:
+    explicit ScriptLog(const char* title);
+    ~ScriptLog();
+
+    ScriptLog(const ScriptLog&) = delete;
+    ScriptLog& operator=(const ScriptLog&) = delete;
+
+    template <typename T>
+    ScriptLog& operator<<(const T& x)
+    {
+        _os << x;
+        return *this;
+    }
+
+    ScriptLog& operator<<(std::ostream& (*manip)(std::ostream&))
+    {
+        _os << manip;
+        return *this;
+    }
+};
+
+[[nodiscard]] inline ScriptLog scriptLog(const char* title)
+{
+    return ScriptLog{title};
+}
+
+// Appends the `ScriptLog` lines of the calling thread to `buffer` while
+// alive, instead of logging them. Captures can be nested.
+class ScriptLogCapture
+{
+    friend class ScriptLog;
+
+private:
+    std::string& _buffer;
+    ScriptLogCapture* _previous;
+
+public:
+    explicit ScriptLogCapture(std::string& buffer);
+    ~ScriptLogCapture();
+
+    ScriptLogCapture(const ScriptLogCapture&) = delete;
+    ScriptLogCapture& operator=(const ScriptLogCapture&) = delete;
+};
+
+} // namespace hg::Utils
@@ -0,0 +1,134 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sf {
+class Font;
+class RenderTarget;
+class Text;
+class Texture;
+} // namespace sf
+
+namespace hg::Utils {
+
+// Draws many strings with few draw calls. The glyph geometry of each
+// (font, character size, style, string) is laid out once, exactly like
+// `sf::Text` would, and cached. Queued strings are copied into one vertex
+// buffer per glyph texture, which are drawn by `flush`.
+//
+// Strings are interpreted like `sf::String` does by default, one code point
+// per byte. Underlined and strike-through styles are not supported. Cached
+// geometry refers to fonts by address: call `clear` before destroying a font
+// that was used with the batch.
+class TextBatch
+{
+public:
+    // Cached runs unused for at least this many frames are evicted by
+    // `endFrame`, which checks them once every `maxIdleFrames` frames.
+    static constexpr std::uint64_t maxIdleFrames = 120;
+
+    struct Stats
+    {
+        std::size_t texts;
+        std::size_t layouts;
+        std::size_t drawCalls;
+        std::size_t cachedRuns;
+    };
+
+private:
+    struct RunKey
+    {
+        const sf::Font* font;
+        unsigned int characterSize;
+        std::uint32_t style;
+        float letterSpacing;
+        float lineSpacing;
+        float outlineThickness;
+        std::string string;
+
+        [[nodiscard]] bool operator==(const RunKey&) const = default;
+    };
+
+    struct RunKeyHash
+    {
+        [[nodiscard]] std::size_t operator()(const RunKey& key) const noexcept;
+    };
+
+    struct Run
+    {
+        // Outline quads first, then fill quads, in local coordinates.
+        std::vector<sf::Vertex> vertices;
+        std::size_t outlineVertexCount;
+        sf::FloatRect bounds;
+        const sf::Texture* texture;
+        std::uint64_t lastUsedFrame;
+    };
+
+    struct Batch
+    {
+        const sf::Texture* texture;
+        FastVertexVectorTris vertices;
+    };
+
+    std::unordered_map<RunKey, Run, RunKeyHash> _runs;
+    std::vector<Batch> _batches;
+
+    // Reused for lookups, so that cache hits do not allocate.
+    RunKey _lookupKey;
+    std::vector<sf::Vertex> _fillVertices;
+
+    std::uint64_t _frame;
+    Stats _stats;
+    Stats _lastFrameStats;
+
+    [[nodiscard]] Run& getRun(const sf::Text& text, const std::string_view str);
+    [[nodiscard]] FastVertexVectorTris& getBatch(const sf::Texture* texture);
+
+    void layout(Run& run, const RunKey& key);
+
+public:
+    TextBatch();
+
+    // Bounds `str` would have if set as the string of `text`, without and
+    // with its transform applied.
+    [[nodiscard]] sf::FloatRect getLocalBounds(
+        const sf::Text& text, const std::string_view str);
+
+    [[nodiscard]] sf::FloatRect getGlobalBounds(
+        const sf::Text& text, const std::string_view str);
+
+    // Queues `str` to be drawn with the font, size, style, colors, outline
+    // and transform of `text`. Returns its global bounds.
+    sf::FloatRect add(const sf::Text& text, const std::string_view str);
+
+    // Draws and dequeues everything queued so far, with one draw call per
+    // glyph texture. Overlapping strings using different textures may be
+    // drawn in a different order than they were queued in.
+    void flush(sf::RenderTarget& target,
+        sf::RenderStates states = sf::RenderStates::Default);
+
+    // Closes the current frame for the statistics and cache eviction.
+    void endFrame();
+
+    // Drops all cached geometry and queued strings.
+    void clear();
+
+    [[nodiscard]] const Stats& getLastFrameStats() const noexcept;
+};
+
+} // namespace hg::Utils
@@ -4,17 +4,76 @@
 
 #pragma once
 
+#include "SSVOpenHexagon/Utils/FixedFunction.hpp"
+#include "SSVOpenHexagon/Global/Macros.hpp"
+
 #include <type_traits>
 #include <variant>
 #include <utility>
 #include <chrono>
-#include <functional>
+#include <memory>
 #include <optional>
 #include <cstddef>
 #include <vector>
 
 namespace hg::Utils {
 
+// Pool of callables stored in fixed-size chunks. Slots never move once
+// allocated, so a callable can safely append to its own timeline while it is
+// executing. `reset` destroys the stored callables but keeps the chunks, so a
+// timeline that is repeatedly cleared and refilled stops allocating once it
+// reaches its peak size.
+template <typename T>
+class timeline2_arena
+{
+private:
+    static constexpr std::size_t chunk_size = 64;
+
+    std::vector<std::unique_ptr<T[]>> _chunks;
+    std::size_t _used{0};
+
+    [[nodiscard]] T& slot_at(const std::size_t i) noexcept
+    {
+        return _chunks[i / chunk_size][i % chunk_size];
+    }
+
+public:
+    template <typename F>
+    [[nodiscard]] T* emplace(F&& f)
+    {
+        if(_used == _chunks.size() * chunk_size)
+        {
+            _chunks.emplace_back(std::make_unique<T[]>(chunk_size));
+        }
+
+        T& slot = slot_at(_used);
+        slot = T{SSVOH_FWD(f)};
+
+        ++_used;
+        return &slot;
+    }
+
+    void reset() noexcept
+    {
+        for(std::size_t i = 0; i < _used; ++i)
+        {
+            slot_at(i) = T{};
+        }
+
+        _used = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return _used;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return _chunks.size() * chunk_size;
+    }
+};
+
 class timeline2
 {
 public:
@@ -22,9 +81,14 @@ public:
     using time_point = clock::time_point;
     using duration = clock::duration;
 
+    // Large enough for the closures created by the Lua API, e.g. a message
+    // string plus a duration and `this`.
+    using do_fn = FixedFunction<void(), 64>;
+    using time_point_fn = FixedFunction<time_point(), 32>;
+
     struct action_do
     {
-        std::function<void()> _func;
+        do_fn* _func;
     };
 
     struct action_wait_for
@@ -39,7 +103,7 @@ public:
 
     struct action_wait_until_fn
     {
-        std::function<time_point()> _time_point_fn;
+        time_point_fn* _time_point_fn;
     };
 
     struct action
@@ -49,18 +113,35 @@ public:
             _inner;
     };
 
+    static_assert(std::is_trivially_copyable_v<action>);
+
 private:
     std::vector<action> _actions;
+    timeline2_arena<do_fn> _do_fns;
+    timeline2_arena<time_point_fn> _time_point_fns;
 
 public:
+    // Destroys all actions, keeping the allocated storage for reuse.
     void clear();
 
-    void append_do(const std::function<void()>& func);
+    template <typename F>
+    void append_do(F&& func)
+    {
+        _actions.emplace_back(
+            action{action_do{_do_fns.emplace(SSVOH_FWD(func))}});
+    }
+
     void append_wait_for(const duration d);
     void append_wait_for_seconds(const double s);
     void append_wait_for_sixths(const double s);
     void append_wait_until(const time_point tp);
-    void append_wait_until_fn(const std::function<time_point()>& tp_fn);
+
+    template <typename F>
+    void append_wait_until_fn(F&& tp_fn)
+    {
+        _actions.emplace_back(action{
+            action_wait_until_fn{_time_point_fns.emplace(SSVOH_FWD(tp_fn))}});
+    }
 
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] action& action_at(const std::size_t i) noexcept;
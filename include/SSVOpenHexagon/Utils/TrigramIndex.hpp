@@ -0,0 +1,80 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hg::Utils {
+
+// Case-insensitive substring search over a set of short documents, such as
+// level names and descriptions. Each document is made of a few fields, most
+// relevant first. Every trigram of the fields maps to the sorted list of the
+// documents containing it, so that a query only verifies the documents that
+// contain all of its trigrams.
+//
+// Text is normalized one byte at a time: ASCII letters are lowercased and
+// other ASCII characters that are not digits separate words. Other bytes,
+// such as UTF-8 sequences, are matched as they are.
+class TrigramIndex
+{
+public:
+    using DocId = std::uint32_t;
+
+private:
+    using Trigram = std::uint32_t;
+
+    struct Field
+    {
+        std::uint32_t begin;
+        std::uint32_t size;
+    };
+
+    // Normalized text of all fields, and the range of each field in it.
+    std::string _text;
+    std::vector<Field> _fields;
+
+    // Index of the first field of each document in `_fields`, followed by the
+    // number of fields.
+    std::vector<std::uint32_t> _docFields;
+
+    // Sorted trigrams, each one owning the range of `_postings` starting at
+    // the same index of `_postingsBegin`. `_postingsBegin` has one more
+    // element, the size of `_postings`.
+    std::vector<Trigram> _trigrams;
+    std::vector<std::uint32_t> _postingsBegin;
+    std::vector<DocId> _postings;
+
+    [[nodiscard]] std::string_view getField(const std::size_t i) const noexcept;
+
+public:
+    TrigramIndex();
+
+    // Adds a document made of `fields`, most relevant first. Returns its id,
+    // which is the number of documents added before it. Call `build` once
+    // all documents have been added, before searching.
+    DocId add(std::initializer_list<std::string_view> fields);
+
+    // Builds the posting lists of all documents added so far.
+    void build();
+
+    void clear();
+
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    // Replaces the contents of `out` with the documents containing every word
+    // of `query`, at most `maxResults` of them. Results are sorted by
+    // relevance: a word matching an earlier field or at the start of a word
+    // ranks higher. Ties keep the order in which documents were added. Empty
+    // queries match nothing.
+    void search(const std::string_view query, std::vector<DocId>& out,
+        const std::size_t maxResults) const;
+};
+
+} // namespace hg::Utils
@@ -0,0 +1,135 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/Database.hpp"
+
+#include "SSVOpenHexagon/Utils/Concat.hpp"
+#include "SSVOpenHexagon/Utils/Timestamp.hpp"
+
+#include "PerfUtils.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+
+// Usage: perf.Database [users] [levels] [iterations]
+//
+// Populates a synthetic database with `users * levels` scores (1M by default)
+// and reports the latency of the queries the server runs on its hot path.
+
+[[nodiscard]] static std::string levelValidator(const int i)
+{
+    return hg::Utils::concat("perf_level_", i, "_m_1");
+}
+
+static void execOrDie(const std::string& query)
+{
+    if(const std::optional<std::string> error = hg::Database::execute(query);
+        error.has_value())
+    {
+        std::printf("Error executing '%s': %s\n", query.c_str(), error->c_str());
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int nUsers = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const int nLevels = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const int nIterations = argc > 3 ? std::atoi(argv[3]) : 10000;
+
+    const std::string dbPath = "perf_ohdb.sqlite";
+
+    std::remove(dbPath.c_str());
+    std::remove((dbPath + "-wal").c_str());
+    std::remove((dbPath + "-shm").c_str());
+
+    hg::Database::setStoragePath(dbPath);
+
+    // ------------------------------------------------------------------------
+    // Populate with plain SQL, going through `addScore` for a million rows
+    // would mostly measure logging.
+    const double populateNs = perf_impl::measureNs(
+        [&]
+        {
+            const std::string seq = hg::Utils::concat(
+                "WITH RECURSIVE seq(i) AS (SELECT 0 UNION ALL SELECT i + 1 "
+                "FROM seq WHERE i + 1 < ",
+                nUsers, ") ");
+
+            execOrDie(hg::Utils::concat(seq,
+                "INSERT INTO users(steamId, name, passwordHash) "
+                "SELECT i, 'user' || i, X'00' FROM seq;"));
+
+            execOrDie(hg::Utils::concat(seq,
+                "INSERT INTO loginTokens(userId, timestamp, token) "
+                "SELECT i + 1, ",
+                hg::Utils::nowTimestamp(), ", i FROM seq;"));
+
+            execOrDie("BEGIN TRANSACTION;");
+
+            for(int l = 0; l < nLevels; ++l)
+            {
+                execOrDie(hg::Utils::concat(seq,
+                    "INSERT INTO scores(levelValidator, timestamp, "
+                    "userSteamId, value) SELECT '",
+                    levelValidator(l), "', 0, i, abs(random() % 100000) / 100.0 "
+                    "FROM seq;"));
+            }
+
+            execOrDie("COMMIT;");
+        });
+
+    std::printf("Populated %d users and %lld scores in %.2fs\n\n", nUsers,
+        static_cast<long long>(nUsers) * nLevels, populateNs / 1e9);
+
+    // ------------------------------------------------------------------------
+    std::mt19937 rng{0};
+    std::uniform_int_distribution<int> userDist{0, nUsers - 1};
+    std::uniform_int_distribution<int> levelDist{0, nLevels - 1};
+
+    perf_impl::LatencySamples topScores{"getTopScores(6)"};
+    perf_impl::LatencySamples ownScore{"getScore"};
+    perf_impl::LatencySamples tokenValid{"isLoginTokenValid"};
+    perf_impl::LatencySamples addAndFlush{"addScore + flushPendingScores"};
+
+    for(int i = 0; i < nIterations; ++i)
+    {
+        const std::string lv = levelValidator(levelDist(rng));
+        const auto steamId = static_cast<std::uint64_t>(userDist(rng));
+
+        topScores.measure([&] { (void)hg::Database::getTopScores(6, lv); });
+        ownScore.measure([&] { (void)hg::Database::getScore(lv, steamId); });
+
+        tokenValid.measure(
+            [&] { (void)hg::Database::isLoginTokenValid(steamId); });
+    }
+
+    // Batched writes, flushed in groups like the server does.
+    constexpr int batchSize = 64;
+    for(int i = 0; i < nIterations / batchSize; ++i)
+    {
+        addAndFlush.measure(
+            [&]
+            {
+                for(int j = 0; j < batchSize; ++j)
+                {
+                    hg::Database::addScore(levelValidator(levelDist(rng)), 0,
+                        static_cast<std::uint64_t>(userDist(rng)), 1000.0 + i);
+                }
+
+                hg::Database::flushPendingScores();
+            });
+    }
+
+    topScores.report();
+    ownScore.report();
+    tokenValid.report();
+    addAndFlush.report();
+
+    return 0;
+}
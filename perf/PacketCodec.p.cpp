@@ -0,0 +1,238 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/Shared.hpp"
+#include "SSVOpenHexagon/Online/Sodium.hpp"
+
+#include "SSVOpenHexagon/Core/Replay.hpp"
+
+#include "PerfUtils.hpp"
+
+#include <SFML/Network/Packet.hpp>
+
+#include <sodium.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Usage: perf.PacketCodec [iterations]
+//
+// Measures encode + encrypt + decrypt + decode round trips through the public
+// protocol functions, for a representative set of packet types.
+
+namespace {
+
+struct Keys
+{
+    hg::SodiumRTKeys client;
+    hg::SodiumRTKeys server;
+};
+
+[[nodiscard]] Keys makeKeys()
+{
+    const hg::SodiumPSKeys clientPSKeys = hg::generateSodiumPSKeys();
+    const hg::SodiumPSKeys serverPSKeys = hg::generateSodiumPSKeys();
+
+    const std::optional<hg::SodiumRTKeys> client =
+        hg::calculateClientSessionSodiumRTKeys(
+            clientPSKeys, serverPSKeys.keyPublic);
+
+    const std::optional<hg::SodiumRTKeys> server =
+        hg::calculateServerSessionSodiumRTKeys(
+            serverPSKeys, clientPSKeys.keyPublic);
+
+    if(!client.has_value() || !server.has_value())
+    {
+        std::printf("Failed to calculate session keys\n");
+        std::exit(1);
+    }
+
+    return Keys{*client, *server};
+}
+
+[[nodiscard]] hg::replay_file makeReplayFile(const int nInputs)
+{
+    hg::replay_file rf{};
+    rf._version = 1;
+    rf._player_name = "perf";
+    rf._seed = 12345;
+    rf._pack_id = "ohvrvanilla_vittorio_romeo_cube_1";
+    rf._level_id = "ohvrvanilla_vittorio_romeo_cube_1_pointless";
+    rf._first_play = true;
+    rf._difficulty_mult = 1.f;
+    rf._played_score = nInputs / 60.0;
+
+    for(int i = 0; i < nInputs; ++i)
+    {
+        rf._data.record_input(i % 3 == 0, i % 5 == 0, false, i % 7 == 0);
+    }
+
+    return rf;
+}
+
+[[nodiscard]] std::vector<hg::Database::ProcessedScore> makeScores()
+{
+    std::vector<hg::Database::ProcessedScore> result;
+
+    for(sf::Uint32 i = 0; i < 6; ++i)
+    {
+        result.push_back(hg::Database::ProcessedScore{.position = i + 1,
+            .userName = "user" + std::to_string(i),
+            .scoreTimestamp = 1600000000 + i,
+            .scoreValue = 100.0 - i});
+    }
+
+    return result;
+}
+
+template <typename T>
+void benchClientToServer(const char* name, const Keys& keys, const T& data,
+    const int nIterations)
+{
+    perf_impl::LatencySamples samples{name};
+
+    sf::Packet packet;
+    std::ostringstream errorOss;
+
+    for(int i = 0; i < nIterations; ++i)
+    {
+        samples.measure(
+            [&]
+            {
+                if(!hg::makeClientToServerEncryptedPacket(
+                       keys.client.keyTransmit, packet, data))
+                {
+                    std::printf("Failed to encode '%s'\n", name);
+                    std::exit(1);
+                }
+
+                errorOss.str("");
+                const hg::PVClientToServer pv = hg::decodeClientToServerPacket(
+                    &keys.server.keyReceive, errorOss, packet);
+
+                if(!std::holds_alternative<T>(pv))
+                {
+                    std::printf("Failed to decode '%s': %s\n", name,
+                        errorOss.str().c_str());
+                    std::exit(1);
+                }
+            });
+    }
+
+    std::printf("%-40s %zu bytes\n", name, packet.getDataSize());
+    samples.report();
+}
+
+template <typename T>
+void benchServerToClient(const char* name, const Keys& keys, const T& data,
+    const int nIterations)
+{
+    perf_impl::LatencySamples samples{name};
+
+    sf::Packet packet;
+    std::ostringstream errorOss;
+
+    for(int i = 0; i < nIterations; ++i)
+    {
+        samples.measure(
+            [&]
+            {
+                if(!hg::makeServerToClientEncryptedPacket(
+                       keys.server.keyTransmit, packet, data))
+                {
+                    std::printf("Failed to encode '%s'\n", name);
+                    std::exit(1);
+                }
+
+                errorOss.str("");
+                const hg::PVServerToClient pv = hg::decodeServerToClientPacket(
+                    &keys.client.keyReceive, errorOss, packet);
+
+                if(!std::holds_alternative<T>(pv))
+                {
+                    std::printf("Failed to decode '%s': %s\n", name,
+                        errorOss.str().c_str());
+                    std::exit(1);
+                }
+            });
+    }
+
+    std::printf("%-40s %zu bytes\n", name, packet.getDataSize());
+    samples.report();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if(sodium_init() < 0)
+    {
+        std::printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    const int nIterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    const Keys keys = makeKeys();
+
+    const hg::replay_file replayFile = makeReplayFile(60 * 60 * 5);
+    const std::optional<hg::compressed_replay_file> compressedReplayFile =
+        hg::compress_replay_file(replayFile);
+
+    if(!compressedReplayFile.has_value())
+    {
+        std::printf("Failed to compress replay\n");
+        return 1;
+    }
+
+    benchClientToServer(
+        "CTSPHeartbeat", keys, hg::CTSPHeartbeat{}, nIterations);
+
+    benchClientToServer("CTSPLogin", keys,
+        hg::CTSPLogin{.steamId = 76561198000000000,
+            .name = "perf",
+            .passwordHash = std::string(64, 'x')},
+        nIterations);
+
+    benchClientToServer("CTSPRequestTopScoresAndOwnScore", keys,
+        hg::CTSPRequestTopScoresAndOwnScore{.loginToken = 1234567890,
+            .levelValidator = replayFile._level_id + "_m_1"},
+        nIterations);
+
+    benchClientToServer("CTSPReplay (5 minutes)", keys,
+        hg::CTSPReplay{.loginToken = 1234567890, .replayFile = replayFile},
+        nIterations / 100);
+
+    benchClientToServer("CTSPCompressedReplay (5 minutes)", keys,
+        hg::CTSPCompressedReplay{.loginToken = 1234567890,
+            .compressedReplayFile = *compressedReplayFile},
+        nIterations / 10);
+
+    benchServerToClient("STCPLoginSuccess", keys,
+        hg::STCPLoginSuccess{.loginToken = 1234567890, .loginName = "perf"},
+        nIterations);
+
+    const std::vector<hg::Database::ProcessedScore> scores = makeScores();
+
+    benchServerToClient("STCPTopScoresAndOwnScore", keys,
+        hg::STCPTopScoresAndOwnScore{
+            .levelValidator = replayFile._level_id + "_m_1",
+            .scores = scores,
+            .ownScore = scores[3]},
+        nIterations);
+
+    benchServerToClient("STCPServerStatus", keys,
+        hg::STCPServerStatus{.protocolVersion = hg::PROTOCOL_VERSION,
+            .gameVersion = hg::GAME_VERSION,
+            .supportedLevelValidators =
+                std::vector<std::string>(32, replayFile._level_id + "_m_1")},
+        nIterations);
+
+    return 0;
+}
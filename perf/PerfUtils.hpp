@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace perf_impl {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+[[nodiscard]] double measureNs(F&& f)
+{
+    const auto start = Clock::now();
+    std::forward<F>(f)();
+    const auto end = Clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+class LatencySamples
+{
+private:
+    std::string _name;
+    std::vector<double> _samplesNs;
+
+public:
+    explicit LatencySamples(std::string name) : _name{std::move(name)}
+    {}
+
+    void add(const double ns)
+    {
+        _samplesNs.emplace_back(ns);
+    }
+
+    template <typename F>
+    void measure(F&& f)
+    {
+        add(measureNs(std::forward<F>(f)));
+    }
+
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return _samplesNs.size();
+    }
+
+    [[nodiscard]] double total() const noexcept
+    {
+        double result = 0.0;
+
+        for(const double ns : _samplesNs)
+        {
+            result += ns;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] double percentile(const double p)
+    {
+        if(_samplesNs.empty())
+        {
+            return 0.0;
+        }
+
+        const auto idx = static_cast<std::size_t>(
+            p * static_cast<double>(_samplesNs.size() - 1));
+
+        std::nth_element(
+            _samplesNs.begin(), _samplesNs.begin() + idx, _samplesNs.end());
+
+        return _samplesNs[idx];
+    }
+
+    void report()
+    {
+        const double n = static_cast<double>(count());
+
+        std::printf(
+            "%-40s n=%-8zu mean=%10.0fns p50=%10.0fns p99=%10.0fns "
+            "max=%10.0fns\n",
+            _name.c_str(), count(), n > 0 ? total() / n : 0.0,
+            percentile(0.5), percentile(0.99), percentile(1.0));
+    }
+};
+
+} // namespace perf_impl
@@ -0,0 +1,293 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Global/Assets.hpp"
+#include "SSVOpenHexagon/Global/Config.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
+#include "SSVOpenHexagon/Global/Version.hpp"
+#include "SSVOpenHexagon/Core/HexagonGame.hpp"
+#include "SSVOpenHexagon/Core/Replay.hpp"
+
+#include "PerfUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Usage: perf.Simulation [ticks] [output.json]
+//
+// Runs every level of the bundled vanilla packs headless for a fixed number
+// of ticks (one minute of game time by default), driven by a seeded input
+// stream played back as a replay. The player is invincible so that every
+// level runs for the full duration.
+//
+// Reports ticks per second, peak wall counts and, when built with
+// `SSVOH_ENABLE_PROFILER`, the time spent per tick in each profiled
+// `HexagonGame` phase (nested phases are included in their parent's time).
+// Results are also written as JSON (to `perf_simulation.json` by default) for
+// comparison across commits.
+//
+// Must be run from a directory containing the `Packs/` folder (e.g.
+// `_RELEASE`).
+
+namespace {
+
+struct SimulationResult
+{
+    std::string packId;
+    std::string levelId;
+    std::uint64_t ticks;
+    double totalNs;
+    std::size_t peakWalls;
+    std::size_t peakCustomWalls;
+    std::map<std::string, double> phaseNs;
+};
+
+// Holds each input for a random number of ticks, similarly to a human player.
+[[nodiscard]] hg::replay_data makeInputStream(
+    const std::uint64_t nTicks, const unsigned int seed)
+{
+    hg::replay_data result;
+
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> holdDist{5, 60};
+    std::uniform_int_distribution<int> movementDist{-1, 1};
+    std::uniform_int_distribution<int> percentDist{0, 99};
+
+    std::uint64_t tick = 0;
+
+    while(tick < nTicks)
+    {
+        const int movement = movementDist(rng);
+        const bool focus = percentDist(rng) < 20;
+        const bool swap = percentDist(rng) < 5;
+
+        const auto hold = static_cast<std::uint64_t>(holdDist(rng));
+
+        for(std::uint64_t i = 0; i < hold && tick < nTicks; ++i, ++tick)
+        {
+            result.record_input(
+                movement < 0, movement > 0, swap && i == 0, focus);
+        }
+    }
+
+    return result;
+}
+
+[[nodiscard]] SimulationResult runLevel(hg::HGAssets& assets,
+    const std::string& packId, const std::string& levelId,
+    const std::uint64_t nTicks, const unsigned int seed)
+{
+    hg::HexagonGame game{
+        nullptr /* steamManager */,   //
+        nullptr /* discordManager */, //
+        assets,                       //
+        nullptr /* audio */,          //
+        nullptr /* window */,         //
+        nullptr /* client */          //
+    };
+
+    hg::replay_file rf{};
+    rf._version = 0;
+    rf._player_name = "perf";
+    rf._seed = seed;
+    rf._data = makeInputStream(nTicks, seed);
+    rf._pack_id = packId;
+    rf._level_id = levelId;
+    rf._first_play = true;
+    rf._difficulty_mult = 1.f;
+    rf._played_score = 0.0;
+
+    game.setLastReplay(rf);
+    game.newGame(packId, levelId, rf._first_play, rf._difficulty_mult,
+        /* mExecuteLastReplay */ true);
+
+    // Discard zones recorded while loading the level.
+    hg::Profiler::markFrame();
+
+    SimulationResult result{.packId = packId,
+        .levelId = levelId,
+        .ticks = 0,
+        .totalNs = 0.0,
+        .peakWalls = 0,
+        .peakCustomWalls = 0,
+        .phaseNs = {}};
+
+    perf_impl::LatencySamples samples{levelId};
+
+    for(; result.ticks < nTicks && !game.getStatus().hasDied; ++result.ticks)
+    {
+        samples.measure([&] { game.executeTick(1.f /* timescale */); });
+
+        result.peakWalls = std::max(result.peakWalls, game.walls.size());
+        result.peakCustomWalls =
+            std::max(result.peakCustomWalls, game.cwManager.count());
+
+        if constexpr(hg::Profiler::enabled)
+        {
+            for(const hg::Profiler::ZoneStats& zs :
+                hg::Profiler::getZoneStats())
+            {
+                result.phaseNs[zs.name] += zs.lastMs * 1'000'000.0;
+            }
+        }
+    }
+
+    result.totalNs = samples.total();
+    samples.report();
+
+    return result;
+}
+
+void writeJsonString(std::FILE* f, const std::string& s)
+{
+    std::fputc('"', f);
+
+    for(const char c : s)
+    {
+        if(c == '"' || c == '\\')
+        {
+            std::fputc('\\', f);
+        }
+
+        std::fputc(c, f);
+    }
+
+    std::fputc('"', f);
+}
+
+[[nodiscard]] bool writeJson(const char* path, const std::uint64_t nTicks,
+    const std::vector<SimulationResult>& results)
+{
+    std::FILE* f = std::fopen(path, "w");
+
+    if(f == nullptr)
+    {
+        return false;
+    }
+
+    std::fprintf(f,
+        "{\n  \"gameVersion\": \"%s\",\n  \"profiler\": %s,\n"
+        "  \"ticks\": %llu,\n  \"levels\": [",
+        hg::GAME_VERSION_STR, hg::Profiler::enabled ? "true" : "false",
+        static_cast<unsigned long long>(nTicks));
+
+    for(std::size_t i = 0; i < results.size(); ++i)
+    {
+        const SimulationResult& r = results[i];
+        const double ticks = static_cast<double>(r.ticks);
+
+        std::fprintf(f, "%s\n    {\"pack\": ", i == 0 ? "" : ",");
+        writeJsonString(f, r.packId);
+        std::fprintf(f, ", \"level\": ");
+        writeJsonString(f, r.levelId);
+
+        std::fprintf(f,
+            ", \"ticks\": %llu, \"ticksPerSecond\": %.1f, "
+            "\"nsPerTick\": %.1f, \"peakWalls\": %zu, "
+            "\"peakCustomWalls\": %zu, \"phaseNsPerTick\": {",
+            static_cast<unsigned long long>(r.ticks),
+            r.totalNs > 0.0 ? ticks * 1e9 / r.totalNs : 0.0,
+            ticks > 0.0 ? r.totalNs / ticks : 0.0, r.peakWalls,
+            r.peakCustomWalls);
+
+        bool first = true;
+        for(const auto& [name, ns] : r.phaseNs)
+        {
+            std::fprintf(f, "%s", first ? "" : ", ");
+            writeJsonString(f, name);
+            std::fprintf(f, ": %.1f", ticks > 0.0 ? ns / ticks : 0.0);
+
+            first = false;
+        }
+
+        std::fprintf(f, "}}");
+    }
+
+    std::fprintf(f, "\n  ]\n}\n");
+    return std::fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto defaultTicks =
+        static_cast<std::uint64_t>(hg::Config::TICKS_PER_SECOND * 60.f);
+
+    const std::uint64_t nTicks =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : defaultTicks;
+
+    const char* outputPath = argc > 2 ? argv[2] : "perf_simulation.json";
+
+    constexpr std::array packIds{
+        "ohvrvanilla_vittorio_romeo_cube_1",        //
+        "ohvrvanilla_vittorio_romeo_experimental_1" //
+    };
+
+    hg::Config::loadConfig({});
+    hg::Config::setInvincible(true);
+
+    hg::HGAssets assets{nullptr /* steamManager */, true /* headless */};
+
+    hg::ProfileData fakeProfile{hg::GAME_VERSION, "perfProfile", {}, {}};
+    assets.addLocalProfile(std::move(fakeProfile));
+    assets.pSetCurrent("perfProfile");
+
+    if(!hg::Profiler::enabled)
+    {
+        std::printf("Profiler not compiled in, rebuild with "
+                    "'SSVOH_ENABLE_PROFILER' for per-phase timings\n");
+    }
+
+    std::vector<SimulationResult> results;
+    unsigned int seed = 0;
+
+    for(const char* packId : packIds)
+    {
+        if(!assets.isValidPackId(packId))
+        {
+            std::printf("Pack '%s' not found, skipping\n", packId);
+            continue;
+        }
+
+        for(const std::string& levelId : assets.getLevelIdsByPack(packId))
+        {
+            results.emplace_back(
+                runLevel(assets, packId, levelId, nTicks, ++seed));
+        }
+    }
+
+    for(const SimulationResult& r : results)
+    {
+        const double ticks = static_cast<double>(r.ticks);
+
+        std::printf("%-60s %10.0f ticks/s  peak walls %4zu  custom %4zu\n",
+            r.levelId.c_str(), r.totalNs > 0.0 ? ticks * 1e9 / r.totalNs : 0.0,
+            r.peakWalls, r.peakCustomWalls);
+
+        for(const auto& [name, ns] : r.phaseNs)
+        {
+            std::printf("    %-40s %10.0f ns/tick\n", name.c_str(),
+                ticks > 0.0 ? ns / ticks : 0.0);
+        }
+    }
+
+    if(!writeJson(outputPath, nTicks, results))
+    {
+        std::printf("Failed to write '%s'\n", outputPath);
+        return 1;
+    }
+
+    std::printf("Results written to '%s'\n", outputPath);
+    return 0;
+}
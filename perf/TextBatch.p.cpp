@@ -0,0 +1,149 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/TextBatch.hpp"
+
+#include "PerfUtils.hpp"
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Usage: perf.TextBatch [levels] [frames]
+//
+// Simulates the text of one level selection menu frame for a pack with
+// `levels` levels (500 by default): a name, an author and a ranked badge per
+// level, plus the level description and leaderboard lines. Reports the CPU
+// time per frame of drawing every string with its own `sf::Text`, as the menu
+// used to, and of drawing them through `hg::Utils::TextBatch`. Must be run
+// from a directory containing `Assets/OpenSquare-Regular.ttf`.
+
+namespace {
+
+struct Label
+{
+    sf::Text* text;
+    std::string string;
+    sf::Vector2f position;
+};
+
+[[nodiscard]] std::vector<Label> makeFrame(const int nLevels, sf::Text& big,
+    sf::Text& medium, sf::Text& small)
+{
+    std::vector<Label> result;
+
+    for(int i = 0; i < nLevels; ++i)
+    {
+        const float y = static_cast<float>(i) * 48.f;
+
+        result.push_back(
+            {&big, "LEVEL NUMBER " + std::to_string(i), {420.f, y}});
+
+        result.push_back({&small, "AUTHOR " + std::to_string(i % 17),
+            {420.f, y + 30.f}});
+
+        result.push_back({&small, "RANKED", {960.f, y}});
+    }
+
+    for(int i = 0; i < 8; ++i)
+    {
+        const float y = 400.f + static_cast<float>(i) * 20.f;
+
+        result.push_back({&small,
+            "DESCRIPTION LINE " + std::to_string(i) + " OF THE LEVEL",
+            {20.f, y}});
+
+        result.push_back(
+            {&medium, "#" + std::to_string(i + 1) + " PLAYER", {20.f, y}});
+
+        result.push_back({&small, "123.456s", {200.f, y}});
+    }
+
+    return result;
+}
+
+void bench(const char* name, const std::vector<Label>& labels,
+    const int nFrames, sf::RenderTexture& target, auto&& drawFrame)
+{
+    perf_impl::LatencySamples samples{name};
+
+    for(int i = 0; i < nFrames; ++i)
+    {
+        target.clear();
+        samples.measure([&] { drawFrame(labels); });
+    }
+
+    samples.report();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int nLevels = argc > 1 ? std::atoi(argv[1]) : 500;
+    const int nFrames = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    if(nLevels <= 0 || nFrames <= 0)
+    {
+        std::printf("Invalid arguments\n");
+        return 1;
+    }
+
+    sf::Font font;
+    if(!font.loadFromFile("Assets/OpenSquare-Regular.ttf"))
+    {
+        std::printf("Could not load `Assets/OpenSquare-Regular.ttf`\n");
+        return 1;
+    }
+
+    sf::RenderTexture target;
+    if(!target.create(1280, 720))
+    {
+        std::printf("Could not create render texture\n");
+        return 1;
+    }
+
+    sf::Text big{"", font, 32};
+    sf::Text medium{"", font, 24};
+    sf::Text small{"", font, 16};
+
+    const std::vector<Label> labels = makeFrame(nLevels, big, medium, small);
+
+    bench("sf::Text per label", labels, nFrames, target,
+        [&](const std::vector<Label>& frame)
+        {
+            for(const Label& l : frame)
+            {
+                l.text->setString(l.string);
+                l.text->setPosition(l.position);
+                target.draw(*l.text);
+            }
+        });
+
+    hg::Utils::TextBatch batch;
+
+    bench("hg::Utils::TextBatch", labels, nFrames, target,
+        [&](const std::vector<Label>& frame)
+        {
+            for(const Label& l : frame)
+            {
+                l.text->setPosition(l.position);
+                batch.add(*l.text, l.string);
+            }
+
+            batch.flush(target);
+            batch.endFrame();
+        });
+
+    const hg::Utils::TextBatch::Stats& stats = batch.getLastFrameStats();
+
+    std::printf("%zu strings per frame, draw calls: %zu -> %zu\n",
+        labels.size(), labels.size(), stats.drawCalls);
+}
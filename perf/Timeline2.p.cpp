@@ -0,0 +1,157 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/Timeline2.hpp"
+
+#include "PerfUtils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Usage: perf.Timeline2 [actions] [rounds]
+//
+// Appends `actions` closures (100k by default) to a timeline, runs them all and
+// clears the timeline, `rounds` times. The closures capture a string and a few
+// scalars, like the ones created by `e_messageAdd` and `w_wallAdj`. A plain
+// `std::vector<std::function<void()>>` is measured as a baseline.
+
+namespace {
+
+struct Sink
+{
+    double total{0.0};
+
+    void consume(
+        const double side, const double thickness, const double duration)
+    {
+        total += side + thickness + duration;
+    }
+};
+
+void benchTimeline2(const int nActions, const int nRounds)
+{
+    perf_impl::LatencySamples append{"timeline2 append"};
+    perf_impl::LatencySamples run{"timeline2 run"};
+    perf_impl::LatencySamples clear{"timeline2 clear"};
+
+    hg::Utils::timeline2 timeline;
+    Sink sink;
+
+    const std::string message = "perf message";
+    const auto tp = hg::Utils::timeline2::clock::now();
+
+    for(int round = 0; round < nRounds; ++round)
+    {
+        append.measure(
+            [&]
+            {
+                for(int i = 0; i < nActions; ++i)
+                {
+                    if(i % 2 == 0)
+                    {
+                        timeline.append_do(
+                            [&sink, i, thickness = 40.f, duration = 2.0]
+                            { sink.consume(i, thickness, duration); });
+                    }
+                    else
+                    {
+                        timeline.append_do(
+                            [&sink, message, duration = 2.0]
+                            {
+                                sink.consume(0.0,
+                                    static_cast<double>(message.size()),
+                                    duration);
+                            });
+                    }
+                }
+            });
+
+        run.measure(
+            [&]
+            {
+                hg::Utils::timeline2_runner runner;
+                (void)runner.update(timeline, tp);
+            });
+
+        clear.measure([&] { timeline.clear(); });
+    }
+
+    append.report();
+    run.report();
+    clear.report();
+
+    std::printf("%-40s %f\n", "checksum", sink.total);
+}
+
+void benchStdFunction(const int nActions, const int nRounds)
+{
+    perf_impl::LatencySamples append{"std::function append"};
+    perf_impl::LatencySamples run{"std::function run"};
+    perf_impl::LatencySamples clear{"std::function clear"};
+
+    std::vector<std::function<void()>> actions;
+    Sink sink;
+
+    const std::string message = "perf message";
+
+    for(int round = 0; round < nRounds; ++round)
+    {
+        append.measure(
+            [&]
+            {
+                for(int i = 0; i < nActions; ++i)
+                {
+                    if(i % 2 == 0)
+                    {
+                        actions.emplace_back(
+                            [&sink, i, thickness = 40.f, duration = 2.0]
+                            { sink.consume(i, thickness, duration); });
+                    }
+                    else
+                    {
+                        actions.emplace_back(
+                            [&sink, message, duration = 2.0]
+                            {
+                                sink.consume(0.0,
+                                    static_cast<double>(message.size()),
+                                    duration);
+                            });
+                    }
+                }
+            });
+
+        run.measure(
+            [&]
+            {
+                for(const std::function<void()>& f : actions)
+                {
+                    f();
+                }
+            });
+
+        clear.measure([&] { actions.clear(); });
+    }
+
+    append.report();
+    run.report();
+    clear.report();
+
+    std::printf("%-40s %f\n", "checksum", sink.total);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int nActions = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int nRounds = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    benchTimeline2(nActions, nRounds);
+    benchStdFunction(nActions, nRounds);
+
+    return 0;
+}
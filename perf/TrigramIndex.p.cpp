@@ -0,0 +1,162 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/TrigramIndex.hpp"
+
+#include "PerfUtils.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// Usage: perf.TrigramIndex [levels]
+//
+// Indexes `levels` synthetic levels (20000 by default) the way the level
+// selection search does: name, author, pack name and description. Reports the
+// build time and the latency of each keystroke while typing a few queries,
+// compared with a plain substring scan over the same text, which stops at the
+// first matches and does not rank them.
+
+namespace {
+
+constexpr std::size_t maxResults = 50;
+
+// Pseudo-words of two or three syllables, for a vocabulary of about 30000
+// words.
+[[nodiscard]] std::string makeWords(std::mt19937& rng, const int count)
+{
+    static constexpr const char* syllables[] = {"hex", "a", "gon", "pen",
+        "ta", "squa", "re", "tri", "an", "gle", "spi", "ral", "fla", "sh",
+        "or", "bit", "pul", "se", "cu", "be", "hy", "per", "nig", "ht", "sto",
+        "rm", "e", "cho", "ne", "on", "vo", "id", "ap", "er", "tu", "bli"};
+
+    std::uniform_int_distribution<std::size_t> syllable{
+        0, std::size(syllables) - 1};
+
+    std::uniform_int_distribution<int> length{2, 3};
+
+    std::string result;
+
+    for(int i = 0; i < count; ++i)
+    {
+        if(i != 0)
+        {
+            result += ' ';
+        }
+
+        for(int j = length(rng); j > 0; --j)
+        {
+            result += syllables[syllable(rng)];
+        }
+    }
+
+    return result;
+}
+
+struct Level
+{
+    std::string name;
+    std::string author;
+    std::string pack;
+    std::string description;
+};
+
+[[nodiscard]] std::size_t scan(
+    const std::vector<Level>& levels, const std::string& query)
+{
+    std::size_t found = 0;
+
+    for(const Level& l : levels)
+    {
+        if(found == maxResults)
+        {
+            break;
+        }
+
+        if(l.name.find(query) != std::string::npos ||
+            l.author.find(query) != std::string::npos ||
+            l.pack.find(query) != std::string::npos ||
+            l.description.find(query) != std::string::npos)
+        {
+            ++found;
+        }
+    }
+
+    return found;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int nLevels = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    if(nLevels <= 0)
+    {
+        std::printf("Invalid arguments\n");
+        return 1;
+    }
+
+    std::mt19937 rng{0};
+    std::vector<Level> levels;
+
+    for(int i = 0; i < nLevels; ++i)
+    {
+        levels.push_back(Level{makeWords(rng, 2) + ' ' + std::to_string(i),
+            "author " + std::to_string(i % 300), makeWords(rng, 2),
+            makeWords(rng, 16)});
+    }
+
+    hg::Utils::TrigramIndex index;
+
+    const double buildNs = perf_impl::measureNs(
+        [&]
+        {
+            for(const Level& l : levels)
+            {
+                index.add({l.name, l.author, l.pack, l.description});
+            }
+
+            index.build();
+        });
+
+    std::printf("Indexed %d levels in %.2fms\n", nLevels, buildNs / 1e6);
+
+    const std::string queries[] = {
+        "hexagon", "neon storm", "author 42", "apertura remix", "zzz"};
+
+    perf_impl::LatencySamples indexSamples{"hg::Utils::TrigramIndex"};
+    perf_impl::LatencySamples scanSamples{"substring scan"};
+
+    std::vector<hg::Utils::TrigramIndex::DocId> results;
+    std::size_t checksum = 0;
+
+    for(int rep = 0; rep < 20; ++rep)
+    {
+        for(const std::string& query : queries)
+        {
+            // One search per keystroke.
+            for(std::size_t len = 1; len <= query.size(); ++len)
+            {
+                const std::string typed = query.substr(0, len);
+
+                indexSamples.measure(
+                    [&] { index.search(typed, results, maxResults); });
+
+                checksum += results.size();
+
+                scanSamples.measure([&] { checksum += scan(levels, typed); });
+            }
+        }
+    }
+
+    indexSamples.report();
+    scanSamples.report();
+
+    std::printf("checksum: %zu\n", checksum);
+}
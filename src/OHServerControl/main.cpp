@@ -1,5 +1,6 @@
 #include <SFML/Network/UdpSocket.hpp>
 #include <SFML/Network/Packet.hpp>
+#include <SFML/Network/SocketSelector.hpp>
 
 #include <string>
 #include <iostream>
@@ -46,6 +47,38 @@ int main(int argc, char* argv[])
         return true;
     };
 
+    // Some commands (e.g. `stats`) are answered by the server, print the
+    // reply if one arrives shortly after sending.
+    const auto printReply = [&]
+    {
+        sf::SocketSelector selector;
+        selector.add(controlSocket);
+
+        if(!selector.wait(sf::seconds(1)))
+        {
+            return;
+        }
+
+        sf::IpAddress senderIp;
+        unsigned short senderPort;
+
+        packet.clear();
+        if(controlSocket.receive(packet, senderIp, senderPort) !=
+            sf::Socket::Status::Done)
+        {
+            std::cerr << "Error receiving control reply\n";
+            return;
+        }
+
+        std::string reply;
+        if(packet >> reply)
+        {
+            std::cout << reply << std::flush;
+        }
+    };
+
+    const auto expectsReply = [&] { return stringBuf == "stats"; };
+
     if(argc == 1) // Interactive mode
     {
         while(true)
@@ -56,13 +89,27 @@ int main(int argc, char* argv[])
                 continue;
             }
 
-            sendToServer();
+            if(sendToServer() && expectsReply())
+            {
+                printReply();
+            }
         }
     }
 
     if(argc == 2) // One-off send
     {
         stringBuf = argv[1];
-        return sendToServer() ? 0 : 1;
+
+        if(!sendToServer())
+        {
+            return 1;
+        }
+
+        if(expectsReply())
+        {
+            printReply();
+        }
+
+        return 0;
     }
 }
@@ -0,0 +1,867 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+// Synthetic client load generator for `HexagonServer`. Spawns many simulated
+// clients over loopback (or any address) that go through the same
+// handshake/register/login/ready flow as the game client, then issue a
+// configurable mix of requests at a configurable rate, and finally reports
+// throughput and latency percentiles per request type.
+
+#include "SSVOpenHexagon/Core/Replay.hpp"
+
+#include "SSVOpenHexagon/Online/Shared.hpp"
+#include "SSVOpenHexagon/Online/Sodium.hpp"
+
+#include "SSVOpenHexagon/Utils/LevelValidator.hpp"
+#include "SSVOpenHexagon/Utils/Match.hpp"
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace hg::LoadTest {
+
+using Clock = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
+// ----------------------------------------------------------------------------
+// Options.
+
+struct Options
+{
+    std::string serverIp{"127.0.0.1"};
+    unsigned short serverPort{50505};
+    int clients{1000};
+    int threads{4};
+    double durationSeconds{30.0};
+    double requestsPerSecondPerClient{1.0};
+    double timeoutSeconds{5.0};
+    std::uint64_t steamIdBase{900000000000000000ull};
+
+    // Relative weights of the requests issued once a client is ready.
+    int weightTopScores{60};
+    int weightTopScoresAndOwnScore{30};
+    int weightReplay{10};
+
+    std::string replayPath;
+};
+
+void printUsage()
+{
+    std::cout
+        << "Usage: OHServerLoadTest [options]\n"
+        << "  -ip <address>         server address (default: 127.0.0.1)\n"
+        << "  -port <port>          server port (default: 50505)\n"
+        << "  -clients <n>          number of simulated clients (1000)\n"
+        << "  -threads <n>          number of worker threads (4)\n"
+        << "  -duration <seconds>   duration of the steady phase (30)\n"
+        << "  -rate <n>             requests per second per client (1)\n"
+        << "  -timeout <seconds>    reply timeout (5)\n"
+        << "  -steamid-base <id>    first synthetic Steam ID\n"
+        << "  -mix <t>,<to>,<r>     weights of top scores, top scores and\n"
+        << "                        own score, replay requests (60,30,10)\n"
+        << "  -replay <file>        replay sent by replay requests, which\n"
+        << "                        are disabled if not specified\n";
+}
+
+[[nodiscard]] std::optional<Options> parseOptions(int argc, char* argv[])
+{
+    Options result;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+
+        if(arg == "-h" || arg == "--help")
+        {
+            return std::nullopt;
+        }
+
+        if(i + 1 >= argc)
+        {
+            std::cerr << "Missing value for option '" << arg << "'\n";
+            return std::nullopt;
+        }
+
+        const char* value = argv[++i];
+
+        if(arg == "-ip")
+        {
+            result.serverIp = value;
+        }
+        else if(arg == "-port")
+        {
+            result.serverPort = static_cast<unsigned short>(std::atoi(value));
+        }
+        else if(arg == "-clients")
+        {
+            result.clients = std::max(1, std::atoi(value));
+        }
+        else if(arg == "-threads")
+        {
+            result.threads = std::max(1, std::atoi(value));
+        }
+        else if(arg == "-duration")
+        {
+            result.durationSeconds = std::atof(value);
+        }
+        else if(arg == "-rate")
+        {
+            result.requestsPerSecondPerClient = std::atof(value);
+        }
+        else if(arg == "-timeout")
+        {
+            result.timeoutSeconds = std::atof(value);
+        }
+        else if(arg == "-steamid-base")
+        {
+            result.steamIdBase = std::strtoull(value, nullptr, 10);
+        }
+        else if(arg == "-mix")
+        {
+            char sep0, sep1;
+            std::istringstream iss{value};
+
+            if(!(iss >> result.weightTopScores >> sep0 >>
+                    result.weightTopScoresAndOwnScore >> sep1 >>
+                    result.weightReplay))
+            {
+                std::cerr << "Invalid mix '" << value << "'\n";
+                return std::nullopt;
+            }
+        }
+        else if(arg == "-replay")
+        {
+            result.replayPath = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option '" << arg << "'\n";
+            return std::nullopt;
+        }
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// Statistics.
+
+enum class RequestType : std::uint8_t
+{
+    PublicKey = 0,
+    Register = 1,
+    Login = 2,
+    ServerStatus = 3,
+    TopScores = 4,
+    TopScoresAndOwnScore = 5,
+    Replay = 6, // Replay followed by a top scores and own score request.
+
+    Count
+};
+
+constexpr std::array<const char*, static_cast<std::size_t>(RequestType::Count)>
+    requestTypeNames{
+        "public key",                  //
+        "register",                    //
+        "login",                       //
+        "server status",               //
+        "top scores",                  //
+        "top scores and own score",    //
+        "replay + top scores and own", //
+    };
+
+struct RequestStats
+{
+    std::vector<double> latenciesUs;
+    std::uint64_t timeouts{0};
+    std::uint64_t failures{0};
+};
+
+using Stats =
+    std::array<RequestStats, static_cast<std::size_t>(RequestType::Count)>;
+
+[[nodiscard]] double percentile(std::vector<double>& samples, const double p)
+{
+    if(samples.empty())
+    {
+        return 0.0;
+    }
+
+    const auto idx = static_cast<std::size_t>(
+        p * static_cast<double>(samples.size() - 1));
+
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx];
+}
+
+// ----------------------------------------------------------------------------
+// Simulated client.
+
+struct SharedData
+{
+    const Options& options;
+    std::optional<compressed_replay_file> compressedReplay;
+    std::string replayLevelValidator;
+    std::atomic<bool> steadyPhase{false};
+    std::atomic<bool> running{true};
+    std::atomic<int> readyClients{0};
+    std::atomic<int> failedClients{0};
+};
+
+class SimulatedClient
+{
+public:
+    enum class State : std::uint8_t
+    {
+        Failed = 0,
+        Handshaking = 1,
+        Registering = 2,
+        LoggingIn = 3,
+        RequestingServerStatus = 4,
+        Ready = 5,
+        AwaitingReply = 6,
+    };
+
+private:
+    SharedData& _shared;
+    Stats& _stats;
+    std::mt19937& _rng;
+
+    sf::TcpSocket _socket;
+    sf::Packet _packetBuffer;
+    std::ostringstream _errorOss;
+
+    const SodiumPSKeys _psKeys;
+    std::optional<SodiumRTKeys> _rtKeys;
+
+    const std::uint64_t _steamId;
+    const std::string _name;
+    const std::string _passwordHash;
+    std::uint64_t _loginToken;
+    std::vector<std::string> _supportedLevelValidators;
+
+    State _state;
+    RequestType _pendingRequest;
+    TimePoint _sentAt;
+    TimePoint _nextRequestAt;
+
+    [[nodiscard]] bool sendPacket()
+    {
+        while(true)
+        {
+            const sf::Socket::Status status = _socket.send(_packetBuffer);
+
+            if(status == sf::Socket::Status::Done)
+            {
+                return true;
+            }
+
+            if(status != sf::Socket::Status::Partial &&
+                status != sf::Socket::Status::NotReady)
+            {
+                return false;
+            }
+        }
+    }
+
+    template <typename T>
+    [[nodiscard]] bool sendUnencrypted(const T& data)
+    {
+        makeClientToServerPacket(_packetBuffer, data);
+        return sendPacket();
+    }
+
+    template <typename T>
+    [[nodiscard]] bool sendEncrypted(const T& data)
+    {
+        if(!_rtKeys.has_value() ||
+            !makeClientToServerEncryptedPacket(
+                _rtKeys->keyTransmit, _packetBuffer, data))
+        {
+            return false;
+        }
+
+        return sendPacket();
+    }
+
+    void fail()
+    {
+        if(_state != State::Failed)
+        {
+            ++_stats[static_cast<std::size_t>(_pendingRequest)].failures;
+            ++_shared.failedClients;
+        }
+
+        _state = State::Failed;
+        _socket.disconnect();
+    }
+
+    template <typename T>
+    void request(const RequestType type, const State nextState, const T& data,
+        const bool encrypted = true)
+    {
+        _pendingRequest = type;
+        _sentAt = Clock::now();
+
+        if(!(encrypted ? sendEncrypted(data) : sendUnencrypted(data)))
+        {
+            fail();
+            return;
+        }
+
+        _state = nextState;
+    }
+
+    void completeRequest(const State nextState)
+    {
+        // Only record latencies of the steady phase, the initial burst of
+        // logins would otherwise dominate the results.
+        if(_shared.steadyPhase || _pendingRequest < RequestType::TopScores)
+        {
+            const double us = std::chrono::duration<double, std::micro>(
+                Clock::now() - _sentAt)
+                                  .count();
+
+            _stats[static_cast<std::size_t>(_pendingRequest)]
+                .latenciesUs.emplace_back(us);
+        }
+
+        _state = nextState;
+    }
+
+    void becomeReady()
+    {
+        _state = State::Ready;
+        ++_shared.readyClients;
+
+        (void)sendEncrypted(CTSPReady{.loginToken = _loginToken});
+        scheduleNextRequest();
+    }
+
+    void scheduleNextRequest()
+    {
+        const double rate = _shared.options.requestsPerSecondPerClient;
+
+        if(rate <= 0.0)
+        {
+            _nextRequestAt = TimePoint::max();
+            return;
+        }
+
+        // Poisson arrivals, so that clients don't synchronize.
+        const double delaySeconds =
+            std::exponential_distribution<double>{rate}(_rng);
+
+        _nextRequestAt = Clock::now() +
+                         std::chrono::duration_cast<Clock::duration>(
+                             std::chrono::duration<double>(delaySeconds));
+    }
+
+    [[nodiscard]] const std::string& randomLevelValidator()
+    {
+        std::uniform_int_distribution<std::size_t> dist{
+            0, _supportedLevelValidators.size() - 1};
+
+        return _supportedLevelValidators[dist(_rng)];
+    }
+
+    void issueNextRequest()
+    {
+        const Options& o = _shared.options;
+
+        const int weightReplay =
+            _shared.compressedReplay.has_value() ? o.weightReplay : 0;
+
+        const int totalWeight =
+            o.weightTopScores + o.weightTopScoresAndOwnScore + weightReplay;
+
+        if(totalWeight <= 0 || _supportedLevelValidators.empty())
+        {
+            _nextRequestAt = TimePoint::max();
+            return;
+        }
+
+        const int roll =
+            std::uniform_int_distribution<int>{0, totalWeight - 1}(_rng);
+
+        if(roll < o.weightTopScores)
+        {
+            request(RequestType::TopScores, State::AwaitingReply,
+                CTSPRequestTopScores{.loginToken = _loginToken,
+                    .levelValidator = randomLevelValidator()});
+
+            return;
+        }
+
+        if(roll < o.weightTopScores + o.weightTopScoresAndOwnScore)
+        {
+            request(RequestType::TopScoresAndOwnScore, State::AwaitingReply,
+                CTSPRequestTopScoresAndOwnScore{.loginToken = _loginToken,
+                    .levelValidator = randomLevelValidator()});
+
+            return;
+        }
+
+        // The server doesn't reply to replays, so they are followed by a
+        // request that does: since packets of a connection are processed in
+        // order, its latency includes the replay validation.
+        const std::string& lv = _shared.replayLevelValidator;
+
+        if(!sendEncrypted(
+               CTSPStartedGame{.loginToken = _loginToken, .levelValidator = lv}))
+        {
+            fail();
+            return;
+        }
+
+        _pendingRequest = RequestType::Replay;
+        _sentAt = Clock::now();
+
+        if(!sendEncrypted(CTSPCompressedReplay{.loginToken = _loginToken,
+               .compressedReplayFile = *_shared.compressedReplay}) ||
+            !sendEncrypted(CTSPRequestTopScoresAndOwnScore{
+                .loginToken = _loginToken, .levelValidator = lv}))
+        {
+            fail();
+            return;
+        }
+
+        _state = State::AwaitingReply;
+    }
+
+    void login()
+    {
+        completeRequest(State::LoggingIn);
+        request(RequestType::Login, State::LoggingIn,
+            CTSPLogin{.steamId = _steamId,
+                .name = _name,
+                .passwordHash = _passwordHash});
+    }
+
+    void replyReceived()
+    {
+        if(_state != State::AwaitingReply)
+        {
+            return;
+        }
+
+        completeRequest(State::Ready);
+        scheduleNextRequest();
+    }
+
+    void processPacket()
+    {
+        _errorOss.str("");
+        const PVServerToClient pv = decodeServerToClientPacket(
+            _rtKeys.has_value() ? &_rtKeys->keyReceive : nullptr, _errorOss,
+            _packetBuffer);
+
+        Utils::match(
+            pv,
+
+            [&](const STCPPublicKey& stcp)
+            {
+                _rtKeys = calculateClientSessionSodiumRTKeys(_psKeys, stcp.key);
+
+                if(!_rtKeys.has_value())
+                {
+                    fail();
+                    return;
+                }
+
+                completeRequest(State::Registering);
+                request(RequestType::Register, State::Registering,
+                    CTSPRegister{.steamId = _steamId,
+                        .name = _name,
+                        .passwordHash = _passwordHash});
+            },
+
+            [&](const STCPRegistrationSuccess&) { login(); },
+
+            // Registration fails if a previous run already registered this
+            // client, we can proceed with the login anyway.
+            [&](const STCPRegistrationFailure&) { login(); },
+
+            [&](const STCPLoginSuccess& stcp)
+            {
+                _loginToken = stcp.loginToken;
+
+                completeRequest(State::RequestingServerStatus);
+                request(RequestType::ServerStatus,
+                    State::RequestingServerStatus,
+                    CTSPRequestServerStatus{.loginToken = _loginToken});
+            },
+
+            [&](const STCPServerStatus& stcp)
+            {
+                _supportedLevelValidators = stcp.supportedLevelValidators;
+
+                completeRequest(State::Ready);
+                becomeReady();
+            },
+
+            [&](const STCPTopScores&) { replyReceived(); },
+            [&](const STCPTopScoresAndOwnScore&) { replyReceived(); },
+
+            [&](const STCPKick&) { fail(); },
+
+            [&](const STCPLoginFailure& stcp)
+            {
+                std::cerr << "Login failure for '" << _name << "': '"
+                          << stcp.error << "'\n";
+
+                fail();
+            },
+
+            [&](const PInvalid& p)
+            {
+                std::cerr << "Invalid packet: '" << p.error << "'\n";
+                fail();
+            },
+
+            [&](const auto&) {});
+    }
+
+public:
+    explicit SimulatedClient(SharedData& shared, Stats& stats,
+        std::mt19937& rng, const std::uint64_t steamId)
+        : _shared{shared},
+          _stats{stats},
+          _rng{rng},
+          _psKeys{generateSodiumPSKeys()},
+          _steamId{steamId},
+          _name{"lt" + std::to_string(steamId % 1000000000ull)},
+          _passwordHash{sodiumHash("loadtest" + std::to_string(steamId))},
+          _loginToken{0},
+          _state{State::Failed},
+          _pendingRequest{RequestType::PublicKey}
+    {}
+
+    [[nodiscard]] sf::TcpSocket& getSocket() noexcept
+    {
+        return _socket;
+    }
+
+    [[nodiscard]] State getState() const noexcept
+    {
+        return _state;
+    }
+
+    [[nodiscard]] bool connect()
+    {
+        const Options& o = _shared.options;
+
+        _socket.setBlocking(true);
+
+        if(_socket.connect(o.serverIp, o.serverPort, sf::seconds(5)) !=
+            sf::Socket::Status::Done)
+        {
+            ++_shared.failedClients;
+            return false;
+        }
+
+        _state = State::Handshaking;
+
+        if(!sendUnencrypted(CTSPHeartbeat{}))
+        {
+            fail();
+            return false;
+        }
+
+        request(RequestType::PublicKey, State::Handshaking,
+            CTSPPublicKey{_psKeys.keyPublic}, false /* encrypted */);
+
+        _socket.setBlocking(false);
+        return _state != State::Failed;
+    }
+
+    void receive()
+    {
+        while(_state != State::Failed)
+        {
+            const sf::Socket::Status status = _socket.receive(_packetBuffer);
+
+            if(status == sf::Socket::Status::Done)
+            {
+                processPacket();
+                continue;
+            }
+
+            if(status == sf::Socket::Status::NotReady ||
+                status == sf::Socket::Status::Partial)
+            {
+                return;
+            }
+
+            fail();
+        }
+    }
+
+    void update(const TimePoint now)
+    {
+        if(_state == State::Failed || _state == State::Ready)
+        {
+            if(_state == State::Ready && _shared.steadyPhase &&
+                now >= _nextRequestAt)
+            {
+                issueNextRequest();
+            }
+
+            return;
+        }
+
+        const auto timeout = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(_shared.options.timeoutSeconds));
+
+        if(now - _sentAt < timeout)
+        {
+            return;
+        }
+
+        ++_stats[static_cast<std::size_t>(_pendingRequest)].timeouts;
+
+        if(_state == State::AwaitingReply)
+        {
+            _state = State::Ready;
+            scheduleNextRequest();
+            return;
+        }
+
+        // Timed out during the login flow, give up on this client.
+        fail();
+    }
+
+    void disconnect()
+    {
+        if(_state != State::Failed)
+        {
+            _socket.setBlocking(true);
+            (void)sendUnencrypted(CTSPDisconnect{});
+        }
+
+        _socket.disconnect();
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Worker thread, drives a subset of the clients with its own selector.
+
+void runWorker(SharedData& shared, Stats& stats, const int firstClient,
+    const int clientCount, const unsigned int seed)
+{
+    std::mt19937 rng{seed};
+
+    std::list<SimulatedClient> clients;
+    sf::SocketSelector selector;
+
+    for(int i = 0; i < clientCount && shared.running; ++i)
+    {
+        const std::uint64_t steamId = shared.options.steamIdBase +
+                                      static_cast<std::uint64_t>(firstClient + i);
+
+        SimulatedClient& client =
+            clients.emplace_back(shared, stats, rng, steamId);
+
+        if(client.connect())
+        {
+            selector.add(client.getSocket());
+        }
+    }
+
+    while(shared.running)
+    {
+        if(selector.wait(sf::milliseconds(1)))
+        {
+            for(SimulatedClient& client : clients)
+            {
+                if(client.getState() != SimulatedClient::State::Failed &&
+                    selector.isReady(client.getSocket()))
+                {
+                    client.receive();
+                }
+            }
+        }
+
+        const TimePoint now = Clock::now();
+
+        for(SimulatedClient& client : clients)
+        {
+            client.update(now);
+        }
+    }
+
+    for(SimulatedClient& client : clients)
+    {
+        client.disconnect();
+    }
+}
+
+} // namespace hg::LoadTest
+
+int main(int argc, char* argv[])
+{
+    using namespace hg::LoadTest;
+
+    const std::optional<Options> options = parseOptions(argc, argv);
+
+    if(!options.has_value())
+    {
+        printUsage();
+        return 1;
+    }
+
+    const Options& o = *options;
+
+    SharedData shared{.options = o};
+
+    if(!o.replayPath.empty())
+    {
+        hg::replay_file rf;
+
+        if(!rf.deserialize_from_file(o.replayPath))
+        {
+            std::cerr << "Failure loading replay '" << o.replayPath << "'\n";
+            return 1;
+        }
+
+        shared.compressedReplay = hg::compress_replay_file(rf);
+
+        if(!shared.compressedReplay.has_value())
+        {
+            std::cerr << "Failure compressing replay '" << o.replayPath
+                      << "'\n";
+
+            return 1;
+        }
+
+        shared.replayLevelValidator =
+            hg::Utils::getLevelValidator(rf._level_id, rf._difficulty_mult);
+    }
+    else if(o.weightReplay > 0)
+    {
+        std::cout << "No replay specified with '-replay', replay requests are "
+                     "disabled\n";
+    }
+
+    std::cout << "Connecting " << o.clients << " clients to '" << o.serverIp
+              << ':' << o.serverPort << "' using " << o.threads
+              << " threads...\n";
+
+    std::vector<Stats> stats(static_cast<std::size_t>(o.threads));
+    std::vector<std::thread> workers;
+
+    const int clientsPerThread = (o.clients + o.threads - 1) / o.threads;
+
+    for(int t = 0; t < o.threads; ++t)
+    {
+        const int first = t * clientsPerThread;
+        const int count = std::min(clientsPerThread, o.clients - first);
+
+        workers.emplace_back(runWorker, std::ref(shared),
+            std::ref(stats[static_cast<std::size_t>(t)]), first,
+            std::max(count, 0), static_cast<unsigned int>(t));
+    }
+
+    // Wait until every client is either ready or failed, then start the
+    // steady phase.
+    const TimePoint loginStart = Clock::now();
+
+    while(shared.readyClients + shared.failedClients < o.clients &&
+          Clock::now() - loginStart < std::chrono::seconds(60))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::cout << "Login phase done in "
+              << std::chrono::duration<double>(Clock::now() - loginStart)
+                     .count()
+              << "s (" << shared.readyClients << " ready, "
+              << shared.failedClients << " failed), running for "
+              << o.durationSeconds << "s...\n";
+
+    shared.steadyPhase = true;
+
+    const TimePoint steadyStart = Clock::now();
+
+    std::this_thread::sleep_for(std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(o.durationSeconds)));
+
+    const double steadySeconds =
+        std::chrono::duration<double>(Clock::now() - steadyStart).count();
+
+    shared.running = false;
+
+    for(std::thread& w : workers)
+    {
+        w.join();
+    }
+
+    // ------------------------------------------------------------------------
+    // Merge and report.
+    Stats merged;
+
+    for(const Stats& s : stats)
+    {
+        for(std::size_t i = 0; i < merged.size(); ++i)
+        {
+            merged[i].latenciesUs.insert(merged[i].latenciesUs.end(),
+                s[i].latenciesUs.begin(), s[i].latenciesUs.end());
+
+            merged[i].timeouts += s[i].timeouts;
+            merged[i].failures += s[i].failures;
+        }
+    }
+
+    std::printf("\n%-28s %10s %10s %12s %12s %10s %10s\n", "request",
+        "count", "req/s", "p50 (us)", "p99 (us)", "timeouts", "failures");
+
+    std::size_t steadyRequests = 0;
+
+    for(std::size_t i = 0; i < merged.size(); ++i)
+    {
+        RequestStats& rs = merged[i];
+        const bool steady =
+            i >= static_cast<std::size_t>(RequestType::TopScores);
+
+        if(steady)
+        {
+            steadyRequests += rs.latenciesUs.size();
+        }
+
+        std::printf("%-28s %10zu %10.1f %12.0f %12.0f %10llu %10llu\n",
+            requestTypeNames[i], rs.latenciesUs.size(),
+            steady ? static_cast<double>(rs.latenciesUs.size()) / steadySeconds
+                   : 0.0,
+            percentile(rs.latenciesUs, 0.5), percentile(rs.latenciesUs, 0.99),
+            static_cast<unsigned long long>(rs.timeouts),
+            static_cast<unsigned long long>(rs.failures));
+    }
+
+    std::printf("\nSteady phase throughput: %.1f replies/s\n",
+        static_cast<double>(steadyRequests) / steadySeconds);
+
+    return 0;
+}
@@ -14,14 +14,285 @@
 
 #include <SSVUtils/Core/Log/Log.hpp>
 
+#include <SFML/Audio/InputSoundFile.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
-#include <SFML/Audio/Music.hpp>
-
+#include <SFML/Audio/SoundStream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace hg {
 
+namespace {
+
+// Amount of music decoded ahead of time, enough to cover the time it takes
+// for the stream to catch up once playing.
+inline constexpr float musicPrefetchSeconds{2.f};
+
+struct MusicKey
+{
+    std::string path;
+    float offsetSeconds;
+
+    [[nodiscard]] bool operator==(const MusicKey& rhs) const noexcept
+    {
+        return path == rhs.path &&
+               std::abs(offsetSeconds - rhs.offsetSeconds) < 0.001f;
+    }
+};
+
+// A music file opened and seeked, with its first seconds already decoded.
+struct PreparedMusic
+{
+    MusicKey key;
+    std::unique_ptr<sf::InputSoundFile> file;
+
+    // Samples starting at `key.offsetSeconds`, `file` is positioned right
+    // after them.
+    std::vector<sf::Int16> samples;
+};
+
+[[nodiscard]] std::unique_ptr<PreparedMusic> prepareMusic(const MusicKey& key)
+{
+    auto result = std::make_unique<PreparedMusic>();
+    result->key = key;
+    result->file = std::make_unique<sf::InputSoundFile>();
+
+    if(!result->file->openFromFile(key.path))
+    {
+        return nullptr;
+    }
+
+    sf::InputSoundFile& file = *result->file;
+    file.seek(sf::seconds(key.offsetSeconds));
+
+    const auto count = static_cast<std::size_t>(
+        file.getSampleRate() * file.getChannelCount() * musicPrefetchSeconds);
+
+    result->samples.resize(count);
+    result->samples.resize(file.read(result->samples.data(), count));
+
+    return result;
+}
+
+// Streams music from a file like `sf::Music`, but can also start from a
+// `PreparedMusic`, playing its decoded samples while the file catches up.
+class MusicStream : public sf::SoundStream
+{
+private:
+    std::unique_ptr<sf::InputSoundFile> _file;
+    std::vector<sf::Int16> _buffer;
+
+    std::vector<sf::Int16> _prefetched;
+    std::size_t _prefetchedPos{0};
+    sf::Time _prefetchedOffset;
+
+    // `sf::SoundStream` seeks to zero whenever it stops, including right
+    // before seeking to the requested offset, so seeks are only performed
+    // once data is needed.
+    std::optional<sf::Time> _pendingSeek;
+
+    void initializeFromFile()
+    {
+        // One second of audio per chunk, as `sf::Music` does.
+        _buffer.resize(_file->getSampleRate() * _file->getChannelCount());
+        initialize(_file->getChannelCount(), _file->getSampleRate());
+    }
+
+protected:
+    [[nodiscard]] bool onGetData(Chunk& data) override
+    {
+        if(_pendingSeek.has_value())
+        {
+            _prefetched.clear();
+            _prefetchedPos = 0;
+
+            _file->seek(*_pendingSeek);
+            _pendingSeek.reset();
+        }
+
+        if(_prefetchedPos < _prefetched.size())
+        {
+            data.samples = _prefetched.data() + _prefetchedPos;
+            data.sampleCount =
+                std::min(_buffer.size(), _prefetched.size() - _prefetchedPos);
+
+            _prefetchedPos += data.sampleCount;
+            return true;
+        }
+
+        data.samples = _buffer.data();
+        data.sampleCount = _file->read(_buffer.data(), _buffer.size());
+
+        return data.sampleCount != 0 &&
+               _file->getSampleOffset() < _file->getSampleCount();
+    }
+
+    void onSeek(const sf::Time timeOffset) override
+    {
+        // Seeking to where the prefetched samples start keeps them.
+        if(_prefetchedPos == 0 && !_prefetched.empty() &&
+            std::abs((timeOffset - _prefetchedOffset).asMilliseconds()) < 1)
+        {
+            _pendingSeek.reset();
+            return;
+        }
+
+        _pendingSeek = timeOffset;
+    }
+
+public:
+    ~MusicStream() override
+    {
+        stop();
+    }
+
+    [[nodiscard]] bool openFromFile(const std::string& path)
+    {
+        stop();
+
+        _prefetched.clear();
+        _prefetchedPos = 0;
+        _pendingSeek.reset();
+
+        _file = std::make_unique<sf::InputSoundFile>();
+        if(!_file->openFromFile(path))
+        {
+            return false;
+        }
+
+        initializeFromFile();
+        return true;
+    }
+
+    void openFromPrepared(PreparedMusic&& pm)
+    {
+        stop();
+
+        _file = std::move(pm.file);
+        _prefetched = std::move(pm.samples);
+        _prefetchedPos = 0;
+        _prefetchedOffset = sf::seconds(pm.key.offsetSeconds);
+        _pendingSeek.reset();
+
+        initializeFromFile();
+    }
+};
+
+// Prepares music on a worker thread. Only the most recent request matters:
+// it replaces any request that has not started yet.
+class MusicPrefetcher
+{
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+
+    std::optional<MusicKey> _requested;
+    std::optional<MusicKey> _preparing;
+    std::optional<MusicKey> _preparedKey;
+    std::unique_ptr<PreparedMusic> _prepared; // Null if preparing failed.
+
+    bool _stopRequested{false};
+    std::thread _worker;
+
+    void workerLoop()
+    {
+        std::unique_lock lock{_mutex};
+
+        while(true)
+        {
+            _cv.wait(lock,
+                [this] { return _requested.has_value() || _stopRequested; });
+
+            if(_stopRequested)
+            {
+                return;
+            }
+
+            _preparing = std::move(_requested);
+            _requested.reset();
+
+            lock.unlock();
+            std::unique_ptr<PreparedMusic> pm = prepareMusic(*_preparing);
+            lock.lock();
+
+            _preparedKey = std::move(_preparing);
+            _preparing.reset();
+            _prepared = std::move(pm);
+
+            _cv.notify_all();
+        }
+    }
+
+public:
+    MusicPrefetcher() : _worker{[this] { workerLoop(); }}
+    {}
+
+    ~MusicPrefetcher()
+    {
+        {
+            std::lock_guard lock{_mutex};
+            _stopRequested = true;
+        }
+
+        _cv.notify_all();
+        _worker.join();
+    }
+
+    void request(MusicKey&& key)
+    {
+        {
+            std::lock_guard lock{_mutex};
+
+            if(_preparing == key || _preparedKey == key)
+            {
+                return;
+            }
+
+            _requested = std::move(key);
+        }
+
+        _cv.notify_all();
+    }
+
+    // Returns the music prepared for `key`, waiting for it if it is being
+    // prepared. Returns null if it was never requested, has not started
+    // yet, or could not be prepared.
+    [[nodiscard]] std::unique_ptr<PreparedMusic> take(const MusicKey& key)
+    {
+        std::unique_lock lock{_mutex};
+
+        if(_requested == key)
+        {
+            // Opening the file right away is faster than waiting for the
+            // worker to get to it.
+            _requested.reset();
+            return nullptr;
+        }
+
+        _cv.wait(lock, [&] { return _preparing != key; });
+
+        if(_preparedKey != key)
+        {
+            return nullptr;
+        }
+
+        _preparedKey.reset();
+        return std::move(_prepared);
+    }
+};
+
+} // namespace
+
 class Audio::AudioImpl
 {
 private:
@@ -32,10 +303,11 @@ private:
     // TODO (P2): remove these, roll own system
     ssvs::SoundPlayer _soundPlayer;
 
-    std::optional<sf::Music> _music;
+    std::optional<MusicStream> _music;
     float _musicVolume;
     std::string _lastLoadedMusicPath;
 
+    MusicPrefetcher _musicPrefetcher;
 
     void playSoundImpl(
         const std::string& assetId, const ssvs::SoundPlayer::Mode mode)
@@ -55,7 +327,8 @@ public:
           _soundPlayer{},
           _music{},
           _musicVolume{100.f},
-          _lastLoadedMusicPath{}
+          _lastLoadedMusicPath{},
+          _musicPrefetcher{}
     {
         SSVOH_ASSERT(static_cast<bool>(_soundBufferGetter));
     }
@@ -184,7 +457,14 @@ public:
             _music.emplace();
         }
 
-        if(_lastLoadedMusicPath != *path)
+        if(std::unique_ptr<PreparedMusic> pm = _musicPrefetcher.take(
+               MusicKey{.path = *path, .offsetSeconds = playingOffsetSeconds});
+            pm != nullptr)
+        {
+            _music->openFromPrepared(std::move(*pm));
+            _lastLoadedMusicPath = *path;
+        }
+        else if(_lastLoadedMusicPath != *path)
         {
             if(!_music->openFromFile(*path))
             {
@@ -192,6 +472,7 @@ public:
                     << "Failed loading music file '" << path << "'\n";
 
                 _music.reset();
+                _lastLoadedMusicPath.clear();
                 return false;
             }
 
@@ -205,6 +486,19 @@ public:
         return true;
     }
 
+    void prefetchMusic(const std::string& packId, const std::string& id,
+        const float playingOffsetSeconds)
+    {
+        const std::string* path =
+            _musicPathGetter(Utils::concat(packId, '_', id));
+
+        if(path != nullptr)
+        {
+            _musicPrefetcher.request(
+                MusicKey{.path = *path, .offsetSeconds = playingOffsetSeconds});
+        }
+    }
+
     void setCurrentMusicPitch(const float pitch)
     {
         if(_music.has_value())
@@ -310,6 +604,12 @@ void Audio::playPackSoundAbort(const std::string& packId, const std::string& id)
     return impl().loadAndPlayMusic(packId, id, playingOffsetSeconds);
 }
 
+void Audio::prefetchMusic(const std::string& packId, const std::string& id,
+    const float playingOffsetSeconds)
+{
+    impl().prefetchMusic(packId, id, playingOffsetSeconds);
+}
+
 void Audio::setCurrentMusicPitch(const float pitch)
 {
     impl().setCurrentMusicPitch(pitch);
@@ -6,13 +6,44 @@
 
 #include "SSVOpenHexagon/Global/Assert.hpp"
 #include "SSVOpenHexagon/Components/CPlayer.hpp"
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
 
-#include <SSVUtils/Core/Log/Log.hpp>
 #include <SSVUtils/Core/Utils/Containers.hpp>
 #include <SSVUtils/Core/Common/LikelyUnlikely.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace hg {
 
+[[nodiscard]] static int batchValueToInt(const double value) noexcept
+{
+    // Converting a value that does not fit is undefined behavior, such values
+    // are mapped to `-1`, which is never a valid handle.
+    constexpr double min = std::numeric_limits<int>::min();
+    constexpr double max = std::numeric_limits<int>::max();
+
+    if(!(value > min - 1.0 && value < max + 1.0))
+    {
+        return -1;
+    }
+
+    return static_cast<int>(value);
+}
+
+[[nodiscard]] static sf::Vector2f batchValuesToPos(
+    const double* values) noexcept
+{
+    return sf::Vector2f(
+        static_cast<float>(values[0]), static_cast<float>(values[1]));
+}
+
+[[nodiscard]] static sf::Color batchValuesToColor(const double* values) noexcept
+{
+    return sf::Color(batchValueToInt(values[0]), batchValueToInt(values[1]),
+        batchValueToInt(values[2]), batchValueToInt(values[3]));
+}
+
 [[nodiscard]] bool CCustomWallManager::isValidHandle(
     const CCustomWallHandle h) const noexcept
 {
@@ -24,17 +55,16 @@ namespace hg {
 [[nodiscard]] bool CCustomWallManager::checkValidHandle(
     const CCustomWallHandle h, const char* msg)
 {
-    if(SSVU_UNLIKELY(_handleAvailable[h]))
+    if(SSVU_UNLIKELY(!isValidHandle(h) || _handleAvailable[h]))
     {
-        ssvu::lo("CustomWallManager")
+        Utils::scriptLog("CustomWallManager")
             << "Attempted to " << msg << " of invalid custom wall " << h
             << '\n';
 
-        SSVOH_ASSERT(ssvu::contains(_freeHandles, h));
+        SSVOH_ASSERT(!isValidHandle(h) || ssvu::contains(_freeHandles, h));
         return false;
     }
 
-    SSVOH_ASSERT(isValidHandle(h));
     return true;
 }
 
@@ -43,7 +73,7 @@ namespace hg {
 {
     if(SSVU_UNLIKELY(vertexIdx < 0 || vertexIdx > 3))
     {
-        ssvu::lo("CustomWallManager")
+        Utils::scriptLog("CustomWallManager")
             << "Invalid vertex index " << vertexIdx << " for custom wall " << h
             << " while attempting to " << msg << '\n';
 
@@ -109,11 +139,8 @@ void CCustomWallManager::destroyUnchecked(const CCustomWallHandle cwHandle)
 
 void CCustomWallManager::destroy(const CCustomWallHandle cwHandle)
 {
-    if(SSVU_UNLIKELY(_handleAvailable[cwHandle]))
+    if(!checkValidHandle(cwHandle, "destroy instance"))
     {
-        ssvu::lo("CustomWallManager")
-            << "Attempted to destroy invalid wall " << cwHandle << '\n';
-
         return;
     }
 
@@ -180,7 +207,7 @@ void CCustomWallManager::setKillingSide(
 {
     if(SSVU_UNLIKELY(side > 3u))
     {
-        ssvu::lo("CustomWallManager")
+        Utils::scriptLog("CustomWallManager")
             << "Attempted to set killing side with invalid value " << side
             << ", acceptable values are 0 to 3\n";
 
@@ -308,6 +335,52 @@ void CCustomWallManager::setVertexColor4Same(
     _customWalls[cwHandle].setVertexColor(3, color);
 }
 
+[[nodiscard]] double* CCustomWallManager::getVertexPos4Batch()
+{
+    if(_vertexPos4Batch.empty())
+    {
+        _vertexPos4Batch.resize(batchCapacity * vertexPos4BatchStride);
+    }
+
+    return _vertexPos4Batch.data();
+}
+
+[[nodiscard]] double* CCustomWallManager::getVertexColor4Batch()
+{
+    if(_vertexColor4Batch.empty())
+    {
+        _vertexColor4Batch.resize(batchCapacity * vertexColor4BatchStride);
+    }
+
+    return _vertexColor4Batch.data();
+}
+
+void CCustomWallManager::commitVertexPos4Batch(const std::size_t count)
+{
+    const double* row = getVertexPos4Batch();
+    const std::size_t n = std::min(count, batchCapacity);
+
+    for(std::size_t i = 0; i < n; ++i, row += vertexPos4BatchStride)
+    {
+        setVertexPos4(batchValueToInt(row[0]), batchValuesToPos(row + 1),
+            batchValuesToPos(row + 3), batchValuesToPos(row + 5),
+            batchValuesToPos(row + 7));
+    }
+}
+
+void CCustomWallManager::commitVertexColor4Batch(const std::size_t count)
+{
+    const double* row = getVertexColor4Batch();
+    const std::size_t n = std::min(count, batchCapacity);
+
+    for(std::size_t i = 0; i < n; ++i, row += vertexColor4BatchStride)
+    {
+        setVertexColor4(batchValueToInt(row[0]), batchValuesToColor(row + 1),
+            batchValuesToColor(row + 5), batchValuesToColor(row + 9),
+            batchValuesToColor(row + 13));
+    }
+}
+
 void CCustomWallManager::clear()
 {
     _freeHandles.clear();
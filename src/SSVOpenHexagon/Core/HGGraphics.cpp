@@ -10,6 +10,7 @@
 #include "SSVOpenHexagon/Global/Assets.hpp"
 #include "SSVOpenHexagon/Global/Config.hpp"
 #include "SSVOpenHexagon/Global/Imgui.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 
 #include "SSVOpenHexagon/Utils/Color.hpp"
 #include "SSVOpenHexagon/Utils/String.hpp"
@@ -36,7 +37,7 @@ namespace hg {
 }
 
 void HexagonGame::render(
-    sf::Drawable& mDrawable, const sf::RenderStates& mStates)
+    const sf::Drawable& mDrawable, const sf::RenderStates& mStates)
 {
     if(window == nullptr)
     {
@@ -51,11 +52,17 @@ void HexagonGame::render(
 
 void HexagonGame::draw()
 {
+    // Frames are delimited by draw calls, so the previous frame's draw and the
+    // updates that followed it are reported together.
+    SSVOH_PROFILE_FRAME();
+
     if(window == nullptr)
     {
         return;
     }
 
+    SSVOH_PROFILE_SCOPE("HexagonGame::draw");
+
     const auto getRenderStates = [this](
                                      const RenderStage rs) -> sf::RenderStates
     {
@@ -120,42 +127,29 @@ void HexagonGame::draw()
 
     window->setView(backgroundCamera->apply());
 
-    wallQuads3D.clear();
-    pivotQuads3D.clear();
-    playerTris3D.clear();
-    wallQuads.clear();
-    pivotQuads.clear();
-    playerTris.clear();
-    capTris.clear();
+    FrameVertices& frame = vertexPipeline.getBackFrame();
+    frame.clear();
 
     // Reserve right amount of memory for all walls and custom walls
-    wallQuads.reserve_more_quad(walls.size() + cwManager.count());
+    frame.wallQuads.reserve_more_quad(walls.size() + cwManager.count());
 
     for(CWall& w : walls)
     {
-        w.draw(getColorWall(), wallQuads);
+        w.draw(getColorWall(), frame.wallQuads);
     }
 
-    cwManager.draw(wallQuads);
+    cwManager.draw(frame.wallQuads);
 
     if(status.started)
     {
-        player.draw(getSides(), getColorMain(), getColorPlayer(), pivotQuads,
-            capTris, playerTris, getColorCap(), Config::getAngleTiltIntensity(),
+        player.draw(getSides(), getColorMain(), getColorPlayer(),
+            frame.pivotQuads, frame.capTris, frame.playerTris, getColorCap(),
+            Config::getAngleTiltIntensity(),
             Config::getShowSwapBlinkingEffect());
     }
 
     if(Config::get3D())
     {
-        const float depth(styleData._3dDepth);
-        const std::size_t numWallQuads(wallQuads.size());
-        const std::size_t numPivotQuads(pivotQuads.size());
-        const std::size_t numPlayerTris(playerTris.size());
-
-        wallQuads3D.reserve(numWallQuads * depth);
-        pivotQuads3D.reserve(numPivotQuads * depth);
-        playerTris3D.reserve(numPlayerTris * depth);
-
         const float pulse3D{Config::getNoPulse() ? 1.f : status.pulse3D};
         const float effect{
             styleData._3dSkew * Config::get3DMultiplier() * pulse3D};
@@ -165,98 +159,47 @@ void HexagonGame::draw()
 
         const float radRot(
             ssvu::toRad(backgroundCamera->getRotation()) + (ssvu::pi / 2.f));
-        const float sinRot(std::sin(radRot));
-        const float cosRot(std::cos(radRot));
-
-        for(std::size_t i = 0; i < depth; ++i)
-        {
-            wallQuads3D.unsafe_emplace_other(wallQuads);
-            pivotQuads3D.unsafe_emplace_other(pivotQuads);
-            playerTris3D.unsafe_emplace_other(playerTris);
-        }
-
-        const auto adjustAlpha = [&](sf::Color& c, const float i)
-        {
-            SSVOH_ASSERT(styleData._3dAlphaMult != 0.f);
-
-            const float newAlpha =
-                (static_cast<float>(c.a) / styleData._3dAlphaMult) -
-                i * styleData._3dAlphaFalloff;
-
-            c.a = Utils::componentClamp(newAlpha);
-        };
-
-        for(int j(0); j < static_cast<int>(depth); ++j)
-        {
-            const float i(depth - j - 1);
-
-            const float offset(styleData._3dSpacing *
-                               (float(i + 1.f) * styleData._3dPerspectiveMult) *
-                               (effect * 3.6f) * 1.4f);
-
-            const sf::Vector2f newPos(offset * cosRot, offset * sinRot);
-
-            sf::Color overrideColor;
-
-            if(!Config::getBlackAndWhite())
-            {
-                overrideColor = Utils::getColorDarkened(
-                    styleData.get3DOverrideColor(), styleData._3dDarkenMult);
-            }
-            else
-            {
-                overrideColor = Utils::getColorDarkened(
-                    sf::Color(255, 255, 255, styleData.getMainColor().a),
-                    styleData._3dDarkenMult);
-            }
-            adjustAlpha(overrideColor, i);
-
-            // Draw pivot layers
-            for(std::size_t k = j * numPivotQuads; k < (j + 1) * numPivotQuads;
-                ++k)
-            {
-                pivotQuads3D[k].position += newPos;
-                pivotQuads3D[k].color = overrideColor;
-            }
-
-            if(styleData.get3DOverrideColor() == styleData.getMainColor())
-            {
-                overrideColor = Utils::getColorDarkened(
-                    getColorWall(), styleData._3dDarkenMult);
-
-                adjustAlpha(overrideColor, i);
-            }
-
-            // Draw wall layers
-            for(std::size_t k = j * numWallQuads; k < (j + 1) * numWallQuads;
-                ++k)
-            {
-                wallQuads3D[k].position += newPos;
-                wallQuads3D[k].color = overrideColor;
-            }
-
-            // Apply player color if no 3D override is present.
-            if(styleData.get3DOverrideColor() == styleData.getMainColor())
-            {
-                overrideColor = Utils::getColorDarkened(
-                    getColorPlayer(), styleData._3dDarkenMult);
 
-                adjustAlpha(overrideColor, i);
-            }
-
-            // Draw player layers
-            for(std::size_t k = j * numPlayerTris; k < (j + 1) * numPlayerTris;
-                ++k)
-            {
-                playerTris3D[k].position += newPos;
-                playerTris3D[k].color = overrideColor;
-            }
-        }
-    }
-
-    render(wallQuads3D, getRenderStates(RenderStage::WallQuads3D));
-    render(pivotQuads3D, getRenderStates(RenderStage::PivotQuads3D));
-    render(playerTris3D, getRenderStates(RenderStage::PlayerTris3D));
+        const sf::Color pivotColor =
+            !Config::getBlackAndWhite()
+                ? Utils::getColorDarkened(
+                      styleData.get3DOverrideColor(), styleData._3dDarkenMult)
+                : Utils::getColorDarkened(
+                      sf::Color(255, 255, 255, styleData.getMainColor().a),
+                      styleData._3dDarkenMult);
+
+        // Walls and player keep their own color if no 3D override is present.
+        const bool noOverride =
+            styleData.get3DOverrideColor() == styleData.getMainColor();
+
+        frame.extrusion3D = Extrusion3DParams{
+            .depth = styleData._3dDepth > 0.f
+                         ? static_cast<std::size_t>(styleData._3dDepth)
+                         : 0,
+            .spacing = styleData._3dSpacing,
+            .perspectiveMult = styleData._3dPerspectiveMult,
+            .effect = effect,
+            .alphaMult = styleData._3dAlphaMult,
+            .alphaFalloff = styleData._3dAlphaFalloff,
+            .sinRot = std::sin(radRot),
+            .cosRot = std::cos(radRot),
+            .pivotColor = pivotColor,
+            .wallColor = noOverride ? Utils::getColorDarkened(getColorWall(),
+                                          styleData._3dDarkenMult)
+                                    : pivotColor,
+            .playerColor = noOverride
+                               ? Utils::getColorDarkened(
+                                     getColorPlayer(), styleData._3dDarkenMult)
+                               : pivotColor};
+    }
+
+    const FrameVertices& ready = Config::getPipelinedVertexGeneration()
+                                     ? vertexPipeline.submitBackFrame()
+                                     : vertexPipeline.buildBackFrame();
+
+    render(ready.wallQuads3D, getRenderStates(RenderStage::WallQuads3D));
+    render(ready.pivotQuads3D, getRenderStates(RenderStage::PivotQuads3D));
+    render(ready.playerTris3D, getRenderStates(RenderStage::PlayerTris3D));
 
     if(Config::getShowPlayerTrail() && status.showPlayerTrail)
     {
@@ -268,10 +211,10 @@ void HexagonGame::draw()
         drawSwapParticles();
     }
 
-    render(wallQuads, getRenderStates(RenderStage::WallQuads));
-    render(capTris, getRenderStates(RenderStage::CapTris));
-    render(pivotQuads, getRenderStates(RenderStage::PivotQuads));
-    render(playerTris, getRenderStates(RenderStage::PlayerTris));
+    render(ready.wallQuads, getRenderStates(RenderStage::WallQuads));
+    render(ready.capTris, getRenderStates(RenderStage::CapTris));
+    render(ready.pivotQuads, getRenderStates(RenderStage::PivotQuads));
+    render(ready.playerTris, getRenderStates(RenderStage::PlayerTris));
 
     window->setView(overlayCamera->apply());
 
@@ -309,10 +252,14 @@ void HexagonGame::draw()
     }
 
     drawImguiLuaConsole();
+
+    textBatch.endFrame();
 }
 
 void HexagonGame::drawImguiLuaConsole()
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::drawImguiLuaConsole");
+
     if(window == nullptr)
     {
         return;
@@ -390,32 +337,52 @@ void HexagonGame::drawLevelInfo()
     render(levelInfoTextDM);
 }
 
-void HexagonGame::drawParticles()
+void HexagonGame::drawParticlePool(const Utils::ParticlePool& pool,
+    const sf::Texture& texture, const sf::Vector2f& origin,
+    const Utils::ParticlePool::Rotation rotation)
 {
-    for(Particle& p : particles)
+    if(pool.empty())
     {
-        render(p.sprite);
+        return;
     }
+
+    particleTris.clear();
+    pool.appendQuads(particleTris, sf::Vector2f{texture.getSize()}, origin,
+        rotation);
+
+    render(particleTris, sf::RenderStates{&texture});
+}
+
+void HexagonGame::drawParticles()
+{
+    SSVOH_ASSERT(txStarParticle != nullptr);
+
+    drawParticlePool(particles, *txStarParticle, {0.f, 0.f},
+        Utils::ParticlePool::Rotation::Enabled);
 }
 
 void HexagonGame::drawTrailParticles()
 {
-    for(TrailParticle& p : trailParticles)
-    {
-        render(p.sprite);
-    }
+    SSVOH_ASSERT(txSmallCircle != nullptr);
+
+    drawParticlePool(trailParticles, *txSmallCircle,
+        sf::Vector2f{txSmallCircle->getSize()} / 2.f,
+        Utils::ParticlePool::Rotation::Disabled);
 }
 
 void HexagonGame::drawSwapParticles()
 {
-    for(SwapParticle& p : swapParticles)
-    {
-        render(p.sprite);
-    }
+    SSVOH_ASSERT(txSmallCircle != nullptr);
+
+    drawParticlePool(swapParticles, *txSmallCircle,
+        sf::Vector2f{txSmallCircle->getSize()} / 2.f,
+        Utils::ParticlePool::Rotation::Disabled);
 }
 
 void HexagonGame::updateText(ssvu::FT mFT)
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateText");
+
     if(window == nullptr)
     {
         return;
@@ -525,18 +492,17 @@ void HexagonGame::updateText(ssvu::FT mFT)
         // By default, use the timer for scoring
         if(status.started)
         {
-            timeText.setString(formatTime(status.getTimeSeconds()));
+            timeString = formatTime(status.getTimeSeconds());
         }
         else
         {
-            timeText.setString("0");
+            timeString = "0";
         }
     }
     else
     {
         // Alternative scoring
-        timeText.setString(
-            lua.readVariable<std::string>(levelStatus.scoreOverride));
+        timeString = lua.readVariable<std::string>(levelStatus.scoreOverride);
     }
 
     const auto getScaledCharacterSize = [&](const float size)
@@ -548,14 +514,14 @@ void HexagonGame::updateText(ssvu::FT mFT)
     timeText.setCharacterSize(getScaledCharacterSize(70.f));
 
     // Set information text
-    text.setString(os.str());
+    statusString = os.str();
     text.setCharacterSize(getScaledCharacterSize(20.f));
     text.setOrigin({0.f, 0.f});
 
     // Set FPS Text, if option is enabled.
     if(Config::getShowFPS())
     {
-        fpsText.setString(ssvu::toStr(window->getFPS()));
+        fpsString = ssvu::toStr(window->getFPS());
         fpsText.setCharacterSize(getScaledCharacterSize(20.f));
     }
 
@@ -587,11 +553,11 @@ void HexagonGame::updateText(ssvu::FT mFT)
         os.flush();
 
         replayText.setCharacterSize(getScaledCharacterSize(16.f));
-        replayText.setString(os.str());
+        replayString = os.str();
     }
     else
     {
-        replayText.setString("");
+        replayString.clear();
     }
 }
 
@@ -625,26 +591,39 @@ void HexagonGame::drawText_TimeAndStatus(const sf::Color& offsetColor)
 
     if(Config::getShowTimer())
     {
+        const sf::FloatRect bounds =
+            textBatch.getLocalBounds(timeText, timeString);
+
         timeText.setFillColor(colorText);
-        timeText.setOrigin(ssvs::getLocalNW(timeText));
+        timeText.setOrigin({bounds.left, bounds.top});
         timeText.setPosition({padding, padding});
 
-        render(timeText);
+        textBatch.add(timeText, timeString);
     }
 
     if(Config::getShowStatusText())
     {
+        const sf::FloatRect bounds =
+            textBatch.getLocalBounds(text, statusString);
+
+        const sf::FloatRect timeBounds =
+            textBatch.getGlobalBounds(timeText, timeString);
+
         text.setFillColor(colorText);
-        text.setOrigin(ssvs::getLocalNW(text));
-        text.setPosition({padding, ssvs::getGlobalBottom(timeText) + padding});
+        text.setOrigin({bounds.left, bounds.top});
+        text.setPosition(
+            {padding, timeBounds.top + timeBounds.height + padding});
 
-        render(text);
+        textBatch.add(text, statusString);
     }
 
     if(Config::getShowFPS())
     {
+        const sf::FloatRect bounds =
+            textBatch.getLocalBounds(fpsText, fpsString);
+
         fpsText.setFillColor(colorText);
-        fpsText.setOrigin(ssvs::getLocalSW(fpsText));
+        fpsText.setOrigin({bounds.left, bounds.top + bounds.height});
 
         if(Config::getShowLevelInfo() || mustShowReplayUI())
         {
@@ -656,7 +635,7 @@ void HexagonGame::drawText_TimeAndStatus(const sf::Color& offsetColor)
             fpsText.setPosition({padding, Config::getHeight() - padding});
         }
 
-        render(fpsText);
+        textBatch.add(fpsText, fpsString);
     }
 
     if(mustShowReplayUI())
@@ -666,12 +645,20 @@ void HexagonGame::drawText_TimeAndStatus(const sf::Color& offsetColor)
 
         const float replayPadding = 8.f * scaling;
 
+        const sf::FloatRect bounds =
+            textBatch.getLocalBounds(replayText, replayString);
+
         replayText.setFillColor(colorText);
-        replayText.setOrigin(ssvs::getLocalCenterE(replayText));
+        replayText.setOrigin({bounds.left + bounds.width,
+            bounds.top + bounds.height / 2.f});
         replayText.setPosition(ssvs::getGlobalCenterW(replayIcon) -
                                sf::Vector2f{replayPadding, 0});
-        render(replayText);
+
+        textBatch.add(replayText, replayString);
     }
+
+    // One draw call per font and character size in use.
+    textBatch.flush(window->getRenderWindow());
 }
 
 template <typename FRender>
@@ -718,6 +705,8 @@ void HexagonGame::drawText_PersonalBest(const sf::Color& offsetColor)
 
 void HexagonGame::drawText()
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::drawText");
+
     const sf::Color offsetColor{
         Config::getBlackAndWhite() || styleData.getColors().empty()
             ? sf::Color::Black
@@ -21,6 +21,7 @@
 #include "SSVOpenHexagon/Utils/Concat.hpp"
 #include "SSVOpenHexagon/Utils/LuaMetadata.hpp"
 #include "SSVOpenHexagon/Utils/LuaMetadataProxy.hpp"
+#include "SSVOpenHexagon/Utils/LuaProfiler.hpp"
 #include "SSVOpenHexagon/Utils/ScopeGuard.hpp"
 #include "SSVOpenHexagon/Utils/Timeline2.hpp"
 #include "SSVOpenHexagon/Utils/TypeWrapper.hpp"
@@ -43,7 +44,8 @@ Utils::LuaMetadataProxy addLuaFn(
     Lua::LuaContext& lua, const std::string& name, F&& f)
 {
     // TODO (P2): reduce instantiations by using captureless lambdas
-    lua.writeVariable(name, SSVOH_FWD(f));
+    lua.writeVariable(name,
+        Utils::makeProfiledLuaFn(lua.getProfiler(), name, SSVOH_FWD(f)));
     return Utils::LuaMetadataProxy{
         Utils::TypeWrapper<F>{}, LuaScripting::getMetadata(), name};
 }
@@ -305,9 +307,21 @@ static void waitUntilSImpl(const double mDuration,
 
 void HexagonGame::initLua_MainTimeline()
 {
+    const std::size_t evalProfilerIndex = luaProfiler.getIndex(
+        "t_eval action", Utils::LuaProfiler::Kind::Timeline);
+
     addLuaFn(lua, "t_eval",
-        [this](const std::string& mCode)
-        { timeline.append_do([=, this] { Utils::runLuaCode(lua, mCode); }); })
+        [this, evalProfilerIndex](const std::string& mCode)
+        {
+            timeline.append_do(
+                [=, this]
+                {
+                    const Utils::LuaProfiler::Scope scope{
+                        &luaProfiler, evalProfilerIndex};
+
+                    Utils::runLuaCode(lua, mCode);
+                });
+        })
         .arg("code")
         .doc(
             "*Add to the main timeline*: evaluate the Lua code specified in "
@@ -345,10 +359,20 @@ void HexagonGame::initLua_MainTimeline()
 
 void HexagonGame::initLua_EventTimeline()
 {
+    const std::size_t evalProfilerIndex = luaProfiler.getIndex(
+        "e_eval action", Utils::LuaProfiler::Kind::Timeline);
+
     addLuaFn(lua, "e_eval",
-        [this](const std::string& mCode) {
+        [this, evalProfilerIndex](const std::string& mCode)
+        {
             eventTimeline.append_do(
-                [=, this] { Utils::runLuaCode(lua, mCode); });
+                [=, this]
+                {
+                    const Utils::LuaProfiler::Scope scope{
+                        &luaProfiler, evalProfilerIndex};
+
+                    Utils::runLuaCode(lua, mCode);
+                });
         })
         .arg("code")
         .doc(
@@ -475,8 +499,12 @@ void HexagonGame::initLua_CustomTimelines()
         return false;
     };
 
+    const std::size_t evalProfilerIndex = luaProfiler.getIndex(
+        "ct_eval action", Utils::LuaProfiler::Kind::Timeline);
+
     addLuaFn(lua, "ct_eval",
-        [checkHandle, this](CustomTimelineHandle cth, const std::string& mCode)
+        [checkHandle, this, evalProfilerIndex](
+            CustomTimelineHandle cth, const std::string& mCode)
         {
             if(!checkHandle(cth, "ct_eval"))
             {
@@ -484,7 +512,13 @@ void HexagonGame::initLua_CustomTimelines()
             }
 
             _customTimelineManager.get(cth)._timeline.append_do(
-                [=, this] { Utils::runLuaCode(lua, mCode); });
+                [=, this]
+                {
+                    const Utils::LuaProfiler::Scope scope{
+                        &luaProfiler, evalProfilerIndex};
+
+                    Utils::runLuaCode(lua, mCode);
+                });
         })
         .arg("handle")
         .arg("code")
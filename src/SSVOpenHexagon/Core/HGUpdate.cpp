@@ -10,11 +10,13 @@
 #include "SSVOpenHexagon/Global/Assets.hpp"
 #include "SSVOpenHexagon/Global/Audio.hpp"
 #include "SSVOpenHexagon/Global/Config.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 
 #include "SSVOpenHexagon/Utils/Clock.hpp"
 #include "SSVOpenHexagon/Utils/Concat.hpp"
 #include "SSVOpenHexagon/Utils/Easing.hpp"
 #include "SSVOpenHexagon/Utils/LevelValidator.hpp"
+#include "SSVOpenHexagon/Utils/LuaProfiler.hpp"
 #include "SSVOpenHexagon/Utils/MoveTowards.hpp"
 #include "SSVOpenHexagon/Utils/Split.hpp"
 #include "SSVOpenHexagon/Utils/String.hpp"
@@ -77,6 +79,8 @@ void HexagonGame::advanceByTicks(const int nTicks)
 
 void HexagonGame::update(ssvu::FT mFT, const float timescale)
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::update");
+
     // ------------------------------------------------------------------------
     // Fast-forwarding for level testing
     if(fastForwardTarget.has_value())
@@ -418,6 +422,8 @@ void HexagonGame::update(ssvu::FT mFT, const float timescale)
 
 void HexagonGame::updateWalls(ssvu::FT mFT)
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateWalls");
+
     bool collided{false};
     const float radiusSquared{status.radius * status.radius + 8.f};
     const sf::Vector2f& pPos{player.getPosition()};
@@ -479,6 +485,8 @@ void HexagonGame::updateWalls(ssvu::FT mFT)
 
 void HexagonGame::updateCustomWalls(ssvu::FT mFT)
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateCustomWalls");
+
     if(cwManager.handleCollision(getInputMovement(), getRadius(), player, mFT))
     {
         performPlayerKill();
@@ -631,6 +639,8 @@ void HexagonGame::updateInput_RecordCurrentInputToLastReplayData()
 
 void HexagonGame::updateInput()
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateInput");
+
     if(imguiLuaConsoleHasInput())
     {
         return;
@@ -692,6 +702,8 @@ void HexagonGame::updateEvents(ssvu::FT)
 
 void HexagonGame::updateCustomTimelines()
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateCustomTimelines");
+
     _customTimelineManager.updateAllTimelines(status.getCurrentTP());
 }
 
@@ -715,19 +727,29 @@ void HexagonGame::updateIncrement()
 
 void HexagonGame::updateLevel(ssvu::FT mFT)
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateLevel");
+
     if(status.isTimePaused())
     {
         return;
     }
 
-    runLuaFunctionIfExists<float>("onUpdate", mFT);
+    {
+        SSVOH_PROFILE_SCOPE("Lua onUpdate");
+        runLuaFunctionIfExists<float>("onUpdate", mFT);
+    }
 
     const auto o = timelineRunner.update(timeline, status.getTimeTP());
 
     if(o == Utils::timeline2_runner::outcome::finished && !mustChangeSides)
     {
         timeline.clear();
-        runLuaFunctionIfExists<void>("onStep");
+
+        {
+            SSVOH_PROFILE_SCOPE("Lua onStep");
+            runLuaFunctionIfExists<void>("onStep");
+        }
+
         timelineRunner = {};
     }
 }
@@ -899,56 +921,38 @@ void HexagonGame::updatePulse3D(ssvu::FT mFT)
 
 void HexagonGame::updateParticles(ssvu::FT mFT)
 {
-    SSVOH_ASSERT(window != nullptr);
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateParticles");
 
-    const auto isOutOfBounds = [](const Particle& p)
-    {
-        const sf::Sprite& sp = p.sprite;
-        const sf::Vector2f& pos = sp.getPosition();
-        constexpr float padding = 256.f;
-
-        return (pos.x < 0 - padding || pos.x > Config::getWidth() + padding ||
-                pos.y < 0 - padding || pos.y > Config::getHeight() + padding);
-    };
+    SSVOH_ASSERT(window != nullptr);
 
     const auto makePBParticle = [this]
     {
-        Particle p;
-
-        SSVOH_ASSERT(txStarParticle != nullptr);
-        p.sprite.setTexture(*txStarParticle);
-        p.sprite.setPosition(
-            {ssvu::getRndR(-64.f, Config::getWidth() + 64.f), -64.f});
-        p.sprite.setRotation(sf::degrees(ssvu::getRndR(0.f, 360.f)));
-
-        const float scale = ssvu::getRndR(0.75f, 1.35f);
-        p.sprite.setScale({scale, scale});
-
         sf::Color c = getColorMain();
         c.a = ssvu::getRndI(90, 145);
-        p.sprite.setColor(c);
-
-        p.velocity = {ssvu::getRndR(-12.f, 12.f), ssvu::getRndR(4.f, 18.f)};
-        p.angularVelocity = ssvu::getRndR(-6.f, 6.f);
 
-        return p;
+        return Utils::ParticleSpawnData{
+            .position{ssvu::getRndR(-64.f, Config::getWidth() + 64.f), -64.f},
+            .velocity{ssvu::getRndR(-12.f, 12.f), ssvu::getRndR(4.f, 18.f)},
+            .angle{ssvu::getRndR(0.f, 360.f)},
+            .angularVelocity{ssvu::getRndR(-6.f, 6.f)},
+            .scale{ssvu::getRndR(0.75f, 1.35f)},
+            .alpha{static_cast<float>(c.a)},
+            .color{c}};
     };
 
-    ssvu::eraseRemoveIf(particles, isOutOfBounds);
+    constexpr float padding = 256.f;
 
-    for(Particle& p : particles)
-    {
-        sf::Sprite& sp = p.sprite;
-        sp.setPosition(sp.getPosition() + p.velocity * mFT);
-        sp.setRotation(sp.getRotation() + sf::degrees(p.angularVelocity * mFT));
-    }
+    particles.eraseOutside({-padding, -padding},
+        {Config::getWidth() + padding, Config::getHeight() + padding});
+
+    particles.integrate(mFT);
 
     if(mustSpawnPBParticles)
     {
         nextPBParticleSpawn -= mFT;
         if(nextPBParticleSpawn <= 0.f)
         {
-            particles.emplace_back(makePBParticle());
+            particles.spawn(makePBParticle());
             nextPBParticleSpawn = 2.75f;
         }
     }
@@ -956,105 +960,58 @@ void HexagonGame::updateParticles(ssvu::FT mFT)
 
 void HexagonGame::updateTrailParticles(ssvu::FT mFT)
 {
-    SSVOH_ASSERT(window != nullptr);
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateTrailParticles");
 
-    const auto isDead = [&](const TrailParticle& p)
-    { return p.sprite.getColor().a <= 3; };
+    SSVOH_ASSERT(window != nullptr);
 
     const auto makeTrailParticle = [this]
     {
-        TrailParticle p;
-
-        SSVOH_ASSERT(txSmallCircle != nullptr);
-        p.sprite.setTexture(*txSmallCircle);
-        p.sprite.setPosition(player.getPosition());
-        p.sprite.setOrigin(sf::Vector2f{txSmallCircle->getSize()} / 2.f);
-
-        const float scale = Config::getPlayerTrailScale();
-        p.sprite.setScale({scale, scale});
-
-        sf::Color c = getColorPlayerTrail();
-
-        c.a = Config::getPlayerTrailAlpha();
-        p.sprite.setColor(c);
-
-        p.angle = player.getPlayerAngle();
-
-        return p;
+        return Utils::ParticleSpawnData{.position{player.getPosition()},
+            .velocity{0.f, 0.f},
+            .angle{player.getPlayerAngle()},
+            .angularVelocity{0.f},
+            .scale{Config::getPlayerTrailScale()},
+            .alpha{static_cast<float>(
+                static_cast<sf::Uint8>(Config::getPlayerTrailAlpha()))},
+            .color{getColorPlayerTrail()}};
     };
 
-    ssvu::eraseRemoveIf(trailParticles, isDead);
-
-    for(TrailParticle& p : trailParticles)
-    {
-        sf::Color color = p.sprite.getColor();
-
-        const float newAlpha = Utils::getMoveTowardsZero(
-            static_cast<float>(color.a), Config::getPlayerTrailDecay() * mFT);
-
-        color.a = static_cast<sf::Uint8>(newAlpha);
-        p.sprite.setColor(color);
-
-        p.sprite.setScale(p.sprite.getScale() * 0.98f);
-
-        p.sprite.setPosition(
-            ssvs::getVecFromRad(p.angle, status.radius + 2.4f));
-    }
+    trailParticles.eraseFaded(3.f);
+    trailParticles.fade(Config::getPlayerTrailDecay() * mFT);
+    trailParticles.multiplyScale(0.98f);
+    trailParticles.placeOnCircle(status.radius + 2.4f);
 
     if(player.hasChangedAngle())
     {
-        trailParticles.emplace_back(makeTrailParticle());
+        trailParticles.spawn(makeTrailParticle());
     }
 }
 
 void HexagonGame::updateSwapParticles(ssvu::FT mFT)
 {
-    SSVOH_ASSERT(window != nullptr);
+    SSVOH_PROFILE_SCOPE("HexagonGame::updateSwapParticles");
 
-    const auto isDead = [&](const SwapParticle& p)
-    { return p.sprite.getColor().a <= 3; };
+    SSVOH_ASSERT(window != nullptr);
 
     const auto makeSwapParticle = [this](const SwapParticleSpawnInfo& si,
                                       const float expand, const float speedMult,
                                       const float scaleMult, const float alpha)
     {
-        SwapParticle p;
-
-        SSVOH_ASSERT(txSmallCircle != nullptr);
-        p.sprite.setTexture(*txSmallCircle);
-        p.sprite.setPosition(si.position);
-        p.sprite.setOrigin(sf::Vector2f{txSmallCircle->getSize()} / 2.f);
-
-        const float scale = ssvu::getRndR(0.65f, 1.35f) * scaleMult;
-        p.sprite.setScale({scale, scale});
-
-        sf::Color c = getColorPlayerTrail();
-
-        c.a = alpha;
-        p.sprite.setColor(c);
-
-        p.velocity =
-            ssvs::getVecFromRad(si.angle + ssvu::getRndR(-expand, expand),
-                ssvu::getRndR(0.1f, 10.f) * speedMult);
-
-        return p;
+        return Utils::ParticleSpawnData{.position{si.position},
+            .velocity{
+                ssvs::getVecFromRad(si.angle + ssvu::getRndR(-expand, expand),
+                    ssvu::getRndR(0.1f, 10.f) * speedMult)},
+            .angle{0.f},
+            .angularVelocity{0.f},
+            .scale{ssvu::getRndR(0.65f, 1.35f) * scaleMult},
+            .alpha{alpha},
+            .color{getColorPlayerTrail()}};
     };
 
-    ssvu::eraseRemoveIf(swapParticles, isDead);
-
-    for(SwapParticle& p : swapParticles)
-    {
-        sf::Color color = p.sprite.getColor();
-
-        const float newAlpha =
-            Utils::getMoveTowardsZero(static_cast<float>(color.a), 3.5f * mFT);
-
-        color.a = static_cast<sf::Uint8>(newAlpha);
-        p.sprite.setColor(color);
-
-        p.sprite.setScale(p.sprite.getScale() * 0.98f);
-        p.sprite.setPosition(p.sprite.getPosition() + p.velocity * mFT);
-    }
+    swapParticles.eraseFaded(3.f);
+    swapParticles.fade(3.5f * mFT);
+    swapParticles.multiplyScale(0.98f);
+    swapParticles.integrate(mFT);
 
     if(swapParticlesSpawnInfo.has_value())
     {
@@ -1062,28 +1019,25 @@ void HexagonGame::updateSwapParticles(ssvu::FT mFT)
         {
             for(int i = 0; i < 20; ++i)
             {
-                swapParticles.emplace_back(
-                    makeSwapParticle(*swapParticlesSpawnInfo,
-                        0.45f /* expand */, 1.f /* speedMult */,
-                        1.f /* scaleMult */, 45.f /* alpha */));
+                swapParticles.spawn(makeSwapParticle(*swapParticlesSpawnInfo,
+                    0.45f /* expand */, 1.f /* speedMult */,
+                    1.f /* scaleMult */, 45.f /* alpha */));
             }
 
             for(int i = 0; i < 10; ++i)
             {
-                swapParticles.emplace_back(
-                    makeSwapParticle(*swapParticlesSpawnInfo,
-                        3.14f /* expand */, 0.45f /* speedMult */,
-                        0.75f /* scaleMult */, 35.f /* alpha */));
+                swapParticles.spawn(makeSwapParticle(*swapParticlesSpawnInfo,
+                    3.14f /* expand */, 0.45f /* speedMult */,
+                    0.75f /* scaleMult */, 35.f /* alpha */));
             }
         }
         else
         {
             for(int i = 0; i < 14; ++i)
             {
-                swapParticles.emplace_back(
-                    makeSwapParticle(*swapParticlesSpawnInfo,
-                        3.14f /* expand */, 1.3f /* speedMult */,
-                        0.4f /* scaleMult */, 140.f /* alpha */));
+                swapParticles.spawn(makeSwapParticle(*swapParticlesSpawnInfo,
+                    3.14f /* expand */, 1.3f /* speedMult */,
+                    0.4f /* scaleMult */, 140.f /* alpha */));
             }
         }
 
@@ -1427,9 +1381,45 @@ void HexagonGame::postUpdate_ImguiLuaConsole()
 !help           Display this help
 !ff <seconds>   Fast-forward simulation to specified time
 !advt <ticks>   Advance simulation by specified number of ticks
+!luaprof <cmd>  Lua profiler: `on`, `off`, `reset` or `dump <file>`
 ?fn             Display Lua docs for function `fn`
 )");
         }
+        else if(cmdSplit.size() > 1 && cmdSplit.at(0) == "!luaprof")
+        {
+            const std::string& subCmd = cmdSplit.at(1);
+
+            if(subCmd == "on" || subCmd == "off")
+            {
+                luaProfiler.setEnabled(subCmd == "on");
+                ilcCmdLog.emplace_back(
+                    Utils::concat("[luaprof]: profiler ", subCmd, '\n'));
+            }
+            else if(subCmd == "reset")
+            {
+                luaProfiler.reset();
+                ilcCmdLog.emplace_back("[luaprof]: counters reset\n");
+            }
+            else if(subCmd == "dump" && cmdSplit.size() > 2)
+            {
+                const std::string& path = cmdSplit.at(2);
+
+                if(luaProfiler.dumpToFile(path))
+                {
+                    ilcCmdLog.emplace_back(
+                        Utils::concat("[luaprof]: written to '", path, "'\n"));
+                }
+                else
+                {
+                    ilcCmdLog.emplace_back(Utils::concat(
+                        "[error]: could not write to '", path, "'\n"));
+                }
+            }
+            else
+            {
+                ilcCmdLog.emplace_back("[error]: invalid argument for <cmd>\n");
+            }
+        }
         else if(cmdSplit.size() > 1 && cmdSplit.at(0) == "!ff")
         {
             try
@@ -1517,6 +1507,15 @@ void HexagonGame::postUpdate_ImguiLuaConsole()
     ImGui::SameLine();
     ImGui::Text("draw ms: %.2f", window->getMsDraw());
 
+    const Utils::LuaPoolAllocator::Stats& luaHeap = luaAllocator->getStats();
+    ImGui::Text("Lua heap KiB: %.1f (peak %.1f, reserved %.1f)",
+        static_cast<double>(luaHeap.bytesInUse) / 1024.0,
+        static_cast<double>(luaHeap.peakBytesInUse) / 1024.0,
+        static_cast<double>(luaHeap.bytesReserved) / 1024.0);
+    ImGui::SameLine();
+    ImGui::Text("allocs/tick: %llu",
+        static_cast<unsigned long long>(luaHeap.lastTickAllocations));
+
     static float simSpeed = Config::getTimescale();
     ImGui::DragFloat("Timescale", &simSpeed, 0.005f);
     Config::setTimescale(simSpeed);
@@ -1527,6 +1526,12 @@ void HexagonGame::postUpdate_ImguiLuaConsole()
     ImGui::Checkbox("Invincible", &invincible);
     Config::setInvincible(invincible);
 
+    ImGui::SameLine();
+
+    bool luaProfilerEnabled = luaProfiler.isEnabled();
+    ImGui::Checkbox("Lua profiler", &luaProfilerEnabled);
+    luaProfiler.setEnabled(luaProfilerEnabled);
+
     ImGui::Separator();
 
     {
@@ -1612,12 +1617,64 @@ void HexagonGame::postUpdate_ImguiLuaConsole()
         }
     }
 
+    if(luaProfiler.isEnabled() && ImGui::CollapsingHeader("Lua profiler"))
+    {
+        if(ImGui::Button("Reset"))
+        {
+            luaProfiler.reset();
+        }
+
+        if(ImGui::BeginTable("LuaProfiler", 6))
+        {
+            ImGui::TableSetupColumn("entry point");
+            ImGui::TableSetupColumn("kind");
+            ImGui::TableSetupColumn("calls");
+            ImGui::TableSetupColumn("total ms");
+            ImGui::TableSetupColumn("self ms");
+            ImGui::TableSetupColumn("avg us");
+            ImGui::TableHeadersRow();
+
+            for(const Utils::LuaProfiler::Entry& e :
+                luaProfiler.getSortedEntries())
+            {
+                ImGui::TableNextRow();
+
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(e.name.c_str());
+
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextUnformatted(Utils::luaProfilerKindToStr(e.kind));
+
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%llu", static_cast<unsigned long long>(e.calls));
+
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%.3f", static_cast<double>(e.totalNs) / 1e6);
+
+                ImGui::TableSetColumnIndex(4);
+                ImGui::Text("%.3f", static_cast<double>(e.selfNs) / 1e6);
+
+                ImGui::TableSetColumnIndex(5);
+                ImGui::Text("%.2f",
+                    static_cast<double>(e.totalNs) / 1e3 /
+                        static_cast<double>(e.calls));
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
     ImGui::End();
+
+    Profiler::drawImguiWindow();
 #endif
 }
 
 void HexagonGame::postUpdate()
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::postUpdate");
+
+    luaAllocator->markTick();
     postUpdate_ImguiLuaConsole();
 }
 
@@ -339,6 +339,25 @@ template <typename T>
     );
 }
 
+[[nodiscard]] bool HexagonClient::sendRequestLeaderboardPage(
+    const sf::Uint64 loginToken, const std::string& levelValidator,
+    const std::uint32_t offset, const std::uint32_t limit,
+    const bool aroundOwnScore, const std::uint64_t knownVersion)
+{
+    SSVOH_CLOG_VERBOSE << "Sending leaderboard page request to server...\n";
+
+    return sendEncrypted( //
+        CTSPRequestLeaderboardPage{
+            .loginToken = loginToken,         //
+            .levelValidator = levelValidator, //
+            .offset = offset,                 //
+            .limit = limit,                   //
+            .aroundOwnScore = aroundOwnScore, //
+            .knownVersion = knownVersion      //
+        }                                     //
+    );
+}
+
 [[nodiscard]] bool HexagonClient::sendStartedGame(
     const sf::Uint64 loginToken, const std::string& levelValidator)
 {
@@ -747,6 +766,26 @@ bool HexagonClient::receiveDataFromServer(sf::Packet& p)
             return true;
         },
 
+        [&](const STCPLeaderboardPage& stcp)
+        {
+            SSVOH_CLOG << "Received leaderboard page from server, "
+                          "levelValidator: '"
+                       << stcp.levelValidator << "', changed: '"
+                       << stcp.scores.size() << "'\n";
+
+            addEvent(EReceivedLeaderboardPage{
+                .levelValidator = stcp.levelValidator, //
+                .version = stcp.version,               //
+                .baseVersion = stcp.baseVersion,       //
+                .offset = stcp.offset,                 //
+                .size = stcp.size,                     //
+                .scores = stcp.scores,                 //
+                .ownScore = stcp.ownScore              //
+            });
+
+            return true;
+        },
+
         [&](const STCPServerStatus& stcp)
         {
             SSVOH_CLOG << "Received server status from server\n";
@@ -935,6 +974,21 @@ bool HexagonClient::tryRequestTopScoresAndOwnScore(
     return sendRequestTopScoresAndOwnScore(_loginToken.value(), levelValidator);
 }
 
+bool HexagonClient::tryRequestLeaderboardPage(
+    const std::string& levelValidator, const std::uint32_t offset,
+    const std::uint32_t limit, const bool aroundOwnScore,
+    const std::uint64_t knownVersion)
+{
+    if(!connectedAndInState(State::LoggedIn_Ready))
+    {
+        return fail();
+    }
+
+    SSVOH_ASSERT(_loginToken.has_value());
+    return sendRequestLeaderboardPage(_loginToken.value(), levelValidator,
+        offset, limit, aroundOwnScore, knownVersion);
+}
+
 bool HexagonClient::trySendStartedGame(const std::string& levelValidator)
 {
     if(!connectedAndInState(State::LoggedIn_Ready))
@@ -11,6 +11,7 @@
 #include "SSVOpenHexagon/Global/Audio.hpp"
 #include "SSVOpenHexagon/Global/Config.hpp"
 #include "SSVOpenHexagon/Global/Imgui.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 
 #include "SSVOpenHexagon/Core/HexagonClient.hpp"
 #include "SSVOpenHexagon/Core/Joystick.hpp"
@@ -34,8 +35,11 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <cstddef>
+#include <utility>
 
 namespace hg {
 
@@ -59,6 +63,14 @@ namespace {
     return random_number_generator{seed_rng()};
 }
 
+[[nodiscard]] Lua::LuaContext::InstructionBudget makeLuaInstructionBudget(
+    const LevelData& levelData, const Lua::LuaContext::InstructionBudget& limit)
+{
+    return {.perCall = std::min(levelData.luaInstructionBudgetPerCall,
+                limit.perCall),
+        .total = std::min(levelData.luaInstructionBudgetTotal, limit.total)};
+}
+
 } // namespace
 
 HexagonGame::ActiveReplay::ActiveReplay(const replay_file& mReplayFile)
@@ -73,6 +85,11 @@ void HexagonGame::createWall(int mSide, float mThickness,
         levelStatus.wallSpawnDistance, mSpeed, mCurve, mHueMod);
 }
 
+[[nodiscard]] bool HexagonGame::isLuaInstructionBudgetExceeded() const noexcept
+{
+    return lua.isInstructionBudgetExceeded();
+}
+
 void HexagonGame::setMustStart(const bool x)
 {
     mustStart = x;
@@ -537,6 +554,8 @@ void HexagonGame::playPackSoundOverride(
 void HexagonGame::newGame(const std::string& mPackId, const std::string& mId,
     bool mFirstPlay, float mDifficultyMult, bool executeLastReplay)
 {
+    SSVOH_PROFILE_SCOPE("HexagonGame::newGame");
+
     SSVOH_ASSERT(assets.isValidPackId(mPackId));
     SSVOH_ASSERT(assets.isValidLevelId(mId));
 
@@ -700,9 +719,28 @@ void HexagonGame::newGame(const std::string& mPackId, const std::string& mId,
     inputImplCCW = inputImplCW = false;
     playerNowReadyToSwap = false;
 
-    lua = Lua::LuaContext{};
+    // Close the previous state before creating the new one, so that a level
+    // that needed a lot of memory does not keep it for the whole session.
+    {
+        const Lua::LuaContext closed{std::move(lua)};
+    }
+
+    if(luaAllocator->getStats().bytesInUse == 0)
+    {
+        constexpr std::size_t luaRetainedBytes = 2 * 1024 * 1024;
+        luaAllocator->trim(luaRetainedBytes);
+    }
+
+    lua = Lua::LuaContext{luaAllocator};
+    lua.setProfiler(&luaProfiler);
     calledDeprecatedFunctions.clear();
     initLua();
+
+    if(luaInstructionBudgetLimit.has_value())
+    {
+        lua.setInstructionBudget(makeLuaInstructionBudget(
+            *levelData, *luaInstructionBudgetLimit));
+    }
     runLuaFile(levelData->luaScriptPath);
 
     if(!firstPlay)
@@ -1053,6 +1091,14 @@ void HexagonGame::death_sendAndSaveReplay(const replay_file& rf)
     return true;
 }
 
+void HexagonGame::executeTick(const float timescale)
+{
+    update(Config::TIME_STEP, timescale);
+    postUpdate();
+
+    SSVOH_PROFILE_FRAME();
+}
+
 [[nodiscard]] std::optional<HexagonGame::GameExecutionResult>
 HexagonGame::executeGameUntilDeath(
     const int maxProcessingSeconds, const float timescale)
@@ -1062,22 +1108,32 @@ HexagonGame::executeGameUntilDeath(
     const auto exceededProcessingTime = [&]
     { return hrSecondsSince(tpBegin) > maxProcessingSeconds; };
 
+    std::uint64_t ticks = 0;
+
     while(!status.hasDied)
     {
-        update(Config::TIME_STEP, timescale);
-        postUpdate();
+        executeTick(timescale);
+        ++ticks;
 
-        if(exceededProcessingTime())
+        if(exceededProcessingTime() || isLuaInstructionBudgetExceeded())
         {
             return std::nullopt;
         }
     }
 
+    // The budget might have been exceeded by a script that then killed the
+    // player, the result would not be meaningful.
+    if(isLuaInstructionBudgetExceeded())
+    {
+        return std::nullopt;
+    }
+
     return GameExecutionResult{
         .playedTimeSeconds = status.getPlayedAccumulatedFrametimeInSeconds(), //
         .pausedTimeSeconds = status.getPausedAccumulatedFrametimeInSeconds(), //
         .totalTimeSeconds = status.getTotalAccumulatedFrametimeInSeconds(),   //
-        .customScore = status.getCustomScore()                                //
+        .customScore = status.getCustomScore(),                               //
+        .ticks = ticks                                                        //
     };
 }
 
@@ -7,11 +7,13 @@
 #include "SSVOpenHexagon/Global/Assert.hpp"
 #include "SSVOpenHexagon/Global/Assets.hpp"
 #include "SSVOpenHexagon/Global/Config.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 #include "SSVOpenHexagon/Global/Version.hpp"
 
 #include "SSVOpenHexagon/Core/HexagonGame.hpp"
 #include "SSVOpenHexagon/Core/Replay.hpp"
 
+#include "SSVOpenHexagon/Utils/Clock.hpp"
 #include "SSVOpenHexagon/Utils/Concat.hpp"
 #include "SSVOpenHexagon/Utils/LevelValidator.hpp"
 #include "SSVOpenHexagon/Utils/Match.hpp"
@@ -22,6 +24,7 @@
 
 #include "SSVOpenHexagon/Online/Shared.hpp"
 #include "SSVOpenHexagon/Online/Database.hpp"
+#include "SSVOpenHexagon/Online/LeaderboardDelta.hpp"
 #include "SSVOpenHexagon/Online/Sodium.hpp"
 
 #include <SSVUtils/Core/Log/Log.hpp>
@@ -30,15 +33,21 @@
 
 #include <boost/pfr.hpp>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <csignal>
+#include <cstddef>
 #include <cstdlib>
+#include <iomanip>
 #include <optional>
 #include <cstdio>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <stdexcept>
+#include <variant>
 
 static auto& slog(const char* funcName)
 {
@@ -56,6 +65,33 @@ static auto& slog(const char* funcName)
 
 namespace hg {
 
+namespace {
+
+// Largest packet a client is allowed to send, bigger frames are treated as
+// malicious and cause a disconnection.
+constexpr std::size_t maxClientPacketSize = 1024 * 1024;
+
+// Maximum amount of data read from a single client per server iteration, so
+// that one fast sender cannot starve the others.
+constexpr std::size_t maxReceivedBytesPerIteration = 64 * 1024;
+
+// A client that does not read its data fast enough is disconnected once this
+// many bytes are queued for it.
+constexpr std::size_t maxOutgoingBytes = 1024 * 1024;
+
+// Upper bound for the Lua instruction budgets requested by levels. This is
+// what bounds the cost of replay validation: replays hitting it are rejected
+// on every machine. Even the largest budget runs in a few seconds.
+constexpr Lua::LuaContext::InstructionBudget maxLuaInstructionBudget{
+    .perCall = 20'000'000, .total = 2'000'000'000};
+
+// Fail-safe for replays that take too long despite the instruction budget,
+// e.g. because of a bug in the simulation. Hitting it is logged as an error,
+// as the result depends on the speed of the machine.
+constexpr int maxReplayProcessingSeconds = 60;
+
+} // namespace
+
 template <typename... Ts>
 [[nodiscard]] bool HexagonServer::fail(const Ts&... xs)
 {
@@ -113,16 +149,52 @@ template <typename... Ts>
     return true;
 }
 
-[[nodiscard]] bool HexagonServer::sendPacket(ConnectedClient& c, sf::Packet& p)
+[[nodiscard]] bool HexagonServer::initializeDatabase()
 {
-    if(c._socket.send(p) != sf::Socket::Status::Done)
+    SSVOH_SLOG << "Initializing database...\n";
+
+    try
     {
-        return fail("Failure sending packet");
+        Database::initialize();
+    }
+    catch(const std::exception& e)
+    {
+        return fail("Failure initializing database: '", e.what(), '\'');
     }
 
     return true;
 }
 
+[[nodiscard]] bool HexagonServer::sendPacket(ConnectedClient& c, sf::Packet& p)
+{
+    c._outgoing.push(p);
+
+    if(c._outgoing.getPendingBytes() > maxOutgoingBytes)
+    {
+        c._mustDisconnect = true;
+
+        return fail("Too much pending outgoing data for client '",
+            static_cast<void*>(&c), '\'');
+    }
+
+    return flushOutgoing(c);
+}
+
+[[nodiscard]] bool HexagonServer::flushOutgoing(ConnectedClient& c)
+{
+    const sf::Socket::Status status = c._outgoing.flushTo(c._socket);
+
+    if(status == sf::Socket::Status::Done ||
+        status == sf::Socket::Status::NotReady)
+    {
+        // Whatever could not be sent yet is retried on the next iteration.
+        return true;
+    }
+
+    c._mustDisconnect = true;
+    return fail("Failure sending packet");
+}
+
 template <typename T>
 [[nodiscard]] bool HexagonServer::sendEncrypted(
     ConnectedClient& c, const T& data)
@@ -259,6 +331,26 @@ template <typename T>
     );
 }
 
+[[nodiscard]] bool HexagonServer::sendLeaderboardPage(ConnectedClient& c,
+    const std::string& levelValidator, const std::uint64_t version,
+    const std::uint64_t baseVersion, const std::uint32_t offset,
+    const std::uint32_t size,
+    const std::vector<Database::ProcessedScore>& scores,
+    const std::optional<Database::ProcessedScore>& ownScore)
+{
+    return sendEncrypted(c, //
+        STCPLeaderboardPage{
+            .levelValidator = levelValidator, //
+            .version = version,               //
+            .baseVersion = baseVersion,       //
+            .offset = offset,                 //
+            .size = size,                     //
+            .scores = scores,                 //
+            .ownScore = ownScore              //
+        }                                     //
+    );
+}
+
 void HexagonServer::kickAndRemoveClient(ConnectedClient& c)
 {
     (void)sendKick(c);
@@ -278,6 +370,7 @@ void HexagonServer::run()
         try
         {
             runIteration();
+            SSVOH_PROFILE_FRAME();
         }
         catch(const std::runtime_error& e)
         {
@@ -294,7 +387,37 @@ void HexagonServer::runIteration()
 {
     SSVOH_SLOG_VERBOSE << "New iteration...\n";
 
-    if(_socketSelector.wait(sf::seconds(30)))
+    // Wake up quickly while there are scores waiting to be committed, so that
+    // they are not held back by an idle selector.
+    sf::Time selectorTimeout = Database::getPendingScoreCount() > 0
+                                   ? sf::milliseconds(10)
+                                   : sf::seconds(30);
+
+    // The selector only reports readability, poll while some clients have
+    // not yet accepted all their outgoing data.
+    for(const ConnectedClient& c : _connectedClients)
+    {
+        if(!c._outgoing.empty())
+        {
+            selectorTimeout = std::min(selectorTimeout, sf::milliseconds(5));
+            break;
+        }
+    }
+
+    if(_metricsDumpInterval.has_value())
+    {
+        selectorTimeout = std::min(selectorTimeout,
+            sf::seconds(static_cast<float>(_metricsDumpInterval->count())));
+    }
+
+    const bool anyReady = _socketSelector.wait(selectorTimeout);
+
+    // Only the work done after waking up is measured, time spent idle in the
+    // selector is not interesting.
+    const Utils::ScopedLatency iterationLatency{_metrics._iterationHistogram};
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration");
+
+    if(anyReady)
     {
         // A timeout is specified so that we can purge clients even if we didn't
         // receive anything.
@@ -304,13 +427,18 @@ void HexagonServer::runIteration()
         runIteration_LoopOverSockets();
     }
 
+    runIteration_FlushOutgoing();
     runIteration_PurgeClients();
     runIteration_PurgeTokens();
+    runIteration_FlushScores();
     runIteration_FlushLogs();
+    runIteration_DumpMetrics();
 }
 
 bool HexagonServer::runIteration_Control()
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_Control");
+
     if(!_socketSelector.isReady(_controlSocket))
     {
         return fail();
@@ -374,6 +502,69 @@ bool HexagonServer::runIteration_Control()
         }
     }
 
+    if(splitted[0] == "stats")
+    {
+        if(splitted.size() == 1)
+        {
+            std::ostringstream oss;
+            printMetrics(oss);
+
+            const std::string stats = oss.str();
+            SSVOH_SLOG << "Server stats:\n" << stats;
+
+            // Reply to the sender, so that the stats can be read by tools
+            // instead of being scraped from the log.
+            _packetBuffer.clear();
+            _packetBuffer << stats;
+
+            if(_controlSocket.send(_packetBuffer, senderIp, senderPort) !=
+                sf::Socket::Status::Done)
+            {
+                SSVOH_SLOG_ERROR << "Failure sending stats reply to '"
+                                 << senderIp << ':' << senderPort << "'\n";
+            }
+
+            return true;
+        }
+
+        if(splitted[1] == "reset" && splitted.size() == 2)
+        {
+            SSVOH_SLOG << "Reset stats\n";
+
+            _metrics.reset();
+            Database::resetQueryStats();
+            return true;
+        }
+
+        if(splitted[1] == "dump" && splitted.size() == 3)
+        {
+            if(splitted[2] == "off")
+            {
+                SSVOH_SLOG << "Disabled periodic stats dump\n";
+
+                _metricsDumpInterval.reset();
+                return true;
+            }
+
+            const int seconds = std::atoi(splitted[2].c_str());
+
+            if(seconds > 0)
+            {
+                SSVOH_SLOG << "Dumping stats every " << seconds
+                           << " second(s)\n";
+
+                _metricsDumpInterval.emplace(seconds);
+                _lastMetricsDump = Utils::SCClock::now();
+                return true;
+            }
+        }
+
+        SSVOH_SLOG_ERROR << "'stats' command must be followed by nothing, "
+                            "'reset', or 'dump <seconds|off>'\n";
+
+        return true;
+    }
+
 // TODO (P1): conditionally enable in debug mode
 #if 0
     if(splitted[0] == "db")
@@ -418,6 +609,8 @@ bool HexagonServer::runIteration_Control()
 
 bool HexagonServer::runIteration_TryAcceptingNewClient()
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_TryAcceptingNewClient");
+
     if(!_socketSelector.isReady(_listener))
     {
         return false;
@@ -425,8 +618,8 @@ bool HexagonServer::runIteration_TryAcceptingNewClient()
 
     SSVOH_SLOG << "Listener is ready, attempting to accept new client\n";
 
-    ConnectedClient& potentialClient =
-        _connectedClients.emplace_back(Utils::SCClock::now());
+    ConnectedClient& potentialClient = _connectedClients.emplace_back(
+        Utils::SCClock::now(), maxClientPacketSize);
 
     sf::TcpSocket& potentialSocket = potentialClient._socket;
     potentialSocket.setBlocking(true);
@@ -450,6 +643,10 @@ bool HexagonServer::runIteration_TryAcceptingNewClient()
 
     potentialClient._state = ConnectedClient::State::Connected;
 
+    // From now on the client is only ever read from and written to without
+    // blocking, see `runIteration_LoopOverSockets` and `flushOutgoing`.
+    potentialSocket.setBlocking(false);
+
     // Add the new client to the selector so that we will be notified when he
     // sends something
     _socketSelector.add(potentialSocket);
@@ -458,6 +655,8 @@ bool HexagonServer::runIteration_TryAcceptingNewClient()
 
 void HexagonServer::runIteration_LoopOverSockets()
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_LoopOverSockets");
+
     for(auto it = _connectedClients.begin(); it != _connectedClients.end();
         ++it)
     {
@@ -472,45 +671,103 @@ void HexagonServer::runIteration_LoopOverSockets()
 
         SSVOH_SLOG_VERBOSE << "Client '" << clientAddr << "' has sent data\n ";
 
-        // The client has sent some data, we can receive it
-        _packetBuffer.clear();
+        // The client has sent some data, we can receive it without blocking.
+        // Partial packets are kept in the client's buffer until completed.
+        const sf::Socket::Status receiveStatus =
+            connectedClient._incoming.receiveFrom(
+                clientSocket, maxReceivedBytesPerIteration);
 
-        // TODO (P1): potential hanging spot?
-        if(clientSocket.receive(_packetBuffer) == sf::Socket::Done)
+        if(!runIteration_ProcessReceivedPackets(connectedClient))
         {
-            SSVOH_SLOG_VERBOSE << "Successfully received data from client '"
-                               << clientAddr << "'\n";
+            SSVOH_SLOG << "Removing misbehaving client '" << clientAddr
+                       << "' from list\n";
 
-            if(processPacket(connectedClient, _packetBuffer))
-            {
-                connectedClient._lastActivity = Utils::SCClock::now();
-                connectedClient._consecutiveFailures = 0;
+            kickAndRemoveClient(connectedClient);
+            it = _connectedClients.erase(it);
+            continue;
+        }
 
-                continue;
-            }
+        if(receiveStatus != sf::Socket::Status::Done)
+        {
+            SSVOH_SLOG << "Client '" << clientAddr
+                       << "' connection lost or errored\n";
+
+            connectedClient._mustDisconnect = true;
+        }
+    }
+}
+
+[[nodiscard]] bool HexagonServer::runIteration_ProcessReceivedPackets(
+    ConnectedClient& c)
+{
+    const void* clientAddr = static_cast<void*>(&c);
+
+    while(!c._mustDisconnect)
+    {
+        const IncomingFrameBuffer::ExtractResult extractResult =
+            c._incoming.extract(_packetBuffer);
+
+        if(extractResult == IncomingFrameBuffer::ExtractResult::NoPacket)
+        {
+            return true;
+        }
+
+        if(extractResult == IncomingFrameBuffer::ExtractResult::Oversized)
+        {
+            SSVOH_SLOG << "Client '" << clientAddr
+                       << "' sent an oversized packet\n";
+
+            return false;
+        }
+
+        SSVOH_SLOG_VERBOSE << "Successfully received packet from client '"
+                           << clientAddr << "'\n";
+
+        if(processPacket(c, _packetBuffer))
+        {
+            c._lastActivity = Utils::SCClock::now();
+            c._consecutiveFailures = 0;
+
+            continue;
         }
 
-        // Failed to receive data
-        SSVOH_SLOG_VERBOSE << "Failed to receive data from client '"
+        // Failed to process packet
+        SSVOH_SLOG_VERBOSE << "Failed to process packet from client '"
                            << clientAddr << "' (consecutive failures: "
-                           << connectedClient._consecutiveFailures << ")\n";
+                           << c._consecutiveFailures << ")\n";
 
-        ++connectedClient._consecutiveFailures;
+        ++c._consecutiveFailures;
 
         constexpr int maxConsecutiveFailures = 5;
-        if(connectedClient._consecutiveFailures == maxConsecutiveFailures)
+        if(c._consecutiveFailures == maxConsecutiveFailures)
         {
             SSVOH_SLOG << "Too many consecutive failures for client '"
-                       << clientAddr << "', removing from list\n";
+                       << clientAddr << "'\n";
 
-            kickAndRemoveClient(connectedClient);
-            it = _connectedClients.erase(it);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void HexagonServer::runIteration_FlushOutgoing()
+{
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_FlushOutgoing");
+
+    for(ConnectedClient& c : _connectedClients)
+    {
+        if(!c._outgoing.empty())
+        {
+            (void)flushOutgoing(c);
         }
     }
 }
 
 void HexagonServer::runIteration_PurgeClients()
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_PurgeClients");
+
     constexpr std::chrono::duration maxInactivity = std::chrono::seconds(60);
 
     const Utils::SCTimePoint now = Utils::SCClock::now();
@@ -558,6 +815,8 @@ template <typename TDuration>
 
 void HexagonServer::runIteration_PurgeTokens()
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_PurgeTokens");
+
     if(!checkAndUpdateLastElapsed(
            _lastTokenPurge, std::chrono::seconds(3600) /* 1 hour */))
     {
@@ -597,6 +856,8 @@ void HexagonServer::runIteration_PurgeTokens()
 
 void HexagonServer::runIteration_FlushLogs()
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_FlushLogs");
+
     if(!checkAndUpdateLastElapsed(_lastLogsFlush, std::chrono::seconds(1)))
     {
         return;
@@ -607,6 +868,140 @@ void HexagonServer::runIteration_FlushLogs()
     ssvu::lo().flush();
 }
 
+void HexagonServer::runIteration_FlushScores()
+{
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_FlushScores");
+
+    const std::size_t pendingScoreCount = Database::getPendingScoreCount();
+
+    if(pendingScoreCount == 0 || !Database::isPendingScoreFlushDue())
+    {
+        return;
+    }
+
+    // Group commit: pay for a single transaction per batch of scores instead
+    // of syncing the database once per validated replay.
+    constexpr std::size_t maxPendingScores = 64;
+
+    if(pendingScoreCount < maxPendingScores &&
+        !checkAndUpdateLastElapsed(
+            _lastScoresFlush, std::chrono::milliseconds(10)))
+    {
+        return;
+    }
+
+    SSVOH_SLOG_VERBOSE << "Flushing " << pendingScoreCount
+                       << " pending score(s)\n";
+
+    Database::flushPendingScores();
+    _lastScoresFlush = Utils::SCClock::now();
+}
+
+void HexagonServer::runIteration_DumpMetrics()
+{
+    SSVOH_PROFILE_SCOPE("HexagonServer::runIteration_DumpMetrics");
+
+    if(!_metricsDumpInterval.has_value() ||
+        !checkAndUpdateLastElapsed(_lastMetricsDump, *_metricsDumpInterval))
+    {
+        return;
+    }
+
+    std::ostringstream oss;
+    printMetrics(oss);
+
+    SSVOH_SLOG << "Server stats:\n" << oss.str();
+}
+
+// Names of the `PVClientToServer` alternatives, in order.
+static constexpr std::array<std::string_view,
+    std::variant_size_v<PVClientToServer>>
+    ctsPacketNames{"invalid", "encrypted msg", "heartbeat", "disconnect",
+        "public key", "register", "login", "logout", "delete account",
+        "request top scores", "replay", "request own score",
+        "request top scores and own score", "started game",
+        "compressed replay", "request server status", "ready",
+        "request leaderboard page"};
+
+// Every alternative must have a name, not only the first ones.
+static_assert(!ctsPacketNames.back().empty());
+
+void HexagonServer::Metrics::reset()
+{
+    _since = Utils::SCClock::now();
+
+    for(Utils::LatencyHistogram& h : _packetHistograms)
+    {
+        h.reset();
+    }
+
+    _decodeHistogram.reset();
+    _replayHistogram.reset();
+    _iterationHistogram.reset();
+    _replayTicks = 0;
+}
+
+void HexagonServer::printMetrics(std::ostream& os) const
+{
+    const double elapsedSecs =
+        std::chrono::duration_cast<std::chrono::duration<double>>(
+            Utils::SCClock::now() - _metrics._since)
+            .count();
+
+    std::array<std::size_t, 4> clientsByState{};
+
+    for(const ConnectedClient& c : _connectedClients)
+    {
+        ++clientsByState[static_cast<std::size_t>(c._state)];
+    }
+
+    os << std::fixed << std::setprecision(1) << "Uptime (since reset): "
+       << elapsedSecs << "s\n"
+       << "Clients: " << _connectedClients.size() << " (connected "
+       << clientsByState[1] << ", logged in " << clientsByState[2]
+       << ", ready " << clientsByState[3] << ")\n"
+       << "Pending scores: " << Database::getPendingScoreCount() << "\n\n";
+
+    const auto printRate = [&](const Utils::LatencyHistogram& h)
+    {
+        os << "  " << std::setprecision(2)
+           << (elapsedSecs > 0.0 ? h.getCount() / elapsedSecs : 0.0)
+           << " per second\n";
+    };
+
+    os << "Packets:\n";
+
+    for(std::size_t i = 0; i < Metrics::packetTypeCount; ++i)
+    {
+        const Utils::LatencyHistogram& h = _metrics._packetHistograms[i];
+
+        if(h.getCount() > 0)
+        {
+            h.print(os, ctsPacketNames[i]);
+        }
+    }
+
+    os << "\nDecoding (including decryption):\n";
+    _metrics._decodeHistogram.print(os, "decode");
+    printRate(_metrics._decodeHistogram);
+
+    const double replaySecs =
+        static_cast<double>(_metrics._replayHistogram.getTotalUs()) / 1e6;
+
+    os << "\nReplay validation:\n";
+    _metrics._replayHistogram.print(os, "replay");
+    os << "  " << _metrics._replayTicks << " ticks simulated, "
+       << std::setprecision(0)
+       << (replaySecs > 0.0 ? _metrics._replayTicks / replaySecs : 0.0)
+       << " ticks per second\n";
+
+    os << "\nServer loop (excluding idle wait):\n";
+    _metrics._iterationHistogram.print(os, "iteration");
+
+    os << "\nDatabase:\n";
+    Database::printQueryStats(os);
+}
+
 [[nodiscard]] bool HexagonServer::validateLogin(
     ConnectedClient& c, const char* context, const sf::Uint64 ctspLoginToken)
 {
@@ -636,6 +1031,8 @@ void HexagonServer::runIteration_FlushLogs()
 [[nodiscard]] bool HexagonServer::processReplay(
     ConnectedClient& c, const sf::Uint64 loginToken, const replay_file& rf)
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::processReplay");
+
     const void* clientAddr = static_cast<void*>(&c);
 
     const Utils::SCTimePoint receiveTime = Utils::SCClock::now();
@@ -681,15 +1078,30 @@ void HexagonServer::runIteration_FlushLogs()
     SSVOH_SLOG << "Processing replay from client '" << clientAddr
                << "' for level '" << levelValidator << "'\n";
 
+    const HRTimePoint replayStart = HRClock::now();
+
     const std::optional<HexagonGame::GameExecutionResult> ger =
         _hexagonGame.runReplayUntilDeathAndGetScore(
-            rf, 5 /* maxProcessingSeconds */, 1.f /* timescale */);
+            rf, maxReplayProcessingSeconds, 1.f /* timescale */);
+
+    _metrics._replayHistogram.record(HRClock::now() - replayStart);
 
     if(!ger.has_value())
     {
+        if(_hexagonGame.isLuaInstructionBudgetExceeded())
+        {
+            return discard("Lua instruction budget exceeded");
+        }
+
+        SSVOH_SLOG_ERROR << "Replay for level '" << levelValidator
+                         << "' hit the processing time fail-safe of "
+                         << maxReplayProcessingSeconds << "s\n";
+
         return discard("max processing time exceeded");
     }
 
+    _metrics._replayTicks += ger->ticks;
+
     const double replayTotalTime = ger->totalTimeSeconds;
     const double replayPlayedTime = ger->playedTimeSeconds;
 
@@ -733,6 +1145,131 @@ void HexagonServer::runIteration_FlushLogs()
     return true;
 }
 
+// Versions sent to clients identify both the scores of the level and the
+// page, so that a cached page is only reused for the same page request.
+[[nodiscard]] static std::uint64_t makeLeaderboardPageVersion(
+    const std::uint64_t levelVersion, const std::uint32_t offset,
+    const std::uint32_t limit) noexcept
+{
+    std::uint64_t x = levelVersion ^
+                      (((std::uint64_t{offset} << 32) | limit) *
+                          0x9E3779B97F4A7C15ull);
+
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    x ^= x >> 31;
+
+    // Zero means that the client has no cached page.
+    return x == 0 ? 1 : x;
+}
+
+[[nodiscard]] bool HexagonServer::processLeaderboardPageRequest(
+    ConnectedClient& c, const CTSPRequestLeaderboardPage& ctsp)
+{
+    const void* clientAddr = static_cast<void*>(&c);
+
+    const std::string& lv = ctsp.levelValidator;
+    const std::uint32_t limit = std::min(ctsp.limit, maxLeaderboardPageLimit);
+
+    std::optional<Database::ProcessedScore> ownScore;
+    bool ownScoreQueried = false;
+
+    const auto queryOwnScore = [&]
+    {
+        if(!ownScoreQueried)
+        {
+            ownScore = Database::getScore(lv, c._loginData->_steamId);
+            ownScoreQueried = true;
+        }
+    };
+
+    std::uint32_t offset = ctsp.offset;
+
+    if(ctsp.aroundOwnScore)
+    {
+        queryOwnScore();
+
+        if(ownScore.has_value())
+        {
+            offset =
+                ownScore->position - std::min(ownScore->position, limit / 2);
+        }
+    }
+
+    const std::uint64_t version = makeLeaderboardPageVersion(
+        Database::getLeaderboardVersion(lv), offset, limit);
+
+    // No score of the level changed since the client cached this very page,
+    // so neither did the page nor the own score.
+    if(ctsp.knownVersion == version)
+    {
+        SSVOH_SLOG_VERBOSE << "Leaderboard page unchanged for client '"
+                           << clientAddr << "'\n";
+
+        return sendLeaderboardPage(
+            c, lv, version, version, offset, 0, {}, std::nullopt);
+    }
+
+    queryOwnScore();
+
+    std::vector<LeaderboardPageSnapshot>& snapshots = _leaderboardSnapshots[lv];
+
+    // Page versions already identify the offset and limit, they are compared
+    // again to rule out collisions.
+    const auto findSnapshot =
+        [&](const std::uint64_t v) -> const LeaderboardPageSnapshot*
+    {
+        for(const LeaderboardPageSnapshot& s : snapshots)
+        {
+            if(s._version == v && s._offset == offset && s._limit == limit)
+            {
+                return &s;
+            }
+        }
+
+        return nullptr;
+    };
+
+    if(findSnapshot(version) == nullptr)
+    {
+        if(snapshots.size() == maxLeaderboardSnapshotsPerLevel)
+        {
+            snapshots.erase(snapshots.begin());
+        }
+
+        snapshots.push_back(LeaderboardPageSnapshot{
+            ._version = version,
+            ._offset = offset,
+            ._limit = limit,
+            ._scores = Database::getScoresPage(offset, limit, lv)});
+    }
+
+    const LeaderboardPageSnapshot& current = *findSnapshot(version);
+    const auto size = static_cast<std::uint32_t>(current._scores.size());
+
+    const LeaderboardPageSnapshot* base =
+        ctsp.knownVersion == 0 ? nullptr : findSnapshot(ctsp.knownVersion);
+
+    if(base == nullptr)
+    {
+        SSVOH_SLOG_VERBOSE << "Sending leaderboard page of " << size
+                           << " scores to client '" << clientAddr << "'\n";
+
+        return sendLeaderboardPage(
+            c, lv, version, 0, offset, size, current._scores, ownScore);
+    }
+
+    const std::vector<Database::ProcessedScore> changed =
+        diffScores(base->_scores, current._scores);
+
+    SSVOH_SLOG_VERBOSE << "Sending " << changed.size()
+                       << " changed leaderboard scores to client '"
+                       << clientAddr << "'\n";
+
+    return sendLeaderboardPage(
+        c, lv, version, base->_version, offset, size, changed, ownScore);
+}
+
 template <typename T>
 void HexagonServer::printCTSPDataVerbose(
     ConnectedClient& c, const char* title, const T& ctsp)
@@ -797,14 +1334,24 @@ void HexagonServer::printCTSPDataVerbose(
 [[nodiscard]] bool HexagonServer::processPacket(
     ConnectedClient& c, sf::Packet& p)
 {
+    SSVOH_PROFILE_SCOPE("HexagonServer::processPacket");
+
     const void* clientAddr = static_cast<void*>(&c);
 
     constexpr int topScoresLimit = 6;
 
     _errorOss.str("");
+
+    const HRTimePoint decodeStart = HRClock::now();
+
     const PVClientToServer pv = decodeClientToServerPacket(
         c._rtKeys.has_value() ? &c._rtKeys->keyReceive : nullptr, _errorOss, p);
 
+    _metrics._decodeHistogram.record(HRClock::now() - decodeStart);
+
+    const Utils::ScopedLatency packetLatency{
+        _metrics._packetHistograms[pv.index()]};
+
     const auto checkState = [&](const ConnectedClient::State state)
     {
         if(c._state != state)
@@ -1278,6 +1825,24 @@ void HexagonServer::printCTSPDataVerbose(
 
             c._state = ConnectedClient::State::LoggedIn_Ready;
             return true;
+        },
+
+        [&](const CTSPRequestLeaderboardPage& ctsp)
+        {
+            printCTSPDataVerbose(c, "request leaderboard page", ctsp);
+
+            if(!checkState(ConnectedClient::State::LoggedIn_Ready) ||
+                !validateLogin(c, "leaderboard page", ctsp.loginToken))
+            {
+                return true;
+            }
+
+            if(!isLevelSupported(ctsp.levelValidator))
+            {
+                return true;
+            }
+
+            return processLeaderboardPageRequest(c, ctsp);
         }
 
         //
@@ -1328,8 +1893,16 @@ HexagonServer::HexagonServer(HGAssets& assets, HexagonGame& hexagonGame,
       _running{true},
       _verbose{false},
       _serverPSKeys{generateSodiumPSKeys()},
-      _lastTokenPurge{Utils::SCClock::now()}
+      _lastTokenPurge{Utils::SCClock::now()},
+      _lastLogsFlush{Utils::SCClock::now()},
+      _lastScoresFlush{Utils::SCClock::now()},
+      _metrics{},
+      _metricsDumpInterval{},
+      _lastMetricsDump{Utils::SCClock::now()}
 {
+    _metrics.reset();
+    _hexagonGame.luaInstructionBudgetLimit = maxLuaInstructionBudget;
+
     const auto sKeyPublic = sodiumKeyToString(_serverPSKeys.keyPublic);
     const auto sKeySecret = sodiumKeyToString(_serverPSKeys.keySecret);
 
@@ -1369,6 +1942,12 @@ HexagonServer::HexagonServer(HGAssets& assets, HexagonGame& hexagonGame,
         return;
     }
 
+    if(!initializeDatabase())
+    {
+        SSVOH_SLOG_INIT_ERROR << "Database could not be initialized\n";
+        return;
+    }
+
 #undef SSVOH_SLOG_INIT_ERROR
 
     // ------------------------------------------------------------------------
@@ -1408,6 +1987,19 @@ HexagonServer::~HexagonServer()
 {
     SSVOH_SLOG << "Uninitializing server...\n";
 
+    try
+    {
+        SSVOH_SLOG << "Flushing " << Database::getPendingScoreCount()
+                   << " pending score(s)\n";
+
+        Database::flushPendingScores();
+    }
+    catch(const std::exception& e)
+    {
+        SSVOH_SLOG_ERROR << "Failed to flush pending scores: '" << e.what()
+                         << "'\n";
+    }
+
     for(ConnectedClient& connectedClient : _connectedClients)
     {
         connectedClient._socket.setBlocking(true);
@@ -6,21 +6,98 @@
 
 #include "SSVOpenHexagon/Global/Assert.hpp"
 
+#include "SSVOpenHexagon/Online/LeaderboardDelta.hpp"
+
+#include "SSVOpenHexagon/SSVUtilsJson/SSVUtilsJson.hpp"
+
+#include "SSVOpenHexagon/Utils/Concat.hpp"
+#include "SSVOpenHexagon/Utils/Timestamp.hpp"
+
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace hg {
 
+[[nodiscard]] static LeaderboardCache::FormattedScore formatScore(
+    const Database::ProcessedScore& ps)
+{
+    std::ostringstream score;
+    score << static_cast<float>(ps.scoreValue) << 's';
+
+    std::string userName = ps.userName;
+    if(userName.size() > 19)
+    {
+        userName.resize(16);
+        userName += "...";
+    }
+
+    return LeaderboardCache::FormattedScore{
+        .timestamp = Utils::formatTimepoint(
+            Utils::toTimepoint(ps.scoreTimestamp), "%Y-%m-%d %H:%M:%S"),
+        .position = Utils::concat('#', ps.position + 1),
+        .score = score.str(),
+        .userName = std::move(userName)};
+}
+
+[[nodiscard]] static ssvuj::Obj scoreToObj(const Database::ProcessedScore& ps)
+{
+    ssvuj::Obj result;
+
+    ssvuj::arch(result, "position", ps.position);
+    ssvuj::arch(result, "user_name", ps.userName);
+    ssvuj::arch(result, "timestamp", ps.scoreTimestamp);
+    ssvuj::arch(result, "value", ps.scoreValue);
+
+    return result;
+}
+
+[[nodiscard]] static Database::ProcessedScore scoreFromObj(
+    const ssvuj::Obj& obj)
+{
+    return Database::ProcessedScore{
+        .position = ssvuj::getExtr<sf::Uint32>(obj, "position", 0),
+        .userName = ssvuj::getExtr<std::string>(obj, "user_name", ""),
+        .scoreTimestamp = ssvuj::getExtr<sf::Uint64>(obj, "timestamp", 0),
+        .scoreValue = ssvuj::getExtr<double>(obj, "value", 0.0)};
+}
+
+void LeaderboardCache::formatScores(CachedScores& cs)
+{
+    cs._formattedScores.clear();
+    cs._formattedScores.reserve(cs._scores.size());
+
+    for(const Database::ProcessedScore& ps : cs._scores)
+    {
+        cs._formattedScores.emplace_back(formatScore(ps));
+    }
+
+    if(cs._ownScore.has_value())
+    {
+        cs._formattedOwnScore = formatScore(*cs._ownScore);
+    }
+    else
+    {
+        cs._formattedOwnScore.reset();
+    }
+}
+
 void LeaderboardCache::receivedScores(const std::string& levelValidator,
     const std::vector<Database::ProcessedScore>& scores)
 {
     CachedScores& cs = _levelValidatorToScores[levelValidator];
     cs._scores = scores;
     cs._cacheTime = HRClock::now();
+    cs._receivedTimestamp = Utils::nowTimestamp();
+    cs._version = 0;
+
+    formatScores(cs);
 }
 
 void LeaderboardCache::receivedOwnScore(
@@ -28,7 +105,51 @@ void LeaderboardCache::receivedOwnScore(
 {
     CachedScores& cs = _levelValidatorToScores[levelValidator];
     cs._ownScore = score;
+    cs._formattedOwnScore = formatScore(score);
     cs._cacheTime = HRClock::now();
+    cs._receivedTimestamp = Utils::nowTimestamp();
+}
+
+void LeaderboardCache::receivedPage(const std::string& levelValidator,
+    const std::uint64_t version, const std::uint64_t baseVersion,
+    const std::uint32_t offset, const std::uint32_t size,
+    const std::vector<Database::ProcessedScore>& scores,
+    const std::optional<Database::ProcessedScore>& ownScore)
+{
+    CachedScores& cs = _levelValidatorToScores[levelValidator];
+
+    // Changes to a page that is not cached anymore, the whole page is
+    // requested again right away.
+    if(baseVersion != 0 && baseVersion != cs._version)
+    {
+        cs._version = 0;
+        cs._cacheTime = HRTimePoint{};
+        return;
+    }
+
+    cs._cacheTime = HRClock::now();
+    cs._receivedTimestamp = Utils::nowTimestamp();
+
+    if(baseVersion == version)
+    {
+        return;
+    }
+
+    if(baseVersion == 0)
+    {
+        cs._scores = scores;
+    }
+    else if(!applyScoresDiff(cs._scores, offset, size, scores))
+    {
+        cs._version = 0;
+        cs._cacheTime = HRTimePoint{};
+        return;
+    }
+
+    cs._version = version;
+    cs._ownScore = ownScore;
+
+    formatScores(cs);
 }
 
 void LeaderboardCache::requestedScores(const std::string& levelValidator)
@@ -36,6 +157,13 @@ void LeaderboardCache::requestedScores(const std::string& levelValidator)
     _levelValidatorToScores[levelValidator]._cacheTime = HRClock::now();
 }
 
+[[nodiscard]] std::uint64_t LeaderboardCache::getVersion(
+    const std::string& levelValidator) const
+{
+    const auto it = _levelValidatorToScores.find(levelValidator);
+    return it == _levelValidatorToScores.end() ? 0 : it->second._version;
+}
+
 [[nodiscard]] bool LeaderboardCache::shouldRequestScores(
     const std::string& levelValidator) const
 {
@@ -47,22 +175,38 @@ void LeaderboardCache::requestedScores(const std::string& levelValidator)
 
     const CachedScores& cs = it->second;
 
-    return (HRClock::now() - cs._cacheTime) > std::chrono::seconds(6);
+    return (HRClock::now() - cs._cacheTime) > refreshInterval;
+}
+
+[[nodiscard]] bool LeaderboardCache::shouldPrefetchScores(
+    const std::string& levelValidator) const
+{
+    const auto it = _levelValidatorToScores.find(levelValidator);
+    if(it == _levelValidatorToScores.end())
+    {
+        return true;
+    }
+
+    const CachedScores& cs = it->second;
+
+    return (HRClock::now() - cs._cacheTime) > prefetchInterval;
 }
 
-[[nodiscard]] const std::vector<Database::ProcessedScore>&
+[[nodiscard]] const std::vector<LeaderboardCache::FormattedScore>&
 LeaderboardCache::getScores(const std::string& levelValidator) const
 {
     SSVOH_ASSERT(hasInformation(levelValidator));
-    return _levelValidatorToScores.at(levelValidator)._scores;
+    return _levelValidatorToScores.at(levelValidator)._formattedScores;
 }
 
-[[nodiscard]] const Database::ProcessedScore* LeaderboardCache::getOwnScore(
-    const std::string& levelValidator) const
+[[nodiscard]] const LeaderboardCache::FormattedScore*
+LeaderboardCache::getOwnScore(const std::string& levelValidator) const
 {
     SSVOH_ASSERT(hasInformation(levelValidator));
 
-    const auto& os = _levelValidatorToScores.at(levelValidator)._ownScore;
+    const auto& os =
+        _levelValidatorToScores.at(levelValidator)._formattedOwnScore;
+
     return os.has_value() ? &*os : nullptr;
 }
 
@@ -73,4 +217,127 @@ LeaderboardCache::getScores(const std::string& levelValidator) const
            _levelValidatorToScores.end();
 }
 
+bool LeaderboardCache::loadFromFile(const std::string& path)
+{
+    if(!ssvufs::Path{path}.isFile())
+    {
+        return false;
+    }
+
+    ssvuj::Obj root;
+    if(!ssvuj::readFromFile(root, path) || !ssvuj::hasObj(root, "levels"))
+    {
+        return false;
+    }
+
+    const std::uint64_t now = Utils::nowTimestamp();
+    const auto maxAge = static_cast<std::uint64_t>(
+        std::chrono::seconds{persistedMaxAge}.count());
+
+    const ssvuj::Obj& levels = ssvuj::getObj(root, "levels");
+
+    for(auto itr = levels.begin(); itr != levels.end(); ++itr)
+    {
+        const ssvuj::Obj& level = *itr;
+
+        const auto receivedTimestamp =
+            ssvuj::getExtr<std::uint64_t>(level, "received", 0);
+
+        if(receivedTimestamp == 0 || receivedTimestamp + maxAge < now)
+        {
+            continue;
+        }
+
+        const auto [it, inserted] =
+            _levelValidatorToScores.try_emplace(ssvuj::getKey(itr));
+
+        // Scores received in this session are more recent.
+        if(!inserted)
+        {
+            continue;
+        }
+
+        CachedScores& cs = it->second;
+
+        if(ssvuj::hasObj(level, "scores"))
+        {
+            const ssvuj::Obj& scores = ssvuj::getObj(level, "scores");
+            const auto scoreCount = ssvuj::getObjSize(scores);
+
+            for(std::uint32_t i = 0; i < scoreCount; ++i)
+            {
+                cs._scores.emplace_back(
+                    scoreFromObj(ssvuj::getObj(scores, i)));
+            }
+        }
+
+        if(ssvuj::hasObj(level, "own"))
+        {
+            cs._ownScore = scoreFromObj(ssvuj::getObj(level, "own"));
+        }
+
+        formatScores(cs);
+
+        // Never requested in this session, so shown scores are refreshed.
+        cs._cacheTime = HRTimePoint{};
+        cs._receivedTimestamp = receivedTimestamp;
+        cs._version = ssvuj::getExtr<std::uint64_t>(level, "version", 0);
+    }
+
+    return true;
+}
+
+void LeaderboardCache::saveToFile(const std::string& path) const
+{
+    std::vector<const std::pair<const std::string, CachedScores>*> received;
+
+    for(const auto& p : _levelValidatorToScores)
+    {
+        if(p.second._receivedTimestamp != 0)
+        {
+            received.emplace_back(&p);
+        }
+    }
+
+    const std::size_t count = std::min(received.size(), maxPersistedLevels);
+
+    // Most recently received first.
+    std::partial_sort(received.begin(), received.begin() + count,
+        received.end(),
+        [](const auto* a, const auto* b) {
+            return a->second._receivedTimestamp >
+                   b->second._receivedTimestamp;
+        });
+
+    ssvuj::Obj levels;
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const auto& [levelValidator, cs] = *received[i];
+
+        ssvuj::Obj level;
+        ssvuj::arch(level, "received", cs._receivedTimestamp);
+        ssvuj::arch(level, "version", cs._version);
+
+        ssvuj::Obj scores;
+        for(std::size_t j = 0; j < cs._scores.size(); ++j)
+        {
+            ssvuj::arch(scores, j, scoreToObj(cs._scores[j]));
+        }
+
+        ssvuj::arch(level, "scores", scores);
+
+        if(cs._ownScore.has_value())
+        {
+            ssvuj::arch(level, "own", scoreToObj(*cs._ownScore));
+        }
+
+        ssvuj::arch(levels, levelValidator, level);
+    }
+
+    ssvuj::Obj root;
+    ssvuj::arch(root, "levels", levels);
+    ssvuj::writeToFile(root, path);
+}
+
 } // namespace hg
@@ -0,0 +1,381 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Core/LevelPreviewLoader.hpp"
+
+#include "SSVOpenHexagon/Core/LuaScripting.hpp"
+
+#include "SSVOpenHexagon/Data/LevelData.hpp"
+#include "SSVOpenHexagon/Data/PackData.hpp"
+
+#include "SSVOpenHexagon/Global/Assets.hpp"
+#include "SSVOpenHexagon/Global/Config.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
+
+#include "SSVOpenHexagon/Utils/Concat.hpp"
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
+#include "SSVOpenHexagon/Utils/Utils.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace hg {
+
+static void executeLuaFile(Lua::LuaContext& lua, const std::string& fileName)
+{
+    std::ifstream s{fileName};
+
+    if(!s)
+    {
+        throw std::runtime_error(
+            Utils::concat("Could not open file: ", fileName, '\n'));
+    }
+
+    lua.executeCode(s);
+}
+
+void LevelPreviewLoader::initLua()
+{
+    LuaScripting::init(
+        _lua, _rng, true /* inMenu */, _cwManager, _levelStatus,
+        _hexagonGameStatus, _styleData, _assets,
+        [this](const std::string& filename) { runLuaFile(filename); },
+        _execScriptPackPathContext,
+        [this]() -> const std::string& { return _levelData->packPath; },
+        [this]() -> const PackData& { return *_packData; });
+
+    _lua.writeVariable("u_log",
+        [this](const std::string& mLog)
+        {
+            _log += mLog;
+            _log += '\n';
+        });
+
+    _lua.writeVariable("u_getDifficultyMult", [] { return 1; });
+
+    _lua.writeVariable("u_getSpeedMultDM", [] { return 1; });
+
+    _lua.writeVariable("u_getDelayMultDM", [] { return 1; });
+
+    _lua.writeVariable("u_getPlayerAngle", [] { return 0; });
+
+    // `Config` is not thread-safe, its values are copied into each job.
+    _lua.writeVariable("u_getWidth", [this] { return _width; });
+
+    _lua.writeVariable("u_getHeight", [this] { return _height; });
+
+    // Unused functions, including the ones that would touch shaders from the
+    // worker thread.
+    for(const auto& un : {"u_isKeyPressed", "u_isMouseButtonPressed",
+            "u_isFastSpinning", "u_setPlayerAngle", "u_forceIncrement",
+            "u_haltTime", "u_timelineWait", "u_clearWalls", "u_setFlashEffect",
+
+            "a_setMusic", "a_setMusicSegment", "a_setMusicSeconds",
+            "a_playSound", "a_playPackSound", "a_syncMusicToDM",
+            "a_setMusicPitch", "a_overrideBeepSound",
+            "a_overrideIncrementSound", "a_overrideSwapSound",
+            "a_overrideDeathSound",
+
+            "t_eval", "t_kill", "t_clear", "t_wait", "t_waitS", "t_waitUntilS",
+
+            "e_eval", "e_kill", "e_stopTime", "e_stopTimeS", "e_wait",
+            "e_waitS", "e_waitUntilS", "e_messageAdd", "e_messageAddImportant",
+            "e_messageAddImportantSilent", "e_clearMessages",
+
+            "ct_create", "ct_eval", "ct_kill", "ct_stopTime", "ct_stopTimeS",
+            "ct_wait", "ct_waitS", "ct_waitUntilS",
+
+            "l_overrideScore", "l_setRotation", "l_getRotation",
+            "l_getOfficial",
+
+            "s_setStyle",
+
+            "w_wall", "w_wallAdj", "w_wallAcc", "w_wallHModSpeedData",
+            "w_wallHModCurveData",
+
+            "steam_unlockAchievement",
+
+            "u_kill", "u_eventKill", "u_playSound", "u_playPackSound",
+            "u_setFlashEffect", "u_setFlashColor",
+
+            "e_eventStopTime", "e_eventStopTimeS", "e_eventWait",
+            "e_eventWaitS", "e_eventWaitUntilS", "m_messageAdd",
+            "m_messageAddImportant", "m_messageAddImportantSilent",
+            "m_clearMessages",
+
+            "shdr_setUniformF", "shdr_setUniformFVec2", "shdr_setUniformFVec3",
+            "shdr_setUniformFVec4", "shdr_setUniformI", "shdr_setUniformIVec2",
+            "shdr_setUniformIVec3", "shdr_setUniformIVec4"})
+    {
+        _lua.writeVariable(un, [] {});
+    }
+}
+
+void LevelPreviewLoader::runLuaFile(const std::string& fileName)
+try
+{
+    executeLuaFile(_lua, fileName);
+}
+catch(const std::exception& e)
+{
+    _errors += Utils::concat(
+        "Fatal error in menu for Lua file '", fileName, "':\n", e.what(), '\n');
+}
+catch(...)
+{
+    _errors += Utils::concat(
+        "Fatal unknown error in menu for Lua file '", fileName, "'\n");
+}
+
+[[nodiscard]] LevelPreview LevelPreviewLoader::prepare(const Job& job)
+{
+    SSVOH_PROFILE_SCOPE("LevelPreviewLoader::prepare");
+
+    _levelData = job.levelData;
+    _packData = job.packData;
+    _width = job.width;
+    _height = job.height;
+
+    _styleData = *job.styleData;
+    _styleData.computeColors();
+
+    _levelStatus = _initialLevelStatus;
+    _execScriptPackPathContext.clear();
+
+    _log.clear();
+    _errors.clear();
+
+    {
+        // Logging from the bindings would race with the main thread.
+        const Utils::ScriptLogCapture logCapture{_log};
+
+        try
+        {
+            executeLuaFile(_lua, _levelData->luaScriptPath);
+            Utils::runLuaFunctionIfExists<void>(_lua, "onInit");
+            Utils::runLuaFunctionIfExists<void>(_lua, "onLoad");
+        }
+        catch(const std::exception& e)
+        {
+            _errors += Utils::concat("Runtime Lua error on menu "
+                                     "(loadFile/onInit/onLoad):\n",
+                e.what(), '\n');
+        }
+        catch(...)
+        {
+            _errors += "Unknown runtime Lua error on menu "
+                       "(loadFile/onInit/onLoad)\n";
+        }
+    }
+
+    return LevelPreview{.levelId = job.levelId,
+        .styleData = _styleData,
+        .levelStatus = _levelStatus,
+        .log = std::move(_log),
+        .errors = std::move(_errors)};
+}
+
+void LevelPreviewLoader::workerLoop()
+{
+    std::unique_lock lock{_mutex};
+
+    while(true)
+    {
+        _cv.wait(lock, [this] { return !_queue.empty() || _stopRequested; });
+
+        if(_stopRequested)
+        {
+            return;
+        }
+
+        Job job = std::move(_queue.front());
+        _queue.pop_front();
+
+        if(findCached(job.levelId) != nullptr)
+        {
+            continue;
+        }
+
+        _running = true;
+        _runningLevelId = job.levelId;
+
+        lock.unlock();
+        auto preview = std::make_shared<const LevelPreview>(prepare(job));
+        lock.lock();
+
+        _running = false;
+
+        _cache.emplace_back(std::move(preview));
+        if(_cache.size() > cacheCapacity)
+        {
+            _cache.erase(_cache.begin());
+        }
+
+        _cv.notify_all();
+    }
+}
+
+[[nodiscard]] LevelPreviewLoader::Job LevelPreviewLoader::makeJob(
+    const std::string& levelId)
+{
+    // Asset lookups and `Config` reads are done on the main thread, as
+    // neither is thread-safe. The referenced data stays valid until assets
+    // are reloaded.
+    const LevelData& levelData = _assets.getLevelData(levelId);
+
+    return Job{.levelId = levelId,
+        .levelData = &levelData,
+        .packData = &_assets.getPackData(levelData.packId),
+        .styleData =
+            &_assets.getStyleData(levelData.packId, levelData.styleId),
+        .width = Config::getWidth(),
+        .height = Config::getHeight()};
+}
+
+[[nodiscard]] bool LevelPreviewLoader::isCachedOrPending(
+    const std::string& levelId) const
+{
+    const auto hasId = [&](const auto& x) { return x.levelId == levelId; };
+
+    return (_running && _runningLevelId == levelId) ||
+           std::any_of(_queue.begin(), _queue.end(), hasId) ||
+           std::any_of(_cache.begin(), _cache.end(),
+               [&](const auto& p) { return hasId(*p); });
+}
+
+[[nodiscard]] std::shared_ptr<const LevelPreview>
+LevelPreviewLoader::findCached(const std::string& levelId)
+{
+    const auto it = std::find_if(_cache.begin(), _cache.end(),
+        [&](const auto& p) { return p->levelId == levelId; });
+
+    if(it == _cache.end())
+    {
+        return nullptr;
+    }
+
+    // Move to the back, as the most recently used.
+    std::rotate(it, it + 1, _cache.end());
+    return _cache.back();
+}
+
+LevelPreviewLoader::LevelPreviewLoader(HGAssets& assets)
+    : _assets{assets},
+      _lua{},
+      _rng{0},
+      _cwManager{},
+      _hexagonGameStatus{},
+      _styleData{},
+      _initialLevelStatus{
+          Config::getMusicSpeedDMSync(), Config::getSpawnDistance()},
+      _levelStatus{_initialLevelStatus},
+      _execScriptPackPathContext{},
+      _levelData{nullptr},
+      _packData{nullptr},
+      _width{0},
+      _height{0},
+      _log{},
+      _errors{}
+{
+    // Registers the Lua functions on the main thread, the worker is only
+    // started on the first request.
+    initLua();
+}
+
+LevelPreviewLoader::~LevelPreviewLoader()
+{
+    if(!_worker.joinable())
+    {
+        return;
+    }
+
+    {
+        std::scoped_lock lock{_mutex};
+        _stopRequested = true;
+    }
+
+    _cv.notify_all();
+    _worker.join();
+}
+
+void LevelPreviewLoader::request(const std::vector<std::string>& levelIds)
+{
+    if(!_worker.joinable())
+    {
+        _worker = std::thread{[this] { workerLoop(); }};
+    }
+
+    {
+        std::scoped_lock lock{_mutex};
+
+        _queue.clear();
+
+        for(const std::string& levelId : levelIds)
+        {
+            if(!isCachedOrPending(levelId))
+            {
+                _queue.emplace_back(makeJob(levelId));
+            }
+        }
+    }
+
+    _cv.notify_all();
+}
+
+[[nodiscard]] std::shared_ptr<const LevelPreview> LevelPreviewLoader::find(
+    const std::string& levelId)
+{
+    std::scoped_lock lock{_mutex};
+    return findCached(levelId);
+}
+
+[[nodiscard]] std::shared_ptr<const LevelPreview> LevelPreviewLoader::wait(
+    const std::string& levelId)
+{
+    if(!_worker.joinable())
+    {
+        _worker = std::thread{[this] { workerLoop(); }};
+    }
+
+    std::unique_lock lock{_mutex};
+
+    std::shared_ptr<const LevelPreview> result = findCached(levelId);
+
+    if(result != nullptr)
+    {
+        return result;
+    }
+
+    if(!_running || _runningLevelId != levelId)
+    {
+        std::erase_if(
+            _queue, [&](const Job& job) { return job.levelId == levelId; });
+
+        _queue.emplace_front(makeJob(levelId));
+        _cv.notify_all();
+    }
+
+    _cv.wait(lock,
+        [&]
+        {
+            result = findCached(levelId);
+            return result != nullptr;
+        });
+
+    return result;
+}
+
+void LevelPreviewLoader::clear()
+{
+    std::unique_lock lock{_mutex};
+
+    _queue.clear();
+    _cv.wait(lock, [this] { return !_running; });
+    _cache.clear();
+}
+
+} // namespace hg
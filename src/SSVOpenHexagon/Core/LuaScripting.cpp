@@ -13,7 +13,9 @@
 #include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
 #include "SSVOpenHexagon/Utils/LuaMetadata.hpp"
 #include "SSVOpenHexagon/Utils/LuaMetadataProxy.hpp"
+#include "SSVOpenHexagon/Utils/LuaProfiler.hpp"
 #include "SSVOpenHexagon/Utils/ScopeGuard.hpp"
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
 
 #include "SSVOpenHexagon/Data/LevelStatus.hpp"
 #include "SSVOpenHexagon/Data/StyleData.hpp"
@@ -48,7 +50,8 @@ Utils::LuaMetadataProxy addLuaFn(
     // TODO (P2): does this handle duplicates properly? Both menu and game call
     // the same thing.
 
-    lua.writeVariable(name, SSVOH_FWD(f));
+    lua.writeVariable(name,
+        Utils::makeProfiledLuaFn(lua.getProfiler(), name, SSVOH_FWD(f)));
     return Utils::LuaMetadataProxy{
         Utils::TypeWrapper<F>{}, getMetadata(), name};
 }
@@ -216,6 +219,11 @@ static void destroyMaliciousFunctions(Lua::LuaContext& lua)
     // inject malicious code.
     lua.clearVariable("package.loadlib");
     lua.clearVariable("package.loaders");
+
+    // The FFI library, when compiled in, gives unrestricted access to memory
+    // and native code. Only views created from C++ are exposed.
+    lua.clearVariable("package.preload.ffi");
+    lua.clearVariable("package.loaded.ffi");
 }
 
 static void initUtils(Lua::LuaContext& lua, const bool inMenu)
@@ -243,6 +251,92 @@ static void initUtils(Lua::LuaContext& lua, const bool inMenu)
         .doc("Returns the string representing the current version of the game");
 }
 
+static void initCustomWallBatchViews(
+    Lua::LuaContext& lua, CCustomWallManager& cwManager)
+{
+    constexpr std::size_t capacity = CCustomWallManager::batchCapacity;
+
+#ifdef SSVOH_ENABLE_LUAJIT_FFI
+    if(Config::getLuaJitFfi())
+    {
+        lua.writeFfiArrayView("cw_vertexPos4Batch",
+            cwManager.getVertexPos4Batch(),
+            capacity * CCustomWallManager::vertexPos4BatchStride);
+
+        lua.writeFfiArrayView("cw_vertexColor4Batch",
+            cwManager.getVertexColor4Batch(),
+            capacity * CCustomWallManager::vertexColor4BatchStride);
+
+        return;
+    }
+#else
+    static_cast<void>(cwManager);
+#endif
+
+    // Without FFI the batches live in plain Lua tables, and are committed by
+    // forwarding each row to the regular functions. Scripts observe the same
+    // behavior in both cases.
+    static_assert(CCustomWallManager::vertexPos4BatchStride == 9);
+    static_assert(CCustomWallManager::vertexColor4BatchStride == 17);
+
+    lua.executeCode(R"(
+local error, floor, min, setmetatable, tostring, type =
+    error, math.floor, math.min, setmetatable, tostring, type
+
+local setVertexPos4, setVertexColor4 = cw_setVertexPos4, cw_setVertexColor4
+local capacity = cw_getBatchCapacity()
+
+local function makeView(size)
+    local store = {}
+
+    local function checkIndex(i)
+        if type(i) ~= "number" or i < 1 or i > size or i ~= floor(i) then
+            error("array view index out of bounds: " .. tostring(i), 3)
+        end
+    end
+
+    return store, setmetatable({}, {
+        __index = function(_, i)
+            checkIndex(i)
+            return store[i] or 0
+        end,
+        __newindex = function(_, i, v)
+            checkIndex(i)
+            if type(v) ~= "number" then
+                error("array view value must be a number", 2)
+            end
+            store[i] = v
+        end,
+        __metatable = false
+    })
+end
+
+local pos, color
+pos, cw_vertexPos4Batch = makeView(capacity * 9)
+color, cw_vertexColor4Batch = makeView(capacity * 17)
+
+cw_commitVertexPos4Batch = function(count)
+    local p = pos
+    for o = 0, (min(floor(count), capacity) - 1) * 9, 9 do
+        setVertexPos4(p[o + 1] or 0,
+            p[o + 2] or 0, p[o + 3] or 0, p[o + 4] or 0, p[o + 5] or 0,
+            p[o + 6] or 0, p[o + 7] or 0, p[o + 8] or 0, p[o + 9] or 0)
+    end
+end
+
+cw_commitVertexColor4Batch = function(count)
+    local c = color
+    for o = 0, (min(floor(count), capacity) - 1) * 17, 17 do
+        setVertexColor4(c[o + 1] or 0,
+            c[o + 2] or 0, c[o + 3] or 0, c[o + 4] or 0, c[o + 5] or 0,
+            c[o + 6] or 0, c[o + 7] or 0, c[o + 8] or 0, c[o + 9] or 0,
+            c[o + 10] or 0, c[o + 11] or 0, c[o + 12] or 0, c[o + 13] or 0,
+            c[o + 14] or 0, c[o + 15] or 0, c[o + 16] or 0, c[o + 17] or 0)
+    end
+end
+)");
+}
+
 static void initCustomWalls(Lua::LuaContext& lua, CCustomWallManager& cwManager)
 {
     addLuaFn(lua, "cw_create", //
@@ -495,6 +589,37 @@ static void initCustomWalls(Lua::LuaContext& lua, CCustomWallManager& cwManager)
     addLuaFn(lua, "cw_clear", //
         [&cwManager] { cwManager.clear(); })
         .doc("Remove all existing custom walls.");
+
+    addLuaFn(lua, "cw_getBatchCapacity", //
+        []() -> int { return CCustomWallManager::batchCapacity; })
+        .doc(
+            "Return the maximum number of rows of `cw_vertexPos4Batch` and "
+            "`cw_vertexColor4Batch` that can be committed at once.");
+
+    addLuaFn(lua, "cw_commitVertexPos4Batch", //
+        [&cwManager](int count)
+        { cwManager.commitVertexPos4Batch(count > 0 ? count : 0); })
+        .arg("count")
+        .doc(
+            "Apply the first `$0` rows of `cw_vertexPos4Batch`, an array of "
+            "rows of nine numbers `cwHandle, x0, y0, x1, y1, x2, y2, x3, y3` "
+            "indexed from `1`, as if `cw_setVertexPos4` was invoked for each "
+            "of them. The array is reused across calls. Much more efficient "
+            "than many `cw_setVertexPos4` calls when LuaJIT FFI is enabled.");
+
+    addLuaFn(lua, "cw_commitVertexColor4Batch", //
+        [&cwManager](int count)
+        { cwManager.commitVertexColor4Batch(count > 0 ? count : 0); })
+        .arg("count")
+        .doc(
+            "Apply the first `$0` rows of `cw_vertexColor4Batch`, an array of "
+            "rows of seventeen numbers `cwHandle, r0, g0, b0, a0, ..., r3, "
+            "g3, b3, a3` indexed from `1`, as if `cw_setVertexColor4` was "
+            "invoked for each of them. The array is reused across calls. Much "
+            "more efficient than many `cw_setVertexColor4` calls when LuaJIT "
+            "FFI is enabled.");
+
+    initCustomWallBatchViews(lua, cwManager);
 }
 
 static void initLevelControl(
@@ -1239,7 +1364,7 @@ static void initShaders(Lua::LuaContext& lua, HGAssets& assets,
 
             if(!id.has_value())
             {
-                ssvu::lo("hg::LuaScripting::initShaders")
+                Utils::scriptLog("hg::LuaScripting::initShaders")
                     << "`u_getShaderId` failed, no id found for '"
                     << shaderFilename << "'\n";
 
@@ -1271,7 +1396,7 @@ static void initShaders(Lua::LuaContext& lua, HGAssets& assets,
 
                 if(!id.has_value())
                 {
-                    ssvu::lo("hg::LuaScripting::initShaders")
+                    Utils::scriptLog("hg::LuaScripting::initShaders")
                         << "`u_getDependencyShaderId` failed, no id found for '"
                         << shaderPath << "'\n";
 
@@ -1309,7 +1434,7 @@ static void initShaders(Lua::LuaContext& lua, HGAssets& assets,
     {
         if(!assets.isValidShaderId(shaderId))
         {
-            ssvu::lo("hg::LuaScripting::initShaders")
+            Utils::scriptLog("hg::LuaScripting::initShaders")
                 << "`" << caller << "` failed, invalid shader id '" << shaderId
                 << "'\n";
 
@@ -1327,7 +1452,7 @@ static void initShaders(Lua::LuaContext& lua, HGAssets& assets,
     {
         if(renderStage >= ids.size())
         {
-            ssvu::lo("hg::LuaScripting::initShaders")
+            Utils::scriptLog("hg::LuaScripting::initShaders")
                 << "`" << caller << "` failed, invalid render stage id '"
                 << renderStage << "'\n";
 
@@ -4,15 +4,13 @@
 
 #include "SSVOpenHexagon/Core/MenuGame.hpp"
 
-#include "SSVOpenHexagon/Components/CCustomWallManager.hpp"
-
 #include "SSVOpenHexagon/Core/BindControl.hpp"
 #include "SSVOpenHexagon/Core/Discord.hpp"
 #include "SSVOpenHexagon/Core/HexagonClient.hpp"
 #include "SSVOpenHexagon/Core/HGStatus.hpp"
 #include "SSVOpenHexagon/Core/Joystick.hpp"
 #include "SSVOpenHexagon/Core/LeaderboardCache.hpp"
-#include "SSVOpenHexagon/Core/LuaScripting.hpp"
+#include "SSVOpenHexagon/Core/LevelPreviewLoader.hpp"
 #include "SSVOpenHexagon/Core/RandomNumberGenerator.hpp"
 #include "SSVOpenHexagon/Core/Steam.hpp"
 
@@ -27,6 +25,7 @@
 #include "SSVOpenHexagon/Global/Assets.hpp"
 #include "SSVOpenHexagon/Global/Audio.hpp"
 #include "SSVOpenHexagon/Global/Config.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 #include "SSVOpenHexagon/Global/Version.hpp"
 
 #include "SSVOpenHexagon/Online/Database.hpp"
@@ -38,7 +37,6 @@
 #include "SSVOpenHexagon/Utils/FontHeight.hpp"
 #include "SSVOpenHexagon/Utils/Geometry.hpp"
 #include "SSVOpenHexagon/Utils/LevelValidator.hpp"
-#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
 #include "SSVOpenHexagon/Utils/Match.hpp"
 #include "SSVOpenHexagon/Utils/ScopeGuard.hpp"
 #include "SSVOpenHexagon/Utils/String.hpp"
@@ -161,8 +159,7 @@ MenuGame::MenuGame(Steam::steam_manager& mSteamManager,
       hexagonClient{mHexagonClient},
       dialogBox(openSquare, mGameWindow),
       leaderboardCache{Utils::makeUnique<LeaderboardCache>()},
-      lua{},
-      execScriptPackPathContext{},
+      levelPreviewLoader{Utils::makeUnique<LevelPreviewLoader>(mAssets)},
       currentPack{nullptr},
       titleBar{assets.getTexture("titleBar.png")},
       creditsBar1{assets.getTexture("creditsBar1.png")},
@@ -736,7 +733,6 @@ MenuGame::MenuGame(Steam::steam_manager& mSteamManager,
 
     initMenus();
     initInput();
-    initLua();
 
     //--------------------------------
     // Main menu background
@@ -779,11 +775,16 @@ MenuGame::MenuGame(Steam::steam_manager& mSteamManager,
         }
     }
     lvlSlct.lvlOffsets.resize(maxSize);
+
+    // Scores from previous sessions are shown until they are refreshed.
+    (void)leaderboardCache->loadFromFile("leaderboardCache.json");
 }
 
 MenuGame::~MenuGame()
 {
     ssvu::lo("MenuGame::~MenuGame") << "Cleaning up menu resources...\n";
+
+    leaderboardCache->saveToFile("leaderboardCache.json");
 }
 
 void MenuGame::init(bool error)
@@ -911,10 +912,23 @@ void MenuGame::initInput()
     using t = ssvs::Input::Type;
     using Tid = Config::Tid;
 
+    // Bound keys can be letters, which are typed into the level search
+    // instead while it is open.
+    const auto unlessSearching = [this](auto action)
+    {
+        return [this, action](ssvu::FT mFT)
+        {
+            if(!levelSearchOpen)
+            {
+                action(mFT);
+            }
+        };
+    };
+
     const auto addTidInput = [&](const Tid tid, const t type, auto action)
     {
-        game.addInput(
-            Config::getTrigger(tid), action, type, static_cast<int>(tid));
+        game.addInput(Config::getTrigger(tid), unlessSearching(action), type,
+            static_cast<int>(tid));
     };
 
     addTidInput(Tid::RotateCCW, t::Once,
@@ -998,33 +1012,32 @@ void MenuGame::initInput()
         {{k::Backspace}}, [this](ssvu::FT /*unused*/) { eraseAction(); },
         t::Once);
 
+    // Changing the level list would leave stale search results behind.
     game.addInput( // hardcoded
-        {{k::F1}}, [this](ssvu::FT /*unused*/) { addRemoveFavoriteLevel(); },
+        {{k::F1}},
+        unlessSearching(
+            [this](ssvu::FT /*unused*/) { addRemoveFavoriteLevel(); }),
         t::Once);
 
     game.addInput( // hardcoded
         {{k::F2}},
-        [this](ssvu::FT /*unused*/) { switchToFromFavoriteLevels(); }, t::Once);
+        unlessSearching(
+            [this](ssvu::FT /*unused*/) { switchToFromFavoriteLevels(); }),
+        t::Once);
 
     game.addInput( // hardcoded
-        {{k::F3}}, [this](ssvu::FT /*unused*/) { reloadAssets(false); },
+        {{k::F3}},
+        unlessSearching([this](ssvu::FT /*unused*/) { reloadAssets(false); }),
         t::Once);
 
     game.addInput( // hardcoded
-        {{k::F4}}, [this](ssvu::FT /*unused*/) { reloadAssets(true); },
+        {{k::F4}},
+        unlessSearching([this](ssvu::FT /*unused*/) { reloadAssets(true); }),
         t::Once);
-}
 
-void MenuGame::runLuaFile(const std::string& mFileName)
-try
-{
-    Utils::runLuaFile(lua, mFileName);
-}
-catch(...)
-{
-    playSoundOverride("error.ogg");
-    ssvu::lo("hg::MenuGame::initLua") << "Fatal error in menu for Lua file '"
-                                      << mFileName << '\'' << std::endl;
+    game.addInput( // hardcoded
+        {{k::F5}}, [this](ssvu::FT /*unused*/) { openCloseLevelSearch(); },
+        t::Once);
 }
 
 void MenuGame::changeResolutionTo(unsigned int mWidth, unsigned int mHeight)
@@ -1051,73 +1064,6 @@ void MenuGame::playSoundOverride(const std::string& assetId)
     }
 }
 
-void MenuGame::initLua()
-{
-    static CCustomWallManager cwManager;
-    static random_number_generator rng{0};
-    static HexagonGameStatus hexagonGameStatus;
-
-    LuaScripting::init(
-        lua, rng, true /* inMenu */, cwManager, levelStatus, hexagonGameStatus,
-        styleData, assets,
-        [this](const std::string& filename) { runLuaFile(filename); },
-        execScriptPackPathContext,
-        [this]() -> const std::string& { return levelData->packPath; },
-        [this]() -> const PackData& { return *currentPack; });
-
-    lua.writeVariable("u_log",
-        [](const std::string& mLog) { ssvu::lo("lua-menu") << mLog << '\n'; });
-
-    lua.writeVariable("u_getDifficultyMult", [] { return 1; });
-
-    lua.writeVariable("u_getSpeedMultDM", [] { return 1; });
-
-    lua.writeVariable("u_getDelayMultDM", [] { return 1; });
-
-    lua.writeVariable("u_getPlayerAngle", [] { return 0; });
-
-    // Unused functions
-    for(const auto& un : {"u_isKeyPressed", "u_isMouseButtonPressed",
-            "u_isFastSpinning", "u_setPlayerAngle", "u_forceIncrement",
-            "u_haltTime", "u_timelineWait", "u_clearWalls", "u_setFlashEffect",
-
-            "a_setMusic", "a_setMusicSegment", "a_setMusicSeconds",
-            "a_playSound", "a_playPackSound", "a_syncMusicToDM",
-            "a_setMusicPitch", "a_overrideBeepSound",
-            "a_overrideIncrementSound", "a_overrideSwapSound",
-            "a_overrideDeathSound",
-
-            "t_eval", "t_kill", "t_clear", "t_wait", "t_waitS", "t_waitUntilS",
-
-            "e_eval", "e_kill", "e_stopTime", "e_stopTimeS", "e_wait",
-            "e_waitS", "e_waitUntilS", "e_messageAdd", "e_messageAddImportant",
-            "e_messageAddImportantSilent", "e_clearMessages",
-
-            "ct_create", "ct_eval", "ct_kill", "ct_stopTime", "ct_stopTimeS",
-            "ct_wait", "ct_waitS", "ct_waitUntilS",
-
-            "l_overrideScore", "l_setRotation", "l_getRotation",
-            "l_getOfficial",
-
-            "s_setStyle",
-
-            "w_wall", "w_wallAdj", "w_wallAcc", "w_wallHModSpeedData",
-            "w_wallHModCurveData",
-
-            "steam_unlockAchievement",
-
-            "u_kill", "u_eventKill", "u_playSound", "u_playPackSound",
-            "u_setFlashEffect", "u_setFlashColor",
-
-            "e_eventStopTime", "e_eventStopTimeS", "e_eventWait",
-            "e_eventWaitS", "e_eventWaitUntilS", "m_messageAdd",
-            "m_messageAddImportant", "m_messageAddImportantSilent",
-            "m_clearMessages"})
-    {
-        lua.writeVariable(un, [] {});
-    }
-}
-
 void MenuGame::ignoreInputsAfterMenuExec()
 {
     // We only want to ignore a single input when using the left mouse button,
@@ -1180,6 +1126,11 @@ void MenuGame::initMenus()
     play.create<i::Slider>("timescale", &Config::getTimescale,
         &Config::setTimescale, 0.1f, 2.f, 0.05f) |
         whenNotOfficial;
+#ifdef SSVOH_ENABLE_LUAJIT_FFI
+    play.create<i::Toggle>(
+        "luajit ffi", &Config::getLuaJitFfi, &Config::setLuaJitFfi) |
+        whenNotOfficial;
+#endif
     play.create<i::Toggle>("save last username",
         &Config::getSaveLastLoginUsername, &Config::setSaveLastLoginUsername);
     play.create<i::Toggle>("show login at startup",
@@ -1419,6 +1370,9 @@ void MenuGame::initMenus()
         [this](unsigned int mValue) { Config::setMaxFPS(window, mValue); }, 30u,
         1000u, 5u);
     fps.create<i::Toggle>("show fps", &Config::getShowFPS, &Config::setShowFPS);
+    fps.create<i::Toggle>("pipelined rendering",
+        &Config::getPipelinedVertexGeneration,
+        &Config::setPipelinedVertexGeneration);
     fps.create<i::GoBack>("back");
 
     gfx.create<i::Toggle>("text outlines", &Config::getDrawTextOutlines,
@@ -1885,6 +1839,12 @@ inline constexpr int maxProfilesOnScreen{6};
 
 void MenuGame::upAction()
 {
+    if(state == States::LevelSelection && levelSearchOpen)
+    {
+        moveLevelSearchSelection(-1);
+        return;
+    }
+
     if(state == States::LevelSelection)
     {
         // Do not do anything until the pack change animation is over.
@@ -1993,6 +1953,12 @@ inline constexpr int maxErrorsOnScreen{7};
 
 void MenuGame::downAction()
 {
+    if(state == States::LevelSelection && levelSearchOpen)
+    {
+        moveLevelSearchSelection(1);
+        return;
+    }
+
     if(state == States::LevelSelection)
     {
         if(packChangeState != PackChange::Rest)
@@ -2323,6 +2289,12 @@ void MenuGame::okAction()
 
         case States::LevelSelection:
         {
+            if(levelSearchOpen)
+            {
+                jumpToLevelSearchResult();
+                break;
+            }
+
             // Reset the scroll of the text fields so that
             // they will be 0 when user exit the level.
             resetNamesScrolls();
@@ -2347,6 +2319,9 @@ void MenuGame::okAction()
 
 void MenuGame::playSelectedLevel()
 {
+    // Back from the game, the level list is shown without the search.
+    closeLevelSearch();
+
     if(fnHGNewGame)
     {
         setMouseCursorVisible(false);
@@ -2363,6 +2338,17 @@ void MenuGame::playSelectedLevel()
 
 void MenuGame::eraseAction()
 {
+    if(state == States::LevelSelection && levelSearchOpen)
+    {
+        if(!levelSearchQuery.empty())
+        {
+            levelSearchQuery.pop_back();
+            updateLevelSearchResults();
+        }
+
+        return;
+    }
+
     if(isEnteringText() && !enteredStr.empty())
     {
         enteredStr.erase(enteredStr.end() - 1);
@@ -2394,20 +2380,14 @@ void MenuGame::eraseAction()
             return;
         }
 
-        // Remove the profile .json
-        if(const std::string fileName{"Profiles/" + name + ".json"};
-            std::remove(fileName.c_str()) != 0)
+        // Remove the profile files and the profile from memory
+        if(!assets.pRemove(name))
         {
-            ssvu::lo("eraseAction()")
-                << "Error: file " << fileName << " does not exist\n";
+            ssvu::lo("eraseAction()") << "Error: file Profiles/" << name
+                                      << ".json does not exist\n";
 
             return;
         }
-        else
-        {
-            // Remove profile from memory as well
-            assets.pRemove(name);
-        }
 
         // Remove the item from the menu
         profileSelectionMenu.getCategory().remove();
@@ -2448,6 +2428,12 @@ void MenuGame::exitAction()
         return;
     }
 
+    if(state == States::LevelSelection && levelSearchOpen)
+    {
+        openCloseLevelSearch();
+        return;
+    }
+
     if(state == States::LevelSelection)
     {
         changeStateTo(States::SMain);
@@ -2488,6 +2474,8 @@ void MenuGame::exitAction()
 
 void MenuGame::update(ssvu::FT mFT)
 {
+    SSVOH_PROFILE_SCOPE("MenuGame::update");
+
     hexagonClient.update();
 
     const auto showHCEventDialogBox = [this](const bool error,
@@ -2597,6 +2585,12 @@ void MenuGame::update(ssvu::FT mFT)
             [&](const HexagonClient::EReceivedOwnScore& e)
             { leaderboardCache->receivedOwnScore(e.levelValidator, e.score); },
 
+            [&](const HexagonClient::EReceivedLeaderboardPage& e)
+            {
+                leaderboardCache->receivedPage(e.levelValidator, e.version,
+                    e.baseVersion, e.offset, e.size, e.scores, e.ownScore);
+            },
+
             [&](const HexagonClient::EGameVersionMismatch&)
             {
                 ssvu::lo("hg::MenuGame::update")
@@ -2621,10 +2615,11 @@ void MenuGame::update(ssvu::FT mFT)
 
     Joystick::update(Config::getJoystickDeadzone());
 
-    // Focus should have no effect if we are in the favorites menu
-    // or a pack change animation is in progress.
+    // Focus should have no effect if we are in the favorites menu,
+    // a pack change animation is in progress or shift is used to type
+    // into the level search.
     if(state == States::LevelSelection && !isFavoriteLevels() &&
-        packChangeState == PackChange::Rest)
+        packChangeState == PackChange::Rest && !levelSearchOpen)
     {
         if(!focusHeld)
         {
@@ -2678,7 +2673,15 @@ void MenuGame::update(ssvu::FT mFT)
     }
 
     // TODO (P2): cleanup mouse control
-    if(state == States::LevelSelection && packChangeState == PackChange::Rest)
+    if(state == States::LevelSelection && levelSearchOpen)
+    {
+        // Clicks on the level list behind the search are dropped.
+        mustFavorite = mustPlay = false;
+        mustChangeIndexTo.reset();
+        mustChangePackIndexTo.reset();
+    }
+    else if(state == States::LevelSelection &&
+            packChangeState == PackChange::Rest)
     {
         if(mustFavorite)
         {
@@ -2833,6 +2836,18 @@ void MenuGame::update(ssvu::FT mFT)
         window.stop();
     }
 
+    if(!pendingLevelPreviewId.empty())
+    {
+        const std::shared_ptr<const LevelPreview> preview =
+            levelPreviewLoader->find(pendingLevelPreviewId);
+
+        if(preview != nullptr)
+        {
+            pendingLevelPreviewId.clear();
+            applyLevelPreview(*preview);
+        }
+    }
+
     styleData.update(mFT);
     backgroundCamera.turn(levelStatus.rotationSpeed * 10.f);
 
@@ -2849,6 +2864,26 @@ void MenuGame::update(ssvu::FT mFT)
             }
         }
     }
+    else if(levelSearchOpen)
+    {
+        const std::size_t prevSize{levelSearchQuery.size()};
+
+        for(const char c : enteredChars)
+        {
+            if(levelSearchQuery.size() < levelSearchQueryLimit &&
+                (ssvu::isAlphanumeric(c) || ssvu::isPunctuation(c) ||
+                    c == ' '))
+            {
+                levelSearchQuery += c;
+            }
+        }
+
+        // Results are refreshed on every keystroke.
+        if(levelSearchQuery.size() != prevSize)
+        {
+            updateLevelSearchResults();
+        }
+    }
     enteredChars.clear();
 
     switch(state)
@@ -2918,6 +2953,8 @@ void MenuGame::update(ssvu::FT mFT)
 
 void MenuGame::setIndex(const int mIdx)
 {
+    SSVOH_PROFILE_SCOPE("MenuGame::setIndex");
+
     lvlDrawer->currentIndex = mIdx;
 
     const std::string levelID{
@@ -2928,9 +2965,6 @@ void MenuGame::setIndex(const int mIdx)
 
     formatLevelDescription();
 
-    styleData = assets.getStyleData(levelData->packId, levelData->styleId);
-    styleData.computeColors();
-
     // If we are in the favorite menu we must find the packId relative
     // to the selected level.
     if(isFavoriteLevels())
@@ -2958,8 +2992,133 @@ void MenuGame::setIndex(const int mIdx)
             assets.getCurrentLocalProfile().isLevelFavorite(levelID);
     }
 
+    // Set gameplay values
+    diffMultIdx = 0;
+    for(; levelData->difficultyMults.at(diffMultIdx) != 1.f; ++diffMultIdx)
+    {}
+
+    // The style and level status of the level are prepared in the
+    // background, the current ones are kept until they are ready. The first
+    // preview has nothing to replace, so it is waited for.
+    requestLevelPreviews();
+    prefetchLeaderboards();
+
+    // Levels started from the menu begin with their first music segment.
+    assets.getMusicData(levelData->packId, levelData->musicId)
+        .prefetchSegment(levelData->packId, audio, 0);
+
+    const std::shared_ptr<const LevelPreview> preview =
+        anyLevelPreviewApplied ? levelPreviewLoader->find(levelID)
+                               : levelPreviewLoader->wait(levelID);
+
+    if(preview == nullptr)
+    {
+        pendingLevelPreviewId = levelID;
+        return;
+    }
+
+    pendingLevelPreviewId.clear();
+    applyLevelPreview(*preview);
+}
+
+inline constexpr int levelPrefetchRadius{2};
+
+void MenuGame::requestLevelPreviews()
+{
+    const std::vector<std::string>& ids = *lvlDrawer->levelDataIds;
+    const int size = static_cast<int>(ids.size());
+    const int idx = lvlDrawer->currentIndex;
+
+    // Current level first, then its neighbours, closest first.
+    std::vector<std::string> levelIds{ids.at(idx)};
+
+    for(int offset = 1; offset <= levelPrefetchRadius; ++offset)
+    {
+        levelIds.emplace_back(ids.at(ssvu::getMod(idx + offset, size)));
+        levelIds.emplace_back(ids.at(ssvu::getMod(idx - offset, size)));
+    }
+
+    levelPreviewLoader->request(levelIds);
+}
+
+void MenuGame::requestLeaderboardPage(const std::string& levelValidator)
+{
+    // Only the scores that changed since the cached version are sent back.
+    hexagonClient.tryRequestLeaderboardPage(levelValidator, 0 /* offset */,
+        LeaderboardCache::pageSize, false /* aroundOwnScore */,
+        leaderboardCache->getVersion(levelValidator));
+
+    leaderboardCache->requestedScores(levelValidator);
+}
+
+void MenuGame::prefetchLeaderboards()
+{
+    if(hexagonClient.getState() != HexagonClient::State::LoggedIn_Ready)
+    {
+        return;
+    }
+
+    const std::vector<std::string>& ids = *lvlDrawer->levelDataIds;
+    const int size = static_cast<int>(ids.size());
+    const int idx = lvlDrawer->currentIndex;
+
+    // The selected level is requested when drawn, its neighbours are
+    // requested ahead of time at the default difficulty, so that their
+    // leaderboards are shown as soon as they are selected.
+    const auto prefetch = [&](const std::string& levelId)
+    {
+        const LevelData& ld = assets.getLevelData(levelId);
+
+        if(ld.unscored)
+        {
+            return;
+        }
+
+        const std::string& levelValidator = ld.getValidator(1.f);
+
+        if(hexagonClient.isLevelSupportedByServer(levelValidator) &&
+            leaderboardCache->shouldPrefetchScores(levelValidator))
+        {
+            requestLeaderboardPage(levelValidator);
+        }
+    };
+
+    for(int offset = 1; offset <= levelPrefetchRadius; ++offset)
+    {
+        prefetch(ids.at(ssvu::getMod(idx + offset, size)));
+        prefetch(ids.at(ssvu::getMod(idx - offset, size)));
+    }
+}
+
+void MenuGame::applyLevelPreview(const LevelPreview& preview)
+{
+    SSVOH_PROFILE_SCOPE("MenuGame::applyLevelPreview");
+
+    anyLevelPreviewApplied = true;
+
+    // Colors were computed before running the level's Lua script.
+    styleData = preview.styleData;
+    levelStatus = preview.levelStatus;
+
+    if(!preview.log.empty())
+    {
+        ssvu::lo("lua-menu") << preview.log;
+    }
+
+    if(!preview.errors.empty())
+    {
+        std::cout << "[MenuGame::applyLevelPreview] With level \""
+                  << assets.getLevelData(preview.levelId).name << "\":\n"
+                  << preview.errors << std::endl;
+
+        if(!Config::getDebug())
+        {
+            playSoundOverride("error.ogg");
+        }
+    }
+
     // Set the colors of the menus
-    auto& colors{styleData.getColors()};
+    const auto colors = styleData.getColors();
     menuQuadColor = Config::getBlackAndWhite() ? sf::Color(20, 20, 20, 255)
                                                : styleData.getTextColor();
     if(ssvu::toInt(menuQuadColor.a) == 0 && !Config::getBlackAndWhite())
@@ -3028,43 +3187,6 @@ void MenuGame::setIndex(const int mIdx)
     txtSelectionRanked.font.setFillColor(menuTextColor);
     txtInstructionsSmall.font.setFillColor(menuTextColor);
     txtSelectionScore.font.setFillColor(menuTextColor);
-
-    // Set gameplay values
-    diffMultIdx = 0;
-    for(; levelData->difficultyMults.at(diffMultIdx) != 1.f; ++diffMultIdx)
-    {}
-
-    try
-    {
-        Utils::runLuaFile(lua, levelData->luaScriptPath);
-        Utils::runLuaFunctionIfExists<void>(lua, "onInit");
-        Utils::runLuaFunctionIfExists<void>(lua, "onLoad");
-    }
-    catch(std::runtime_error& mError)
-    {
-        std::cout << "[MenuGame::init] Runtime Lua error on menu "
-                     "(loadFile/onInit/onLoad) with level \""
-                  << levelData->name << "\": \n"
-                  << mError.what() << '\n'
-                  << std::endl;
-
-        if(!Config::getDebug())
-        {
-            playSoundOverride("error.ogg");
-        }
-    }
-    catch(...)
-    {
-        std::cout << "[MenuGame::init] Unknown runtime Lua error on menu "
-                     "(loadFile/onInit/onLoad) with level \""
-                  << levelData->name << "\"\n"
-                  << std::endl;
-
-        if(!Config::getDebug())
-        {
-            playSoundOverride("error.ogg");
-        }
-    }
 }
 
 void MenuGame::reloadAssets(const bool reloadEntirePack)
@@ -3075,6 +3197,9 @@ void MenuGame::reloadAssets(const bool reloadEntirePack)
         return;
     }
 
+    // The previews refer to the assets being reloaded.
+    levelPreviewLoader->clear();
+
     assets.reloadAllShaders();
 
     // Do the necessary asset reload operation and get the log
@@ -3093,6 +3218,12 @@ void MenuGame::reloadAssets(const bool reloadEntirePack)
 
     setIndex(lvlDrawer->currentIndex); // loads the new levelData
 
+    // The search index was rebuilt with the reloaded levels.
+    if(levelSearchOpen)
+    {
+        updateLevelSearchResults();
+    }
+
     reloadOutput += "\nPRESS ANY KEY OR BUTTON TO CLOSE THIS MESSAGE\n";
     Utils::uppercasify(reloadOutput);
 
@@ -3234,49 +3365,50 @@ void MenuGame::refreshCamera()
     overlayCamera.update(0.5f);
     backgroundCamera.update(0.5f);
 }
-void MenuGame::renderText(
+sf::FloatRect MenuGame::renderText(
     const std::string& mStr, sf::Text& mText, const sf::Vector2f& mPos)
 {
-    mText.setString(mStr);
     mText.setPosition(mPos);
-    render(mText);
+    return textBatch.add(mText, mStr);
 }
 
-void MenuGame::renderText(const std::string& mStr, sf::Text& mText,
+sf::FloatRect MenuGame::renderText(const std::string& mStr, sf::Text& mText,
     const sf::Vector2f& mPos, const sf::Color& mColor)
 {
     const sf::Color prevColor = mText.getFillColor();
     mText.setFillColor(mColor);
-    renderText(mStr, mText, mPos);
+    const sf::FloatRect bounds = renderText(mStr, mText, mPos);
     mText.setFillColor(prevColor);
+    return bounds;
 }
 
-void MenuGame::renderText(const std::string& mStr, sf::Text& mText,
+sf::FloatRect MenuGame::renderText(const std::string& mStr, sf::Text& mText,
     const unsigned int mSize, const sf::Vector2f& mPos)
 {
     mText.setCharacterSize(mSize);
-    renderText(mStr, mText, mPos);
+    return renderText(mStr, mText, mPos);
 }
 
-void MenuGame::renderText(const std::string& mStr, sf::Text& mText,
+sf::FloatRect MenuGame::renderText(const std::string& mStr, sf::Text& mText,
     const unsigned int mSize, const sf::Vector2f& mPos, const sf::Color& mColor)
 {
     const auto prevSize = mText.getCharacterSize();
     mText.setCharacterSize(mSize);
     const sf::Color prevColor = mText.getFillColor();
     mText.setFillColor(mColor);
-    renderText(mStr, mText, mPos);
+    const sf::FloatRect bounds = renderText(mStr, mText, mPos);
     mText.setFillColor(prevColor);
     mText.setCharacterSize(prevSize);
+    return bounds;
 }
 
 // Text rendering centered
 void MenuGame::renderTextCentered(
     const std::string& mStr, sf::Text& mText, const sf::Vector2f& mPos)
 {
-    mText.setString(mStr);
-    mText.setPosition({mPos.x - ssvs::getGlobalHalfWidth(mText), mPos.y});
-    render(mText);
+    const float halfWidth = textBatch.getGlobalBounds(mText, mStr).width / 2.f;
+    mText.setPosition({mPos.x - halfWidth, mPos.y});
+    textBatch.add(mText, mStr);
 }
 
 void MenuGame::renderTextCentered(const std::string& mStr, sf::Text& mText,
@@ -3309,10 +3441,9 @@ void MenuGame::renderTextCentered(const std::string& mStr, sf::Text& mText,
 void MenuGame::renderTextCenteredOffset(const std::string& mStr,
     sf::Text& mText, const sf::Vector2f& mPos, const float xOffset)
 {
-    mText.setString(mStr);
-    mText.setPosition(
-        {xOffset + mPos.x - ssvs::getGlobalHalfWidth(mText), mPos.y});
-    render(mText);
+    const float halfWidth = textBatch.getGlobalBounds(mText, mStr).width / 2.f;
+    mText.setPosition({xOffset + mPos.x - halfWidth, mPos.y});
+    textBatch.add(mText, mStr);
 }
 
 void MenuGame::renderTextCenteredOffset(const std::string& mStr,
@@ -3805,15 +3936,16 @@ void MenuGame::drawOptionsSubmenus(
             itemName = "> " + itemName;
         }
 
-        renderText(itemName, txtMenuSmall.font, {quadBorder, txtHeight},
+        const sf::FloatRect itemBounds = renderText(itemName,
+            txtMenuSmall.font, {quadBorder, txtHeight},
             !items[i]->isEnabled() ? sf::Color{150, 150, 150, 255}
                                    : menuTextColor);
 
         if(!items[i]->isEnabled())
         {
             renderText("[OFFICIAL MODE ENABLED]", txtMenuTiny.font,
-                {ssvs::getGlobalRight(txtMenuSmall.font) + 6.f,
-                    ssvs::getGlobalTop(txtMenuSmall.font) - 2.f},
+                {itemBounds.left + itemBounds.width + 6.f,
+                    itemBounds.top - 2.f},
                 sf::Color{150, 150, 150, 255});
         }
 
@@ -4788,7 +4920,7 @@ void MenuGame::addRemoveFavoriteLevel()
     // Level is a favorite so remove it.
     if(isLevelFavorite)
     {
-        assets.getCurrentLocalProfile().removeFavoriteLevel(levelID);
+        assets.removeFavoriteLevel(levelID);
         favoriteLevelDataIds.erase(std::find(
             favoriteLevelDataIds.begin(), favoriteLevelDataIds.end(), levelID));
         favSlct.lvlOffsets.pop_back();
@@ -4835,7 +4967,7 @@ void MenuGame::addRemoveFavoriteLevel()
     }
     else
     {
-        assets.getCurrentLocalProfile().addFavoriteLevel(levelID);
+        assets.addFavoriteLevel(levelID);
         favSlct.lvlOffsets.emplace_back(0.f);
         isLevelFavorite = true;
 
@@ -4899,6 +5031,168 @@ void MenuGame::switchToFromFavoriteLevels()
     playSoundOverride("select.ogg");
 }
 
+void MenuGame::openCloseLevelSearch()
+{
+    if(state != States::LevelSelection || !dialogBox.empty())
+    {
+        return;
+    }
+
+    const bool wasOpen = levelSearchOpen;
+    closeLevelSearch();
+    levelSearchOpen = !wasOpen;
+
+    playSoundOverride("beep.ogg");
+    touchDelay = 50.f;
+}
+
+void MenuGame::closeLevelSearch()
+{
+    levelSearchOpen = false;
+    levelSearchQuery.clear();
+    levelSearchResults.clear();
+    levelSearchIdx = 0;
+}
+
+void MenuGame::updateLevelSearchResults()
+{
+    levelSearchResults =
+        assets.searchLevels(levelSearchQuery, maxLevelSearchResults);
+
+    levelSearchIdx = 0;
+}
+
+void MenuGame::moveLevelSearchSelection(const int dir)
+{
+    if(levelSearchResults.empty())
+    {
+        return;
+    }
+
+    levelSearchIdx = ssvu::getMod(levelSearchIdx + dir, 0,
+        static_cast<int>(levelSearchResults.size()));
+
+    playSoundOverride("beep.ogg");
+    touchDelay = 50.f;
+}
+
+void MenuGame::jumpToLevelSearchResult()
+{
+    if(levelSearchResults.empty())
+    {
+        return;
+    }
+
+    const std::string levelId{levelSearchResults.at(levelSearchIdx)};
+    openCloseLevelSearch();
+
+    const std::string& packId = assets.getLevelData(levelId).packId;
+    const auto& p{assets.getSelectablePackInfos()};
+
+    const auto packIt = std::find_if(p.begin(), p.end(),
+        [&](const PackInfo& pi) { return pi.id == packId; });
+
+    // The search index only contains the levels of selectable packs.
+    SSVOH_ASSERT(packIt != p.end());
+
+    const std::vector<std::string>& levelIds = assets.getLevelIdsByPack(packId);
+    const auto levelIt = std::find(levelIds.begin(), levelIds.end(), levelId);
+
+    SSVOH_ASSERT(levelIt != levelIds.end());
+
+    // Quickly finish any ongoing pack changes, the found level is always shown
+    // in the list of all levels.
+    packChangeState = PackChange::Rest;
+    packChangeOffset = 0.f;
+    lvlDrawer = &lvlSlct;
+
+    changePackTo(static_cast<int>(packIt - p.begin()));
+    setIndex(static_cast<int>(levelIt - levelIds.begin()));
+    adjustLevelsOffset();
+
+    // Scroll the level list to show the found level.
+    const float top{packLabelHeight * (lvlSlct.packIdx + 1) +
+                    levelLabelHeight * lvlSlct.currentIndex};
+    const float bottom{top + levelLabelHeight + 2.f * slctFrameSize};
+
+    if(top < -lvlSlct.YOffset)
+    {
+        lvlSlct.YScrollTo = lvlSlct.YOffset = -top;
+    }
+    else if(bottom > h - lvlSlct.YOffset)
+    {
+        lvlSlct.YScrollTo = lvlSlct.YOffset = h - bottom;
+    }
+}
+
+void MenuGame::drawLevelSearch()
+{
+    constexpr int maxVisibleResults{10};
+
+    const int resultsSize{static_cast<int>(levelSearchResults.size())};
+    const int firstVisible{
+        std::max(0, levelSearchIdx - maxVisibleResults + 1)};
+    const int visibleResults{
+        std::min(resultsSize - firstVisible, maxVisibleResults)};
+
+    // Calculate coordinates
+    const float queryHeight{txtSelectionMedium.height * 1.5f},
+        rowHeight{txtSelectionSmall.height * 1.5f}, indent{w * 0.25f},
+        width{w * 0.5f}, top{h * 0.15f}, textIndent{indent + slctFrameSize},
+        rowsTop{top + slctFrameSize + queryHeight},
+        bottom{rowsTop + rowHeight * std::max(visibleResults, 1) +
+               slctFrameSize};
+
+    // Draw the quads that surround the text
+    menuQuads.clear();
+    menuQuads.reserve_quad(3);
+
+    createQuad(menuTextColor, indent - slctFrameSize,
+        indent + width + slctFrameSize, top - slctFrameSize,
+        bottom + slctFrameSize);
+
+    createQuad(menuQuadColor, indent, indent + width, top, bottom);
+
+    if(visibleResults > 0)
+    {
+        const float selectedTop{
+            rowsTop + rowHeight * (levelSearchIdx - firstVisible)};
+
+        createQuad(menuSelectionColor, indent, indent + width, selectedTop,
+            selectedTop + rowHeight);
+    }
+
+    render(menuQuads);
+
+    // Draw the query and the results on top of the quads
+    renderText("SEARCH: " + Utils::toUppercase(levelSearchQuery) + '_',
+        txtSelectionMedium.font, {textIndent, top + slctFrameSize},
+        menuTextColor);
+
+    if(visibleResults == 0)
+    {
+        renderText(levelSearchQuery.empty()
+                       ? "TYPE A LEVEL NAME, AUTHOR, PACK OR DESCRIPTION"
+                       : "NO LEVELS FOUND",
+            txtSelectionSmall.font, {textIndent, rowsTop}, menuTextColor);
+
+        return;
+    }
+
+    float height{rowsTop};
+
+    for(int i = firstVisible; i < firstVisible + visibleResults; ++i)
+    {
+        const LevelData& data = assets.getLevelData(levelSearchResults[i]);
+        const PackData& packData = assets.getPackData(data.packId);
+
+        renderText(Utils::concat(data.name, " - ", packData.name),
+            txtSelectionSmall.font, {textIndent, height}, menuTextColor);
+
+        height += rowHeight;
+    }
+}
+
 void MenuGame::drawLevelSelectionRightSide(
     LevelDrawer& drawer, const bool revertOffset)
 {
@@ -4936,8 +5230,9 @@ void MenuGame::drawLevelSelectionRightSide(
     // be drawn last).
 
     topLeft = {w / 2.f, 2.f};
-    tempString = isFavoriteLevels() ? "PRESS F2 TO SHOW ALL LEVELS"
-                                    : "PRESS F2 TO SHOW FAVORITE LEVELS";
+    tempString = isFavoriteLevels()
+                     ? "PRESS F2 TO SHOW ALL LEVELS, F5 TO SEARCH"
+                     : "PRESS F2 TO SHOW FAVORITE LEVELS, F5 TO SEARCH";
     renderTextCentered(tempString, txtSelectionSmall.font, topLeft);
     tempString = "\nHOLD FOCUS TO JUMP BETWEEN PACKS";
     renderTextCentered(tempString, txtSelectionSmall.font, topLeft);
@@ -4952,6 +5247,10 @@ void MenuGame::drawLevelSelectionRightSide(
     height = packLabelHeight * (isFavoriteLevels() ? 1 : drawer.packIdx + 1) +
              slctFrameSize - packChangeOffset + drawer.YOffset;
 
+    // Level labels do not overlap each other, so their text is only flushed
+    // before drawing the ranked badges, which are drawn over the level names.
+    flushText();
+
     for(i = 0; i < levelsSize; ++i)
     {
         //-------------------------------------
@@ -5019,7 +5318,7 @@ void MenuGame::drawLevelSelectionRightSide(
             }
         }
 
-        render(menuQuads);
+        renderBelowText(menuQuads);
         prevLevelIndent = indent;
 
         //-------------------------------------
@@ -5096,7 +5395,7 @@ void MenuGame::drawLevelSelectionRightSide(
     menuQuads.reserve_quad(1);
     createQuad(
         menuQuadColor, prevLevelIndent, w, height, height + slctFrameSize);
-    render(menuQuads);
+    renderBelowText(menuQuads);
 
     height += slctFrameSize;
     i = ssvu::getMod(drawer.packIdx + 1, packsSize);
@@ -5110,6 +5409,9 @@ void MenuGame::drawLevelSelectionRightSide(
 
     const float arrowWidth{packLabelHeight / 2.f - textToQuadBorder};
 
+    // Pack labels are drawn over the level list, but not over each other.
+    flushText();
+
     do
     {
         // Quads
@@ -5137,7 +5439,7 @@ void MenuGame::drawLevelSelectionRightSide(
             mustChangePackIndexTo = i;
         }
 
-        render(menuQuads);
+        renderBelowText(menuQuads);
 
         // Name & >
         if(drawer.isFavorites)
@@ -5150,22 +5452,19 @@ void MenuGame::drawLevelSelectionRightSide(
             Utils::uppercasify(tempString);
         }
 
-        txtSelectionMedium.font.setString(tempString);
-        temp =
-            std::max(
-                txtIndent - ssvs::getGlobalWidth(txtSelectionMedium.font) / 2.f,
-                quadsIndent + arrowWidth + 2.f * slctFrameSize + outerFrame) +
-            panelOffset;
+        const float packNameWidth =
+            textBatch.getGlobalBounds(txtSelectionMedium.font, tempString)
+                .width;
 
-        txtSelectionMedium.font.setPosition(
-            {temp, height + outerFrame -
-                       txtSelectionMedium.height * fontHeightOffset});
+        temp = std::max(txtIndent - packNameWidth / 2.f,
+                   quadsIndent + arrowWidth + 2.f * slctFrameSize +
+                       outerFrame) +
+               panelOffset;
 
-        const sf::Color oldC = txtSelectionMedium.font.getFillColor();
-        txtSelectionMedium.font.setFillColor(
+        renderText(tempString, txtSelectionMedium.font,
+            {temp, height + outerFrame -
+                       txtSelectionMedium.height * fontHeightOffset},
             mouseOverlapColor(mouseOverlap, menuTextColor));
-        render(txtSelectionMedium.font);
-        txtSelectionMedium.font.setFillColor(oldC);
 
         menuQuads.clear();
         menuQuads.reserve_quad(2);
@@ -5203,7 +5502,7 @@ void MenuGame::drawLevelSelectionRightSide(
             menuQuads.batch_unsafe_emplace_back_quad(
                 menuTextColor, topLeft, bottomLeft, bottomRight, topRight);
 
-            render(menuQuads);
+            renderBelowText(menuQuads);
         }
         else
         {
@@ -5235,7 +5534,7 @@ void MenuGame::drawLevelSelectionRightSide(
             menuQuads.batch_unsafe_emplace_back_quad(
                 menuTextColor, topLeft, bottomLeft, bottomRight, topRight);
 
-            render(menuQuads);
+            renderBelowText(menuQuads);
             height -= slctFrameSize / 2.f;
         }
 
@@ -5332,8 +5631,10 @@ void MenuGame::drawLevelSelectionLeftSide(
     const float difficultyHeight{
         height - txtSelectionMedium.height * fontHeightOffset};
 
-    renderText("DIFFICULTY: ", txtSelectionMedium.font,
-        {textXPos, difficultyHeight}, menuQuadColor);
+    const float difficultyLabelWidth =
+        renderText("DIFFICULTY: ", txtSelectionMedium.font,
+            {textXPos, difficultyHeight}, menuQuadColor)
+            .width;
 
     tempString =
         levelData.difficultyMults.size() > 1
@@ -5346,7 +5647,7 @@ void MenuGame::drawLevelSelectionLeftSide(
         {difficultyBumpFactor, difficultyBumpFactor});
 
     renderText(tempString, txtSelectionMedium.font,
-        {textXPos + txtSelectionMedium.font.getGlobalBounds().width,
+        {textXPos + difficultyLabelWidth * difficultyBumpFactor,
             difficultyHeight});
 
     txtSelectionMedium.font.setScale({1.f, 1.f});
@@ -5546,8 +5847,7 @@ void MenuGame::drawLevelSelectionLeftSide(
         hexagonClient.isLevelSupportedByServer(levelValidator) &&
         leaderboardCache->shouldRequestScores(levelValidator))
     {
-        hexagonClient.tryRequestTopScoresAndOwnScore(levelValidator);
-        leaderboardCache->requestedScores(levelValidator);
+        requestLeaderboardPage(levelValidator);
     }
 
     const bool gotScoreInfo = leaderboardCache->hasInformation(levelValidator);
@@ -5588,27 +5888,8 @@ void MenuGame::drawLevelSelectionLeftSide(
 
 
 
-        const auto drawEntry = [&](const int i, const std::string& userName,
-                                   const std::uint64_t scoreTimestamp,
-                                   const double scoreValue)
+        const auto drawEntry = [&](const LeaderboardCache::FormattedScore& fs)
         {
-            const float score = scoreValue;
-
-            const auto tp = Utils::toTimepoint(scoreTimestamp);
-
-            const std::string timestampStr =
-                Utils::formatTimepoint(tp, "%Y-%m-%d %H:%M:%S");
-
-            const std::string posStr = Utils::concat('#', i + 1);
-            std::string scoreStr = ssvu::toStr(score) + 's';
-
-            std::string playerStr = userName;
-            if(playerStr.size() > 19)
-            {
-                playerStr.resize(16);
-                playerStr += "...";
-            }
-
             const float tx = textToQuadBorder - panelOffset;
             const float ty = height -
                              txtSelectionMedium.height * fontHeightOffset +
@@ -5616,11 +5897,12 @@ void MenuGame::drawLevelSelectionLeftSide(
 
             constexpr float ySpacing = 11.f;
 
-            renderText(timestampStr, txtSelectionSmall.font, {tx, ty});
-            renderText(posStr, txtSelectionMedium.font, {tx, ty + ySpacing});
+            renderText(fs.timestamp, txtSelectionSmall.font, {tx, ty});
+            renderText(
+                fs.position, txtSelectionMedium.font, {tx, ty + ySpacing});
             renderText(
-                scoreStr, txtSelectionMedium.font, {tx + 58.f, ty + ySpacing});
-            renderText(playerStr, txtSelectionMedium.font,
+                fs.score, txtSelectionMedium.font, {tx + 58.f, ty + ySpacing});
+            renderText(fs.userName, txtSelectionMedium.font,
                 {tx + 185.f, ty + ySpacing});
 
             height += txtSelectionMedium.height + txtSelectionSmall.height +
@@ -5629,16 +5911,13 @@ void MenuGame::drawLevelSelectionLeftSide(
 
         if(gotScoreInfo)
         {
-            const auto scores = leaderboardCache->getScores(levelValidator);
+            const auto& scores = leaderboardCache->getScores(levelValidator);
 
             if(!scores.empty())
             {
-                int index = 0;
-                for(const Database::ProcessedScore& ps : scores)
+                for(const LeaderboardCache::FormattedScore& fs : scores)
                 {
-                    drawEntry(
-                        index, ps.userName, ps.scoreTimestamp, ps.scoreValue);
-                    ++index;
+                    drawEntry(fs);
                 }
 
                 height -= txtSelectionMedium.height + txtSelectionSmall.height;
@@ -5684,8 +5963,7 @@ void MenuGame::drawLevelSelectionLeftSide(
             }
             else
             {
-                drawEntry(ownScore->position, ownScore->userName,
-                    ownScore->scoreTimestamp, ownScore->scoreValue);
+                drawEntry(*ownScore);
             }
         }
     }
@@ -5695,6 +5973,15 @@ void MenuGame::drawLevelSelectionLeftSide(
 
 void MenuGame::draw()
 {
+    SSVOH_PROFILE_FRAME();
+    SSVOH_PROFILE_SCOPE("MenuGame::draw");
+
+    // Queued text is drawn last, also when returning early.
+    HG_SCOPE_GUARD({
+        flushText();
+        textBatch.endFrame();
+    });
+
     mouseHovering = false;
     mouseWasPressed = mousePressed;
     mousePressed =
@@ -5898,12 +6185,20 @@ void MenuGame::draw()
             }
 
             drawLevelSelectionLeftSide(*lvlDrawer, false);
+
+            if(levelSearchOpen)
+            {
+                drawLevelSearch();
+            }
+
             drawOnlineStatus();
             break;
 
         default: break;
     }
 
+    flushText();
+
     if(mustTakeScreenshot)
     {
         window.saveScreenshot("screenshot.png");
@@ -5923,10 +6218,22 @@ void MenuGame::draw()
 }
 
 void MenuGame::render(sf::Drawable& mDrawable)
+{
+    // Keep the layering of queued text and other drawables.
+    flushText();
+    window.draw(mDrawable);
+}
+
+void MenuGame::renderBelowText(sf::Drawable& mDrawable)
 {
     window.draw(mDrawable);
 }
 
+void MenuGame::flushText()
+{
+    textBatch.flush(window.getRenderWindow());
+}
+
 [[nodiscard]] float MenuGame::getFPSMult() const
 {
     // multiplier for FPS consistent drawing operations.
@@ -5943,6 +6250,8 @@ void MenuGame::drawGraphics()
 
 void MenuGame::drawOnlineStatus()
 {
+    flushText();
+
     window.getRenderWindow().setView(
         sf::View{{{0.f, 0.f}, {getWindowWidth(), getWindowHeight()}}});
 
@@ -0,0 +1,275 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Core/ProfileJournal.hpp"
+
+#include "SSVOpenHexagon/Data/ProfileData.hpp"
+
+#include "SSVOpenHexagon/Global/Profiler.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace hg {
+
+[[nodiscard]] bool ProfileJournal::writeSnapshot(const Job& job)
+{
+    const std::string tmpPath = job.snapshotPath + ".tmp";
+
+    {
+        std::ofstream os{tmpPath, std::ios::trunc};
+        job.writeSnapshot(os);
+        os.close();
+
+        if(!os)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+
+    // Replaces the old snapshot at once, so that a crash leaves either the
+    // old or the new one.
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, job.snapshotPath, ec);
+
+    if(ec)
+    {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void ProfileJournal::workerLoop()
+{
+    std::unique_lock lock{_mutex};
+
+    while(true)
+    {
+        _cv.wait(lock, [this] { return !_queue.empty() || _stopRequested; });
+
+        // Queued writes are never dropped, even when stopping.
+        if(_queue.empty())
+        {
+            return;
+        }
+
+        Job job = std::move(_queue.front());
+        _queue.pop_front();
+
+        _running = true;
+        _runningJournalPath = job.journalPath;
+        lock.unlock();
+
+        bool failed = false;
+
+        if(job.writeSnapshot)
+        {
+            SSVOH_PROFILE_SCOPE("ProfileJournal::compact");
+
+            // The journal is kept if the snapshot was not written, its
+            // entries are replayed over the old snapshot instead.
+            if(writeSnapshot(job))
+            {
+                std::ofstream{job.journalPath, std::ios::trunc};
+            }
+            else
+            {
+                failed = true;
+            }
+        }
+        else
+        {
+            std::ofstream{job.journalPath, std::ios::app} << job.line;
+        }
+
+        lock.lock();
+        _running = false;
+        _runningJournalPath.clear();
+
+        if(failed)
+        {
+            ++_failedCompactions;
+        }
+
+        // Also wakes up `remove`, waiting for this job only.
+        _idleCv.notify_all();
+    }
+}
+
+void ProfileJournal::push(Job&& job)
+{
+    {
+        std::lock_guard lock{_mutex};
+        _queue.emplace_back(std::move(job));
+    }
+
+    _cv.notify_one();
+}
+
+ProfileJournal::ProfileJournal() : _worker{[this] { workerLoop(); }}
+{}
+
+ProfileJournal::~ProfileJournal()
+{
+    {
+        std::lock_guard lock{_mutex};
+        _stopRequested = true;
+    }
+
+    _cv.notify_one();
+    _worker.join();
+}
+
+void ProfileJournal::appendScore(const std::string& journalPath,
+    const std::string& levelId, const float score)
+{
+    // Shortest representation that reads back as the same float.
+    char buf[32];
+    char* const end = std::to_chars(buf, buf + sizeof(buf), score).ptr;
+
+    std::string line = "s ";
+    line.append(buf, end);
+    line += ' ';
+    line += levelId;
+    line += '\n';
+
+    push(Job{.journalPath = journalPath,
+        .line = std::move(line),
+        .snapshotPath = {},
+        .writeSnapshot = {}});
+    ++_entriesSinceCompaction[journalPath];
+}
+
+void ProfileJournal::appendFavorite(const std::string& journalPath,
+    const std::string& levelId, const bool favorite)
+{
+    std::string line = favorite ? "f " : "u ";
+    line += levelId;
+    line += '\n';
+
+    push(Job{.journalPath = journalPath,
+        .line = std::move(line),
+        .snapshotPath = {},
+        .writeSnapshot = {}});
+    ++_entriesSinceCompaction[journalPath];
+}
+
+void ProfileJournal::compact(const std::string& journalPath,
+    const std::string& snapshotPath, SnapshotWriter&& writeSnapshot)
+{
+    push(Job{.journalPath = journalPath,
+        .line = {},
+        .snapshotPath = snapshotPath,
+        .writeSnapshot = std::move(writeSnapshot)});
+
+    _entriesSinceCompaction[journalPath] = 0;
+}
+
+[[nodiscard]] bool ProfileJournal::remove(
+    const std::string& journalPath, const std::string& snapshotPath)
+{
+    {
+        std::unique_lock lock{_mutex};
+
+        std::erase_if(_queue,
+            [&](const Job& job) { return job.journalPath == journalPath; });
+
+        _idleCv.wait(lock,
+            [&] { return !_running || _runningJournalPath != journalPath; });
+    }
+
+    // Only the main thread queues jobs, so none for `journalPath` can start
+    // while the files are deleted.
+    _entriesSinceCompaction.erase(journalPath);
+    std::remove(journalPath.c_str());
+
+    return std::remove(snapshotPath.c_str()) == 0;
+}
+
+[[nodiscard]] std::size_t ProfileJournal::getEntriesSinceCompaction(
+    const std::string& journalPath) const
+{
+    const auto it = _entriesSinceCompaction.find(journalPath);
+    return it == _entriesSinceCompaction.end() ? 0 : it->second;
+}
+
+void ProfileJournal::flush()
+{
+    std::unique_lock lock{_mutex};
+    _idleCv.wait(lock, [this] { return _queue.empty() && !_running; });
+}
+
+[[nodiscard]] std::size_t ProfileJournal::getFailedCompactionCount()
+{
+    std::lock_guard lock{_mutex};
+    return _failedCompactions;
+}
+
+std::size_t ProfileJournal::replay(
+    const std::string& journalPath, ProfileData& profileData)
+{
+    std::ifstream is{journalPath};
+
+    std::size_t count = 0;
+    std::string line;
+
+    // The last line is only complete if it ends with a newline.
+    while(std::getline(is, line) && !is.eof())
+    {
+        if(line.size() < 3 || line[1] != ' ')
+        {
+            continue;
+        }
+
+        if(line[0] == 'f')
+        {
+            profileData.addFavoriteLevel(line.substr(2));
+        }
+        else if(line[0] == 'u')
+        {
+            profileData.removeFavoriteLevel(line.substr(2));
+        }
+        else if(line[0] == 's')
+        {
+            const std::size_t idBegin = line.find(' ', 2);
+            if(idBegin == std::string::npos || idBegin + 1 == line.size())
+            {
+                continue;
+            }
+
+            float score;
+            const auto [ptr, ec] = std::from_chars(
+                line.data() + 2, line.data() + idBegin, score);
+
+            if(ec != std::errc{} || ptr != line.data() + idBegin)
+            {
+                continue;
+            }
+
+            profileData.setScore(line.substr(idBegin + 1), score);
+        }
+        else
+        {
+            continue;
+        }
+
+        ++count;
+    }
+
+    _entriesSinceCompaction[journalPath] = count;
+    return count;
+}
+
+} // namespace hg
@@ -0,0 +1,272 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Core/VertexPipeline.hpp"
+
+#include "SSVOpenHexagon/Global/Assert.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
+
+#include "SSVOpenHexagon/Utils/Color.hpp"
+#include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace hg {
+
+namespace {
+
+using Extrude3DFloats = float __attribute__((vector_size(16)));
+using Extrude3DWords = std::uint32_t __attribute__((vector_size(16)));
+
+// The vectorized path treats groups of four vertices as five 16-byte vectors,
+// which requires `sf::Vertex` to be five 32-bit words with the position in the
+// first two and the color in the third.
+constexpr bool extrude3DCanVectorize =
+    sizeof(sf::Vertex) == 5 * sizeof(float) &&
+    sizeof(sf::Color) == sizeof(std::uint32_t) &&
+    offsetof(sf::Vertex, position) == 0 &&
+    offsetof(sf::Vertex, color) == 2 * sizeof(float) &&
+    offsetof(sf::Vertex, texCoords) == 3 * sizeof(float);
+
+constexpr std::size_t extrude3DWordsPerVertex = 5;
+constexpr std::size_t extrude3DVerticesPerGroup = 4;
+
+void extrude3DLayer(const sf::Vertex* const source, sf::Vertex* const target,
+    const std::size_t n, const sf::Vector2f& offset, const sf::Color& color)
+{
+    std::size_t i = 0;
+
+    if constexpr(extrude3DCanVectorize)
+    {
+        std::uint32_t colorWord;
+        std::memcpy(&colorWord, &color, sizeof(colorWord));
+
+        // For every vector of a group: what to add to each lane, which bits to
+        // keep and which color bits to write. Color words are fully replaced,
+        // so adding zero to them is harmless whatever their bit pattern.
+        Extrude3DFloats add[extrude3DWordsPerVertex];
+        Extrude3DWords keep[extrude3DWordsPerVertex];
+        Extrude3DWords paint[extrude3DWordsPerVertex];
+
+        for(std::size_t v = 0; v < extrude3DWordsPerVertex; ++v)
+        {
+            for(std::size_t lane = 0; lane < 4; ++lane)
+            {
+                const std::size_t field = (v * 4 + lane) % 5;
+
+                add[v][lane] = field == 0 ? offset.x
+                               : field == 1 ? offset.y
+                                            : 0.f;
+
+                keep[v][lane] = field == 2 ? 0u : ~0u;
+                paint[v][lane] = field == 2 ? colorWord : 0u;
+            }
+        }
+
+        const auto* in = reinterpret_cast<const unsigned char*>(source);
+        auto* out = reinterpret_cast<unsigned char*>(target);
+
+        const auto processVector = [&](const std::size_t groupOffset,
+                                       const std::size_t v)
+        {
+            const std::size_t byteOffset =
+                groupOffset + v * sizeof(Extrude3DFloats);
+
+            Extrude3DFloats f;
+            std::memcpy(&f, in + byteOffset, sizeof(f));
+
+            const Extrude3DWords w =
+                (std::bit_cast<Extrude3DWords>(f + add[v]) & keep[v]) |
+                paint[v];
+
+            std::memcpy(out + byteOffset, &w, sizeof(w));
+        };
+
+        // Manually unrolled so that all the masks stay in registers.
+        for(; i + extrude3DVerticesPerGroup <= n;
+            i += extrude3DVerticesPerGroup)
+        {
+            const std::size_t groupOffset = i * sizeof(sf::Vertex);
+
+            processVector(groupOffset, 0);
+            processVector(groupOffset, 1);
+            processVector(groupOffset, 2);
+            processVector(groupOffset, 3);
+            processVector(groupOffset, 4);
+        }
+    }
+
+    for(; i < n; ++i)
+    {
+        target[i] = sf::Vertex{
+            source[i].position + offset, color, source[i].texCoords};
+    }
+}
+
+} // namespace
+
+void extrude3D(const Extrusion3DParams& params, const sf::Color& layerColor,
+    const Utils::FastVertexVectorTris& source,
+    Utils::FastVertexVectorTris& target)
+{
+    SSVOH_ASSERT(params.alphaMult != 0.f);
+
+    const std::size_t n = source.size();
+    if(n == 0 || params.depth == 0)
+    {
+        return;
+    }
+
+    target.reserve(target.size() + n * params.depth);
+    sf::Vertex* const out = target.unsafe_grow(n * params.depth);
+
+    const float baseAlpha = static_cast<float>(layerColor.a) / params.alphaMult;
+
+    for(std::size_t j = 0; j < params.depth; ++j)
+    {
+        const auto i = static_cast<float>(params.depth - j - 1);
+
+        const float offset = params.spacing *
+                             ((i + 1.f) * params.perspectiveMult) *
+                             (params.effect * 3.6f) * 1.4f;
+
+        const sf::Vector2f newPos{
+            offset * params.cosRot, offset * params.sinRot};
+
+        sf::Color color = layerColor;
+        color.a = Utils::componentClamp(baseAlpha - i * params.alphaFalloff);
+
+        extrude3DLayer(source.begin(), out + j * n, n, newPos, color);
+    }
+}
+
+void FrameVertices::clear() noexcept
+{
+    wallQuads.clear();
+    pivotQuads.clear();
+    playerTris.clear();
+    capTris.clear();
+    wallQuads3D.clear();
+    pivotQuads3D.clear();
+    playerTris3D.clear();
+
+    extrusion3D.reset();
+}
+
+void FrameVertices::build3D()
+{
+    SSVOH_PROFILE_SCOPE("FrameVertices::build3D");
+
+    if(!extrusion3D.has_value())
+    {
+        return;
+    }
+
+    const Extrusion3DParams& p = *extrusion3D;
+
+    extrude3D(p, p.wallColor, wallQuads, wallQuads3D);
+    extrude3D(p, p.pivotColor, pivotQuads, pivotQuads3D);
+    extrude3D(p, p.playerColor, playerTris, playerTris3D);
+}
+
+void VertexPipeline::workerLoop()
+{
+    std::unique_lock lock{_mutex};
+
+    while(true)
+    {
+        _cv.wait(lock, [this] { return _jobPending || _stopRequested; });
+
+        if(_stopRequested)
+        {
+            return;
+        }
+
+        FrameVertices& frame = _frames[_jobIdx];
+
+        lock.unlock();
+        frame.build3D();
+        lock.lock();
+
+        _jobPending = false;
+        _cv.notify_all();
+    }
+}
+
+void VertexPipeline::waitForWorker()
+{
+    std::unique_lock lock{_mutex};
+    _cv.wait(lock, [this] { return !_jobPending; });
+}
+
+VertexPipeline::VertexPipeline() = default;
+
+VertexPipeline::~VertexPipeline()
+{
+    if(!_worker.joinable())
+    {
+        return;
+    }
+
+    {
+        std::scoped_lock lock{_mutex};
+        _stopRequested = true;
+    }
+
+    _cv.notify_all();
+    _worker.join();
+}
+
+[[nodiscard]] FrameVertices& VertexPipeline::getBackFrame() noexcept
+{
+    return _frames[_backIdx];
+}
+
+[[nodiscard]] const FrameVertices& VertexPipeline::buildBackFrame()
+{
+    waitForWorker();
+
+    // Avoid showing a stale frame if pipelining is enabled later on.
+    _frames[1 - _backIdx].clear();
+
+    FrameVertices& back = _frames[_backIdx];
+    back.build3D();
+
+    return back;
+}
+
+[[nodiscard]] const FrameVertices& VertexPipeline::submitBackFrame()
+{
+    if(!_worker.joinable())
+    {
+        _worker = std::thread{[this] { workerLoop(); }};
+    }
+
+    waitForWorker();
+
+    {
+        std::scoped_lock lock{_mutex};
+        _jobIdx = _backIdx;
+        _jobPending = true;
+    }
+
+    _cv.notify_all();
+
+    // The other frame was either built by the previous submission or rendered
+    // by the previous call. Either way the worker is done with it, and the
+    // main thread will only overwrite it once rendering is over.
+    _backIdx = 1 - _backIdx;
+    return _frames[_backIdx];
+}
+
+} // namespace hg
@@ -15,6 +15,7 @@
 #include "SSVOpenHexagon/Global/Assert.hpp"
 #include "SSVOpenHexagon/Global/Config.hpp"
 #include "SSVOpenHexagon/Global/Imgui.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 #include "SSVOpenHexagon/Global/Version.hpp"
 
 #include "SSVOpenHexagon/Utils/Concat.hpp"
@@ -82,6 +83,7 @@ struct ParsedArgs
     std::vector<std::string> args;
     std::optional<std::string> cliLevelName;
     std::optional<std::string> cliLevelPack;
+    std::optional<std::string> traceFile;
     bool printLuaDocs{false};
     bool headless{false};
     bool server{false};
@@ -109,6 +111,14 @@ struct ParsedArgs
             continue;
         }
 
+        // Find command-line profiler trace output file
+        if(!std::strcmp(argv[i], "-trace") && i + 1 < argc)
+        {
+            ++i;
+            result.traceFile = argv[i];
+            continue;
+        }
+
         // Find command-line argument to print Lua docs
         if(!std::strcmp(argv[i], "-printLuaDocs"))
         {
@@ -644,10 +654,30 @@ int main(int argc, char* argv[])
     //
     // ------------------------------------------------------------------------
     // Parse command line arguments
-    const auto [args, cliLevelName, cliLevelPack, printLuaDocs, headlessB,
-        server] = parseArgs(argc, argv);
+    const auto [args, cliLevelName, cliLevelPack, traceFile, printLuaDocs,
+        headlessB, server] = parseArgs(argc, argv);
     const auto headless = headlessB; // Workaround binding capture
 
+    //
+    //
+    // ------------------------------------------------------------------------
+    // Profiler trace (written at the end of the scope)
+    if(traceFile.has_value())
+    {
+        if(!hg::Profiler::enabled)
+        {
+            ssvu::lo("::main") << "Profiler not compiled in, rebuild with "
+                                  "'SSVOH_ENABLE_PROFILER' to use '-trace'\n";
+        }
+        else if(!hg::Profiler::startTrace(*traceFile))
+        {
+            ssvu::lo("::main") << "Failed to open trace file '" << *traceFile
+                               << "'\n";
+        }
+    }
+
+    HG_SCOPE_GUARD({ hg::Profiler::stopTrace(); });
+
     //
     //
     // ------------------------------------------------------------------------
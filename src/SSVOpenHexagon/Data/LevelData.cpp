@@ -31,7 +31,11 @@ LevelData::LevelData(const ssvuj::Obj& mRoot, const std::string& mPackPath,
                                    mRoot, "luaFile", "nullLuaPath")},
       difficultyMults{
           ssvuj::getExtr<std::vector<float>>(mRoot, "difficultyMults", {})},
-      unscored{ssvuj::getExtr<bool>(mRoot, "unscored", false)}
+      unscored{ssvuj::getExtr<bool>(mRoot, "unscored", false)},
+      luaInstructionBudgetPerCall{ssvuj::getExtr<unsigned long long>(mRoot,
+          "luaInstructionBudgetPerCall", defaultLuaInstructionBudgetPerCall)},
+      luaInstructionBudgetTotal{ssvuj::getExtr<unsigned long long>(
+          mRoot, "luaInstructionBudgetTotal", defaultLuaInstructionBudgetTotal)}
 {
     difficultyMults.emplace_back(1.f);
     std::sort(difficultyMults.begin(), difficultyMults.end());
@@ -65,4 +65,13 @@ void MusicData::playSeconds(
     }
 }
 
+void MusicData::prefetchSegment(
+    const std::string& mPackId, Audio& mAudio, std::size_t mIdx) const
+{
+    if(mIdx < segments.size())
+    {
+        mAudio.prefetchMusic(mPackId, id, segments[mIdx].time);
+    }
+}
+
 } // namespace hg
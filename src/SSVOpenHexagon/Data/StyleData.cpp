@@ -11,11 +11,16 @@
 #include "SSVOpenHexagon/SSVUtilsJson/SSVUtilsJson.hpp"
 #include "SSVOpenHexagon/Global/UtilsJson.hpp"
 
+#include <SSVUtils/Core/Log/Log.hpp>
 #include <SSVUtils/Core/Utils/Math.hpp>
 
 #include <SSVStart/Utils/Vector2.hpp>
 #include <SSVStart/Utils/SFML.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <span>
+
 namespace hg {
 
 [[nodiscard]] ColorData StyleData::colorDataFromObjOrDefault(
@@ -29,10 +34,53 @@ namespace hg {
     return mDefault;
 }
 
-StyleData::StyleData() = default;
+[[nodiscard]] std::shared_ptr<const StyleData::Definition>
+StyleData::loadDefinition(const ssvuj::Obj& mRoot)
+{
+    auto result = std::make_shared<Definition>();
+
+    result->id = ssvuj::getExtr<std::string>(mRoot, "id", "nullId");
+
+    result->_3dOverrideColor = ssvuj::getExtr<sf::Color>(
+        mRoot, "3D_override_color", sf::Color::Transparent);
+
+    result->mainColorData = ColorData{ssvuj::getObj(mRoot, "main")};
+
+    result->playerColor = colorDataFromObjOrDefault(
+        mRoot, "player_color", result->mainColorData);
+
+    result->textColor = colorDataFromObjOrDefault(
+        mRoot, "text_color", result->mainColorData);
+
+    result->wallColor = colorDataFromObjOrDefault(
+        mRoot, "wall_color", result->mainColorData);
+
+    const auto& objColors(ssvuj::getObj(mRoot, "colors"));
+    auto colorCount(ssvuj::getObjSize(objColors));
+
+    if(colorCount > maxColors)
+    {
+        ssvu::lo("StyleData")
+            << "Style '" << result->id << "' has more than " << maxColors
+            << " colors, the remaining ones are ignored\n";
+
+        colorCount = maxColors;
+    }
+
+    result->colorDatas.reserve(colorCount);
+    for(auto i(0u); i < colorCount; i++)
+    {
+        result->colorDatas.emplace_back(ssvuj::getObj(objColors, i));
+    }
+
+    return result;
+}
+
+StyleData::StyleData() : definition{std::make_shared<const Definition>()}
+{}
 
 StyleData::StyleData(const ssvuj::Obj& mRoot)
-    : id{ssvuj::getExtr<std::string>(mRoot, "id", "nullId")},
+    : definition{loadDefinition(mRoot)},
       hueMin{ssvuj::getExtr<float>(mRoot, "hue_min", 0.f)},
       hueMax{ssvuj::getExtr<float>(mRoot, "hue_max", 360.f)},
       hueIncrement{ssvuj::getExtr<float>(mRoot, "hue_increment", 0.f)},
@@ -54,26 +102,9 @@ StyleData::StyleData(const ssvuj::Obj& mRoot)
       _3dPulseSpeed{ssvuj::getExtr<float>(mRoot, "3D_pulse_speed", 0.01f)},
       _3dPerspectiveMult{
           ssvuj::getExtr<float>(mRoot, "3D_perspective_multiplier", 1.f)},
-      _3dOverrideColor{ssvuj::getExtr<sf::Color>(
-          mRoot, "3D_override_color", sf::Color::Transparent)},
-      mainColorData{ssvuj::getObj(mRoot, "main")}, //
-      playerColor{
-          colorDataFromObjOrDefault(mRoot, "player_color", mainColorData)}, //
-      textColor{
-          colorDataFromObjOrDefault(mRoot, "text_color", mainColorData)}, //
-      wallColor{colorDataFromObjOrDefault(mRoot, "wall_color", mainColorData)},
       capColor{parseCapColor(ssvuj::getObj(mRoot, "cap_color"))}
 {
     currentHue = hueMin;
-
-    const auto& objColors(ssvuj::getObj(mRoot, "colors"));
-    const auto& colorCount(ssvuj::getObjSize(objColors));
-
-    colorDatas.reserve(colorCount);
-    for(auto i(0u); i < colorCount; i++)
-    {
-        colorDatas.emplace_back(ssvuj::getObj(objColors, i));
-    }
 }
 
 sf::Color StyleData::calculateColor(const float mCurrentHue,
@@ -171,28 +202,34 @@ void StyleData::update(ssvu::FT mFT, float mMult)
 
 void StyleData::computeColors()
 {
-    currentMainColor = calculateColor(currentHue, pulseFactor, mainColorData);
-    currentPlayerColor = calculateColor(currentHue, pulseFactor, playerColor);
-    currentTextColor = calculateColor(currentHue, pulseFactor, textColor);
-    currentWallColor = calculateColor(currentHue, pulseFactor, wallColor);
+    const Definition& def = *definition;
+
+    currentMainColor =
+        calculateColor(currentHue, pulseFactor, def.mainColorData);
+    currentPlayerColor =
+        calculateColor(currentHue, pulseFactor, def.playerColor);
+    currentTextColor = calculateColor(currentHue, pulseFactor, def.textColor);
+    currentWallColor = calculateColor(currentHue, pulseFactor, def.wallColor);
 
     current3DOverrideColor =
-        _3dOverrideColor.a != 0 ? _3dOverrideColor : getMainColor();
+        def._3dOverrideColor.a != 0 ? def._3dOverrideColor : getMainColor();
 
-    currentColors.clear();
+    currentColorCount = def.colorDatas.size();
 
-    for(const ColorData& cd : colorDatas)
+    for(std::size_t i = 0; i < currentColorCount; ++i)
     {
-        currentColors.emplace_back(calculateColor(currentHue, pulseFactor, cd));
+        currentColors[i] =
+            calculateColor(currentHue, pulseFactor, def.colorDatas[i]);
     }
 
-    if(currentColors.size() > 1)
+    if(currentColorCount > 1)
     {
         const unsigned int rotation = currentSwapTime / (maxSwapTime / 2.f);
 
-        ssvu::rotate(currentColors,
-            std::begin(currentColors) +
-                ssvu::getMod(rotation + BGColorOffset, currentColors.size()));
+        std::rotate(currentColors.begin(),
+            currentColors.begin() +
+                ssvu::getMod(rotation + BGColorOffset, currentColorCount),
+            currentColors.begin() + currentColorCount);
     }
 }
 
@@ -204,7 +241,7 @@ void StyleData::drawBackgroundImpl(Utils::FastVertexVectorTris& vertices,
     const float halfDiv{div / 2.f};
     const float distance{bgTileRadius};
 
-    const std::vector<sf::Color>& colors(getColors());
+    const std::span<const sf::Color> colors(getColors());
     if(colors.empty())
     {
         return;
@@ -213,7 +250,7 @@ void StyleData::drawBackgroundImpl(Utils::FastVertexVectorTris& vertices,
     for(auto i(0u); i < sides; ++i)
     {
         const float angle{ssvu::toRad(BGRotOff) + div * i};
-        sf::Color currentColor{ssvu::getByModIdx(colors, i)};
+        sf::Color currentColor{colors[ssvu::getMod(i, colors.size())]};
 
         const bool mustDarkenUnevenBackgroundChunk =
             (i % 2 == 0 && i == sides - 1) && darkenUnevenBackgroundChunk;
@@ -291,6 +328,11 @@ void StyleData::setCapColor(const CapColor& mCapColor)
     capColor = mCapColor;
 }
 
+[[nodiscard]] const std::string& StyleData::getId() const noexcept
+{
+    return definition->id;
+}
+
 [[nodiscard]] const sf::Color& StyleData::getMainColor() const noexcept
 {
     return currentMainColor;
@@ -311,17 +353,16 @@ void StyleData::setCapColor(const CapColor& mCapColor)
     return currentWallColor;
 }
 
-[[nodiscard]] const std::vector<sf::Color>&
-StyleData::getColors() const noexcept
+[[nodiscard]] std::span<const sf::Color> StyleData::getColors() const noexcept
 {
-    return currentColors;
+    return {currentColors.data(), currentColorCount};
 }
 
 [[nodiscard]] const sf::Color& StyleData::getColor(
     const std::size_t mIdx) const noexcept
 {
-    SSVOH_ASSERT(!currentColors.empty());
-    return ssvu::getByModIdx(currentColors, mIdx);
+    SSVOH_ASSERT(currentColorCount != 0);
+    return currentColors[ssvu::getMod(mIdx, currentColorCount)];
 }
 
 [[nodiscard]] float StyleData::getCurrentHue() const noexcept
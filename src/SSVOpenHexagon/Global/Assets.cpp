@@ -10,6 +10,7 @@
 
 #include "SSVOpenHexagon/Global/Assert.hpp"
 #include "SSVOpenHexagon/Global/AssetStorage.hpp"
+#include "SSVOpenHexagon/Global/Profiler.hpp"
 #include "SSVOpenHexagon/Global/UtilsJson.hpp"
 #include "SSVOpenHexagon/Global/Version.hpp"
 
@@ -20,6 +21,7 @@
 #include "SSVOpenHexagon/Utils/Concat.hpp"
 #include "SSVOpenHexagon/Utils/EraseIf.hpp"
 #include "SSVOpenHexagon/Utils/LoadFromJson.hpp"
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
 #include "SSVOpenHexagon/Utils/UniquePtr.hpp"
 
 #include <SSVUtils/Core/FileSystem/FileSystem.hpp>
@@ -33,6 +35,11 @@
 #include <SFML/Audio/Music.hpp>
 
 #include <chrono>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace hg {
 
@@ -69,6 +76,18 @@ static void loadAssetsFromJson(AssetStorage& assetStorage,
     }
 }
 
+[[nodiscard]] static std::string getLocalProfileFilePath(
+    const std::string& mName)
+{
+    return "Profiles/" + mName + ".json";
+}
+
+[[nodiscard]] static std::string getLocalProfileJournalPath(
+    const std::string& mName)
+{
+    return "Profiles/" + mName + ".journal";
+}
+
 [[nodiscard]] static std::vector<ssvufs::Path>& getScanBuffer()
 {
     static std::vector<ssvufs::Path> buffer;
@@ -124,6 +143,8 @@ HGAssets::HGAssets(
       levelsOnly{mLevelsOnly},
       assetStorage{Utils::makeUnique<AssetStorage>()}
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::HGAssets");
+
     const HRTimePoint tpBeforeLoad = HRClock::now();
 
     if(!levelsOnly && !mHeadless)
@@ -190,6 +211,8 @@ HGAssets::HGAssets(
         [&](const PackInfo& mA, const PackInfo& mB)
         { return getPackData(mA.id).priority < getPackData(mB.id).priority; });
 
+    buildLevelSearchIndex();
+
     // This will not be used for the rest of the game,
     // so shrink it to fit the actually used size.
     loadInfo.errorMessages.shrink_to_fit();
@@ -210,6 +233,8 @@ HGAssets::~HGAssets()
 
 [[nodiscard]] bool HGAssets::loadPackData(const ssvufs::Path& packPath)
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::loadPackData");
+
     if(!ssvufs::Path{packPath + "/pack.json"}.isFile())
     {
         return false;
@@ -293,6 +318,8 @@ HGAssets::~HGAssets()
 [[nodiscard]] bool HGAssets::loadPackAssets(
     const PackData& packData, const bool headless)
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::loadPackAssets");
+
     const std::string& packPath{packData.folderPath};
     const std::string& packId{packData.id};
 
@@ -450,6 +477,47 @@ HGAssets::getSelectablePackInfos() const noexcept
     return selectablePackInfos;
 }
 
+void HGAssets::buildLevelSearchIndex()
+{
+    SSVOH_PROFILE_SCOPE("HGAssets::buildLevelSearchIndex");
+
+    levelSearchIndex.clear();
+    levelSearchIds.clear();
+
+    for(const PackInfo& packInfo : selectablePackInfos)
+    {
+        const PackData& packData = getPackData(packInfo.id);
+
+        for(const std::string& levelId : getLevelIdsByPack(packInfo.id))
+        {
+            const LevelData& levelData = getLevelData(levelId);
+
+            levelSearchIndex.add({levelData.name, levelData.author,
+                packData.name, levelData.description});
+
+            levelSearchIds.emplace_back(levelId);
+        }
+    }
+
+    levelSearchIndex.build();
+}
+
+[[nodiscard]] std::vector<std::string> HGAssets::searchLevels(
+    const std::string_view mQuery, const std::size_t mMaxResults)
+{
+    levelSearchIndex.search(mQuery, levelSearchBuf, mMaxResults);
+
+    std::vector<std::string> result;
+    result.reserve(levelSearchBuf.size());
+
+    for(const Utils::TrigramIndex::DocId docId : levelSearchBuf)
+    {
+        result.emplace_back(levelSearchIds[docId]);
+    }
+
+    return result;
+}
+
 [[nodiscard]] const PackData* HGAssets::findPackData(
     const std::string& mPackDisambiguator, const std::string& mPackName,
     const std::string& mPackAuthor) const noexcept
@@ -469,6 +537,8 @@ HGAssets::getSelectablePackInfos() const noexcept
 
 [[nodiscard]] bool HGAssets::loadWorkshopPackDatasFromCache()
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::loadWorkshopPackDatasFromCache");
+
     if(!ssvufs::Path{"workshopCache.json"}.isFile())
     {
         ssvu::lo("::loadAssets") << "Workshop cache file does not exist. No "
@@ -522,6 +592,8 @@ HGAssets::getSelectablePackInfos() const noexcept
 
 [[nodiscard]] bool HGAssets::loadAllPackDatas()
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::loadAllPackDatas");
+
     if(!ssvufs::Path{"Packs/"}.isFolder())
     {
         ssvu::lo("::loadAssets") << "Folder Packs/ does not exist" << std::endl;
@@ -577,6 +649,8 @@ HGAssets::getSelectablePackInfos() const noexcept
 
 [[nodiscard]] bool HGAssets::loadAllPackAssets(const bool headless)
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::loadAllPackAssets");
+
     for(const auto& [packId, packData] : packDatas)
     {
         if(loadPackAssets(packData, headless))
@@ -655,6 +729,8 @@ void HGAssets::addLocalProfile(ProfileData&& profileData)
 
 [[nodiscard]] bool HGAssets::loadAllLocalProfiles()
 {
+    SSVOH_PROFILE_SCOPE("HGAssets::loadAllLocalProfiles");
+
     if(!ssvufs::Path{"Profiles/"}.isFolder())
     {
         ssvu::lo("::loadAssets")
@@ -665,12 +741,19 @@ void HGAssets::addLocalProfile(ProfileData&& profileData)
 
     ssvu::lo("::loadAssets") << "loading local profiles\n";
 
+    // Journals must be complete before being replayed.
+    profileJournal.flush();
+
     for(const auto& p : scanSingleByExt("Profiles/", ".json"))
     {
         auto [object, error] = ssvuj::getFromFileWithErrors(p);
         loadInfo.addFormattedError(error);
 
         ProfileData profileData{Utils::loadProfileFromJson(object)};
+
+        profileJournal.replay(
+            getLocalProfileJournalPath(profileData.getName()), profileData);
+
         addLocalProfile(std::move(profileData));
     }
 
@@ -771,8 +854,8 @@ void HGAssets::loadPackAssets_loadStyleData(
         loadInfo.addFormattedError(error);
 
         StyleData styleData{object};
-        styleDataMap.emplace(
-            concatIntoBuf(mPackId, '_', styleData.id), std::move(styleData));
+        styleDataMap.emplace(concatIntoBuf(mPackId, '_', styleData.getId()),
+            std::move(styleData));
 
         ++loadInfo.assets;
     }
@@ -799,59 +882,76 @@ void HGAssets::loadPackAssets_loadLevelData(
 //**********************************************
 // PROFILE
 
-void HGAssets::saveCurrentLocalProfile()
+void HGAssets::compactLocalProfile(const ProfileData& mProfileData)
 {
-    if(currentProfilePtr == nullptr)
-    {
-        return;
-    }
+    std::vector<std::string> favorites(
+        mProfileData.getFavoriteLevelIds().begin(),
+        mProfileData.getFavoriteLevelIds().end());
 
-    ssvuj::Obj profileRoot;
-    ssvuj::Obj currentVersion;
+    // The profile is copied, so that the main thread can keep modifying it
+    // while the snapshot is written.
+    const std::string& name = mProfileData.getName();
 
-    ssvuj::arch(currentVersion, "major", GAME_VERSION.major);
-    ssvuj::arch(currentVersion, "minor", GAME_VERSION.minor);
-    ssvuj::arch(currentVersion, "micro", GAME_VERSION.micro);
+    profileJournal.compact(getLocalProfileJournalPath(name),
+        getLocalProfileFilePath(name),
+        [name, scores = mProfileData.getScores(),
+            favorites = std::move(favorites)](std::ostream& os)
+        {
+            ssvuj::Obj currentVersion;
 
-    ssvuj::arch(profileRoot, "version", currentVersion);
-    ssvuj::arch(profileRoot, "name", getCurrentLocalProfile().getName());
-    ssvuj::arch(profileRoot, "scores", getCurrentLocalProfile().getScores());
+            ssvuj::arch(currentVersion, "major", GAME_VERSION.major);
+            ssvuj::arch(currentVersion, "minor", GAME_VERSION.minor);
+            ssvuj::arch(currentVersion, "micro", GAME_VERSION.micro);
 
-    const auto& favSet{getCurrentLocalProfile().getFavoriteLevelIds()};
-    std::vector<std::string> favorites;
-    std::copy(favSet.begin(), favSet.end(), std::back_inserter(favorites));
-    ssvuj::arch(profileRoot, "favorites", favorites);
+            ssvuj::Obj profileRoot;
+            ssvuj::arch(profileRoot, "version", currentVersion);
+            ssvuj::arch(profileRoot, "name", name);
+            ssvuj::arch(profileRoot, "scores", scores);
+            ssvuj::arch(profileRoot, "favorites", favorites);
 
-    ssvuj::writeToFile(profileRoot, getCurrentLocalProfileFilePath());
+            ssvuj::writeToStream(profileRoot, os);
+        });
 }
 
-void HGAssets::saveAllProfiles()
+void HGAssets::compactLocalProfileIfNeeded(const ProfileData& mProfileData)
 {
-    ssvuj::Obj currentVersion;
+    if(profileJournal.getEntriesSinceCompaction(getLocalProfileJournalPath(
+           mProfileData.getName())) >= maxProfileJournalEntries)
+    {
+        compactLocalProfile(mProfileData);
+    }
+}
 
-    ssvuj::arch(currentVersion, "major", GAME_VERSION.major);
-    ssvuj::arch(currentVersion, "minor", GAME_VERSION.minor);
-    ssvuj::arch(currentVersion, "micro", GAME_VERSION.micro);
+void HGAssets::saveCurrentLocalProfile()
+{
+    if(currentProfilePtr == nullptr)
+    {
+        return;
+    }
 
-    std::vector<std::string> favorites;
+    compactLocalProfile(getCurrentLocalProfile());
+}
 
+void HGAssets::saveAllProfiles()
+{
+    // Profiles without journal entries are already up to date on disk.
     for(const auto& [key, profileData] : profileDataMap)
     {
-        ssvuj::Obj profileRoot;
-        ssvuj::arch(profileRoot, "version", currentVersion);
-        ssvuj::arch(profileRoot, "name", profileData.getName());
-        ssvuj::arch(profileRoot, "scores", profileData.getScores());
-
-        favorites.clear();
-        for(const std::string& favID : profileData.getFavoriteLevelIds())
+        if(profileJournal.getEntriesSinceCompaction(getLocalProfileJournalPath(
+               profileData.getName())) != 0)
         {
-            favorites.emplace_back(favID);
+            compactLocalProfile(profileData);
         }
+    }
 
-        ssvuj::arch(profileRoot, "favorites", favorites);
+    profileJournal.flush();
 
-        ssvuj::writeToFile(
-            profileRoot, "Profiles/" + profileData.getName() + ".json");
+    if(const std::size_t failed = profileJournal.getFailedCompactionCount();
+        failed != 0)
+    {
+        ssvu::lo("HGAssets::saveAllProfiles")
+            << "Failed to write " << failed
+            << " profile snapshots, their changes are kept in journals\n";
     }
 }
 
@@ -928,8 +1028,9 @@ void HGAssets::saveAllProfiles()
     const auto it = shadersPathToId.find(mShaderPath);
     if(it == shadersPathToId.end())
     {
-        ssvu::lo("getShaderIdByPath") << "Shader with path '" << mShaderPath
-                                      << "' not found, couldn't get id\n";
+        Utils::scriptLog("getShaderIdByPath")
+            << "Shader with path '" << mShaderPath
+            << "' not found, couldn't get id\n";
 
         return std::nullopt;
     }
@@ -1000,6 +1101,8 @@ void HGAssets::reloadAllShaders()
     }
     output += "Levels successfully reloaded\n";
 
+    buildLevelSearchIndex();
+
     // Styles
     temp = mPath + "Styles/";
     if(!ssvufs::Path{temp}.isFolder())
@@ -1011,7 +1114,7 @@ void HGAssets::reloadAllShaders()
         for(const auto& p : scanSingleByExt(mPath + "Styles/", ".json"))
         {
             StyleData styleData{ssvuj::getFromFile(p)};
-            temp = mPackId + "_" + styleData.id;
+            temp = mPackId + "_" + styleData.getId();
 
             styleDataMap[temp] = std::move(styleData);
         }
@@ -1113,6 +1216,8 @@ void HGAssets::reloadAllShaders()
     }
     output = "level data " + mId + ".json successfully loaded\n";
 
+    buildLevelSearchIndex();
+
     //*******************************************
     // Style
     temp = mPath + "Styles/";
@@ -1249,7 +1354,37 @@ float HGAssets::getLocalScore(const std::string& mId)
 
 void HGAssets::setLocalScore(const std::string& mId, float mScore)
 {
-    getCurrentLocalProfile().setScore(mId, mScore);
+    ProfileData& profileData = getCurrentLocalProfile();
+    profileData.setScore(mId, mScore);
+
+    profileJournal.appendScore(
+        getLocalProfileJournalPath(profileData.getName()), mId, mScore);
+
+    compactLocalProfileIfNeeded(profileData);
+}
+
+void HGAssets::addFavoriteLevel(const std::string& mLevelId)
+{
+    ProfileData& profileData = getCurrentLocalProfile();
+    profileData.addFavoriteLevel(mLevelId);
+
+    profileJournal.appendFavorite(
+        getLocalProfileJournalPath(profileData.getName()), mLevelId,
+        true /* favorite */);
+
+    compactLocalProfileIfNeeded(profileData);
+}
+
+void HGAssets::removeFavoriteLevel(const std::string& mLevelId)
+{
+    ProfileData& profileData = getCurrentLocalProfile();
+    profileData.removeFavoriteLevel(mLevelId);
+
+    profileJournal.appendFavorite(
+        getLocalProfileJournalPath(profileData.getName()), mLevelId,
+        false /* favorite */);
+
+    compactLocalProfileIfNeeded(profileData);
 }
 
 //**********************************************
@@ -1285,11 +1420,6 @@ const ProfileData* HGAssets::getLocalProfileByName(
     return &profileDataMap.find(mName)->second;
 }
 
-[[nodiscard]] std::string HGAssets::getCurrentLocalProfileFilePath()
-{
-    return "Profiles/" + currentProfilePtr->getName() + ".json";
-}
-
 
 [[nodiscard]] std::size_t HGAssets::getLocalProfilesSize()
 {
@@ -1341,7 +1471,13 @@ void HGAssets::pCreate(const std::string& mName)
     ssvuj::arch(root, "name", mName);
     ssvuj::arch(root, "scores", ssvuj::Obj{});
     ssvuj::arch(root, "favorites", ssvuj::Obj{});
-    ssvuj::writeToFile(root, "Profiles/" + mName + ".json");
+
+    // Also drops the journal left behind by a removed profile of the same
+    // name.
+    profileJournal.compact(getLocalProfileJournalPath(mName),
+        getLocalProfileFilePath(mName),
+        [root = std::move(root)](std::ostream& os)
+        { ssvuj::writeToStream(root, os); });
 
     profileDataMap.clear();
 
@@ -1353,9 +1489,18 @@ void HGAssets::pCreate(const std::string& mName)
     }
 }
 
-void HGAssets::pRemove(const std::string& mName)
+[[nodiscard]] bool HGAssets::pRemove(const std::string& mName)
 {
+    // Pending journal writes and compactions of the profile are dropped
+    // first, so that they do not bring its files back.
+    if(!profileJournal.remove(
+           getLocalProfileJournalPath(mName), getLocalProfileFilePath(mName)))
+    {
+        return false;
+    }
+
     profileDataMap.erase(mName);
+    return true;
 }
 
 [[nodiscard]] sf::SoundBuffer* HGAssets::getSoundBuffer(
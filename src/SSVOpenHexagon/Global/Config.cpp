@@ -276,6 +276,9 @@ using cil = std::initializer_list<cmb>;
     X(showSwapParticles, bool, "show_swap_particles", true)                \
     X(playSwapReadySound, bool, "play_swap_ready_sound", true)             \
     X(showSwapBlinkingEffect, bool, "show_swap_blinking_effect", true)     \
+    X(pipelinedVertexGeneration, bool, "pipelined_vertex_generation",      \
+        false)                                                             \
+    X(luaJitFfi, bool, "luajit_ffi", false)                                \
     X_LINKEDVALUES_BINDS
 
 namespace hg::Config {
@@ -856,6 +859,16 @@ void setShowSwapBlinkingEffect(bool x)
     showSwapBlinkingEffect() = x;
 }
 
+void setPipelinedVertexGeneration(bool x)
+{
+    pipelinedVertexGeneration() = x;
+}
+
+void setLuaJitFfi(bool x)
+{
+    luaJitFfi() = x;
+}
+
 [[nodiscard]] bool getOfficial()
 {
     return official();
@@ -1236,6 +1249,21 @@ void setShowSwapBlinkingEffect(bool x)
     return showSwapBlinkingEffect();
 }
 
+[[nodiscard]] bool getPipelinedVertexGeneration()
+{
+    return pipelinedVertexGeneration();
+}
+
+[[nodiscard]] bool getLuaJitFfi()
+{
+#ifdef SSVOH_ENABLE_LUAJIT_FFI
+    // The server does not validate replays against the FFI path.
+    return getOfficial() ? luaJitFfi().getDefault() : luaJitFfi();
+#else
+    return false;
+#endif
+}
+
 //***********************************************************
 //
 // KEYBOARD/MOUSE BINDS
@@ -0,0 +1,325 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Global/Profiler.hpp"
+
+#ifndef SSVOH_ANDROID
+#include <imgui.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hg::Profiler {
+
+namespace {
+
+struct ZoneEvent
+{
+    const char* name;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+};
+
+// Events beyond this limit are dropped until the next `markFrame`, so that
+// threads which never reach a frame boundary cannot grow without bound.
+constexpr std::size_t maxEventsPerThread = 1 << 16;
+
+// Weight of the latest frame in the moving average shown in the ImGui view.
+constexpr double avgSmoothing = 0.05;
+
+struct ThreadEvents
+{
+    std::mutex mutex;
+    std::vector<ZoneEvent> events;
+    std::uint32_t threadId;
+};
+
+struct ProfilerState
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadEvents>> threads;
+
+    // Only touched by `markFrame` and the trace functions, under `mutex`.
+    std::vector<ZoneEvent> frameEvents;
+    std::vector<ZoneStats> stats;
+    std::unordered_map<std::string_view, std::size_t> statsIndices;
+
+    std::ofstream traceStream;
+    bool traceFirstEvent{true};
+};
+
+[[nodiscard]] ProfilerState& profilerState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+[[nodiscard]] std::int64_t nowNs() noexcept
+{
+    using clock = std::chrono::steady_clock;
+    static const clock::time_point epoch = clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock::now() - epoch)
+        .count();
+}
+
+[[nodiscard]] ThreadEvents& threadEvents()
+{
+    thread_local const std::shared_ptr<ThreadEvents> result = []
+    {
+        ProfilerState& state = profilerState();
+        const std::lock_guard guard{state.mutex};
+
+        auto te = std::make_shared<ThreadEvents>();
+        te->events.reserve(1024);
+        te->threadId = static_cast<std::uint32_t>(state.threads.size());
+
+        state.threads.emplace_back(te);
+        return te;
+    }();
+
+    return *result;
+}
+
+void writeTraceEscaped(std::ofstream& os, const char* s)
+{
+    for(; *s != '\0'; ++s)
+    {
+        if(*s == '"' || *s == '\\')
+        {
+            os << '\\';
+        }
+
+        os << *s;
+    }
+}
+
+void writeTraceEvent(
+    ProfilerState& state, const ZoneEvent& e, const std::uint32_t threadId)
+{
+    if(!state.traceFirstEvent)
+    {
+        state.traceStream << ",\n";
+    }
+
+    state.traceFirstEvent = false;
+
+    // Trace-event timestamps are in microseconds.
+    state.traceStream << R"({"name":")";
+    writeTraceEscaped(state.traceStream, e.name);
+    state.traceStream << R"(","ph":"X","ts":)"
+                      << static_cast<double>(e.startNs) / 1000.0
+                      << R"(,"dur":)"
+                      << static_cast<double>(e.durationNs) / 1000.0
+                      << R"(,"pid":0,"tid":)" << threadId << '}';
+}
+
+// Moves every thread's pending events out, streaming them to the trace file
+// if one is open. Must be called with `state.mutex` held.
+void collectEvents(ProfilerState& state)
+{
+    state.frameEvents.clear();
+
+    for(const std::shared_ptr<ThreadEvents>& te : state.threads)
+    {
+        const std::lock_guard guard{te->mutex};
+
+        if(state.traceStream.is_open())
+        {
+            for(const ZoneEvent& e : te->events)
+            {
+                writeTraceEvent(state, e, te->threadId);
+            }
+        }
+
+        state.frameEvents.insert(
+            state.frameEvents.end(), te->events.begin(), te->events.end());
+
+        te->events.clear();
+    }
+}
+
+} // namespace
+
+ScopedZone::ScopedZone(const char* name) noexcept
+    : _name{name}, _startNs{nowNs()}
+{}
+
+ScopedZone::~ScopedZone() noexcept
+{
+    const std::int64_t endNs = nowNs();
+    ThreadEvents& te = threadEvents();
+
+    const std::lock_guard guard{te.mutex};
+
+    if(te.events.size() < maxEventsPerThread)
+    {
+        te.events.push_back(ZoneEvent{_name, _startNs, endNs - _startNs});
+    }
+}
+
+void markFrame()
+{
+    ProfilerState& state = profilerState();
+    const std::lock_guard guard{state.mutex};
+
+    collectEvents(state);
+
+    for(ZoneStats& zs : state.stats)
+    {
+        zs.lastMs = 0.0;
+        zs.lastCalls = 0;
+    }
+
+    for(const ZoneEvent& e : state.frameEvents)
+    {
+        const auto [it, inserted] =
+            state.statsIndices.try_emplace(e.name, state.stats.size());
+
+        if(inserted)
+        {
+            state.stats.push_back(ZoneStats{e.name, 0.0, 0.0, 0.0, 0});
+        }
+
+        ZoneStats& zs = state.stats[it->second];
+        zs.lastMs += static_cast<double>(e.durationNs) / 1'000'000.0;
+        ++zs.lastCalls;
+    }
+
+    for(ZoneStats& zs : state.stats)
+    {
+        zs.avgMs += (zs.lastMs - zs.avgMs) * avgSmoothing;
+        zs.maxMs = std::max(zs.maxMs, zs.lastMs);
+    }
+}
+
+[[nodiscard]] std::vector<ZoneStats> getZoneStats()
+{
+    ProfilerState& state = profilerState();
+    const std::lock_guard guard{state.mutex};
+
+    return state.stats;
+}
+
+[[nodiscard]] bool startTrace(const std::string& path)
+{
+    ProfilerState& state = profilerState();
+    const std::lock_guard guard{state.mutex};
+
+    if(state.traceStream.is_open())
+    {
+        return false;
+    }
+
+    state.traceStream.open(path);
+
+    if(!state.traceStream)
+    {
+        state.traceStream = std::ofstream{};
+        return false;
+    }
+
+    state.traceStream << std::fixed << std::setprecision(3);
+    state.traceStream << R"({"traceEvents":[)" << '\n';
+    state.traceFirstEvent = true;
+
+    return true;
+}
+
+void stopTrace()
+{
+    ProfilerState& state = profilerState();
+    const std::lock_guard guard{state.mutex};
+
+    if(!state.traceStream.is_open())
+    {
+        return;
+    }
+
+    // Flush zones recorded after the last frame boundary.
+    collectEvents(state);
+
+    state.traceStream << "\n]}\n";
+    state.traceStream.close();
+}
+
+[[nodiscard]] bool isTracing()
+{
+    ProfilerState& state = profilerState();
+    const std::lock_guard guard{state.mutex};
+
+    return state.traceStream.is_open();
+}
+
+void drawImguiWindow()
+{
+#ifndef SSVOH_ANDROID
+    if constexpr(!enabled)
+    {
+        return;
+    }
+
+    std::vector<ZoneStats> stats = getZoneStats();
+
+    std::sort(stats.begin(), stats.end(),
+        [](const ZoneStats& a, const ZoneStats& b)
+        { return a.avgMs > b.avgMs; });
+
+    ImGui::SetNextWindowSize(ImVec2(500, 400), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Profiler");
+
+    if(isTracing())
+    {
+        ImGui::Text("Writing trace...");
+    }
+
+    if(ImGui::BeginTable("ProfilerZones", 5))
+    {
+        ImGui::TableSetupColumn("zone");
+        ImGui::TableSetupColumn("last ms");
+        ImGui::TableSetupColumn("avg ms");
+        ImGui::TableSetupColumn("max ms");
+        ImGui::TableSetupColumn("calls");
+        ImGui::TableHeadersRow();
+
+        for(const ZoneStats& zs : stats)
+        {
+            ImGui::TableNextRow();
+
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(zs.name);
+
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%.3f", zs.lastMs);
+
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.3f", zs.avgMs);
+
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%.3f", zs.maxMs);
+
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%u", zs.lastCalls);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+#endif
+}
+
+} // namespace hg::Profiler
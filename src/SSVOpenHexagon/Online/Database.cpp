@@ -6,6 +6,7 @@
 
 #include "SSVOpenHexagon/Global/Assert.hpp"
 #include "SSVOpenHexagon/Utils/Concat.hpp"
+#include "SSVOpenHexagon/Utils/LatencyHistogram.hpp"
 #include "SSVOpenHexagon/Utils/ScopeGuard.hpp"
 #include "SSVOpenHexagon/Utils/Timestamp.hpp"
 
@@ -14,10 +15,20 @@
 #include <sqlite3.h>
 #include <sqlite_orm.h>
 
+#include <algorithm>
 #include <string>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <optional>
 #include <chrono>
+#include <map>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 static auto& dlog(const char* funcName)
 {
@@ -33,15 +44,57 @@ static auto& dlog(const char* funcName)
 
 #define SSVOH_DLOG_VAR(x) '\'' << #x << "': '" << x << '\''
 
+#define SSVOH_DTIMED                                                 \
+    static ::hg::Utils::LatencyHistogram& dHistogram =               \
+        ::hg::Database::Impl::getQueryHistogram(__func__);           \
+                                                                     \
+    const ::hg::Utils::ScopedLatency dScopedLatency                  \
+    {                                                                \
+        dHistogram                                                   \
+    }
+
 namespace hg::Database {
 
 namespace Impl {
 
+[[nodiscard]] inline std::map<std::string_view, Utils::LatencyHistogram>&
+getQueryHistograms()
+{
+    static std::map<std::string_view, Utils::LatencyHistogram> histograms;
+    return histograms;
+}
+
+[[nodiscard]] inline Utils::LatencyHistogram& getQueryHistogram(
+    const std::string_view funcName)
+{
+    return getQueryHistograms()[funcName];
+}
+
+[[nodiscard]] inline std::string& getStoragePath()
+{
+    static std::string storagePath = "ohdb.sqlite";
+    return storagePath;
+}
+
+[[nodiscard]] inline bool& getStorageCreated()
+{
+    static bool storageCreated = false;
+    return storageCreated;
+}
+
 inline auto makeStorage()
 {
     using namespace sqlite_orm;
 
-    auto storage = make_storage("ohdb.sqlite",                            //
+    getStorageCreated() = true;
+
+    auto storage = make_storage(getStoragePath(),                         //
+                                                                          //
+        make_index("idx_scores_levelValidator_value",                     //
+            &Score::levelValidator, &Score::value),                       //
+        make_index("idx_scores_userSteamId_levelValidator",               //
+            &Score::userSteamId, &Score::levelValidator),                 //
+        make_index("idx_loginTokens_token", &LoginToken::token),          //
                                                                           //
         make_table("users",                                               //
             make_column("id", &User::id, autoincrement(), primary_key()), //
@@ -70,6 +123,14 @@ inline auto makeStorage()
     );
 
     storage.sync_schema(true /* preserve */);
+
+    // Keep a single connection open for the lifetime of the server and use
+    // WAL journaling: readers don't block the writer and commits only need to
+    // append to the log, which makes batched score writes cheap.
+    storage.open_forever();
+    storage.pragma.journal_mode(journal_mode::WAL);
+    storage.pragma.synchronous(1 /* NORMAL */);
+
     return storage;
 }
 
@@ -79,10 +140,441 @@ inline auto& getStorage()
     return storage;
 }
 
+// The hot queries below are prepared once and reused, only rebinding their
+// arguments on every call. They are created lazily after the storage, so they
+// are also destroyed before it.
+
+inline auto& getScoresPageStatement()
+{
+    using namespace sqlite_orm;
+
+    static auto statement = getStorage().prepare(
+        select(columns(&User::name, &Score::timestamp, &Score::value,
+                   &Score::userSteamId),
+            join<Score>(on(c(&User::steamId) == &Score::userSteamId)),
+            where(std::string{} == c(&Score::levelValidator)),
+            order_by(&Score::value).desc(), limit(0, offset(0))));
+
+    return statement;
+}
+
+inline auto& getUserScoreStatement()
+{
+    using namespace sqlite_orm;
+
+    static auto statement = getStorage().prepare(
+        select(columns(&User::name, &Score::timestamp, &Score::value),
+            join<Score>(on(c(&User::steamId) == &Score::userSteamId)),
+            where(std::string{} == c(&Score::levelValidator) &&
+                  std::uint64_t{0} == c(&Score::userSteamId))));
+
+    return statement;
+}
+
+inline auto& getBetterScoreCountStatement()
+{
+    using namespace sqlite_orm;
+
+    static auto statement = getStorage().prepare(select(count<Score>(),
+        where(std::string{} == c(&Score::levelValidator) &&
+              c(&Score::value) > 0.0)));
+
+    return statement;
+}
+
+inline auto& getScoresForUserAndLevelStatement()
+{
+    using namespace sqlite_orm;
+
+    static auto statement = getStorage().prepare(
+        get_all<Score>(where(std::uint64_t{0} == c(&Score::userSteamId) &&
+                             std::string{} == c(&Score::levelValidator))));
+
+    return statement;
+}
+
+// Login tokens are mirrored in memory so that validating a request never
+// needs to touch SQLite. The cache is loaded from the storage on first use and
+// kept in sync by every function that adds or removes tokens.
+struct LoginTokenCache
+{
+    std::unordered_map<std::uint64_t, LoginToken> byToken;
+    std::unordered_map<std::uint32_t, std::uint64_t> tokenByUserId;
+
+    void add(const LoginToken& loginToken)
+    {
+        byToken.insert_or_assign(loginToken.token, loginToken);
+        tokenByUserId.insert_or_assign(loginToken.userId, loginToken.token);
+    }
+
+    void removeForUser(const std::uint32_t userId)
+    {
+        const auto it = tokenByUserId.find(userId);
+
+        if(it == tokenByUserId.end())
+        {
+            return;
+        }
+
+        byToken.erase(it->second);
+        tokenByUserId.erase(it);
+    }
+};
+
+[[nodiscard]] inline LoginTokenCache makeLoginTokenCache()
+{
+    LoginTokenCache result;
+
+    for(const LoginToken& loginToken : getStorage().get_all<LoginToken>())
+    {
+        result.add(loginToken);
+    }
+
+    SSVOH_DLOG << "Loaded " << result.byToken.size()
+               << " login token(s) from storage\n";
+
+    return result;
+}
+
+[[nodiscard]] inline LoginTokenCache& getLoginTokenCache()
+{
+    static LoginTokenCache loginTokenCache = makeLoginTokenCache();
+    return loginTokenCache;
+}
+
+struct PendingScore
+{
+    Score score;
+    std::uint32_t failedWrites;
+};
+
+[[nodiscard]] inline std::vector<PendingScore>& getPendingScores()
+{
+    static std::vector<PendingScore> pendingScores;
+    return pendingScores;
+}
+
+// Scores that failed to be written because of a transient error, such as a
+// busy or full database, are retried with a growing delay.
+constexpr std::uint32_t maxScoreWriteAttempts = 10;
+constexpr std::chrono::milliseconds minScoreRetryDelay{100};
+constexpr std::chrono::milliseconds maxScoreRetryDelay{30'000};
+
+struct ScoreRetry
+{
+    std::chrono::steady_clock::time_point notBefore;
+    std::chrono::milliseconds delay;
+};
+
+[[nodiscard]] inline ScoreRetry& getScoreRetry()
+{
+    static ScoreRetry scoreRetry{.notBefore{}, .delay = minScoreRetryDelay};
+    return scoreRetry;
+}
+
+// Every level has a version that changes whenever one of its scores is
+// written. Versions start from the time the server started, so that versions
+// cached by clients before a restart never match a current one.
+struct LeaderboardVersions
+{
+    std::uint64_t base;
+    std::uint64_t last;
+    std::unordered_map<std::string, std::uint64_t> byLevel;
+};
+
+[[nodiscard]] inline LeaderboardVersions& getLeaderboardVersions()
+{
+    static LeaderboardVersions versions{.base = Utils::nowTimestamp() << 20,
+        .last = Utils::nowTimestamp() << 20,
+        .byLevel{}};
+
+    return versions;
+}
+
+inline void bumpLeaderboardVersion(const std::string& levelValidator)
+{
+    LeaderboardVersions& versions = getLeaderboardVersions();
+    versions.byLevel[levelValidator] = ++versions.last;
+}
+
+inline void writeScore(const Score& score)
+{
+    using namespace sqlite_orm;
+
+    auto& statement = getScoresForUserAndLevelStatement();
+    get<0>(statement) = score.userSteamId;
+    get<1>(statement) = score.levelValidator;
+
+    const auto query = getStorage().execute(statement);
+
+    if(query.empty())
+    {
+        const int id = getStorage().insert(score);
+        bumpLeaderboardVersion(score.levelValidator);
+
+        SSVOH_DLOG << "Added score with id '" << id << "' to storage:\n"
+                   << getStorage().dump(score) << '\n';
+
+        return;
+    }
+
+    const Score& existingScore = query.at(0);
+    if(existingScore.value >= score.value)
+    {
+        return;
+    }
+
+    Score updatedScore = score;
+    updatedScore.id = existingScore.id;
+
+    getStorage().update(updatedScore);
+    bumpLeaderboardVersion(score.levelValidator);
+
+    SSVOH_DLOG << "Updated score with id '" << updatedScore.id
+               << "' to storage:\n"
+               << getStorage().dump(updatedScore) << '\n';
+}
+
+// Whether writing the score again can succeed. Other errors, e.g. constraint
+// violations, would fail on every retry.
+[[nodiscard]] inline bool isTransientWriteError(const std::system_error& e)
+{
+    if(e.code().category() != sqlite_orm::get_sqlite_error_category())
+    {
+        return false;
+    }
+
+    switch(e.code().value() & 0xFF) // Primary result code
+    {
+        case SQLITE_BUSY: [[fallthrough]];
+        case SQLITE_LOCKED: [[fallthrough]];
+        case SQLITE_NOMEM: [[fallthrough]];
+        case SQLITE_IOERR: [[fallthrough]];
+        case SQLITE_FULL: [[fallthrough]];
+        case SQLITE_CANTOPEN: [[fallthrough]];
+        case SQLITE_PROTOCOL: return true;
+
+        default: return false;
+    }
+}
+
+inline void logDroppedScore(const Score& score, const std::exception& e)
+{
+    SSVOH_DLOG_ERROR << "Dropping score of user '" << score.userSteamId
+                     << "' on level '" << score.levelValidator << "': '"
+                     << e.what() << "'\n";
+}
+
+// Returns `false` if the score failed to be written and should be retried.
+[[nodiscard]] inline bool writeOrDropScore(PendingScore& pendingScore)
+{
+    try
+    {
+        writeScore(pendingScore.score);
+        return true;
+    }
+    catch(const std::system_error& e)
+    {
+        if(isTransientWriteError(e) &&
+            ++pendingScore.failedWrites < maxScoreWriteAttempts)
+        {
+            SSVOH_DLOG_ERROR << "Keeping score of user '"
+                             << pendingScore.score.userSteamId
+                             << "' on level '"
+                             << pendingScore.score.levelValidator
+                             << "' for a later retry: '" << e.what() << "'\n";
+
+            return false;
+        }
+
+        logDroppedScore(pendingScore.score, e);
+        return true;
+    }
+    catch(const std::exception& e)
+    {
+        logDroppedScore(pendingScore.score, e);
+        return true;
+    }
+}
+
+// A pending score that changes what reads of its level return, as it is
+// better than the stored score of its user, if any.
+struct EffectivePendingScore
+{
+    std::uint64_t userSteamId;
+    std::optional<double> replacedValue;
+    ProcessedScore processedScore;
+};
+
+// Best first, only used by reads so that they see pending scores without
+// having to commit them.
+[[nodiscard]] inline std::vector<EffectivePendingScore>
+getEffectivePendingScores(const std::string& levelValidator)
+{
+    using namespace sqlite_orm;
+
+    std::vector<EffectivePendingScore> result;
+
+    for(const PendingScore& pendingScore : getPendingScores())
+    {
+        const Score& score = pendingScore.score;
+
+        if(score.levelValidator != levelValidator)
+        {
+            continue;
+        }
+
+        auto& statement = getUserScoreStatement();
+        get<0>(statement) = levelValidator;
+        get<1>(statement) = score.userSteamId;
+
+        const auto query = getStorage().execute(statement);
+
+        std::optional<double> replacedValue;
+        std::string userName;
+
+        if(!query.empty())
+        {
+            // Kept by `writeScore`, as it is at least as good.
+            if(std::get<2>(query.at(0)) >= score.value)
+            {
+                continue;
+            }
+
+            replacedValue = std::get<2>(query.at(0));
+            userName = std::get<0>(query.at(0));
+        }
+        else
+        {
+            // Reads join users, so scores of unknown users are never listed.
+            const std::optional<User> user =
+                getUserWithSteamId(score.userSteamId);
+
+            if(!user.has_value())
+            {
+                continue;
+            }
+
+            userName = user->name;
+        }
+
+        result.push_back( //
+            EffectivePendingScore{
+                .userSteamId = score.userSteamId, //
+                .replacedValue = replacedValue,   //
+                .processedScore =
+                    ProcessedScore{
+                        .position = 0,                     //
+                        .userName = std::move(userName),   //
+                        .scoreTimestamp = score.timestamp, //
+                        .scoreValue = score.value          //
+                    } //
+            });
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+        [](const EffectivePendingScore& a, const EffectivePendingScore& b)
+        { return a.processedScore.scoreValue > b.processedScore.scoreValue; });
+
+    return result;
+}
+
+// At most `limit` scores of the level starting from `offset`, as if the
+// pending scores were already written.
+[[nodiscard]] inline std::vector<ProcessedScore> getScoresWithPending(
+    const std::string& levelValidator, const std::uint32_t offset,
+    const std::uint32_t limit)
+{
+    using namespace sqlite_orm;
+
+    const std::vector<EffectivePendingScore> pending =
+        getEffectivePendingScores(levelValidator);
+
+    // Each pending score shifts the stored ones after it by one place, so
+    // with pending scores the stored ones are read from the top.
+    const std::size_t queryLimit =
+        pending.empty() ? limit : offset + limit + pending.size();
+
+    auto& statement = getScoresPageStatement();
+    get<0>(statement) = levelValidator;
+    get<1>(statement) = static_cast<int>(queryLimit);
+    get<2>(statement) = static_cast<int>(pending.empty() ? offset : 0);
+
+    const auto query = getStorage().execute(statement);
+
+    std::vector<ProcessedScore> result;
+    result.reserve(std::min<std::size_t>(limit, query.size() + pending.size()));
+
+    std::uint32_t position = pending.empty() ? offset : 0;
+
+    const auto add = [&](const ProcessedScore& processedScore)
+    {
+        if(position >= offset && result.size() < limit)
+        {
+            result.push_back(processedScore);
+            result.back().position = position;
+        }
+
+        ++position;
+    };
+
+    auto pendingIt = pending.begin();
+
+    for(const auto& row : query)
+    {
+        const double value = std::get<2>(row);
+
+        // Stored scores come first among equal ones, as they are older.
+        for(; pendingIt != pending.end() &&
+              pendingIt->processedScore.scoreValue > value;
+            ++pendingIt)
+        {
+            add(pendingIt->processedScore);
+        }
+
+        const bool replaced = std::any_of(pending.begin(), pending.end(),
+            [&](const EffectivePendingScore& eps)
+            { return eps.userSteamId == std::get<3>(row); });
+
+        if(!replaced)
+        {
+            add(ProcessedScore{
+                .position = 0,                      //
+                .userName = std::get<0>(row),       //
+                .scoreTimestamp = std::get<1>(row), //
+                .scoreValue = std::get<2>(row),     //
+            });
+        }
+    }
+
+    // Worse than all the stored scores read, only added if the page is not
+    // full yet.
+    for(; pendingIt != pending.end(); ++pendingIt)
+    {
+        add(pendingIt->processedScore);
+    }
+
+    return result;
+}
+
 } // namespace Impl
 
+void setStoragePath(const std::string& path)
+{
+    SSVOH_ASSERT(!Impl::getStorageCreated());
+    Impl::getStoragePath() = path;
+}
+
+void initialize()
+{
+    (void)Impl::getStorage();
+    (void)Impl::getLoginTokenCache();
+}
+
 void addUser(const User& user)
 {
+    SSVOH_DTIMED;
+
     const int id = Impl::getStorage().insert(user);
 
     SSVOH_DLOG << "Added user with id '" << id << "' to storage:\n"
@@ -91,6 +583,8 @@ void addUser(const User& user)
 
 void removeUser(const std::uint32_t id)
 {
+    SSVOH_DTIMED;
+
     Impl::getStorage().remove<User>(id);
 
     SSVOH_DLOG << "Removed user with id '" << id << "' from storage\n";
@@ -117,6 +611,8 @@ void dumpUsers()
 
 [[nodiscard]] bool anyUserWithName(const std::string& name)
 {
+    SSVOH_DTIMED;
+
     using namespace sqlite_orm;
 
     auto query =
@@ -128,6 +624,8 @@ void dumpUsers()
 [[nodiscard]] std::optional<User> getUserWithSteamIdAndName(
     const std::uint64_t steamId, const std::string& name)
 {
+    SSVOH_DTIMED;
+
     using namespace sqlite_orm;
 
     auto query = Impl::getStorage().get_all<User>(
@@ -153,16 +651,27 @@ void dumpUsers()
 
 void removeAllLoginTokensForUser(const std::uint32_t userId)
 {
+    SSVOH_DTIMED;
+
     using namespace sqlite_orm;
 
     Impl::getStorage().remove_all<LoginToken>(
         where(userId == c(&LoginToken::userId)));
+
+    Impl::getLoginTokenCache().removeForUser(userId);
 }
 
 void addLoginToken(const LoginToken& loginToken)
 {
+    SSVOH_DTIMED;
+
     const int id = Impl::getStorage().insert(loginToken);
 
+    LoginToken storedLoginToken = loginToken;
+    storedLoginToken.id = id;
+
+    Impl::getLoginTokenCache().add(storedLoginToken);
+
     SSVOH_DLOG << "Added login token with id '" << id << "' to storage:\n"
                << Impl::getStorage().dump(loginToken) << '\n';
 }
@@ -170,6 +679,8 @@ void addLoginToken(const LoginToken& loginToken)
 [[nodiscard]] std::vector<User> getAllUsersWithSteamId(
     const std::uint64_t steamId)
 {
+    SSVOH_DTIMED;
+
     using namespace sqlite_orm;
 
     auto query =
@@ -213,148 +724,283 @@ constexpr int tokenValiditySeconds = 3600;
 
 [[nodiscard]] std::vector<LoginToken> getAllStaleLoginTokens()
 {
-    using namespace sqlite_orm;
+    SSVOH_DTIMED;
 
-    auto query = Impl::getStorage().get_all<LoginToken>();
+    std::vector<LoginToken> result;
 
-    query.erase(std::remove_if(query.begin(), query.end(),
-                    [&](const LoginToken& lt)
-                    { return isLoginTokenTimestampValid(lt); }),
-        std::end(query));
+    for(const auto& [token, lt] : Impl::getLoginTokenCache().byToken)
+    {
+        if(!isLoginTokenTimestampValid(lt))
+        {
+            result.push_back(lt);
+        }
+    }
 
-    return query;
+    return result;
 }
 
 void removeAllStaleLoginTokens()
 {
+    SSVOH_DTIMED;
+
     using namespace sqlite_orm;
 
     const auto staleTokens = getAllStaleLoginTokens();
     for(const LoginToken& lt : staleTokens)
     {
         Impl::getStorage().remove<LoginToken>(lt.id);
+        Impl::getLoginTokenCache().removeForUser(lt.userId);
     }
 }
 
 [[nodiscard]] std::vector<ProcessedScore> getTopScores(
     const int topLimit, const std::string& levelValidator)
 {
-    using namespace sqlite_orm;
+    SSVOH_DTIMED;
 
-    auto query = Impl::getStorage().select(
-        columns(&User::name, &Score::timestamp, &Score::value),
-        join<Score>(on(c(&User::steamId) == &Score::userSteamId)),
-        where(levelValidator == c(&Score::levelValidator)),
-        order_by(&Score::value).desc(), limit(topLimit));
+    return Impl::getScoresWithPending(
+        levelValidator, 0, static_cast<std::uint32_t>(topLimit));
+}
 
-    std::vector<ProcessedScore> result;
+[[nodiscard]] std::vector<ProcessedScore> getScoresPage(
+    const std::uint32_t offset, const std::uint32_t limit,
+    const std::string& levelValidator)
+{
+    SSVOH_DTIMED;
 
-    std::uint32_t index = 0;
-    for(const auto& row : query)
-    {
-        result.push_back( //
-            ProcessedScore{
-                .position = index,                  //
-                .userName = std::get<0>(row),       //
-                .scoreTimestamp = std::get<1>(row), //
-                .scoreValue = std::get<2>(row),     //
-            });
+    return Impl::getScoresWithPending(levelValidator, offset, limit);
+}
 
-        ++index;
-    }
+[[nodiscard]] std::uint64_t getLeaderboardVersion(
+    const std::string& levelValidator)
+{
+    const Impl::LeaderboardVersions& versions = Impl::getLeaderboardVersions();
+    const auto it = versions.byLevel.find(levelValidator);
 
-    return result;
+    return it == versions.byLevel.end() ? versions.base : it->second;
 }
 
 [[nodiscard]] bool isLoginTokenValid(std::uint64_t token)
 {
-    using namespace sqlite_orm;
+    SSVOH_DTIMED;
 
-    const auto query = Impl::getStorage().get_all<LoginToken>(
-        where(token == c(&LoginToken::token)));
+    const auto& byToken = Impl::getLoginTokenCache().byToken;
+    const auto it = byToken.find(token);
 
-    if(query.empty() || query.size() > 1)
+    if(it == byToken.end())
     {
         return false;
     }
 
-    return isLoginTokenTimestampValid(query.at(0));
+    return isLoginTokenTimestampValid(it->second);
 }
 
 void addScore(const std::string& levelValidator, const std::uint64_t timestamp,
     const std::uint64_t userSteamId, const double value)
 {
-    using namespace sqlite_orm;
+    SSVOH_DTIMED;
 
-    Score score{
-        .levelValidator = levelValidator, //
-        .timestamp = timestamp,           //
-        .userSteamId = userSteamId,       //
-        .value = value                    //
-    };
+    std::vector<Impl::PendingScore>& pendingScores = Impl::getPendingScores();
 
-    const auto query = Impl::getStorage().get_all<Score>(
-        where(userSteamId == c(&Score::userSteamId) &&
-              levelValidator == c(&Score::levelValidator)));
+    // Reads already include pending scores.
+    Impl::bumpLeaderboardVersion(levelValidator);
 
-    if(query.empty())
+    // Coalesce with an already queued score for the same user and level, only
+    // the best one would survive the commit anyway.
+    for(Impl::PendingScore& pendingScore : pendingScores)
     {
-        const int id = Impl::getStorage().insert(score);
+        Score& score = pendingScore.score;
 
-        SSVOH_DLOG << "Added score with id '" << id << "' to storage:\n"
-                   << Impl::getStorage().dump(score) << '\n';
+        if(score.userSteamId == userSteamId &&
+            score.levelValidator == levelValidator)
+        {
+            if(score.value < value)
+            {
+                score.timestamp = timestamp;
+                score.value = value;
+            }
+
+            return;
+        }
+    }
+
+    pendingScores.push_back( //
+        Impl::PendingScore{
+            .score =
+                Score{
+                    .levelValidator = levelValidator, //
+                    .timestamp = timestamp,           //
+                    .userSteamId = userSteamId,       //
+                    .value = value                    //
+                },
+            .failedWrites = 0 //
+        });
+}
+
+[[nodiscard]] std::size_t getPendingScoreCount()
+{
+    return Impl::getPendingScores().size();
+}
+
+[[nodiscard]] bool isPendingScoreFlushDue()
+{
+    return std::chrono::steady_clock::now() >= Impl::getScoreRetry().notBefore;
+}
+
+void flushPendingScores()
+{
+    SSVOH_DTIMED;
+
+    std::vector<Impl::PendingScore>& pendingScores = Impl::getPendingScores();
 
+    if(pendingScores.empty())
+    {
         return;
     }
 
-    const Score& existingScore = query.at(0);
-    if(existingScore.value >= value)
+    Impl::ScoreRetry& scoreRetry = Impl::getScoreRetry();
+
+    try
     {
+        // If any write throws, the guard rolls back the whole transaction.
+        auto guard = Impl::getStorage().transaction_guard();
+
+        for(const Impl::PendingScore& pendingScore : pendingScores)
+        {
+            Impl::writeScore(pendingScore.score);
+        }
+
+        guard.commit();
+
+        SSVOH_DLOG << "Committed " << pendingScores.size()
+                   << " pending score(s) in a single transaction\n";
+
+        pendingScores.clear();
+        scoreRetry.delay = Impl::minScoreRetryDelay;
         return;
     }
+    catch(const std::exception& e)
+    {
+        SSVOH_DLOG_ERROR << "Failed to commit " << pendingScores.size()
+                         << " pending score(s) in a single transaction: '"
+                         << e.what() << "', writing them one at a time\n";
+    }
 
-    score.id = existingScore.id;
+    // Retrying the batch would fail forever on the same bad record, blocking
+    // all later scores, so each score is written on its own. Scores that fail
+    // because of a transient error stay queued, the others are dropped.
+    std::vector<Impl::PendingScore> retriedScores;
+
+    for(Impl::PendingScore& pendingScore : pendingScores)
+    {
+        if(!Impl::writeOrDropScore(pendingScore))
+        {
+            retriedScores.push_back(std::move(pendingScore));
+        }
+    }
 
-    Impl::getStorage().update(score);
+    pendingScores = std::move(retriedScores);
 
-    SSVOH_DLOG << "Updated score with id '" << score.id << "' to storage:\n"
-               << Impl::getStorage().dump(score) << '\n';
+    if(pendingScores.empty())
+    {
+        scoreRetry.delay = Impl::minScoreRetryDelay;
+        return;
+    }
+
+    scoreRetry.notBefore = std::chrono::steady_clock::now() + scoreRetry.delay;
+    scoreRetry.delay = std::min(scoreRetry.delay * 2, Impl::maxScoreRetryDelay);
 }
 
 [[nodiscard]] std::optional<ProcessedScore> getScore(
     const std::string& levelValidator, const std::uint64_t userSteamId)
 {
+    SSVOH_DTIMED;
+
     using namespace sqlite_orm;
 
-    const auto query =
-        Impl::getStorage().select(columns(&User::name, &Score::timestamp,
-                                      &Score::value, &Score::userSteamId),
-            join<Score>(on(c(&User::steamId) == &Score::userSteamId)),
-            where(levelValidator == c(&Score::levelValidator)),
-            order_by(&Score::value).desc());
+    const std::vector<Impl::EffectivePendingScore> pending =
+        Impl::getEffectivePendingScores(levelValidator);
 
-    if(query.empty())
+    const auto ownIt = std::find_if(pending.begin(), pending.end(),
+        [&](const Impl::EffectivePendingScore& eps)
+        { return eps.userSteamId == userSteamId; });
+
+    std::optional<ProcessedScore> result;
+
+    if(ownIt != pending.end())
     {
-        return std::nullopt;
+        result = ownIt->processedScore;
     }
+    else
+    {
+        auto& scoreStatement = Impl::getUserScoreStatement();
+        get<0>(scoreStatement) = levelValidator;
+        get<1>(scoreStatement) = userSteamId;
 
-    std::uint32_t index = 0;
-    for(const auto& row : query)
+        const auto query = Impl::getStorage().execute(scoreStatement);
+
+        if(query.empty())
+        {
+            return std::nullopt;
+        }
+
+        const auto& row = query.at(0);
+
+        result = ProcessedScore{
+            .position = 0,                      //
+            .userName = std::get<0>(row),       //
+            .scoreTimestamp = std::get<1>(row), //
+            .scoreValue = std::get<2>(row),     //
+        };
+    }
+
+    const double value = result->scoreValue;
+
+    // The position is the number of strictly better scores on the same level,
+    // which the `(levelValidator, value)` index answers without a full scan.
+    auto& countStatement = Impl::getBetterScoreCountStatement();
+    get<0>(countStatement) = levelValidator;
+    get<1>(countStatement) = value;
+
+    const auto countQuery = Impl::getStorage().execute(countStatement);
+    SSVOH_ASSERT(countQuery.size() == 1);
+
+    // Pending scores replace the stored scores of their users.
+    std::int64_t position = countQuery.at(0);
+
+    for(const Impl::EffectivePendingScore& eps : pending)
     {
-        if(std::get<3>(row) == userSteamId)
+        if(eps.replacedValue.has_value() && *eps.replacedValue > value)
         {
-            return {ProcessedScore{
-                .position = index,                  //
-                .userName = std::get<0>(row),       //
-                .scoreTimestamp = std::get<1>(row), //
-                .scoreValue = std::get<2>(row),     //
-            }};
+            --position;
         }
 
-        ++index;
+        if(eps.processedScore.scoreValue > value)
+        {
+            ++position;
+        }
     }
 
-    return std::nullopt;
+    SSVOH_ASSERT(position >= 0);
+    result->position = static_cast<std::uint32_t>(position);
+
+    return result;
+}
+
+void printQueryStats(std::ostream& os)
+{
+    for(const auto& [funcName, histogram] : Impl::getQueryHistograms())
+    {
+        histogram.print(os, funcName);
+    }
+}
+
+void resetQueryStats()
+{
+    for(auto& [funcName, histogram] : Impl::getQueryHistograms())
+    {
+        histogram.reset();
+    }
 }
 
 [[nodiscard]] std::optional<std::string> execute(const std::string& query)
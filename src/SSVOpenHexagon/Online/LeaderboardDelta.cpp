@@ -0,0 +1,58 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/LeaderboardDelta.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hg {
+
+[[nodiscard]] static bool sameScore(const Database::ProcessedScore& a,
+    const Database::ProcessedScore& b) noexcept
+{
+    return a.position == b.position && a.scoreTimestamp == b.scoreTimestamp &&
+           a.scoreValue == b.scoreValue && a.userName == b.userName;
+}
+
+[[nodiscard]] std::vector<Database::ProcessedScore> diffScores(
+    const std::vector<Database::ProcessedScore>& oldPage,
+    const std::vector<Database::ProcessedScore>& newPage)
+{
+    std::vector<Database::ProcessedScore> result;
+
+    for(std::size_t i = 0; i < newPage.size(); ++i)
+    {
+        if(i >= oldPage.size() || !sameScore(oldPage[i], newPage[i]))
+        {
+            result.push_back(newPage[i]);
+        }
+    }
+
+    return result;
+}
+
+[[nodiscard]] bool applyScoresDiff(std::vector<Database::ProcessedScore>& page,
+    const std::uint32_t offset, const std::uint32_t size,
+    const std::vector<Database::ProcessedScore>& changed)
+{
+    // Entries appended by the diff are all in `changed`, so their
+    // placeholder values are always overwritten.
+    page.resize(size);
+
+    for(const Database::ProcessedScore& ps : changed)
+    {
+        if(ps.position < offset || ps.position - offset >= size)
+        {
+            return false;
+        }
+
+        page[ps.position - offset] = ps;
+    }
+
+    return true;
+}
+
+} // namespace hg
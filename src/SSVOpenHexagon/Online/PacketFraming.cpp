@@ -0,0 +1,189 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/PacketFraming.hpp"
+
+#include "SSVOpenHexagon/Global/Assert.hpp"
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/Socket.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hg {
+
+namespace {
+
+constexpr std::size_t frameHeaderSize = sizeof(std::uint32_t);
+
+[[nodiscard]] std::uint32_t readFrameHeader(const char* data) noexcept
+{
+    const auto byte = [&](const std::size_t i)
+    { return static_cast<std::uint32_t>(static_cast<unsigned char>(data[i])); };
+
+    return (byte(0) << 24) | (byte(1) << 16) | (byte(2) << 8) | byte(3);
+}
+
+void writeFrameHeader(std::vector<char>& out, const std::uint32_t size)
+{
+    out.push_back(static_cast<char>((size >> 24) & 0xFF));
+    out.push_back(static_cast<char>((size >> 16) & 0xFF));
+    out.push_back(static_cast<char>((size >> 8) & 0xFF));
+    out.push_back(static_cast<char>(size & 0xFF));
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+
+IncomingFrameBuffer::IncomingFrameBuffer(const std::size_t maxPacketSize)
+    : _data{}, _readPos{0}, _maxPacketSize{maxPacketSize}
+{}
+
+void IncomingFrameBuffer::compact()
+{
+    if(_readPos == 0)
+    {
+        return;
+    }
+
+    _data.erase(_data.begin(), _data.begin() + _readPos);
+    _readPos = 0;
+}
+
+void IncomingFrameBuffer::append(const char* data, const std::size_t size)
+{
+    compact();
+    _data.insert(_data.end(), data, data + size);
+}
+
+[[nodiscard]] sf::Socket::Status IncomingFrameBuffer::receiveFrom(
+    sf::TcpSocket& socket, const std::size_t maxBytes)
+{
+    std::array<char, 4096> chunk;
+    std::size_t totalReceived = 0;
+
+    while(totalReceived < maxBytes)
+    {
+        std::size_t received = 0;
+
+        const sf::Socket::Status status =
+            socket.receive(chunk.data(), chunk.size(), received);
+
+        if(status == sf::Socket::Status::NotReady)
+        {
+            return sf::Socket::Status::Done;
+        }
+
+        if(status != sf::Socket::Status::Done)
+        {
+            return status;
+        }
+
+        append(chunk.data(), received);
+        totalReceived += received;
+    }
+
+    return sf::Socket::Status::Done;
+}
+
+[[nodiscard]] IncomingFrameBuffer::ExtractResult IncomingFrameBuffer::extract(
+    sf::Packet& p)
+{
+    const std::size_t available = _data.size() - _readPos;
+
+    if(available < frameHeaderSize)
+    {
+        return ExtractResult::NoPacket;
+    }
+
+    const std::size_t packetSize = readFrameHeader(_data.data() + _readPos);
+
+    if(packetSize > _maxPacketSize)
+    {
+        return ExtractResult::Oversized;
+    }
+
+    if(available < frameHeaderSize + packetSize)
+    {
+        return ExtractResult::NoPacket;
+    }
+
+    p.clear();
+    p.append(_data.data() + _readPos + frameHeaderSize, packetSize);
+
+    _readPos += frameHeaderSize + packetSize;
+
+    if(_readPos == _data.size())
+    {
+        _data.clear();
+        _readPos = 0;
+    }
+
+    return ExtractResult::Packet;
+}
+
+[[nodiscard]] std::size_t IncomingFrameBuffer::getBufferedBytes() const noexcept
+{
+    return _data.size() - _readPos;
+}
+
+// ----------------------------------------------------------------------------
+
+OutgoingFrameQueue::OutgoingFrameQueue() : _data{}
+{}
+
+void OutgoingFrameQueue::push(const sf::Packet& p)
+{
+    const std::size_t size = p.getDataSize();
+    const char* data = static_cast<const char*>(p.getData());
+
+    writeFrameHeader(_data, static_cast<std::uint32_t>(size));
+    _data.insert(_data.end(), data, data + size);
+}
+
+[[nodiscard]] sf::Socket::Status OutgoingFrameQueue::flushTo(
+    sf::TcpSocket& socket)
+{
+    std::size_t sendPos = 0;
+    sf::Socket::Status status = sf::Socket::Status::Done;
+
+    while(sendPos < _data.size())
+    {
+        std::size_t sent = 0;
+
+        status = socket.send(
+            _data.data() + sendPos, _data.size() - sendPos, sent);
+
+        sendPos += sent;
+        SSVOH_ASSERT(sendPos <= _data.size());
+
+        if(status != sf::Socket::Status::Done)
+        {
+            break;
+        }
+    }
+
+    // Drop what was sent, keep the rest for the next call.
+    _data.erase(_data.begin(), _data.begin() + sendPos);
+
+    return status == sf::Socket::Status::Partial ? sf::Socket::Status::NotReady
+                                                 : status;
+}
+
+[[nodiscard]] bool OutgoingFrameQueue::empty() const noexcept
+{
+    return _data.empty();
+}
+
+[[nodiscard]] std::size_t OutgoingFrameQueue::getPendingBytes() const noexcept
+{
+    return _data.size();
+}
+
+} // namespace hg
@@ -4,6 +4,7 @@
 
 #include "SSVOpenHexagon/Online/Shared.hpp"
 
+#include "SSVOpenHexagon/Online/BinaryCodec.hpp"
 #include "SSVOpenHexagon/Online/Sodium.hpp"
 
 #include "SSVOpenHexagon/Global/Assert.hpp"
@@ -18,700 +19,594 @@
 
 #include <boost/pfr.hpp>
 
+#include <cstddef>
 #include <cstdint>
 #include <sstream>
 #include <iostream>
 #include <optional>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
-namespace hg {
-
-namespace {
-
-template <typename...>
-struct TypeList
-{};
+namespace hg::Binary {
 
-template <typename T, typename... Ts>
-[[nodiscard]] constexpr bool contains(TypeList<Ts...>)
-{
-    return (std::is_same_v<T, Ts> || ...);
-}
-
-template <typename T, typename... Ts>
-[[nodiscard]] constexpr std::size_t indexOfType(TypeList<Ts...>)
+template <>
+struct Codec<GameVersion>
 {
-    static_assert(contains<T>(TypeList<Ts...>{}));
+    static constexpr std::size_t fixedSize = 3 * sizeof(sf::Int32);
 
-    constexpr std::array test{std::is_same_v<T, Ts>...};
-    for(std::size_t i = 0; i < test.size(); ++i)
+    static void encode(Writer& w, const GameVersion& gv)
     {
-        if(test[i])
-        {
-            return i;
-        }
+        w.writeBigEndian(static_cast<sf::Int32>(gv.major));
+        w.writeBigEndian(static_cast<sf::Int32>(gv.minor));
+        w.writeBigEndian(static_cast<sf::Int32>(gv.micro));
     }
 
-    throw;
-}
-
-template <typename T, typename... Ts>
-[[nodiscard]] constexpr bool variantContains(TypeList<std::variant<Ts...>>)
-{
-    return contains<T>(TypeList<Ts...>{});
-}
+    [[nodiscard]] static bool decode(Reader& r, GameVersion& gv)
+    {
+        sf::Int32 major;
+        sf::Int32 minor;
+        sf::Int32 micro;
 
-template <typename T, typename... Ts>
-[[nodiscard]] constexpr std::size_t indexOfVariantType(
-    TypeList<std::variant<Ts...>>)
-{
-    return indexOfType<T>(TypeList<Ts...>{});
-}
+        if(!r.readBigEndian(major) || !r.readBigEndian(minor) ||
+            !r.readBigEndian(micro))
+        {
+            return false;
+        }
 
-using PacketType = sf::Uint8;
+        gv.major = major;
+        gv.minor = minor;
+        gv.micro = micro;
 
-template <typename T>
-[[nodiscard]] constexpr PacketType getPacketType()
-{
-    if constexpr(variantContains<T>(TypeList<PVClientToServer>{}))
-    {
-        return indexOfVariantType<T>(TypeList<PVClientToServer>{});
-    }
-    else if constexpr(variantContains<T>(TypeList<PVServerToClient>{}))
-    {
-        return indexOfVariantType<T>(TypeList<PVServerToClient>{});
-    }
-    else
-    {
-        throw;
+        return true;
     }
-}
-
-static constexpr sf::Uint8 preamble1stByte{'o'};
-static constexpr sf::Uint8 preamble2ndByte{'h'};
+};
 
-void encodePreamble(sf::Packet& p)
+// Same layout as `replay_file::serialize_to_packet`: the size of the
+// serialized replay followed by its bytes.
+template <>
+struct Codec<replay_file>
 {
-    p << static_cast<sf::Uint8>(preamble1stByte)
-      << static_cast<sf::Uint8>(preamble2ndByte);
-}
+    static constexpr std::size_t fixedSize = dynamicSize;
 
-void encodeProtocolVersion(sf::Packet& p)
-{
-    p << static_cast<sf::Uint8>(PROTOCOL_VERSION);
-}
+    // Upper bound of the serialized size, used to reserve space.
+    [[nodiscard]] static std::size_t encodedSize(const replay_file& rf)
+    {
+        constexpr std::size_t fixedFieldsUpperBound = 64;
 
-void encodeVersion(sf::Packet& p)
-{
-    p << static_cast<sf::Uint8>(GAME_VERSION.major)
-      << static_cast<sf::Uint8>(GAME_VERSION.minor)
-      << static_cast<sf::Uint8>(GAME_VERSION.micro);
-}
+        return sizeof(sf::Uint64) + fixedFieldsUpperBound +
+               rf._player_name.size() + rf._data.size() +
+               rf._pack_id.size() + rf._level_id.size();
+    }
 
-void clearPacketAndEncodePreambleAndProtocolVersionAndGameVersion(sf::Packet& p)
-{
-    p.clear();
+    static void encode(Writer& w, const replay_file& rf)
+    {
+        std::vector<sf::Uint8>& buffer = w.getBuffer();
 
-    encodePreamble(p);
-    encodeProtocolVersion(p);
-    encodeVersion(p);
-}
+        const std::size_t sizeOffset = w.getSize();
+        (void)w.claim(sizeof(sf::Uint64));
 
-template <typename T>
-void encodePacketType(sf::Packet& p, const T&)
-{
-    p << static_cast<sf::Uint8>(getPacketType<T>());
-}
+        // Serialize directly into the output, growing it if the estimate was
+        // not enough.
+        const std::size_t dataOffset = w.getSize();
+        std::size_t capacity = encodedSize(rf);
 
-template <typename T>
-[[nodiscard]] bool extractInto(
-    T& target, std::ostringstream& errorOss, sf::Packet& p);
+        constexpr std::size_t maxCapacity = 64 * 1024 * 1024;
 
-template <typename T, typename = void>
-struct Extractor
-{
-    template <typename U = T>
-    [[nodiscard]] static auto doExtractIntoImpl(
-        U& target, std::ostringstream& errorOss, sf::Packet& p, int)
-        -> decltype((p >> target), bool())
-    {
-        if(!(p >> target))
+        while(true)
         {
-            errorOss << "Error extracting single object\n";
-            return false;
-        }
+            buffer.resize(dataOffset + capacity);
 
-        return true;
-    }
+            const serialization_result sr = rf.serialize(
+                reinterpret_cast<std::byte*>(buffer.data() + dataOffset),
+                capacity);
 
-    template <typename U = T>
-    [[nodiscard]] static bool doExtractIntoImpl(
-        U& target, std::ostringstream& errorOss, sf::Packet& p, long)
-    {
-        bool result = true;
+            if(sr || capacity >= maxCapacity)
+            {
+                const std::size_t writtenBytes = sr ? sr.written_bytes() : 0;
 
-        if constexpr((boost::pfr::tuple_size_v<T>) > 0)
-        {
-            boost::pfr::for_each_field(target,
-                [&](auto& nestedField)
-                {
-                    if(!extractInto(nestedField, errorOss, p))
-                    {
-                        result = false;
-                    }
-                });
-        }
+                buffer.resize(dataOffset + writtenBytes);
 
-        return result;
-    }
+                storeBigEndian(buffer.data() + sizeOffset,
+                    static_cast<sf::Uint64>(writtenBytes));
 
-    [[nodiscard]] static bool doExtractInto(
-        T& target, std::ostringstream& errorOss, sf::Packet& p)
-    {
-        return doExtractIntoImpl(target, errorOss, p, 0);
-    }
-};
-
-template <typename T, std::size_t N>
-struct Extractor<std::array<T, N>>
-{
-    using Type = std::array<T, N>;
-
-    [[nodiscard]] static bool doExtractInto(
-        Type& result, std::ostringstream& errorOss, sf::Packet& p)
-    {
-        for(std::size_t i = 0; i < N; ++i)
-        {
-            if(extractInto(result[i], errorOss, p))
-            {
-                continue;
+                return;
             }
 
-            errorOss << "Error extracting array element at index '" << i
-                     << "'\n";
-
-            return false;
+            capacity *= 2;
         }
-
-        return true;
     }
-};
-
 
-template <typename T>
-struct Extractor<std::vector<T>>
-{
-    using Type = std::vector<T>;
-
-    [[nodiscard]] static bool doExtractInto(
-        Type& result, std::ostringstream& errorOss, sf::Packet& p)
+    [[nodiscard]] static bool decode(Reader& r, replay_file& rf)
     {
         sf::Uint64 size;
-        if(!(p >> size))
+
+        if(!r.readBigEndian(size))
         {
-            errorOss << "Error extracting vector size\n";
             return false;
         }
 
-        result.resize(size);
+        const sf::Uint8* data = r.take(size);
 
-        for(std::size_t i = 0; i < size; ++i)
+        if(data == nullptr)
         {
-            if(extractInto(result[i], errorOss, p))
-            {
-                continue;
-            }
-
-            errorOss << "Error extracting vector element at index '" << i
-                     << "'\n";
-
             return false;
         }
 
-        return true;
+        return static_cast<bool>(
+            rf.deserialize(reinterpret_cast<const std::byte*>(data), size));
     }
 };
 
-template <typename T>
-struct Extractor<std::optional<T>>
+template <>
+struct Codec<compressed_replay_file>
 {
-    using Type = std::optional<T>;
+    static constexpr std::size_t fixedSize = dynamicSize;
 
-    [[nodiscard]] static bool doExtractInto(
-        Type& result, std::ostringstream& errorOss, sf::Packet& p)
+    [[nodiscard]] static std::size_t encodedSize(
+        const compressed_replay_file& crf)
     {
-        bool set;
-        if(!(p >> set))
-        {
-            errorOss << "Error extracting optional set flag\n";
-            return false;
-        }
+        return sizeof(sf::Uint64) + crf._data.size();
+    }
 
-        if(!set)
-        {
-            result.reset();
-            return true;
-        }
+    static void encode(Writer& w, const compressed_replay_file& crf)
+    {
+        w.writeBigEndian(static_cast<sf::Uint64>(crf._data.size()));
+        w.writeBytes(crf._data.data(), crf._data.size());
+    }
 
-        result.emplace();
+    [[nodiscard]] static bool decode(Reader& r, compressed_replay_file& crf)
+    {
+        sf::Uint64 size;
 
-        if(!extractInto(*result, errorOss, p))
+        if(!r.readBigEndian(size))
         {
-            errorOss << "Error extracting optional element\n";
             return false;
         }
 
-        return true;
-    }
-};
-
-template <>
-struct Extractor<hg::replay_file>
-{
-    using Type = hg::replay_file;
+        const sf::Uint8* data = r.take(size);
 
-    [[nodiscard]] static bool doExtractInto(
-        Type& result, std::ostringstream& errorOss, sf::Packet& p)
-    {
-        if(!result.deserialize_from_packet(p))
+        if(data == nullptr)
         {
-            errorOss << "Error deserializing replay\n";
             return false;
         }
 
+        crf._data.assign(reinterpret_cast<const char*>(data),
+            reinterpret_cast<const char*>(data) + size);
+
         return true;
     }
 };
 
+// Only used by `make*Packet(p, PEncryptedMsg{...})`, encrypted packets are
+// normally built in place by `makeEncryptedPacketImpl`.
 template <>
-struct Extractor<hg::compressed_replay_file>
+struct Codec<PEncryptedMsg>
 {
-    using Type = hg::compressed_replay_file;
+    static constexpr std::size_t fixedSize = dynamicSize;
 
-    [[nodiscard]] static bool doExtractInto(
-        Type& result, std::ostringstream& errorOss, sf::Packet& p)
+    [[nodiscard]] static std::size_t encodedSize(const PEncryptedMsg& msg)
     {
-        if(!result.deserialize_from_packet(p))
-        {
-            errorOss << "Error deserializing compressed replay\n";
-            return false;
-        }
+        return sodiumNonceBytes + 2 * sizeof(sf::Uint64) +
+               msg.ciphertextLength;
+    }
 
-        return true;
+    static void encode(Writer& w, const PEncryptedMsg& msg)
+    {
+        SSVOH_ASSERT(msg.ciphertext.ptr != nullptr);
+        SSVOH_ASSERT(msg.ciphertext.ptr->size() >= msg.ciphertextLength);
+
+        Binary::encode(w, msg.nonce);
+        Binary::encode(w, msg.messageLength);
+        Binary::encode(w, msg.ciphertextLength);
+        w.writeBytes(msg.ciphertext.ptr->data(), msg.ciphertextLength);
     }
 };
 
-template <>
-struct Extractor<hg::GameVersion>
-{
-    using Type = hg::GameVersion;
+} // namespace hg::Binary
 
-    [[nodiscard]] static bool doExtractInto(
-        Type& result, std::ostringstream& errorOss, sf::Packet& p)
-    {
-        sf::Int32 major;
-        if(!(p >> major))
-        {
-            errorOss << "Error deserializing major version\n";
-            return false;
-        }
+namespace hg {
 
-        sf::Int32 minor;
-        if(!(p >> minor))
-        {
-            errorOss << "Error deserializing minor version\n";
-            return false;
-        }
+namespace {
 
-        sf::Int32 micro;
-        if(!(p >> micro))
+template <typename...>
+struct TypeList
+{};
+
+template <typename T, typename... Ts>
+[[nodiscard]] constexpr bool contains(TypeList<Ts...>)
+{
+    return (std::is_same_v<T, Ts> || ...);
+}
+
+template <typename T, typename... Ts>
+[[nodiscard]] constexpr std::size_t indexOfType(TypeList<Ts...>)
+{
+    static_assert(contains<T>(TypeList<Ts...>{}));
+
+    constexpr std::array test{std::is_same_v<T, Ts>...};
+    for(std::size_t i = 0; i < test.size(); ++i)
+    {
+        if(test[i])
         {
-            errorOss << "Error deserializing micro version\n";
-            return false;
+            return i;
         }
+    }
 
-        result.major = major;
-        result.minor = minor;
-        result.micro = micro;
+    throw;
+}
 
-        return true;
-    }
-};
+template <typename T, typename... Ts>
+[[nodiscard]] constexpr bool variantContains(TypeList<std::variant<Ts...>>)
+{
+    return contains<T>(TypeList<Ts...>{});
+}
 
-template <typename T>
-[[nodiscard]] bool extractInto(
-    T& target, std::ostringstream& errorOss, sf::Packet& p)
+template <typename T, typename... Ts>
+[[nodiscard]] constexpr std::size_t indexOfVariantType(
+    TypeList<std::variant<Ts...>>)
 {
-    return Extractor<T>::doExtractInto(target, errorOss, p);
+    return indexOfType<T>(TypeList<Ts...>{});
 }
 
+using PacketType = sf::Uint8;
+
 template <typename T>
-[[nodiscard]] std::optional<T> extract(
-    std::ostringstream& errorOss, sf::Packet& p)
+[[nodiscard]] constexpr PacketType getPacketType()
 {
-    T temp;
-
-    if(!extractInto(temp, errorOss, p))
+    if constexpr(variantContains<T>(TypeList<PVClientToServer>{}))
+    {
+        return indexOfVariantType<T>(TypeList<PVClientToServer>{});
+    }
+    else if constexpr(variantContains<T>(TypeList<PVServerToClient>{}))
     {
-        return std::nullopt;
+        return indexOfVariantType<T>(TypeList<PVServerToClient>{});
+    }
+    else
+    {
+        throw;
     }
+}
+
+static constexpr sf::Uint8 preamble1stByte{'o'};
+static constexpr sf::Uint8 preamble2ndByte{'h'};
+
+// Preamble, protocol version, and game version.
+constexpr std::size_t headerSize = 6;
 
-    return {std::move(temp)};
+void encodePreambleAndProtocolVersionAndGameVersion(Binary::Writer& w)
+{
+    Binary::encode(w, preamble1stByte);
+    Binary::encode(w, preamble2ndByte);
+    Binary::encode(w, static_cast<sf::Uint8>(PROTOCOL_VERSION));
+    Binary::encode(w, static_cast<sf::Uint8>(GAME_VERSION.major));
+    Binary::encode(w, static_cast<sf::Uint8>(GAME_VERSION.minor));
+    Binary::encode(w, static_cast<sf::Uint8>(GAME_VERSION.micro));
 }
 
 template <typename T>
-[[nodiscard]] auto makeAlwaysTrueMatcher(
-    std::ostringstream& errorOss, sf::Packet& p)
+[[nodiscard]] std::size_t getEncodedOHPacketSize(const T& data)
 {
-    return [&](const char* name) -> bool
-    {
-        T temp;
-
-        if(!extractInto<T>(temp, errorOss, p))
-        {
-            errorOss << "Error extracting " << name << '\n';
-            return false;
-        }
+    return sizeof(PacketType) + Binary::encodedSize(data);
+}
 
-        return true;
-    };
+template <typename T>
+void encodeOHPacket(Binary::Writer& w, const T& data)
+{
+    Binary::encode(w, getPacketType<T>());
+    Binary::encode(w, data);
 }
 
-class AdvancedMatcher
+[[nodiscard]] bool verifyReceivedPacketPreambleAndProtocolVersionAndGameVersion(
+    std::ostringstream& errorOss, Binary::Reader& r)
 {
-private:
-    std::ostringstream& _errorOss;
-    sf::Packet& _p;
-
-public:
-    [[nodiscard]] explicit AdvancedMatcher(
-        std::ostringstream& errorOss, sf::Packet& p)
-        : _errorOss{errorOss}, _p{p}
-    {}
-
-    template <typename T>
-    [[nodiscard]] bool extractIntoOrPrintError(const char* name, T& target)
+    const auto extract = [&](const char* name, sf::Uint8& target)
     {
-        if(!extractInto<T>(target, _errorOss, _p))
+        if(!Binary::decode(r, target))
         {
-            _errorOss << "Error extracting " << name << '\n';
+            errorOss << "Error extracting " << name << '\n';
             return false;
         }
 
         return true;
-    }
+    };
 
-    template <typename T>
-    [[nodiscard]] bool extractAndMatchOrPrintError(
-        const char* name, T& target, const T& expected)
+    const auto match = [&](const char* name, const sf::Uint8 expected)
     {
-        if(!extractIntoOrPrintError(name, target))
+        sf::Uint8 value;
+
+        if(!extract(name, value))
         {
             return false;
         }
 
-        if(target != expected)
+        if(value != expected)
         {
-            _errorOss << "Error, " << name << " has value '" << target
-                      << ", which doesn't match expected value '" << expected
-                      << "'\n";
+            errorOss << "Error, " << name << " has value '"
+                     << static_cast<int>(value)
+                     << ", which doesn't match expected value '"
+                     << static_cast<int>(expected) << "'\n";
 
             return false;
         }
 
         return true;
-    }
-
-    template <typename T>
-    [[nodiscard]] bool skipOrPrintError(const char* name)
-    {
-        T temp;
-        return extractIntoOrPrintError(name, temp);
-    }
-
-    template <typename T>
-    [[nodiscard]] std::optional<T> extractOrPrintError(const char* name)
-    {
-        T temp;
-
-        if(!extractIntoOrPrintError(name, temp))
-        {
-            return std::nullopt;
-        }
-
-        return {std::move(temp)};
-    }
-
-    template <typename T>
-    [[nodiscard]] bool matchOrPrintError(const char* name, const T& expected)
-    {
-        T temp;
-        return extractAndMatchOrPrintError(name, temp, expected);
-    }
-};
-
-template <typename T>
-[[nodiscard]] auto makeMatcher(std::ostringstream& errorOss, sf::Packet& p)
-{
-    return [&](const char* name, const T& expected) -> bool {
-        return AdvancedMatcher{errorOss, p}.matchOrPrintError<T>(
-            name, expected);
     };
-}
 
-template <typename T>
-[[nodiscard]] auto makeExtractor(std::ostringstream& errorOss, sf::Packet& p)
-{
-    return [&](const char* name) -> std::optional<T> {
-        return AdvancedMatcher{errorOss, p}.extractOrPrintError<T>(name);
+    const auto skip = [&](const char* name)
+    {
+        sf::Uint8 value;
+        return extract(name, value);
     };
-}
-
-[[nodiscard]] bool verifyReceivedPacketPreambleAndProtocolVersionAndGameVersion(
-    std::ostringstream& errorOss, sf::Packet& p)
-{
-    AdvancedMatcher m{errorOss, p};
 
     return
         // Preamble bytes and protocol version must match.
-        m.matchOrPrintError<sf::Uint8>("preamble 1st byte", preamble1stByte) &&
-        m.matchOrPrintError<sf::Uint8>("preamble 2st byte", preamble2ndByte) &&
-        m.matchOrPrintError<sf::Uint8>("protocol version", PROTOCOL_VERSION) &&
+        match("preamble 1st byte", preamble1stByte) &&
+        match("preamble 2st byte", preamble2ndByte) &&
+        match("protocol version", PROTOCOL_VERSION) &&
 
         // Game version is currently ignored.
-        m.skipOrPrintError<sf::Uint8>("major version") &&
-        m.skipOrPrintError<sf::Uint8>("minor version") &&
-        m.skipOrPrintError<sf::Uint8>("micro version");
+        skip("major version") && //
+        skip("minor version") && //
+        skip("micro version");
 }
 
-[[nodiscard]] std::optional<PacketType> extractPacketType(
-    std::ostringstream& errorOss, sf::Packet& p)
-{
-    const std::optional<sf::Uint8> extracted =
-        makeExtractor<sf::Uint8>(errorOss, p)("packet type");
-
-    if(!extracted.has_value())
-    {
-        return std::nullopt;
-    }
-
-    return {static_cast<PacketType>(*extracted)};
-}
-
-template <typename T>
-void encodeFirstNVectorElements(
-    sf::Packet& p, const std::vector<T>& data, const std::size_t len)
-{
-    SSVOH_ASSERT(data.size() >= len);
-
-    for(std::size_t i = 0; i < len; ++i)
-    {
-        p << data[i];
-    }
-}
-
-std::vector<sf::Uint8>& getStaticMessageBuffer()
+std::vector<sf::Uint8>& getStaticEncodeBuffer()
 {
     thread_local std::vector<sf::Uint8> result;
     return result;
 }
 
-std::vector<sf::Uint8>& getStaticCiphertextBuffer()
+std::vector<sf::Uint8>& getStaticDecryptBuffer()
 {
     thread_local std::vector<sf::Uint8> result;
     return result;
 }
 
-sf::Packet& getStaticPacketBuffer()
+void assignToPacket(sf::Packet& p, const std::vector<sf::Uint8>& buffer)
 {
-    thread_local sf::Packet result;
-    return result;
+    p.clear();
+    p.append(buffer.data(), buffer.size());
 }
 
-template <typename TData, typename TField>
-auto encodeField(sf::Packet& p, const TData& data, const TField& field);
-
-template <typename TData, typename TField>
-void encodeFieldImpl(
-    sf::Packet& p, const TData& data, const TField& field, long)
+template <typename T>
+void makePacketImpl(sf::Packet& p, const T& data)
 {
-    if constexpr(boost::pfr::tuple_size_v < TField >> 0)
-    {
-        boost::pfr::for_each_field(field, [&](const auto& nestedField)
-            { encodeField(p, data, nestedField); });
-    }
-}
+    std::vector<sf::Uint8>& buffer = getStaticEncodeBuffer();
+    buffer.clear();
+    buffer.reserve(headerSize + getEncodedOHPacketSize(data));
 
-template <typename TData, typename TField>
-auto encodeFieldImpl(sf::Packet& p, const TData&, const TField& field, int)
-    -> decltype((p << field), void())
-{
-    p << field;
-}
+    Binary::Writer w{buffer};
+    encodePreambleAndProtocolVersionAndGameVersion(w);
+    encodeOHPacket(w, data);
 
-template <typename TData, typename TField>
-auto encodeField(sf::Packet& p, const TData& data, const TField& field)
-{
-    encodeFieldImpl(p, data, field, 0);
+    assignToPacket(p, buffer);
 }
 
-template <typename TData, typename T, std::size_t N>
-void encodeField(sf::Packet& p, const TData& data, const std::array<T, N>& arr)
+template <typename T>
+[[nodiscard]] bool makeEncryptedPacketImpl(
+    const SodiumTransmitKeyArray& keyTransmit, sf::Packet& p, const T& data)
 {
-    for(std::size_t i = 0; i < arr.size(); ++i)
-    {
-        encodeField(p, data, arr[i]);
-    }
-}
+    // The whole `PEncryptedMsg` packet is built in a single buffer:
+    //
+    //     header | type | nonce | messageLength | ciphertextLength | mac | msg
+    //
+    // The message is encoded at its final position and then encrypted in
+    // place, as libsodium allows the ciphertext to overlap the message.
+    std::vector<sf::Uint8>& buffer = getStaticEncodeBuffer();
+    buffer.clear();
 
-template <typename TData, typename T>
-void encodeField(sf::Packet& p, const TData& data, const std::vector<T>& vec)
-{
-    encodeField(p, data, static_cast<sf::Uint64>(vec.size()));
+    constexpr std::size_t lengthsSize = 2 * sizeof(sf::Uint64);
 
-    for(const T& x : vec)
-    {
-        encodeField(p, data, x);
-    }
-}
+    buffer.reserve(headerSize + sizeof(PacketType) + sodiumNonceBytes +
+                   lengthsSize + crypto_secretbox_MACBYTES +
+                   getEncodedOHPacketSize(data));
 
-template <typename TData, typename T>
-void encodeField(sf::Packet& p, const TData& data, const std::optional<T>& opt)
-{
-    encodeField(p, data, opt.has_value());
+    Binary::Writer w{buffer};
+    encodePreambleAndProtocolVersionAndGameVersion(w);
+    Binary::encode(w, getPacketType<PEncryptedMsg>());
 
-    if(opt.has_value())
-    {
-        encodeField(p, data, *opt);
-    }
-}
+    const SodiumNonceArray nonce = generateNonce();
+    Binary::encode(w, nonce);
 
-template <typename TData>
-void encodeField(sf::Packet& p, const TData& data, const hg::replay_file& rf)
-{
-    (void)data;
-    (void)rf.serialize_to_packet(p);
-}
+    const std::size_t lengthsOffset = w.getSize();
+    (void)w.claim(lengthsSize);
 
-template <typename TData>
-void encodeField(
-    sf::Packet& p, const TData& data, const hg::compressed_replay_file& crf)
-{
-    (void)data;
-    (void)crf.serialize_to_packet(p);
-}
+    const std::size_t ciphertextOffset = w.getSize();
+    (void)w.claim(crypto_secretbox_MACBYTES);
 
-template <typename TData>
-void encodeField(sf::Packet& p, const TData& data, const hg::GameVersion& gv)
-{
-    (void)data;
-    p << static_cast<sf::Int32>(gv.major) << static_cast<sf::Int32>(gv.minor)
-      << static_cast<sf::Int32>(gv.micro);
-}
+    const std::size_t messageOffset = w.getSize();
+    encodeOHPacket(w, data);
 
-template <typename TData>
-void encodeField(
-    sf::Packet& p, const TData& data, const Impl::CiphertextVectorPtr& field)
-{
-    encodeFirstNVectorElements(p, *field.ptr, data.ciphertextLength);
-}
+    const std::size_t messageLength = w.getSize() - messageOffset;
+    const std::size_t ciphertextLength = getCiphertextLength(messageLength);
+    SSVOH_ASSERT(ciphertextOffset + ciphertextLength == w.getSize());
 
-template <typename T>
-void encodeOHPacket(sf::Packet& p, const T& data)
-{
-    encodePacketType(p, data);
+    Binary::storeBigEndian(buffer.data() + lengthsOffset,
+        static_cast<sf::Uint64>(messageLength));
+
+    Binary::storeBigEndian(buffer.data() + lengthsOffset + sizeof(sf::Uint64),
+        static_cast<sf::Uint64>(ciphertextLength));
 
-    if constexpr(boost::pfr::tuple_size_v < T >> 0)
+    if(crypto_secretbox_easy(buffer.data() + ciphertextOffset,
+           buffer.data() + messageOffset, messageLength, nonce.data(),
+           keyTransmit.data()) != 0)
     {
-        boost::pfr::for_each_field(
-            data, [&](const auto& field) { encodeField(p, data, field); });
+        return false;
     }
+
+    assignToPacket(p, buffer);
+    return true;
 }
 
-[[nodiscard]] bool decryptPacket(std::ostringstream& errorOss, sf::Packet& p,
-    const SodiumReceiveKeyArray& keyReceive, sf::Packet& decryptedPacket)
+[[nodiscard]] bool decryptPacket(const SodiumReceiveKeyArray* keyReceive,
+    std::ostringstream& errorOss, Binary::Reader& r,
+    std::vector<sf::Uint8>& message)
 {
+    if(keyReceive == nullptr)
+    {
+        errorOss << "Cannot decode encrypted message without receive key\n";
+        return false;
+    }
+
     SodiumNonceArray nonce;
-    if(!extractInto(nonce, errorOss, p))
+    if(!Binary::decode(r, nonce))
     {
         errorOss << "Error decoding client nonce\n";
         return false;
     }
 
     sf::Uint64 messageLength;
-    if(!extractInto(messageLength, errorOss, p))
+    if(!Binary::decode(r, messageLength))
     {
         errorOss << "Error decoding client message length\n";
         return false;
     }
 
     sf::Uint64 ciphertextLength;
-    if(!extractInto(ciphertextLength, errorOss, p))
+    if(!Binary::decode(r, ciphertextLength))
     {
         errorOss << "Error decoding client ciphertext length\n";
         return false;
     }
 
-    std::vector<sf::Uint8>& ciphertext = getStaticCiphertextBuffer();
-    ciphertext.resize(ciphertextLength);
-
-    for(std::size_t i = 0; i < ciphertextLength; ++i)
+    if(ciphertextLength < crypto_secretbox_MACBYTES ||
+        messageLength != ciphertextLength - crypto_secretbox_MACBYTES)
     {
-        if(p >> ciphertext[i])
-        {
-            continue;
-        }
-
-        errorOss << "Error decoding client ciphertext at index '" << i << "'\n";
+        errorOss << "Mismatched client message and ciphertext lengths\n";
+        return false;
+    }
 
+    // Decrypt straight from the received bytes, without copying them first.
+    const sf::Uint8* ciphertext = r.take(ciphertextLength);
+    if(ciphertext == nullptr)
+    {
+        errorOss << "Error decoding client ciphertext\n";
         return false;
     }
 
-    std::vector<sf::Uint8>& message = getStaticMessageBuffer();
     message.resize(messageLength);
 
-    if(crypto_secretbox_open_easy(message.data(), ciphertext.data(),
-           ciphertextLength, nonce.data(), keyReceive.data()) != 0)
+    if(crypto_secretbox_open_easy(message.data(), ciphertext,
+           ciphertextLength, nonce.data(), keyReceive->data()) != 0)
     {
         errorOss << "Failure decrypting encrypted client message\n";
         return false;
     }
 
-    decryptedPacket.clear();
-    decryptedPacket.append(message.data(), messageLength);
-
     return true;
 }
 
-template <typename F, typename T>
-[[nodiscard]] bool makeEncryptedPacketImpl(F&& f,
-    const SodiumTransmitKeyArray& keyTransmit, sf::Packet& p, const T& data)
+template <typename T>
+[[nodiscard]] bool decodeAllFields(
+    std::ostringstream& errorOss, Binary::Reader& r, T& target)
 {
-    sf::Packet& packetToEncrypt = getStaticPacketBuffer();
-    packetToEncrypt.clear();
+    bool success = true;
 
-    encodeOHPacket(packetToEncrypt, data);
+    if constexpr((boost::pfr::tuple_size_v<T>) > 0)
+    {
+        boost::pfr::for_each_field(target,
+            [&](auto& field, std::size_t i)
+            {
+                if(success && !Binary::decode(r, field))
+                {
+                    errorOss << "Error decoding field #" << i << " \n";
+                    success = false;
+                }
+            });
+    }
 
-    PEncryptedMsg encryptedMsg{
-        .nonce = generateNonce(),
-        .messageLength = packetToEncrypt.getDataSize(),
-        .ciphertextLength = getCiphertextLength(packetToEncrypt.getDataSize())
-        //
-    };
+    return success;
+}
 
-    encryptedMsg.ciphertext.ptr = &getStaticCiphertextBuffer();
-    encryptedMsg.ciphertext.ptr->resize(encryptedMsg.ciphertextLength);
+template <typename TVariant, std::size_t I>
+[[nodiscard]] TVariant decodeAlternative(
+    std::ostringstream& errorOss, Binary::Reader& r)
+{
+    std::variant_alternative_t<I, TVariant> result;
 
-    if(crypto_secretbox_easy(encryptedMsg.ciphertext.ptr->data(),
-           static_cast<const sf::Uint8*>(packetToEncrypt.getData()),
-           encryptedMsg.messageLength, encryptedMsg.nonce.data(),
-           keyTransmit.data()) != 0)
+    if(!decodeAllFields(errorOss, r, result))
     {
-        return false;
+        return {PInvalid{.error = errorOss.str()}};
     }
 
-    f(p, encryptedMsg);
-    return true;
+    return {std::move(result)};
+}
+
+template <typename TVariant>
+[[nodiscard]] TVariant decodePacket(const SodiumReceiveKeyArray* keyReceive,
+    std::ostringstream& errorOss, Binary::Reader& r, const bool allowEncrypted)
+{
+    PacketType pt;
+    if(!Binary::decode(r, pt))
+    {
+        errorOss << "Error extracting packet type\n";
+        return {PInvalid{.error = errorOss.str()}};
+    }
+
+    if(pt == getPacketType<PEncryptedMsg>())
+    {
+        if(!allowEncrypted)
+        {
+            errorOss << "Nested encrypted message\n";
+            return {PInvalid{.error = errorOss.str()}};
+        }
+
+        std::vector<sf::Uint8>& message = getStaticDecryptBuffer();
+
+        if(!decryptPacket(keyReceive, errorOss, r, message))
+        {
+            return {PInvalid{.error = errorOss.str()}};
+        }
+
+        Binary::Reader messageReader{message.data(), message.size()};
+
+        return decodePacket<TVariant>(
+            keyReceive, errorOss, messageReader, false /* allowEncrypted */);
+    }
+
+    // The first two alternatives are `PInvalid` and `PEncryptedMsg`.
+    constexpr std::size_t firstPacketIndex = 2;
+    static_assert(getPacketType<PEncryptedMsg>() == firstPacketIndex - 1);
+
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) -> TVariant
+    {
+        std::optional<TVariant> result;
+
+        (void)((pt == firstPacketIndex + Is &&
+                   (result.emplace(decodeAlternative<TVariant,
+                        firstPacketIndex + Is>(errorOss, r)),
+                       true)) ||
+               ...);
+
+        if(result.has_value())
+        {
+            return std::move(*result);
+        }
+
+        errorOss << "Unknown packet type '" << static_cast<int>(pt) << "'\n";
+        return {PInvalid{.error = errorOss.str()}};
+    }
+    (std::make_index_sequence<std::variant_size_v<TVariant> -
+                              firstPacketIndex>{});
+}
+
+template <typename TVariant>
+[[nodiscard]] TVariant decodePacketWithHeader(
+    const SodiumReceiveKeyArray* keyReceive, std::ostringstream& errorOss,
+    sf::Packet& p)
+{
+    Binary::Reader r{p.getData(), p.getDataSize()};
+
+    if(!verifyReceivedPacketPreambleAndProtocolVersionAndGameVersion(
+           errorOss, r))
+    {
+        return {PInvalid{.error = errorOss.str()}};
+    }
+
+    return decodePacket<TVariant>(
+        keyReceive, errorOss, r, true /* allowEncrypted */);
 }
 
 } // namespace
@@ -721,8 +616,7 @@ template <typename F, typename T>
 template <typename T>
 void makeClientToServerPacket(sf::Packet& p, const T& data)
 {
-    clearPacketAndEncodePreambleAndProtocolVersionAndGameVersion(p);
-    encodeOHPacket(p, data);
+    makePacketImpl(p, data);
 }
 
 template void makeClientToServerPacket(sf::Packet&, const PEncryptedMsg&);
@@ -739,9 +633,7 @@ template <typename T>
 [[nodiscard]] bool makeClientToServerEncryptedPacket(
     const SodiumTransmitKeyArray& keyTransmit, sf::Packet& p, const T& data)
 {
-    return makeEncryptedPacketImpl([](auto&&... xs)
-        { makeClientToServerPacket(SSVOH_FWD(xs)...); },
-        keyTransmit, p, data);
+    return makeEncryptedPacketImpl(keyTransmit, p, data);
 }
 
 #define INSTANTIATE_MAKE_CTS_ENCRYPTED(mIdx, mData, mArg) \
@@ -753,115 +645,11 @@ VRM_PP_FOREACH_REVERSE(INSTANTIATE_MAKE_CTS_ENCRYPTED, VRM_PP_EMPTY(),
 
 // ----------------------------------------------------------------------------
 
-#define HANDLE_PACKET(type)                                 \
-    do                                                      \
-    {                                                       \
-        if(*pt == getPacketType<type>())                    \
-        {                                                   \
-            type result;                                    \
-                                                            \
-            if(!extractAllMembers(result))                  \
-            {                                               \
-                return {PInvalid{.error = errorOss.str()}}; \
-            }                                               \
-                                                            \
-            return {result};                                \
-        }                                                   \
-    }                                                       \
-    while(false)
-
-#define INJECT_COMMON_PACKET_HANDLING_CODE(function)                     \
-    const std::optional<PacketType> pt = extractPacketType(errorOss, p); \
-                                                                         \
-    if(!pt.has_value())                                                  \
-    {                                                                    \
-        return {PInvalid{.error = errorOss.str()}};                      \
-    }                                                                    \
-                                                                         \
-    if(*pt == getPacketType<PEncryptedMsg>())                            \
-    {                                                                    \
-        if(!decodeEncryptedPacket(keyReceive, errorOss, p))              \
-        {                                                                \
-            return {PInvalid{.error = errorOss.str()}};                  \
-        }                                                                \
-                                                                         \
-        return function(keyReceive, errorOss, getStaticPacketBuffer());  \
-    }                                                                    \
-                                                                         \
-    const auto extractAllMembers = makeExtractAllMembers(errorOss, p)
-
-
-#define FORIMPL_HANDLE_PACKET(mIdx, mData, mArg) HANDLE_PACKET(mArg);
-
-// ----------------------------------------------------------------------------
-
-static auto makeExtractAllMembers(std::ostringstream& errorOss, sf::Packet& p)
-{
-    return [&]<typename T>(T& target)
-    {
-        bool success = true;
-
-        if constexpr((boost::pfr::tuple_size_v<T>) > 0)
-        {
-            boost::pfr::for_each_field(target,
-                [&](auto& field, std::size_t i)
-                {
-                    if(!extractInto(field, errorOss, p))
-                    {
-                        errorOss << "Error decoding field #" << i << " \n";
-                        success = false;
-                    }
-                });
-        }
-
-        return success;
-    };
-}
-
-[[nodiscard]] static bool decodeEncryptedPacket(
-    const SodiumReceiveKeyArray* keyReceive, std::ostringstream& errorOss,
-    sf::Packet& p)
-{
-    if(keyReceive == nullptr)
-    {
-        errorOss << "Cannot decode encrypted message without receive key\n";
-        return false;
-    }
-
-    if(!decryptPacket(errorOss, p, *keyReceive, getStaticPacketBuffer()))
-    {
-        return false;
-    }
-
-    return true;
-}
-
-// ----------------------------------------------------------------------------
-
-[[nodiscard]] static PVClientToServer decodeClientToServerPacketInner(
-    const SodiumReceiveKeyArray* keyReceive, std::ostringstream& errorOss,
-    sf::Packet& p)
-{
-    INJECT_COMMON_PACKET_HANDLING_CODE(decodeClientToServerPacketInner);
-
-    VRM_PP_FOREACH_REVERSE(FORIMPL_HANDLE_PACKET, VRM_PP_EMPTY(),
-        VRM_PP_TPL_EXPLODE(SSVOH_CTS_PACKETS))
-
-    errorOss << "Unknown packet type '" << static_cast<int>(*pt) << "'\n";
-    return {PInvalid{.error = errorOss.str()}};
-}
-
 [[nodiscard]] PVClientToServer decodeClientToServerPacket(
     const SodiumReceiveKeyArray* keyReceive, std::ostringstream& errorOss,
     sf::Packet& p)
 {
-    if(!verifyReceivedPacketPreambleAndProtocolVersionAndGameVersion(
-           errorOss, p))
-    {
-        return {PInvalid{.error = errorOss.str()}};
-    }
-
-    return decodeClientToServerPacketInner(keyReceive, errorOss, p);
+    return decodePacketWithHeader<PVClientToServer>(keyReceive, errorOss, p);
 }
 
 // ----------------------------------------------------------------------------
@@ -869,8 +657,7 @@ static auto makeExtractAllMembers(std::ostringstream& errorOss, sf::Packet& p)
 template <typename T>
 void makeServerToClientPacket(sf::Packet& p, const T& data)
 {
-    clearPacketAndEncodePreambleAndProtocolVersionAndGameVersion(p);
-    encodeOHPacket(p, data);
+    makePacketImpl(p, data);
 }
 
 template void makeServerToClientPacket(sf::Packet&, const PEncryptedMsg&);
@@ -887,9 +674,7 @@ template <typename T>
 [[nodiscard]] bool makeServerToClientEncryptedPacket(
     const SodiumTransmitKeyArray& keyTransmit, sf::Packet& p, const T& data)
 {
-    return makeEncryptedPacketImpl([](auto&&... xs)
-        { makeServerToClientPacket(SSVOH_FWD(xs)...); },
-        keyTransmit, p, data);
+    return makeEncryptedPacketImpl(keyTransmit, p, data);
 }
 
 #define INSTANTIATE_MAKE_STC_ENCRYPTED(mIdx, mData, mArg) \
@@ -901,30 +686,11 @@ VRM_PP_FOREACH_REVERSE(INSTANTIATE_MAKE_STC_ENCRYPTED, VRM_PP_EMPTY(),
 
 // ----------------------------------------------------------------------------
 
-[[nodiscard]] static PVServerToClient decodeServerToClientPacketInner(
-    const SodiumReceiveKeyArray* keyReceive, std::ostringstream& errorOss,
-    sf::Packet& p)
-{
-    INJECT_COMMON_PACKET_HANDLING_CODE(decodeServerToClientPacketInner);
-
-    VRM_PP_FOREACH_REVERSE(FORIMPL_HANDLE_PACKET, VRM_PP_EMPTY(),
-        VRM_PP_TPL_EXPLODE(SSVOH_STC_PACKETS))
-
-    errorOss << "Unknown packet type '" << static_cast<int>(*pt) << "'\n";
-    return {PInvalid{.error = errorOss.str()}};
-}
-
 [[nodiscard]] PVServerToClient decodeServerToClientPacket(
     const SodiumReceiveKeyArray* keyReceive, std::ostringstream& errorOss,
     sf::Packet& p)
 {
-    if(!verifyReceivedPacketPreambleAndProtocolVersionAndGameVersion(
-           errorOss, p))
-    {
-        return {PInvalid{.error = errorOss.str()}};
-    }
-
-    return decodeServerToClientPacketInner(keyReceive, errorOss, p);
+    return decodePacketWithHeader<PVServerToClient>(keyReceive, errorOss, p);
 }
 
 } // namespace hg
@@ -0,0 +1,101 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string_view>
+
+namespace hg::Utils {
+
+LatencyHistogram::LatencyHistogram() noexcept
+{
+    reset();
+}
+
+void LatencyHistogram::record(const std::uint64_t us) noexcept
+{
+    const std::size_t bucket =
+        std::min<std::size_t>(std::bit_width(us), bucketCount - 1);
+
+    ++_buckets[bucket];
+    ++_count;
+    _totalUs += us;
+    _maxUs = std::max(_maxUs, us);
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    _buckets.fill(0);
+    _count = 0;
+    _totalUs = 0;
+    _maxUs = 0;
+}
+
+[[nodiscard]] std::uint64_t LatencyHistogram::getCount() const noexcept
+{
+    return _count;
+}
+
+[[nodiscard]] std::uint64_t LatencyHistogram::getTotalUs() const noexcept
+{
+    return _totalUs;
+}
+
+[[nodiscard]] std::uint64_t LatencyHistogram::getMaxUs() const noexcept
+{
+    return _maxUs;
+}
+
+[[nodiscard]] double LatencyHistogram::getMeanUs() const noexcept
+{
+    return _count == 0 ? 0.0
+                       : static_cast<double>(_totalUs) /
+                             static_cast<double>(_count);
+}
+
+[[nodiscard]] std::uint64_t LatencyHistogram::getPercentileUs(
+    const double p) const noexcept
+{
+    // Nearest-rank definition: the sample at 1-based rank `ceil(p * count)`.
+    const std::uint64_t rank = std::max<std::uint64_t>(1,
+        static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(_count))));
+
+    std::uint64_t cumulative = 0;
+
+    for(std::size_t i = 0; i < bucketCount; ++i)
+    {
+        cumulative += _buckets[i];
+
+        if(cumulative >= rank)
+        {
+            const std::uint64_t upperBound =
+                i == 0 ? 0 : (std::uint64_t{1} << i) - 1;
+
+            return std::min(upperBound, _maxUs);
+        }
+    }
+
+    return _maxUs;
+}
+
+void LatencyHistogram::print(
+    std::ostream& os, const std::string_view name) const
+{
+    os << std::left << std::setw(36) << name << std::right
+       << " n=" << std::setw(8) << _count                           //
+       << " mean=" << std::setw(8) << std::fixed << std::setprecision(1)
+       << getMeanUs() << "us"                                       //
+       << " p50<=" << std::setw(8) << getPercentileUs(0.5) << "us"  //
+       << " p99<=" << std::setw(8) << getPercentileUs(0.99) << "us" //
+       << " max=" << std::setw(8) << _maxUs << "us\n";
+}
+
+} // namespace hg::Utils
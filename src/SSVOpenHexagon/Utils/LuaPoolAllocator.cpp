@@ -0,0 +1,237 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LuaPoolAllocator.hpp"
+
+#include "SSVOpenHexagon/Global/Assert.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace hg::Utils {
+
+static_assert(LuaPoolAllocator::granularity >= alignof(std::max_align_t));
+static_assert(LuaPoolAllocator::chunkSize % LuaPoolAllocator::granularity == 0);
+
+[[nodiscard]] std::size_t LuaPoolAllocator::sizeClassOf(
+    const std::size_t size) noexcept
+{
+    SSVOH_ASSERT(size > 0 && size <= maxPooledSize);
+    return (size + granularity - 1) / granularity - 1;
+}
+
+[[nodiscard]] void* LuaPoolAllocator::allocatePooled(
+    const std::size_t sizeClass) noexcept
+{
+    if(FreeBlock* block = _freeLists[sizeClass]; block != nullptr)
+    {
+        _freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    const std::size_t blockSize = (sizeClass + 1) * granularity;
+
+    if(static_cast<std::size_t>(_chunkEnd - _chunkCursor) < blockSize &&
+        !refillChunk())
+    {
+        return nullptr;
+    }
+
+    void* result = _chunkCursor;
+    _chunkCursor += blockSize;
+
+    return result;
+}
+
+[[nodiscard]] bool LuaPoolAllocator::refillChunk() noexcept
+{
+    // Chunks kept by `trim` are used again first.
+    if(_usedChunkCount == _chunks.size())
+    {
+        UniquePtrArray<std::byte> chunk{
+            new(std::nothrow) std::byte[chunkSize]};
+
+        if(chunk == nullptr)
+        {
+            return false;
+        }
+
+        try
+        {
+            _chunks.push_back(std::move(chunk));
+        }
+        catch(const std::bad_alloc&)
+        {
+            return false;
+        }
+
+        _stats.bytesReserved += chunkSize;
+    }
+
+    // The tail of the previous chunk is too small for the request that
+    // triggered the refill, but can still serve smaller ones.
+    const auto remaining = static_cast<std::size_t>(_chunkEnd - _chunkCursor);
+
+    if(remaining >= granularity)
+    {
+        pushFreeBlock(_chunkCursor, sizeClassOf(remaining));
+    }
+
+    _chunkCursor = _chunks[_usedChunkCount].get();
+    _chunkEnd = _chunkCursor + chunkSize;
+    ++_usedChunkCount;
+
+    return true;
+}
+
+void LuaPoolAllocator::pushFreeBlock(
+    void* ptr, const std::size_t sizeClass) noexcept
+{
+    _freeLists[sizeClass] = new(ptr) FreeBlock{_freeLists[sizeClass]};
+}
+
+LuaPoolAllocator::LuaPoolAllocator()
+    : _freeLists{},
+      _chunks{},
+      _usedChunkCount{0},
+      _chunkCursor{nullptr},
+      _chunkEnd{nullptr},
+      _stats{},
+      _allocationsAtTickStart{0}
+{}
+
+[[nodiscard]] void* LuaPoolAllocator::reallocate(
+    void* ptr, std::size_t oldSize, const std::size_t newSize) noexcept
+{
+    if(ptr == nullptr)
+    {
+        // Lua does not guarantee a meaningful `oldSize` for new blocks.
+        oldSize = 0;
+    }
+
+    const bool oldPooled = oldSize <= maxPooledSize;
+
+    if(newSize == 0)
+    {
+        if(ptr != nullptr)
+        {
+            if(oldPooled)
+            {
+                pushFreeBlock(ptr, sizeClassOf(oldSize));
+            }
+            else
+            {
+                std::free(ptr);
+            }
+
+            _stats.bytesInUse -= oldSize;
+        }
+
+        return nullptr;
+    }
+
+    const bool newPooled = newSize <= maxPooledSize;
+    void* result;
+
+    if(ptr != nullptr && oldPooled && newPooled &&
+        sizeClassOf(oldSize) == sizeClassOf(newSize))
+    {
+        result = ptr;
+    }
+    else if(ptr != nullptr && !oldPooled && !newPooled)
+    {
+        result = std::realloc(ptr, newSize);
+
+        if(result == nullptr)
+        {
+            return nullptr;
+        }
+    }
+    else
+    {
+        result = newPooled ? allocatePooled(sizeClassOf(newSize))
+                           : std::malloc(newSize);
+
+        if(result == nullptr)
+        {
+            return nullptr;
+        }
+
+        if(ptr != nullptr)
+        {
+            std::memcpy(result, ptr, std::min(oldSize, newSize));
+
+            if(oldPooled)
+            {
+                pushFreeBlock(ptr, sizeClassOf(oldSize));
+            }
+            else
+            {
+                std::free(ptr);
+            }
+        }
+    }
+
+    if(ptr == nullptr)
+    {
+        ++_stats.allocations;
+
+        if(newPooled)
+        {
+            ++_stats.pooledAllocations;
+        }
+    }
+
+    _stats.bytesInUse = _stats.bytesInUse - oldSize + newSize;
+    _stats.peakBytesInUse = std::max(_stats.peakBytesInUse, _stats.bytesInUse);
+
+    return result;
+}
+
+[[nodiscard]] void* LuaPoolAllocator::luaAlloc(
+    void* ud, void* ptr, std::size_t oldSize, std::size_t newSize) noexcept
+{
+    SSVOH_ASSERT(ud != nullptr);
+
+    return static_cast<LuaPoolAllocator*>(ud)->reallocate(
+        ptr, oldSize, newSize);
+}
+
+void LuaPoolAllocator::trim(const std::size_t retainedBytes) noexcept
+{
+    SSVOH_ASSERT(_stats.bytesInUse == 0);
+
+    // Every block is free, so all chunks can be carved out from the start
+    // again, regardless of the size classes they were split into.
+    _freeLists.fill(nullptr);
+    _usedChunkCount = 0;
+    _chunkCursor = _chunkEnd = nullptr;
+
+    const std::size_t retainedChunks =
+        (retainedBytes + chunkSize - 1) / chunkSize;
+
+    if(_chunks.size() > retainedChunks)
+    {
+        _chunks.resize(retainedChunks);
+    }
+
+    _stats.bytesReserved = _chunks.size() * chunkSize;
+}
+
+void LuaPoolAllocator::markTick() noexcept
+{
+    _stats.lastTickAllocations = _stats.allocations - _allocationsAtTickStart;
+    _allocationsAtTickStart = _stats.allocations;
+}
+
+[[nodiscard]] const LuaPoolAllocator::Stats&
+LuaPoolAllocator::getStats() const noexcept
+{
+    return _stats;
+}
+
+} // namespace hg::Utils
@@ -0,0 +1,155 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LuaProfiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+
+namespace hg::Utils {
+
+LuaProfiler::Scope::Scope(
+    LuaProfiler* profiler, const std::size_t index) noexcept
+    : _profiler{profiler != nullptr && profiler->_enabled ? profiler : nullptr},
+      _parent{_profiler != nullptr ? _profiler->_current : nullptr},
+      _index{index},
+      _childNs{0},
+      _start{}
+{
+    if(_profiler == nullptr)
+    {
+        return;
+    }
+
+    _profiler->_current = this;
+    _start = HRClock::now();
+}
+
+LuaProfiler::Scope::~Scope() noexcept
+{
+    if(_profiler == nullptr)
+    {
+        return;
+    }
+
+    const std::int64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            HRClock::now() - _start)
+            .count();
+
+    Entry& e = _profiler->_entries[_index];
+    ++e.calls;
+    e.totalNs += ns;
+    e.selfNs += ns - _childNs;
+    e.maxNs = std::max(e.maxNs, ns);
+
+    if(_parent != nullptr)
+    {
+        _parent->_childNs += ns;
+    }
+
+    _profiler->_current = _parent;
+}
+
+LuaProfiler::LuaProfiler() : _current{nullptr}, _enabled{false}
+{}
+
+void LuaProfiler::setEnabled(const bool enabled) noexcept
+{
+    _enabled = enabled;
+}
+
+[[nodiscard]] bool LuaProfiler::isEnabled() const noexcept
+{
+    return _enabled;
+}
+
+[[nodiscard]] std::size_t LuaProfiler::getIndex(
+    const std::string& name, const Kind kind)
+{
+    const auto [it, inserted] = _indices.try_emplace(name, _entries.size());
+
+    if(inserted)
+    {
+        _entries.push_back(Entry{name, kind, 0, 0, 0, 0});
+    }
+
+    return it->second;
+}
+
+void LuaProfiler::reset() noexcept
+{
+    for(Entry& e : _entries)
+    {
+        e.calls = 0;
+        e.totalNs = e.selfNs = e.maxNs = 0;
+    }
+}
+
+[[nodiscard]] std::vector<LuaProfiler::Entry>
+LuaProfiler::getSortedEntries() const
+{
+    std::vector<Entry> result;
+
+    for(const Entry& e : _entries)
+    {
+        if(e.calls > 0)
+        {
+            result.push_back(e);
+        }
+    }
+
+    std::sort(result.begin(), result.end(),
+        [](const Entry& a, const Entry& b) { return a.selfNs > b.selfNs; });
+
+    return result;
+}
+
+void LuaProfiler::printCsv(std::ostream& os) const
+{
+    os << "name,kind,calls,total_ms,self_ms,avg_us,max_us\n";
+
+    for(const Entry& e : getSortedEntries())
+    {
+        const double totalMs = static_cast<double>(e.totalNs) / 1'000'000.0;
+        const double selfMs = static_cast<double>(e.selfNs) / 1'000'000.0;
+        const double avgUs = static_cast<double>(e.totalNs) / 1'000.0 /
+                             static_cast<double>(e.calls);
+        const double maxUs = static_cast<double>(e.maxNs) / 1'000.0;
+
+        os << e.name << ',' << luaProfilerKindToStr(e.kind) << ',' << e.calls
+           << ',' << totalMs << ',' << selfMs << ',' << avgUs << ',' << maxUs
+           << '\n';
+    }
+}
+
+[[nodiscard]] bool LuaProfiler::dumpToFile(const std::string& path) const
+{
+    std::ofstream ofs{path};
+
+    if(!ofs)
+    {
+        return false;
+    }
+
+    printCsv(ofs);
+    return static_cast<bool>(ofs);
+}
+
+[[nodiscard]] const char* luaProfilerKindToStr(
+    const LuaProfiler::Kind kind) noexcept
+{
+    switch(kind)
+    {
+        case LuaProfiler::Kind::Callback: return "callback";
+        case LuaProfiler::Kind::Timeline: return "timeline";
+        case LuaProfiler::Kind::Binding: return "binding";
+    }
+
+    return "unknown";
+}
+
+} // namespace hg::Utils
@@ -0,0 +1,223 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/ParticlePool.hpp"
+
+#include "SSVOpenHexagon/Global/Assert.hpp"
+
+#include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
+#include "SSVOpenHexagon/Utils/MoveTowards.hpp"
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace hg::Utils {
+
+void ParticlePool::moveParticle(
+    const std::size_t from, const std::size_t to) noexcept
+{
+    _xs[to] = _xs[from];
+    _ys[to] = _ys[from];
+    _velocityXs[to] = _velocityXs[from];
+    _velocityYs[to] = _velocityYs[from];
+    _angles[to] = _angles[from];
+    _angularVelocities[to] = _angularVelocities[from];
+    _scales[to] = _scales[from];
+    _alphas[to] = _alphas[from];
+    _colors[to] = _colors[from];
+}
+
+template <typename F>
+void ParticlePool::eraseIfImpl(F&& f) noexcept
+{
+    std::size_t out = 0;
+
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        if(f(i))
+        {
+            continue;
+        }
+
+        if(out != i)
+        {
+            moveParticle(i, out);
+        }
+
+        ++out;
+    }
+
+    _size = out;
+}
+
+ParticlePool::ParticlePool(const std::size_t capacity)
+    : _capacity{capacity},
+      _size{0},
+      _xs(capacity),
+      _ys(capacity),
+      _velocityXs(capacity),
+      _velocityYs(capacity),
+      _angles(capacity),
+      _angularVelocities(capacity),
+      _scales(capacity),
+      _alphas(capacity),
+      _colors(capacity)
+{}
+
+bool ParticlePool::spawn(const ParticleSpawnData& data) noexcept
+{
+    if(_size == _capacity)
+    {
+        return false;
+    }
+
+    const std::size_t i = _size++;
+
+    _xs[i] = data.position.x;
+    _ys[i] = data.position.y;
+    _velocityXs[i] = data.velocity.x;
+    _velocityYs[i] = data.velocity.y;
+    _angles[i] = data.angle;
+    _angularVelocities[i] = data.angularVelocity;
+    _scales[i] = data.scale;
+    _alphas[i] = data.alpha;
+    _colors[i] = data.color;
+
+    return true;
+}
+
+void ParticlePool::clear() noexcept
+{
+    _size = 0;
+}
+
+[[nodiscard]] std::size_t ParticlePool::size() const noexcept
+{
+    return _size;
+}
+
+[[nodiscard]] std::size_t ParticlePool::capacity() const noexcept
+{
+    return _capacity;
+}
+
+[[nodiscard]] bool ParticlePool::empty() const noexcept
+{
+    return _size == 0;
+}
+
+void ParticlePool::integrate(const float ft) noexcept
+{
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        _xs[i] += _velocityXs[i] * ft;
+        _ys[i] += _velocityYs[i] * ft;
+    }
+
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        _angles[i] += _angularVelocities[i] * ft;
+    }
+}
+
+void ParticlePool::fade(const float step) noexcept
+{
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        _alphas[i] = std::floor(getMoveTowardsZero(_alphas[i], step));
+    }
+}
+
+void ParticlePool::multiplyScale(const float mult) noexcept
+{
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        _scales[i] *= mult;
+    }
+}
+
+void ParticlePool::placeOnCircle(const float radius) noexcept
+{
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        _xs[i] = std::cos(_angles[i]) * radius;
+        _ys[i] = std::sin(_angles[i]) * radius;
+    }
+}
+
+void ParticlePool::eraseFaded(const float minAlpha) noexcept
+{
+    eraseIfImpl([&](const std::size_t i) { return _alphas[i] <= minAlpha; });
+}
+
+void ParticlePool::eraseOutside(
+    const sf::Vector2f& min, const sf::Vector2f& max) noexcept
+{
+    eraseIfImpl(
+        [&](const std::size_t i)
+        {
+            return _xs[i] < min.x || _xs[i] > max.x || //
+                   _ys[i] < min.y || _ys[i] > max.y;
+        });
+}
+
+void ParticlePool::appendQuads(FastVertexVectorTris& out,
+    const sf::Vector2f& textureSize, const sf::Vector2f& origin,
+    const Rotation rotation) const
+{
+    constexpr float degToRad = 3.14159265358979323846f / 180.f;
+
+    out.reserve(out.size() + _size * 6);
+
+    // Corners of the texture rectangle, relative to the origin.
+    const float left = -origin.x;
+    const float top = -origin.y;
+    const float right = textureSize.x - origin.x;
+    const float bottom = textureSize.y - origin.y;
+
+    const sf::Vector2f tcNW{0.f, 0.f};
+    const sf::Vector2f tcSW{0.f, textureSize.y};
+    const sf::Vector2f tcSE{textureSize.x, textureSize.y};
+    const sf::Vector2f tcNE{textureSize.x, 0.f};
+
+    for(std::size_t i = 0; i < _size; ++i)
+    {
+        float scaledCos = _scales[i];
+        float scaledSin = 0.f;
+
+        if(rotation == Rotation::Enabled)
+        {
+            const float radians = _angles[i] * degToRad;
+            scaledCos *= std::cos(radians);
+            scaledSin = _scales[i] * std::sin(radians);
+        }
+
+        const auto transform = [&](const float x, const float y)
+        {
+            return sf::Vector2f{_xs[i] + x * scaledCos - y * scaledSin,
+                _ys[i] + x * scaledSin + y * scaledCos};
+        };
+
+        sf::Color color = _colors[i];
+        color.a = static_cast<sf::Uint8>(_alphas[i]);
+
+        const sf::Vector2f nw = transform(left, top);
+        const sf::Vector2f sw = transform(left, bottom);
+        const sf::Vector2f se = transform(right, bottom);
+        const sf::Vector2f ne = transform(right, top);
+
+        out.unsafe_emplace_back(nw, color, tcNW);
+        out.unsafe_emplace_back(sw, color, tcSW);
+        out.unsafe_emplace_back(se, color, tcSE);
+        out.unsafe_emplace_back(nw, color, tcNW);
+        out.unsafe_emplace_back(se, color, tcSE);
+        out.unsafe_emplace_back(ne, color, tcNE);
+    }
+}
+
+} // namespace hg::Utils
@@ -0,0 +1,50 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
+
+#include <SSVUtils/Core/Log/Log.hpp>
+
+#include <ostream>
+#include <string>
+
+namespace hg::Utils {
+
+[[nodiscard]] static ScriptLogCapture*& getActiveCapture() noexcept
+{
+    thread_local ScriptLogCapture* result = nullptr;
+    return result;
+}
+
+ScriptLog::ScriptLog(const char* title) : _title{title}, _os{}
+{}
+
+ScriptLog::~ScriptLog()
+{
+    ScriptLogCapture* const capture = getActiveCapture();
+
+    if(capture == nullptr)
+    {
+        ssvu::lo(_title) << _os.str() << std::flush;
+        return;
+    }
+
+    capture->_buffer += '[';
+    capture->_buffer += _title;
+    capture->_buffer += "] ";
+    capture->_buffer += _os.str();
+}
+
+ScriptLogCapture::ScriptLogCapture(std::string& buffer)
+    : _buffer{buffer}, _previous{getActiveCapture()}
+{
+    getActiveCapture() = this;
+}
+
+ScriptLogCapture::~ScriptLogCapture()
+{
+    getActiveCapture() = _previous;
+}
+
+} // namespace hg::Utils
@@ -0,0 +1,336 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/TextBatch.hpp"
+
+#include "SSVOpenHexagon/Global/Assert.hpp"
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Glyph.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace hg::Utils {
+
+// Same as the quads emitted by `sf::Text`, including their padding.
+static void addGlyphQuad(std::vector<sf::Vertex>& vertices,
+    const sf::Vector2f& position, const sf::Glyph& glyph,
+    const float italicShear, const float outlineThickness)
+{
+    constexpr float padding = 1.f;
+
+    const float left = glyph.bounds.left - padding;
+    const float top = glyph.bounds.top - padding;
+    const float right = glyph.bounds.left + glyph.bounds.width + padding;
+    const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+    const auto u1 = static_cast<float>(glyph.textureRect.left) - padding;
+    const auto v1 = static_cast<float>(glyph.textureRect.top) - padding;
+    const auto u2 = static_cast<float>(
+                        glyph.textureRect.left + glyph.textureRect.width) +
+                    padding;
+    const auto v2 = static_cast<float>(
+                        glyph.textureRect.top + glyph.textureRect.height) +
+                    padding;
+
+    const float x = position.x - outlineThickness;
+    const float y = position.y - outlineThickness;
+
+    const sf::Vector2f nw{x + left - italicShear * top, y + top};
+    const sf::Vector2f ne{x + right - italicShear * top, y + top};
+    const sf::Vector2f sw{x + left - italicShear * bottom, y + bottom};
+    const sf::Vector2f se{x + right - italicShear * bottom, y + bottom};
+
+    vertices.emplace_back(nw, sf::Color::White, sf::Vector2f{u1, v1});
+    vertices.emplace_back(ne, sf::Color::White, sf::Vector2f{u2, v1});
+    vertices.emplace_back(sw, sf::Color::White, sf::Vector2f{u1, v2});
+    vertices.emplace_back(sw, sf::Color::White, sf::Vector2f{u1, v2});
+    vertices.emplace_back(ne, sf::Color::White, sf::Vector2f{u2, v1});
+    vertices.emplace_back(se, sf::Color::White, sf::Vector2f{u2, v2});
+}
+
+[[nodiscard]] std::size_t TextBatch::RunKeyHash::operator()(
+    const RunKey& key) const noexcept
+{
+    std::size_t result = std::hash<std::string_view>{}(key.string);
+
+    const auto combine = [&](const std::size_t x)
+    { result ^= x + 0x9e3779b9 + (result << 6) + (result >> 2); };
+
+    combine(std::hash<const sf::Font*>{}(key.font));
+    combine(key.characterSize);
+    combine(key.style);
+    combine(std::bit_cast<std::uint32_t>(key.letterSpacing));
+    combine(std::bit_cast<std::uint32_t>(key.lineSpacing));
+    combine(std::bit_cast<std::uint32_t>(key.outlineThickness));
+
+    return result;
+}
+
+void TextBatch::layout(Run& run, const RunKey& key)
+{
+    // Mirrors `sf::Text::ensureGeometryUpdate`.
+    SSVOH_ASSERT(key.font != nullptr);
+    SSVOH_ASSERT(
+        (key.style & (sf::Text::Underlined | sf::Text::StrikeThrough)) == 0);
+
+    const sf::Font& font = *key.font;
+    const unsigned int size = key.characterSize;
+
+    run.vertices.clear();
+    run.outlineVertexCount = 0;
+    run.bounds = sf::FloatRect{};
+    run.texture = &font.getTexture(size);
+
+    if(key.string.empty())
+    {
+        return;
+    }
+
+    const bool isBold = key.style & sf::Text::Bold;
+    const float italicShear = (key.style & sf::Text::Italic) ? 0.209f : 0.f;
+    const float outline = key.outlineThickness;
+
+    float whitespaceWidth = font.getGlyph(U' ', size, isBold).advance;
+    const float letterSpacing =
+        (whitespaceWidth / 3.f) * (key.letterSpacing - 1.f);
+    whitespaceWidth += letterSpacing;
+    const float lineSpacing = font.getLineSpacing(size) * key.lineSpacing;
+
+    float x = 0.f;
+    auto y = static_cast<float>(size);
+
+    auto minX = static_cast<float>(size);
+    auto minY = static_cast<float>(size);
+    float maxX = 0.f;
+    float maxY = 0.f;
+
+    // Fill quads are collected separately and appended after the outlines.
+    _fillVertices.clear();
+
+    std::uint32_t prevChar = 0;
+
+    for(const char c : key.string)
+    {
+        const auto curChar = static_cast<std::uint32_t>(
+            static_cast<unsigned char>(c));
+
+        if(curChar == U'\r')
+        {
+            continue;
+        }
+
+        x += font.getKerning(prevChar, curChar, size);
+        prevChar = curChar;
+
+        if(curChar == U' ' || curChar == U'\n' || curChar == U'\t')
+        {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+
+            switch(curChar)
+            {
+                case U' ': x += whitespaceWidth; break;
+                case U'\t': x += whitespaceWidth * 4; break;
+                case U'\n':
+                    y += lineSpacing;
+                    x = 0;
+                    break;
+            }
+
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+
+            continue;
+        }
+
+        if(outline != 0)
+        {
+            const sf::Glyph& glyph =
+                font.getGlyph(curChar, size, isBold, outline);
+
+            const float left = glyph.bounds.left;
+            const float top = glyph.bounds.top;
+            const float right = glyph.bounds.left + glyph.bounds.width;
+            const float bottom = glyph.bounds.top + glyph.bounds.height;
+
+            addGlyphQuad(run.vertices, {x, y}, glyph, italicShear, outline);
+
+            minX = std::min(minX, x + left - italicShear * bottom - outline);
+            maxX = std::max(maxX, x + right - italicShear * top - outline);
+            minY = std::min(minY, y + top - outline);
+            maxY = std::max(maxY, y + bottom - outline);
+        }
+
+        const sf::Glyph& glyph = font.getGlyph(curChar, size, isBold);
+
+        addGlyphQuad(_fillVertices, {x, y}, glyph, italicShear, 0.f);
+
+        if(outline == 0)
+        {
+            const float left = glyph.bounds.left;
+            const float top = glyph.bounds.top;
+            const float right = glyph.bounds.left + glyph.bounds.width;
+            const float bottom = glyph.bounds.top + glyph.bounds.height;
+
+            minX = std::min(minX, x + left - italicShear * bottom);
+            maxX = std::max(maxX, x + right - italicShear * top);
+            minY = std::min(minY, y + top);
+            maxY = std::max(maxY, y + bottom);
+        }
+
+        x += glyph.advance + letterSpacing;
+    }
+
+    run.outlineVertexCount = run.vertices.size();
+    run.vertices.insert(
+        run.vertices.end(), _fillVertices.begin(), _fillVertices.end());
+
+    run.bounds = sf::FloatRect{minX, minY, maxX - minX, maxY - minY};
+}
+
+[[nodiscard]] TextBatch::Run& TextBatch::getRun(
+    const sf::Text& text, const std::string_view str)
+{
+    _lookupKey.font = text.getFont();
+    _lookupKey.characterSize = text.getCharacterSize();
+    _lookupKey.style = text.getStyle();
+    _lookupKey.letterSpacing = text.getLetterSpacing();
+    _lookupKey.lineSpacing = text.getLineSpacing();
+    _lookupKey.outlineThickness = text.getOutlineThickness();
+    _lookupKey.string.assign(str);
+
+    if(const auto it = _runs.find(_lookupKey); it != _runs.end())
+    {
+        it->second.lastUsedFrame = _frame;
+        return it->second;
+    }
+
+    ++_stats.layouts;
+
+    Run& run = _runs[_lookupKey];
+    layout(run, _lookupKey);
+    run.lastUsedFrame = _frame;
+
+    return run;
+}
+
+[[nodiscard]] FastVertexVectorTris& TextBatch::getBatch(
+    const sf::Texture* texture)
+{
+    for(Batch& b : _batches)
+    {
+        if(b.texture == texture)
+        {
+            return b.vertices;
+        }
+    }
+
+    return _batches.emplace_back(Batch{texture, {}}).vertices;
+}
+
+TextBatch::TextBatch()
+    : _runs{},
+      _batches{},
+      _lookupKey{},
+      _fillVertices{},
+      _frame{0},
+      _stats{},
+      _lastFrameStats{}
+{}
+
+[[nodiscard]] sf::FloatRect TextBatch::getLocalBounds(
+    const sf::Text& text, const std::string_view str)
+{
+    return getRun(text, str).bounds;
+}
+
+[[nodiscard]] sf::FloatRect TextBatch::getGlobalBounds(
+    const sf::Text& text, const std::string_view str)
+{
+    return text.getTransform().transformRect(getLocalBounds(text, str));
+}
+
+sf::FloatRect TextBatch::add(const sf::Text& text, const std::string_view str)
+{
+    const Run& run = getRun(text, str);
+    const sf::Transform& transform = text.getTransform();
+
+    ++_stats.texts;
+
+    if(!run.vertices.empty())
+    {
+        FastVertexVectorTris& batch = getBatch(run.texture);
+        batch.reserve_more(run.vertices.size());
+
+        sf::Vertex* out = batch.unsafe_grow(run.vertices.size());
+
+        const sf::Color& outlineColor = text.getOutlineColor();
+        const sf::Color& fillColor = text.getFillColor();
+
+        for(std::size_t i = 0; i < run.vertices.size(); ++i)
+        {
+            const sf::Vertex& v = run.vertices[i];
+
+            out[i].position = transform.transformPoint(v.position);
+            out[i].color =
+                i < run.outlineVertexCount ? outlineColor : fillColor;
+            out[i].texCoords = v.texCoords;
+        }
+    }
+
+    return transform.transformRect(run.bounds);
+}
+
+void TextBatch::flush(sf::RenderTarget& target, sf::RenderStates states)
+{
+    for(Batch& b : _batches)
+    {
+        if(b.vertices.size() == 0)
+        {
+            continue;
+        }
+
+        states.texture = b.texture;
+        target.draw(b.vertices, states);
+        b.vertices.clear();
+
+        ++_stats.drawCalls;
+    }
+}
+
+void TextBatch::endFrame()
+{
+    ++_frame;
+
+    if(_frame % maxIdleFrames == 0)
+    {
+        std::erase_if(_runs,
+            [this](const auto& p)
+            { return _frame - p.second.lastUsedFrame >= maxIdleFrames; });
+    }
+
+    _stats.cachedRuns = _runs.size();
+    _lastFrameStats = _stats;
+    _stats = Stats{};
+}
+
+void TextBatch::clear()
+{
+    _runs.clear();
+    _batches.clear();
+}
+
+[[nodiscard]] const TextBatch::Stats&
+TextBatch::getLastFrameStats() const noexcept
+{
+    return _lastFrameStats;
+}
+
+} // namespace hg::Utils
@@ -12,18 +12,14 @@
 #include <utility>
 #include <chrono>
 #include <optional>
-#include <functional>
 
 namespace hg::Utils {
 
 void timeline2::clear()
 {
     _actions.clear();
-}
-
-void timeline2::append_do(const std::function<void()>& func)
-{
-    _actions.emplace_back(action{action_do{func}});
+    _do_fns.reset();
+    _time_point_fns.reset();
 }
 
 void timeline2::append_wait_for(const duration d)
@@ -46,11 +42,6 @@ void timeline2::append_wait_until(const time_point tp)
     _actions.emplace_back(action{action_wait_until{tp}});
 }
 
-void timeline2::append_wait_until_fn(const std::function<time_point()>& tp_fn)
-{
-    _actions.emplace_back(action{action_wait_until_fn{tp_fn}});
-}
-
 [[nodiscard]] std::size_t timeline2::size() const noexcept
 {
     return _actions.size();
@@ -80,7 +71,7 @@ timeline2_runner::outcome timeline2_runner::update(
             a._inner, //
             [&](const timeline2::action_do& x)
             {
-                x._func();
+                (*x._func)();
                 return outcome::proceed;
             },
             [&](const timeline2::action_wait_for& x)
@@ -115,7 +106,7 @@ timeline2_runner::outcome timeline2_runner::update(
             }, //
             [&](const timeline2::action_wait_until_fn& x)
             {
-                if(tp < x._time_point_fn())
+                if(tp < (*x._time_point_fn)())
                 {
                     // Still waiting.
                     return outcome::waiting;
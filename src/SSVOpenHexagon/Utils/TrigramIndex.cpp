@@ -0,0 +1,303 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/TrigramIndex.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+namespace hg::Utils {
+
+[[nodiscard]] static char normalizeChar(const char c) noexcept
+{
+    if(c >= 'A' && c <= 'Z')
+    {
+        return static_cast<char>(c - 'A' + 'a');
+    }
+
+    if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+        static_cast<unsigned char>(c) >= 128)
+    {
+        return c;
+    }
+
+    return ' ';
+}
+
+[[nodiscard]] static std::uint32_t makeTrigram(
+    const char a, const char b, const char c) noexcept
+{
+    return (std::uint32_t{static_cast<unsigned char>(a)} << 16) |
+           (std::uint32_t{static_cast<unsigned char>(b)} << 8) |
+           std::uint32_t{static_cast<unsigned char>(c)};
+}
+
+// 0 if `word` appears at the start of a word of `field`, 1 if it only appears
+// inside words, 2 if it does not appear.
+[[nodiscard]] static std::uint32_t matchRank(
+    const std::string_view field, const std::string_view word) noexcept
+{
+    std::size_t pos = field.find(word);
+
+    if(pos == std::string_view::npos)
+    {
+        return 2;
+    }
+
+    for(; pos != std::string_view::npos; pos = field.find(word, pos + 1))
+    {
+        if(pos == 0 || field[pos - 1] == ' ')
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+[[nodiscard]] std::string_view TrigramIndex::getField(
+    const std::size_t i) const noexcept
+{
+    return std::string_view{_text}.substr(_fields[i].begin, _fields[i].size);
+}
+
+TrigramIndex::TrigramIndex() : _docFields{0}
+{}
+
+TrigramIndex::DocId TrigramIndex::add(
+    std::initializer_list<std::string_view> fields)
+{
+    const auto id = static_cast<DocId>(size());
+
+    for(const std::string_view field : fields)
+    {
+        const auto begin = static_cast<std::uint32_t>(_text.size());
+
+        std::transform(field.begin(), field.end(), std::back_inserter(_text),
+            &normalizeChar);
+
+        _fields.push_back(
+            Field{begin, static_cast<std::uint32_t>(field.size())});
+    }
+
+    _docFields.push_back(static_cast<std::uint32_t>(_fields.size()));
+    return id;
+}
+
+void TrigramIndex::build()
+{
+    // Documents are visited in order, so each posting list is built sorted.
+    std::unordered_map<Trigram, std::vector<DocId>> postings;
+
+    for(DocId doc = 0; doc < size(); ++doc)
+    {
+        for(std::uint32_t f = _docFields[doc]; f < _docFields[doc + 1]; ++f)
+        {
+            const std::string_view field = getField(f);
+
+            for(std::size_t i = 0; i + 3 <= field.size(); ++i)
+            {
+                // Words of a query never contain separators.
+                if(field[i] == ' ' || field[i + 1] == ' ' ||
+                    field[i + 2] == ' ')
+                {
+                    continue;
+                }
+
+                std::vector<DocId>& docs = postings[makeTrigram(
+                    field[i], field[i + 1], field[i + 2])];
+
+                if(docs.empty() || docs.back() != doc)
+                {
+                    docs.push_back(doc);
+                }
+            }
+        }
+    }
+
+    _trigrams.clear();
+    _postingsBegin.clear();
+    _postings.clear();
+
+    for(const auto& [trigram, docs] : postings)
+    {
+        _trigrams.push_back(trigram);
+    }
+
+    std::sort(_trigrams.begin(), _trigrams.end());
+
+    for(const Trigram trigram : _trigrams)
+    {
+        const std::vector<DocId>& docs = postings[trigram];
+
+        _postingsBegin.push_back(static_cast<std::uint32_t>(_postings.size()));
+        _postings.insert(_postings.end(), docs.begin(), docs.end());
+    }
+
+    _postingsBegin.push_back(static_cast<std::uint32_t>(_postings.size()));
+}
+
+void TrigramIndex::clear()
+{
+    _text.clear();
+    _fields.clear();
+    _docFields.assign(1, 0);
+    _trigrams.clear();
+    _postingsBegin.clear();
+    _postings.clear();
+}
+
+[[nodiscard]] std::size_t TrigramIndex::size() const noexcept
+{
+    return _docFields.size() - 1;
+}
+
+void TrigramIndex::search(const std::string_view query,
+    std::vector<DocId>& out, const std::size_t maxResults) const
+{
+    out.clear();
+
+    std::string normalized(query.size(), ' ');
+    std::transform(
+        query.begin(), query.end(), normalized.begin(), &normalizeChar);
+
+    std::vector<std::string_view> words;
+
+    for(std::size_t i = 0; i < normalized.size();)
+    {
+        const std::size_t end =
+            std::min(normalized.find(' ', i), normalized.size());
+
+        if(end > i)
+        {
+            words.push_back(std::string_view{normalized}.substr(i, end - i));
+        }
+
+        i = end + 1;
+    }
+
+    if(words.empty() || maxResults == 0)
+    {
+        return;
+    }
+
+    // Posting lists of every trigram of the query, intersected shortest
+    // first. Words shorter than a trigram do not narrow the candidates.
+    std::vector<std::pair<const DocId*, const DocId*>> lists;
+
+    for(const std::string_view word : words)
+    {
+        for(std::size_t i = 0; i + 3 <= word.size(); ++i)
+        {
+            const Trigram trigram =
+                makeTrigram(word[i], word[i + 1], word[i + 2]);
+
+            const auto it =
+                std::lower_bound(_trigrams.begin(), _trigrams.end(), trigram);
+
+            if(it == _trigrams.end() || *it != trigram)
+            {
+                return;
+            }
+
+            const auto idx = static_cast<std::size_t>(it - _trigrams.begin());
+
+            lists.emplace_back(_postings.data() + _postingsBegin[idx],
+                _postings.data() + _postingsBegin[idx + 1]);
+        }
+    }
+
+    std::sort(lists.begin(), lists.end(),
+        [](const auto& a, const auto& b)
+        { return a.second - a.first < b.second - b.first; });
+
+    std::vector<DocId> candidates;
+
+    if(lists.empty())
+    {
+        candidates.resize(size());
+        std::iota(candidates.begin(), candidates.end(), DocId{0});
+    }
+    else
+    {
+        candidates.assign(lists.front().first, lists.front().second);
+
+        std::vector<DocId> intersection;
+
+        for(std::size_t i = 1; i < lists.size() && !candidates.empty(); ++i)
+        {
+            intersection.clear();
+
+            std::set_intersection(candidates.begin(), candidates.end(),
+                lists[i].first, lists[i].second,
+                std::back_inserter(intersection));
+
+            candidates.swap(intersection);
+        }
+    }
+
+    // Containing all trigrams of a word does not imply containing the word.
+    std::vector<std::pair<std::uint32_t, DocId>> ranked;
+    std::size_t bestRanked = 0;
+
+    for(const DocId doc : candidates)
+    {
+        std::uint32_t rank = 0;
+        bool matchesAll = true;
+
+        for(const std::string_view word : words)
+        {
+            std::uint32_t wordRank = 2;
+            std::uint32_t f = _docFields[doc];
+
+            for(; f < _docFields[doc + 1]; ++f)
+            {
+                wordRank = matchRank(getField(f), word);
+
+                if(wordRank != 2)
+                {
+                    break;
+                }
+            }
+
+            if(wordRank == 2)
+            {
+                matchesAll = false;
+                break;
+            }
+
+            rank += 2 * (f - _docFields[doc]) + wordRank;
+        }
+
+        if(!matchesAll)
+        {
+            continue;
+        }
+
+        ranked.emplace_back(rank, doc);
+
+        // Candidates are visited in order, so once enough of them have the
+        // best possible rank the remaining ones can not make it.
+        if(rank == 0 && ++bestRanked == maxResults)
+        {
+            break;
+        }
+    }
+
+    const std::size_t count = std::min(maxResults, ranked.size());
+
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end());
+
+    out.reserve(count);
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        out.push_back(ranked[i].second);
+    }
+}
+
+} // namespace hg::Utils
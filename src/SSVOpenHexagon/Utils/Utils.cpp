@@ -7,12 +7,12 @@
 #include "SSVOpenHexagon/Global/Assets.hpp"
 #include "SSVOpenHexagon/Utils/ScopeGuard.hpp"
 #include "SSVOpenHexagon/Utils/Concat.hpp"
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
 #include "SSVOpenHexagon/Data/PackData.hpp"
 
 #include <SSVStart/Camera/Camera.hpp>
 
 #include <SSVUtils/Timeline/Timeline.hpp>
-#include <SSVUtils/Core/Log/Log.hpp>
 
 #include <SFML/System/Vector2.hpp>
 
@@ -30,18 +30,18 @@ void runLuaCode(Lua::LuaContext& mLua, const std::string& mCode)
     }
     catch(std::runtime_error& mError)
     {
-        ssvu::lo("hg::Utils::runLuaCode") << "Fatal Lua error\n"
-                                          << "Code: " << mCode << '\n'
-                                          << "Error: " << mError.what() << '\n'
-                                          << std::endl;
+        scriptLog("hg::Utils::runLuaCode") << "Fatal Lua error\n"
+                                           << "Code: " << mCode << '\n'
+                                           << "Error: " << mError.what() << '\n'
+                                           << std::endl;
 
         throw;
     }
     catch(...)
     {
-        ssvu::lo("hg::Utils::runLuaCode") << "Fatal unknown Lua error\n"
-                                          << "Code: " << mCode << '\n'
-                                          << std::endl;
+        scriptLog("hg::Utils::runLuaCode") << "Fatal unknown Lua error\n"
+                                           << "Code: " << mCode << '\n'
+                                           << std::endl;
 
         throw;
     }
@@ -56,7 +56,7 @@ void runLuaFile(Lua::LuaContext& mLua, const std::string& mFileName)
         const std::string errorStr = concat(
             "Fatal Lua error\n", "Could not open file: ", mFileName, '\n');
 
-        ssvu::lo("hg::Utils::runLuaFile") << errorStr << std::endl;
+        scriptLog("hg::Utils::runLuaFile") << errorStr << std::endl;
         throw std::runtime_error(errorStr);
     }
 
@@ -66,18 +66,18 @@ void runLuaFile(Lua::LuaContext& mLua, const std::string& mFileName)
     }
     catch(std::runtime_error& mError)
     {
-        ssvu::lo("hg::Utils::runLuaFile") << "Fatal Lua error\n"
-                                          << "Filename: " << mFileName << '\n'
-                                          << "Error: " << mError.what() << '\n'
-                                          << std::endl;
+        scriptLog("hg::Utils::runLuaFile") << "Fatal Lua error\n"
+                                           << "Filename: " << mFileName << '\n'
+                                           << "Error: " << mError.what() << '\n'
+                                           << std::endl;
 
         throw;
     }
     catch(...)
     {
-        ssvu::lo("hg::Utils::runLuaFile") << "Fatal unknown Lua error\n"
-                                          << "Filename: " << mFileName << '\n'
-                                          << std::endl;
+        scriptLog("hg::Utils::runLuaFile") << "Fatal unknown Lua error\n"
+                                           << "Filename: " << mFileName << '\n'
+                                           << std::endl;
 
         throw;
     }
@@ -162,7 +162,7 @@ try
 }
 catch(const std::runtime_error& err)
 {
-    ssvu::lo("hg::Utils::withDependencyAssetFilename")
+    scriptLog("hg::Utils::withDependencyAssetFilename")
         << "Fatal error while looking for Lua dependency\nError: " << err.what()
         << std::endl;
 
@@ -170,7 +170,7 @@ catch(const std::runtime_error& err)
 }
 catch(...)
 {
-    ssvu::lo("hg::Utils::withDependencyAssetFilename")
+    scriptLog("hg::Utils::withDependencyAssetFilename")
         << "Fatal unknown error while looking for Lua dependency" << std::endl;
 
     throw;
@@ -0,0 +1,100 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/BinaryCodec.hpp"
+
+#include "TestUtils.hpp"
+
+#include <SFML/Network/Packet.hpp>
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct Fixed
+{
+    sf::Uint8 a;
+    sf::Int32 b;
+    std::array<sf::Uint8, 3> c;
+};
+
+struct Dynamic
+{
+    sf::Uint64 id;
+    std::string name;
+    std::vector<Fixed> fixeds;
+    std::optional<double> value;
+};
+
+static_assert(hg::Binary::fixedSizeOf<Fixed> == 1 + 4 + 3);
+static_assert(hg::Binary::fixedSizeOf<Dynamic> == hg::Binary::dynamicSize);
+
+[[nodiscard]] static bool sameBytes(
+    const std::vector<sf::Uint8>& buffer, const sf::Packet& p)
+{
+    return buffer.size() == p.getDataSize() &&
+           (buffer.empty() ||
+               std::memcmp(buffer.data(), p.getData(), buffer.size()) == 0);
+}
+
+int main()
+{
+    const Dynamic original{.id = 0x0102030405060708,
+        .name = "hello",
+        .fixeds = {Fixed{1, -2, {3, 4, 5}}, Fixed{6, 7, {8, 9, 10}}},
+        .value = 1.5};
+
+    std::vector<sf::Uint8> buffer;
+    hg::Binary::Writer w{buffer};
+    hg::Binary::encode(w, original);
+
+    TEST_ASSERT_EQ(buffer.size(), hg::Binary::encodedSize(original));
+
+    // Same bytes as `sf::Packet`'s own encoding
+    {
+        sf::Packet p;
+        p << original.id << original.name
+          << static_cast<sf::Uint64>(original.fixeds.size());
+
+        for(const Fixed& f : original.fixeds)
+        {
+            p << f.a << f.b << f.c[0] << f.c[1] << f.c[2];
+        }
+
+        p << true << *original.value;
+
+        TEST_ASSERT(sameBytes(buffer, p));
+    }
+
+    // Round trip
+    {
+        Dynamic decoded{};
+        hg::Binary::Reader r{buffer.data(), buffer.size()};
+
+        const bool success = hg::Binary::decode(r, decoded);
+        TEST_ASSERT(success);
+        TEST_ASSERT_EQ(r.getRemaining(), 0);
+
+        TEST_ASSERT_EQ(decoded.id, original.id);
+        TEST_ASSERT_EQ(decoded.name, original.name);
+        TEST_ASSERT_EQ(decoded.fixeds.size(), 2);
+        TEST_ASSERT_EQ(decoded.fixeds[1].b, 7);
+        TEST_ASSERT_EQ(decoded.fixeds[0].b, -2);
+        TEST_ASSERT_EQ(decoded.fixeds[1].c[2], 10);
+        TEST_ASSERT(decoded.value.has_value());
+        TEST_ASSERT_EQ(*decoded.value, 1.5);
+    }
+
+    // Truncated input fails without reading out of bounds
+    for(std::size_t size = 0; size < buffer.size(); ++size)
+    {
+        Dynamic decoded{};
+        hg::Binary::Reader r{buffer.data(), size};
+
+        const bool success = hg::Binary::decode(r, decoded);
+        TEST_ASSERT(!success);
+    }
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Core/LeaderboardCache.hpp"
+
+#include "SSVOpenHexagon/Utils/Timestamp.hpp"
+
+#include "TestUtils.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+static const std::string cachePath = "test_leaderboardCache.json";
+
+static void test_formatting()
+{
+    hg::LeaderboardCache lc;
+    TEST_ASSERT(!lc.hasInformation("lvl"));
+    TEST_ASSERT(lc.shouldRequestScores("lvl"));
+    TEST_ASSERT(lc.shouldPrefetchScores("lvl"));
+
+    lc.receivedScores("lvl", {{0, "alice", 0, 12.5},
+                                 {1, "a_very_long_user_name_indeed", 0, 3.0}});
+
+    TEST_ASSERT(lc.hasInformation("lvl"));
+    TEST_ASSERT(!lc.shouldRequestScores("lvl"));
+    TEST_ASSERT(!lc.shouldPrefetchScores("lvl"));
+
+    const auto& scores = lc.getScores("lvl");
+    TEST_ASSERT_EQ(scores.size(), 2);
+    TEST_ASSERT_EQ(scores[0].position, "#1");
+    TEST_ASSERT_EQ(scores[0].score, "12.5s");
+    TEST_ASSERT_EQ(scores[0].userName, "alice");
+    TEST_ASSERT_EQ(scores[1].position, "#2");
+    TEST_ASSERT_EQ(scores[1].score, "3s");
+    TEST_ASSERT_EQ(scores[1].userName, "a_very_long_user...");
+    TEST_ASSERT(lc.getOwnScore("lvl") == nullptr);
+
+    lc.receivedOwnScore("lvl", {41, "bob", 0, 1.25});
+
+    const auto* own = lc.getOwnScore("lvl");
+    TEST_ASSERT(own != nullptr);
+    TEST_ASSERT_EQ(own->position, "#42");
+    TEST_ASSERT_EQ(own->score, "1.25s");
+    TEST_ASSERT_EQ(own->userName, "bob");
+}
+
+static void test_pages()
+{
+    hg::LeaderboardCache lc;
+    TEST_ASSERT_EQ(lc.getVersion("lvl"), 0);
+
+    // Whole page
+    lc.receivedPage("lvl", 10, 0, 0, 2,
+        {{0, "alice", 0, 12.5}, {1, "bob", 0, 3.0}}, {{1, "bob", 0, 3.0}});
+
+    TEST_ASSERT_EQ(lc.getVersion("lvl"), 10);
+    TEST_ASSERT_EQ(lc.getScores("lvl").size(), 2);
+    TEST_ASSERT_EQ(lc.getScores("lvl")[1].userName, "bob");
+    TEST_ASSERT_EQ(lc.getOwnScore("lvl")->position, "#2");
+
+    // Unchanged, own score is kept
+    lc.receivedPage("lvl", 10, 10, 0, 0, {}, std::nullopt);
+
+    TEST_ASSERT_EQ(lc.getVersion("lvl"), 10);
+    TEST_ASSERT_EQ(lc.getScores("lvl").size(), 2);
+    TEST_ASSERT(lc.getOwnScore("lvl") != nullptr);
+
+    // Only the changed entries
+    lc.receivedPage("lvl", 11, 10, 0, 3,
+        {{1, "carol", 0, 5.0}, {2, "bob", 0, 3.0}}, {{2, "bob", 0, 3.0}});
+
+    TEST_ASSERT_EQ(lc.getVersion("lvl"), 11);
+    TEST_ASSERT_EQ(lc.getScores("lvl").size(), 3);
+    TEST_ASSERT_EQ(lc.getScores("lvl")[0].userName, "alice");
+    TEST_ASSERT_EQ(lc.getScores("lvl")[1].userName, "carol");
+    TEST_ASSERT_EQ(lc.getScores("lvl")[2].userName, "bob");
+    TEST_ASSERT_EQ(lc.getOwnScore("lvl")->position, "#3");
+    TEST_ASSERT(!lc.shouldRequestScores("lvl"));
+
+    // Changes to a version that is not cached, the whole page is requested
+    lc.receivedPage("lvl", 13, 12, 0, 3, {{0, "dave", 0, 20.0}}, std::nullopt);
+
+    TEST_ASSERT_EQ(lc.getVersion("lvl"), 0);
+    TEST_ASSERT_EQ(lc.getScores("lvl")[0].userName, "alice");
+    TEST_ASSERT(lc.shouldRequestScores("lvl"));
+}
+
+static void test_persistence()
+{
+    {
+        hg::LeaderboardCache lc;
+        lc.receivedScores("lvl", {{0, "alice", 1000, 12.5}});
+        lc.receivedOwnScore("lvl", {5, "bob", 2000, 1.25});
+        lc.receivedPage("paged", 42, 0, 0, 1, {{0, "carol", 0, 2.0}}, {});
+
+        // Requested but never received, not saved
+        lc.requestedScores("pending");
+
+        lc.saveToFile(cachePath);
+    }
+
+    hg::LeaderboardCache lc;
+    TEST_ASSERT(lc.loadFromFile(cachePath));
+
+    TEST_ASSERT(!lc.hasInformation("pending"));
+    TEST_ASSERT(lc.hasInformation("lvl"));
+
+    // Loaded scores are shown, but refreshed from the server
+    TEST_ASSERT(lc.shouldRequestScores("lvl"));
+    TEST_ASSERT(lc.shouldPrefetchScores("lvl"));
+
+    const auto& scores = lc.getScores("lvl");
+    TEST_ASSERT_EQ(scores.size(), 1);
+    TEST_ASSERT_EQ(scores[0].position, "#1");
+    TEST_ASSERT_EQ(scores[0].score, "12.5s");
+    TEST_ASSERT_EQ(scores[0].userName, "alice");
+
+    const auto* own = lc.getOwnScore("lvl");
+    TEST_ASSERT(own != nullptr);
+    TEST_ASSERT_EQ(own->position, "#6");
+    TEST_ASSERT_EQ(own->userName, "bob");
+
+    // Versions are kept, so that unchanged pages are not sent again
+    TEST_ASSERT_EQ(lc.getVersion("lvl"), 0);
+    TEST_ASSERT_EQ(lc.getVersion("paged"), 42);
+    TEST_ASSERT_EQ(lc.getScores("paged").size(), 1);
+
+    TEST_ASSERT(!lc.loadFromFile("nonexistent_leaderboardCache.json"));
+}
+
+static void test_expiry()
+{
+    const auto expired = hg::Utils::nowTimestamp() - 60 * 60 * 24 * 8;
+
+    {
+        std::ofstream os{cachePath};
+        os << R"({"levels": {"old": {"received": )" << expired
+           << R"(, "scores": [{"position": 0, "user_name": "alice", )"
+           << R"("timestamp": 0, "value": 1.0}]}}})";
+    }
+
+    hg::LeaderboardCache lc;
+    TEST_ASSERT(lc.loadFromFile(cachePath));
+    TEST_ASSERT(!lc.hasInformation("old"));
+}
+
+int main()
+{
+    test_formatting();
+    test_pages();
+    test_persistence();
+    test_expiry();
+
+    std::remove(cachePath.c_str());
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/LeaderboardDelta.hpp"
+
+#include "TestUtils.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using Scores = std::vector<hg::Database::ProcessedScore>;
+
+[[nodiscard]] static Scores makePage(const std::uint32_t offset,
+    const std::vector<std::string>& names, const double firstValue)
+{
+    Scores result;
+
+    for(std::uint32_t i = 0; i < names.size(); ++i)
+    {
+        result.push_back(hg::Database::ProcessedScore{.position = offset + i,
+            .userName = names[i],
+            .scoreTimestamp = 1000 + i,
+            .scoreValue = firstValue - i});
+    }
+
+    return result;
+}
+
+[[nodiscard]] static bool samePages(const Scores& a, const Scores& b)
+{
+    if(a.size() != b.size())
+    {
+        return false;
+    }
+
+    for(std::size_t i = 0; i < a.size(); ++i)
+    {
+        if(a[i].position != b[i].position || a[i].userName != b[i].userName ||
+            a[i].scoreTimestamp != b[i].scoreTimestamp ||
+            a[i].scoreValue != b[i].scoreValue)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_roundtrip(const std::uint32_t offset, const Scores& oldPage,
+    const Scores& newPage, const std::size_t expectedChanges)
+{
+    const Scores changed = hg::diffScores(oldPage, newPage);
+    TEST_ASSERT_EQ(changed.size(), expectedChanges);
+
+    Scores page = oldPage;
+    TEST_ASSERT(hg::applyScoresDiff(
+        page, offset, static_cast<std::uint32_t>(newPage.size()), changed));
+
+    TEST_ASSERT(samePages(page, newPage));
+}
+
+int main()
+{
+    const Scores a = makePage(0, {"a", "b", "c", "d"}, 100.0);
+
+    // Unchanged
+    test_roundtrip(0, a, a, 0);
+
+    // New best score, everything below shifts down
+    test_roundtrip(0, a, makePage(0, {"e", "a", "b", "c"}, 101.0), 4);
+
+    // Only the last entry changed
+    test_roundtrip(0, a, makePage(0, {"a", "b", "c", "e"}, 100.0), 1);
+
+    // Page grows and shrinks
+    test_roundtrip(0, makePage(0, {"a", "b"}, 100.0), a, 2);
+    test_roundtrip(0, a, makePage(0, {"a", "b"}, 100.0), 0);
+
+    // From and to an empty page
+    test_roundtrip(0, {}, a, 4);
+    test_roundtrip(0, a, {}, 0);
+
+    // Pages that do not start at the top
+    test_roundtrip(
+        20, makePage(20, {"x", "y"}, 50.0), makePage(20, {"x", "z"}, 50.0), 1);
+
+    // Changes outside of the page are rejected
+    {
+        Scores page = makePage(20, {"x", "y"}, 50.0);
+        TEST_ASSERT(!hg::applyScoresDiff(page, 20, 2, makePage(19, {"w"}, 51)));
+
+        page = makePage(20, {"x", "y"}, 50.0);
+        TEST_ASSERT(!hg::applyScoresDiff(page, 20, 2, makePage(22, {"w"}, 51)));
+    }
+}
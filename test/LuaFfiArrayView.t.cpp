@@ -0,0 +1,87 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+
+#include "TestUtils.hpp"
+
+#include <string>
+#include <vector>
+
+#ifdef SSVOH_ENABLE_LUAJIT_FFI
+
+[[nodiscard]] static bool fails(Lua::LuaContext& lua, const std::string& code)
+{
+    try
+    {
+        lua.executeCode(code);
+    }
+    catch(const Lua::LuaContext::ExecutionErrorException&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+int main()
+{
+    std::vector<double> data(8, 0.0);
+    data[0] = 1.5;
+
+    Lua::LuaContext lua;
+    lua.writeFfiArrayView("view", data.data(), data.size());
+
+    // Reads and writes go straight to the buffer
+    {
+        lua.executeCode(R"(
+first = view[1]
+for i = 2, 8 do view[i] = i * 10 end
+)");
+
+        TEST_ASSERT_EQ(lua.readVariable<double>("first"), 1.5);
+        TEST_ASSERT_EQ(data[1], 20.0);
+        TEST_ASSERT_EQ(data[7], 80.0);
+
+        data[3] = -4.0;
+        lua.executeCode("fourth = view[4]");
+        TEST_ASSERT_EQ(lua.readVariable<double>("fourth"), -4.0);
+    }
+
+    // Accesses are bounds-checked
+    {
+        TEST_ASSERT(fails(lua, "local x = view[0]"));
+        TEST_ASSERT(fails(lua, "local x = view[9]"));
+        TEST_ASSERT(fails(lua, "view[9] = 1"));
+        TEST_ASSERT(fails(lua, "view[1.5] = 1"));
+        TEST_ASSERT(fails(lua, "view.x = 1"));
+        TEST_ASSERT(fails(lua, "view[1] = 'a'"));
+        TEST_ASSERT_EQ(data[0], 1.5);
+    }
+
+    // The view cannot be used to reach the FFI library
+    {
+        TEST_ASSERT(fails(lua, "local x = getmetatable(view).__index"));
+        TEST_ASSERT(fails(lua, "setmetatable(view, nil)"));
+
+        lua.executeCode("loaded = package.loaded.ffi == nil");
+        TEST_ASSERT(lua.readVariable<bool>("loaded"));
+    }
+
+    // Multiple views share the same FFI module
+    {
+        std::vector<double> other(2, 7.0);
+        lua.writeFfiArrayView("other", other.data(), other.size());
+
+        lua.executeCode("other[2] = view[2]");
+        TEST_ASSERT_EQ(other[1], 20.0);
+    }
+}
+
+#else
+
+int main()
+{}
+
+#endif
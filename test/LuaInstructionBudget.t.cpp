@@ -0,0 +1,127 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Data/LevelData.hpp"
+#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+
+#include "TestUtils.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+using Budget = Lua::LuaContext::InstructionBudget;
+using BudgetExceeded = Lua::LuaContext::InstructionBudgetExceededException;
+
+[[nodiscard]] static bool callThrowsBudgetExceeded(
+    Lua::LuaContext& lua, const char* fnName)
+{
+    try
+    {
+        lua.callLuaFunction<void>(fnName);
+    }
+    catch(const BudgetExceeded&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+[[nodiscard]] static std::uint64_t countInstructions(const char* code)
+{
+    Lua::LuaContext lua;
+    lua.setInstructionBudget(Budget{});
+    lua.executeCode(code);
+    lua.callLuaFunction<void>("f");
+
+    return lua.getExecutedInstructions();
+}
+
+int main()
+{
+    // Infinite loops are aborted
+    {
+        Lua::LuaContext lua;
+        lua.setInstructionBudget(Budget{.perCall = 100'000});
+        lua.executeCode("function spin() while true do end end");
+
+        TEST_ASSERT(callThrowsBudgetExceeded(lua, "spin"));
+        TEST_ASSERT(lua.isInstructionBudgetExceeded());
+    }
+
+    // Catching the error in Lua does not keep the script running
+    {
+        Lua::LuaContext lua;
+        lua.setInstructionBudget(Budget{.perCall = 100'000});
+        lua.executeCode(R"(
+function spin()
+    while true do
+        pcall(function() while true do end end)
+    end
+end
+)");
+
+        TEST_ASSERT(callThrowsBudgetExceeded(lua, "spin"));
+    }
+
+    // The per-call budget is reset for every call, the total one is not
+    {
+        Lua::LuaContext lua;
+        lua.setInstructionBudget(
+            Budget{.perCall = 100'000, .total = 1'000'000});
+        lua.executeCode("function work() local x = 0 "
+                        "for i = 1, 5000 do x = x + i end end");
+
+        int calls = 0;
+        while(!callThrowsBudgetExceeded(lua, "work"))
+        {
+            ++calls;
+            TEST_ASSERT(calls < 1000);
+        }
+
+        TEST_ASSERT(calls > 1);
+        TEST_ASSERT(lua.getExecutedInstructions() > 900'000);
+    }
+
+    // A level spinning in `onUpdate` is stopped by the default budget, long
+    // before any processing time limit would matter
+    {
+        Lua::LuaContext lua;
+        lua.setInstructionBudget(
+            Budget{.perCall = hg::LevelData::defaultLuaInstructionBudgetPerCall,
+                .total = hg::LevelData::defaultLuaInstructionBudgetTotal});
+        lua.executeCode(R"(
+ticks = 0
+function onUpdate(dt)
+    ticks = ticks + 1
+    if ticks == 100 then while true do end end
+end
+)");
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        int ticks = 0;
+        while(!callThrowsBudgetExceeded(lua, "onUpdate"))
+        {
+            ++ticks;
+            TEST_ASSERT(ticks < 100);
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+        TEST_ASSERT_EQ(ticks, 99);
+        TEST_ASSERT(lua.isInstructionBudgetExceeded());
+        TEST_ASSERT(elapsed < std::chrono::seconds{5});
+    }
+
+    // Counting is deterministic
+    {
+        const char* code = "function f() local t = {} "
+                           "for i = 1, 20000 do t[i] = i * 2 end end";
+
+        const std::uint64_t first = countInstructions(code);
+        TEST_ASSERT(first > 0);
+        TEST_ASSERT_EQ(countInstructions(code), first);
+    }
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LuaPoolAllocator.hpp"
+#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+
+#include "TestUtils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using hg::Utils::LuaPoolAllocator;
+
+[[nodiscard]] static bool isFilledWith(
+    const void* ptr, const std::size_t size, const unsigned char value)
+{
+    const auto* bytes = static_cast<const unsigned char*>(ptr);
+
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        if(bytes[i] != value)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void runLevelScript(const std::shared_ptr<LuaPoolAllocator>& allocator)
+{
+    Lua::LuaContext lua{allocator};
+    lua.executeCode(R"(
+local t = {}
+for i = 1, 5000 do
+    t[i] = { x = i, name = "wall" .. i, f = function() return i end }
+end
+result = #t
+)");
+
+    TEST_ASSERT_EQ(lua.readVariable<int>("result"), 5000);
+}
+
+int main()
+{
+    // Blocks are aligned, preserved on growth and tracked in the stats
+    {
+        LuaPoolAllocator a;
+
+        void* small = a.reallocate(nullptr, 0, 24);
+        TEST_ASSERT(small != nullptr);
+        TEST_ASSERT_EQ(reinterpret_cast<std::uintptr_t>(small) %
+                           LuaPoolAllocator::granularity,
+            0);
+
+        std::memset(small, 0xAB, 24);
+        TEST_ASSERT_EQ(a.getStats().bytesInUse, 24);
+
+        // Same size class, no move
+        void* grown = a.reallocate(small, 24, 30);
+        TEST_ASSERT(grown == small);
+
+        // Across size classes and into the large allocation path
+        void* medium = a.reallocate(small, 30, 200);
+        TEST_ASSERT(medium != nullptr);
+        TEST_ASSERT(isFilledWith(medium, 24, 0xAB));
+
+        std::memset(medium, 0xCD, 200);
+
+        void* large = a.reallocate(medium, 200, 4096);
+        TEST_ASSERT(large != nullptr);
+        TEST_ASSERT(isFilledWith(large, 200, 0xCD));
+        TEST_ASSERT_EQ(a.getStats().bytesInUse, 4096);
+
+        void* shrunk = a.reallocate(large, 4096, 16);
+        TEST_ASSERT(shrunk != nullptr);
+        TEST_ASSERT(isFilledWith(shrunk, 16, 0xCD));
+
+        void* freed = a.reallocate(shrunk, 16, 0);
+        TEST_ASSERT(freed == nullptr);
+
+        const LuaPoolAllocator::Stats& stats = a.getStats();
+        TEST_ASSERT_EQ(stats.bytesInUse, 0);
+        TEST_ASSERT_EQ(stats.peakBytesInUse, 4096);
+        TEST_ASSERT_EQ(stats.allocations, 1);
+        TEST_ASSERT_EQ(stats.pooledAllocations, 1);
+    }
+
+    // Freed blocks are reused by later allocations of the same size class
+    {
+        LuaPoolAllocator a;
+
+        std::vector<void*> blocks;
+        for(int i = 0; i < 10000; ++i)
+        {
+            blocks.push_back(a.reallocate(nullptr, 0, 48));
+            TEST_ASSERT(blocks.back() != nullptr);
+        }
+
+        const std::size_t reserved = a.getStats().bytesReserved;
+        TEST_ASSERT(reserved >= 10000 * 48);
+
+        for(void* p : blocks)
+        {
+            static_cast<void>(a.reallocate(p, 48, 0));
+        }
+
+        for(void*& p : blocks)
+        {
+            p = a.reallocate(nullptr, 0, 40);
+            TEST_ASSERT(p != nullptr);
+        }
+
+        TEST_ASSERT_EQ(a.getStats().bytesReserved, reserved);
+
+        for(void* p : blocks)
+        {
+            static_cast<void>(a.reallocate(p, 40, 0));
+        }
+
+        TEST_ASSERT_EQ(a.getStats().bytesInUse, 0);
+    }
+
+    // Per-tick allocation counts
+    {
+        LuaPoolAllocator a;
+
+        void* p0 = a.reallocate(nullptr, 0, 8);
+        void* p1 = a.reallocate(nullptr, 0, 1024);
+        a.markTick();
+        TEST_ASSERT_EQ(a.getStats().lastTickAllocations, 2);
+
+        a.markTick();
+        TEST_ASSERT_EQ(a.getStats().lastTickAllocations, 0);
+
+        static_cast<void>(a.reallocate(p0, 8, 0));
+        static_cast<void>(a.reallocate(p1, 1024, 0));
+    }
+
+    // Contexts sharing an allocator reuse the memory of closed ones
+    {
+        const auto allocator = std::make_shared<LuaPoolAllocator>();
+
+        runLevelScript(allocator);
+        TEST_ASSERT_EQ(allocator->getStats().bytesInUse, 0);
+
+        const std::size_t reserved = allocator->getStats().bytesReserved;
+        TEST_ASSERT(reserved > 0);
+
+        runLevelScript(allocator);
+        TEST_ASSERT_EQ(allocator->getStats().bytesInUse, 0);
+        TEST_ASSERT_EQ(allocator->getStats().bytesReserved, reserved);
+    }
+
+    // Trimming keeps only the requested chunks, which are used again first
+    {
+        const auto allocator = std::make_shared<LuaPoolAllocator>();
+
+        runLevelScript(allocator);
+        TEST_ASSERT(allocator->getStats().bytesReserved >
+                    4 * LuaPoolAllocator::chunkSize);
+
+        allocator->trim(2 * LuaPoolAllocator::chunkSize - 1);
+        TEST_ASSERT_EQ(allocator->getStats().bytesReserved,
+            2 * LuaPoolAllocator::chunkSize);
+
+        void* p = allocator->reallocate(nullptr, 0, 64);
+        TEST_ASSERT(p != nullptr);
+        TEST_ASSERT_EQ(allocator->getStats().bytesReserved,
+            2 * LuaPoolAllocator::chunkSize);
+        static_cast<void>(allocator->reallocate(p, 64, 0));
+
+        runLevelScript(allocator);
+        TEST_ASSERT_EQ(allocator->getStats().bytesInUse, 0);
+
+        allocator->trim(0);
+        TEST_ASSERT_EQ(allocator->getStats().bytesReserved, 0);
+
+        runLevelScript(allocator);
+        TEST_ASSERT_EQ(allocator->getStats().bytesInUse, 0);
+    }
+
+    // Default-constructed contexts own their allocator
+    {
+        Lua::LuaContext lua;
+        lua.executeCode("t = {} for i = 1, 100 do t[i] = {} end");
+
+        TEST_ASSERT(lua.getAllocator().getStats().bytesInUse > 0);
+        TEST_ASSERT(lua.getAllocator().getStats().pooledAllocations > 100);
+    }
+}
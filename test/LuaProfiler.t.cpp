@@ -0,0 +1,165 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LuaProfiler.hpp"
+#include "SSVOpenHexagon/Utils/LuaWrapper.hpp"
+
+#include "TestUtils.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using hg::Utils::LuaProfiler;
+
+[[nodiscard]] static const LuaProfiler::Entry* findEntry(
+    const std::vector<LuaProfiler::Entry>& entries,
+    const std::string_view name)
+{
+    for(const LuaProfiler::Entry& e : entries)
+    {
+        if(e.name == name)
+        {
+            return &e;
+        }
+    }
+
+    return nullptr;
+}
+
+[[nodiscard]] static std::string readFile(const char* path)
+{
+    std::ifstream ifs{path};
+    return std::string{std::istreambuf_iterator<char>{ifs}, {}};
+}
+
+static void callProfiled(
+    Lua::LuaContext& lua, LuaProfiler& profiler, const std::string& name)
+{
+    const LuaProfiler::Scope scope{
+        &profiler, profiler.getIndex(name, LuaProfiler::Kind::Callback)};
+
+    lua.callLuaFunction<void>(name);
+}
+
+int main()
+{
+    LuaProfiler profiler;
+
+    Lua::LuaContext lua;
+    lua.setProfiler(&profiler);
+
+    int counter = 0;
+    int steps = 0;
+
+    lua.writeVariable("l_add",
+        hg::Utils::makeProfiledLuaFn(lua.getProfiler(), "l_add",
+            [&counter](int x) -> int { return counter += x; }));
+
+    lua.writeVariable("l_next",
+        hg::Utils::makeProfiledLuaFn(lua.getProfiler(), "l_next",
+            [&steps] { return ++steps; }));
+
+    lua.executeCode(R"(
+function onUpdate()
+    for i = 1, 10 do l_add(1) end
+end
+
+function onStep()
+    l_next()
+end
+)");
+
+    // Nothing is recorded while disabled
+    {
+        callProfiled(lua, profiler, "onUpdate");
+
+        TEST_ASSERT_EQ(counter, 10);
+        TEST_ASSERT(profiler.getSortedEntries().empty());
+    }
+
+    // Callbacks and bindings are counted, nested time is excluded from self
+    {
+        profiler.setEnabled(true);
+
+        callProfiled(lua, profiler, "onUpdate");
+        callProfiled(lua, profiler, "onUpdate");
+        callProfiled(lua, profiler, "onStep");
+
+        TEST_ASSERT_EQ(counter, 30);
+
+        const std::vector<LuaProfiler::Entry> entries =
+            profiler.getSortedEntries();
+
+        TEST_ASSERT_EQ(entries.size(), 4);
+
+        const LuaProfiler::Entry* onUpdate = findEntry(entries, "onUpdate");
+        TEST_ASSERT(onUpdate != nullptr);
+        TEST_ASSERT(onUpdate->kind == LuaProfiler::Kind::Callback);
+        TEST_ASSERT_EQ(onUpdate->calls, 2);
+
+        const LuaProfiler::Entry* add = findEntry(entries, "l_add");
+        TEST_ASSERT(add != nullptr);
+        TEST_ASSERT(add->kind == LuaProfiler::Kind::Binding);
+        TEST_ASSERT_EQ(add->calls, 20);
+        TEST_ASSERT_EQ(add->selfNs, add->totalNs);
+
+        TEST_ASSERT(onUpdate->totalNs >= add->totalNs);
+        TEST_ASSERT_EQ(onUpdate->selfNs, onUpdate->totalNs - add->totalNs);
+
+        const LuaProfiler::Entry* next = findEntry(entries, "l_next");
+        TEST_ASSERT(next != nullptr);
+        TEST_ASSERT_EQ(next->calls, 1);
+
+        for(std::size_t i = 1; i < entries.size(); ++i)
+        {
+            TEST_ASSERT(entries[i - 1].selfNs >= entries[i].selfNs);
+        }
+    }
+
+    // Dumped as CSV
+    {
+        const char* path = "LuaProfiler.t.csv";
+
+        TEST_ASSERT(profiler.dumpToFile(path));
+
+        const std::string csv = readFile(path);
+        TEST_ASSERT(csv.starts_with("name,kind,calls,"));
+        TEST_ASSERT(csv.find("\nl_add,binding,20,") != std::string::npos);
+        TEST_ASSERT(csv.find("\nonUpdate,callback,2,") != std::string::npos);
+
+        std::remove(path);
+    }
+
+    // Reset keeps registered indices valid
+    {
+        profiler.reset();
+        TEST_ASSERT(profiler.getSortedEntries().empty());
+
+        callProfiled(lua, profiler, "onStep");
+
+        const std::vector<LuaProfiler::Entry> entries =
+            profiler.getSortedEntries();
+
+        TEST_ASSERT_EQ(entries.size(), 2);
+        TEST_ASSERT(findEntry(entries, "l_next") != nullptr);
+        TEST_ASSERT_EQ(findEntry(entries, "l_next")->calls, 1);
+    }
+
+    // Functions registered without a profiler are still callable
+    {
+        Lua::LuaContext plainLua;
+
+        plainLua.writeVariable("l_twice",
+            hg::Utils::makeProfiledLuaFn(plainLua.getProfiler(), "l_twice",
+                [](int x) { return x * 2; }));
+
+        plainLua.executeCode("result = l_twice(21)");
+        TEST_ASSERT_EQ(plainLua.readVariable<int>("result"), 42);
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Online/PacketFraming.hpp"
+
+#include "TestUtils.hpp"
+
+#include <SFML/Network/Packet.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using ExtractResult = hg::IncomingFrameBuffer::ExtractResult;
+
+[[nodiscard]] static std::vector<char> makeFrame(const std::string& payload)
+{
+    const auto size = static_cast<std::uint32_t>(payload.size());
+
+    std::vector<char> result{static_cast<char>((size >> 24) & 0xFF),
+        static_cast<char>((size >> 16) & 0xFF),
+        static_cast<char>((size >> 8) & 0xFF), static_cast<char>(size & 0xFF)};
+
+    result.insert(result.end(), payload.begin(), payload.end());
+    return result;
+}
+
+[[nodiscard]] static std::string toString(const sf::Packet& p)
+{
+    if(p.getDataSize() == 0)
+    {
+        return {};
+    }
+
+    return std::string(static_cast<const char*>(p.getData()), p.getDataSize());
+}
+
+// `TEST_ASSERT` evaluates its argument twice, so extraction happens outside.
+static void expectNoPacket(hg::IncomingFrameBuffer& buffer, sf::Packet& p)
+{
+    const ExtractResult result = buffer.extract(p);
+    TEST_ASSERT(result == ExtractResult::NoPacket);
+}
+
+static void expectPacket(hg::IncomingFrameBuffer& buffer, sf::Packet& p,
+    const std::string& expected)
+{
+    const ExtractResult result = buffer.extract(p);
+    TEST_ASSERT(result == ExtractResult::Packet);
+    TEST_ASSERT_EQ(toString(p), expected);
+}
+
+int main()
+{
+    sf::Packet p;
+
+    // Frame received one byte at a time
+    {
+        hg::IncomingFrameBuffer buffer{1024};
+        const std::vector<char> frame = makeFrame("hello");
+
+        for(std::size_t i = 0; i < frame.size() - 1; ++i)
+        {
+            buffer.append(&frame[i], 1);
+            expectNoPacket(buffer, p);
+        }
+
+        buffer.append(&frame.back(), 1);
+        expectPacket(buffer, p, "hello");
+        TEST_ASSERT_EQ(buffer.getBufferedBytes(), 0);
+        expectNoPacket(buffer, p);
+    }
+
+    // Multiple frames and a partial one in a single chunk
+    {
+        hg::IncomingFrameBuffer buffer{1024};
+
+        std::vector<char> data = makeFrame("a");
+        const std::vector<char> second = makeFrame("");
+        const std::vector<char> third = makeFrame("third");
+
+        data.insert(data.end(), second.begin(), second.end());
+        data.insert(data.end(), third.begin(), third.end() - 2);
+
+        buffer.append(data.data(), data.size());
+
+        expectPacket(buffer, p, "a");
+        expectPacket(buffer, p, "");
+        expectNoPacket(buffer, p);
+        TEST_ASSERT_EQ(buffer.getBufferedBytes(), third.size() - 2);
+
+        buffer.append(third.data() + third.size() - 2, 2);
+        expectPacket(buffer, p, "third");
+    }
+
+    // Oversized frames are rejected from the header alone
+    {
+        hg::IncomingFrameBuffer buffer{4};
+        const std::vector<char> frame = makeFrame("too long");
+
+        buffer.append(frame.data(), 4);
+        const ExtractResult result = buffer.extract(p);
+        TEST_ASSERT(result == ExtractResult::Oversized);
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/ParticlePool.hpp"
+#include "SSVOpenHexagon/Utils/FastVertexVector.hpp"
+
+#include "TestUtils.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+using hg::Utils::ParticlePool;
+using hg::Utils::ParticleSpawnData;
+
+[[nodiscard]] static ParticleSpawnData makeParticle(
+    const float x, const float alpha)
+{
+    return ParticleSpawnData{.position{x, 0.f},
+        .velocity{1.f, 2.f},
+        .angle{0.f},
+        .angularVelocity{90.f},
+        .scale{1.f},
+        .alpha{alpha},
+        .color{sf::Color::White}};
+}
+
+int main()
+{
+    // Capacity is fixed
+    {
+        ParticlePool pool{2};
+
+        const bool s0 = pool.spawn(makeParticle(0.f, 10.f));
+        const bool s1 = pool.spawn(makeParticle(1.f, 10.f));
+        const bool s2 = pool.spawn(makeParticle(2.f, 10.f));
+
+        TEST_ASSERT(s0);
+        TEST_ASSERT(s1);
+        TEST_ASSERT(!s2);
+        TEST_ASSERT_EQ(pool.size(), 2);
+
+        pool.clear();
+        TEST_ASSERT(pool.empty());
+    }
+
+    // Fading and erasure preserve the order of the survivors
+    {
+        ParticlePool pool{8};
+
+        for(int i = 0; i < 6; ++i)
+        {
+            pool.spawn(makeParticle(static_cast<float>(i), i % 2 ? 4.5f : 9.f));
+        }
+
+        pool.fade(1.f);
+        pool.eraseFaded(3.f);
+        TEST_ASSERT_EQ(pool.size(), 3);
+
+        hg::Utils::FastVertexVectorTris tris;
+        pool.appendQuads(tris, {2.f, 2.f}, {0.f, 0.f},
+            ParticlePool::Rotation::Disabled);
+
+        TEST_ASSERT_EQ(tris.size(), 3 * 6);
+        TEST_ASSERT_EQ(tris[0].position.x, 0.f);
+        TEST_ASSERT_EQ(tris[6].position.x, 2.f);
+        TEST_ASSERT_EQ(tris[12].position.x, 4.f);
+        TEST_ASSERT_EQ(tris[0].color.a, 8);
+    }
+
+    // Integration, scaling, rotation and bounds
+    {
+        ParticlePool pool{4};
+        pool.spawn(makeParticle(0.f, 255.f));
+        pool.spawn(makeParticle(100.f, 255.f));
+
+        pool.integrate(2.f);
+        pool.multiplyScale(0.5f);
+        pool.eraseOutside({-10.f, -10.f}, {10.f, 10.f});
+        TEST_ASSERT_EQ(pool.size(), 1);
+
+        hg::Utils::FastVertexVectorTris tris;
+        pool.appendQuads(
+            tris, {4.f, 4.f}, {2.f, 2.f}, ParticlePool::Rotation::Enabled);
+
+        // Rotated by 180 degrees around (2, 4), scaled by 0.5
+        TEST_ASSERT_EQ(tris.size(), 6);
+        TEST_ASSERT(tris[0].position.x > 2.99f && tris[0].position.x < 3.01f);
+        TEST_ASSERT(tris[0].position.y > 4.99f && tris[0].position.y < 5.01f);
+        TEST_ASSERT_EQ(tris[2].texCoords.x, 4.f);
+        TEST_ASSERT_EQ(tris[2].texCoords.y, 4.f);
+    }
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Core/ProfileJournal.hpp"
+
+#include "SSVOpenHexagon/Data/ProfileData.hpp"
+
+#include "TestUtils.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+static const std::string journalPath = "test_profile.journal";
+static const std::string snapshotPath = "test_profile.snapshot";
+
+[[nodiscard]] static hg::ProfileData makeProfile()
+{
+    return hg::ProfileData{{2, 0, 0}, "test", {{"a", 1.f}}, {"fav"}};
+}
+
+static void test_appendAndReplay()
+{
+    {
+        hg::ProfileJournal pj;
+        TEST_ASSERT_EQ(pj.getEntriesSinceCompaction(journalPath), 0);
+
+        pj.appendScore(journalPath, "a", 12.345678f);
+        pj.appendScore(journalPath, "level with spaces", 0.1f);
+        pj.appendFavorite(journalPath, "fav", false);
+        pj.appendFavorite(journalPath, "b", true);
+
+        TEST_ASSERT_EQ(pj.getEntriesSinceCompaction(journalPath), 4);
+    }
+
+    hg::ProfileJournal pj;
+    hg::ProfileData pd = makeProfile();
+    TEST_ASSERT_EQ(pj.replay(journalPath, pd), 4);
+    TEST_ASSERT_EQ(pj.getEntriesSinceCompaction(journalPath), 4);
+
+    // Scores read back exactly.
+    TEST_ASSERT_EQ(pd.getScore("a"), 12.345678f);
+    TEST_ASSERT_EQ(pd.getScore("level with spaces"), 0.1f);
+    TEST_ASSERT(!pd.isLevelFavorite("fav"));
+    TEST_ASSERT(pd.isLevelFavorite("b"));
+}
+
+static void test_tornAndInvalidLines()
+{
+    {
+        std::ofstream os{journalPath, std::ios::trunc};
+        os << "s 2 a\n"
+           << "x 1 b\n"
+           << "s nope c\n"
+           << "s 3\n"
+           << "f\n"
+           << "s 4 d"; // cut short by a crash
+    }
+
+    hg::ProfileJournal pj;
+    hg::ProfileData pd = makeProfile();
+    TEST_ASSERT_EQ(pj.replay(journalPath, pd), 1);
+
+    TEST_ASSERT_EQ(pd.getScore("a"), 2.f);
+    TEST_ASSERT_EQ(pd.getScores().size(), 1);
+}
+
+static void test_compaction()
+{
+    hg::ProfileJournal pj;
+    std::remove(journalPath.c_str());
+
+    pj.appendScore(journalPath, "a", 5.f);
+
+    int snapshots = 0;
+    pj.compact(journalPath, snapshotPath,
+        [&snapshots](std::ostream& os)
+        {
+            ++snapshots;
+            os << "snapshot";
+        });
+
+    TEST_ASSERT_EQ(pj.getEntriesSinceCompaction(journalPath), 0);
+
+    // Appended after the snapshot, so kept in the journal.
+    pj.appendFavorite(journalPath, "b", true);
+    pj.flush();
+
+    TEST_ASSERT_EQ(snapshots, 1);
+    TEST_ASSERT_EQ(pj.getFailedCompactionCount(), 0);
+
+    std::string snapshot;
+    std::ifstream{snapshotPath} >> snapshot;
+    TEST_ASSERT_EQ(snapshot, "snapshot");
+
+    // Written next to the snapshot, then renamed over it.
+    TEST_ASSERT(!std::ifstream{snapshotPath + ".tmp"}.good());
+
+    hg::ProfileData pd = makeProfile();
+    TEST_ASSERT_EQ(pj.replay(journalPath, pd), 1);
+    TEST_ASSERT_EQ(pd.getScore("a"), 1.f);
+    TEST_ASSERT(pd.isLevelFavorite("b"));
+
+    // Replaying an empty or missing journal changes nothing.
+    pj.compact(journalPath, snapshotPath, [](std::ostream&) {});
+    pj.flush();
+
+    TEST_ASSERT_EQ(pj.replay(journalPath, pd), 0);
+    TEST_ASSERT_EQ(pj.replay("nonexistent.journal", pd), 0);
+}
+
+static void test_failedCompaction()
+{
+    hg::ProfileJournal pj;
+    std::remove(journalPath.c_str());
+
+    pj.appendScore(journalPath, "a", 5.f);
+    pj.compact(journalPath, "nonexistent_directory/test_profile.snapshot",
+        [](std::ostream& os) { os << "snapshot"; });
+    pj.flush();
+
+    TEST_ASSERT_EQ(pj.getFailedCompactionCount(), 1);
+
+    // The snapshot was not written, so the journal is kept.
+    hg::ProfileData pd = makeProfile();
+    TEST_ASSERT_EQ(pj.replay(journalPath, pd), 1);
+    TEST_ASSERT_EQ(pd.getScore("a"), 5.f);
+}
+
+static void test_remove()
+{
+    hg::ProfileJournal pj;
+
+    pj.appendScore(journalPath, "a", 5.f);
+    pj.compact(journalPath, snapshotPath,
+        [](std::ostream& os) { os << "snapshot"; });
+    pj.flush();
+
+    // Queued writes of the removed profile must not recreate its files.
+    pj.appendScore(journalPath, "a", 6.f);
+    pj.compact(journalPath, snapshotPath,
+        [](std::ostream& os) { os << "snapshot"; });
+
+    TEST_ASSERT(pj.remove(journalPath, snapshotPath));
+    pj.flush();
+
+    TEST_ASSERT(!std::ifstream{journalPath}.good());
+    TEST_ASSERT(!std::ifstream{snapshotPath}.good());
+    TEST_ASSERT_EQ(pj.getEntriesSinceCompaction(journalPath), 0);
+
+    // Nothing left to delete.
+    TEST_ASSERT(!pj.remove(journalPath, snapshotPath));
+}
+
+int main()
+{
+    test_appendAndReplay();
+    test_tornAndInvalidLines();
+    test_compaction();
+    test_failedCompaction();
+    test_remove();
+
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+}
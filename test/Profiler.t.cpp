@@ -0,0 +1,103 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Global/Profiler.hpp"
+
+#include "TestUtils.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+[[nodiscard]] static const hg::Profiler::ZoneStats* findZone(
+    const std::vector<hg::Profiler::ZoneStats>& stats,
+    const std::string_view name)
+{
+    for(const hg::Profiler::ZoneStats& zs : stats)
+    {
+        if(zs.name == name)
+        {
+            return &zs;
+        }
+    }
+
+    return nullptr;
+}
+
+[[nodiscard]] static std::string readFile(const char* path)
+{
+    std::ifstream ifs{path};
+    return std::string{std::istreambuf_iterator<char>{ifs}, {}};
+}
+
+int main()
+{
+    const char* tracePath = "Profiler.t.json";
+
+    const bool started = hg::Profiler::startTrace(tracePath);
+    TEST_ASSERT(started);
+    TEST_ASSERT(hg::Profiler::isTracing());
+
+    // Zones from multiple threads are aggregated per frame
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            const hg::Profiler::ScopedZone zone{"test\"zone"};
+        }
+
+        std::thread t{[] { const hg::Profiler::ScopedZone zone{"worker"}; }};
+        t.join();
+
+        hg::Profiler::markFrame();
+
+        const std::vector<hg::Profiler::ZoneStats> stats =
+            hg::Profiler::getZoneStats();
+
+        const hg::Profiler::ZoneStats* zs = findZone(stats, "test\"zone");
+        TEST_ASSERT(zs != nullptr);
+        TEST_ASSERT_EQ(zs->lastCalls, 3);
+        TEST_ASSERT(zs->lastMs >= 0.0);
+
+        const hg::Profiler::ZoneStats* worker = findZone(stats, "worker");
+        TEST_ASSERT(worker != nullptr);
+        TEST_ASSERT_EQ(worker->lastCalls, 1);
+    }
+
+    // Zones not entered during a frame report zero calls
+    {
+        hg::Profiler::markFrame();
+
+        const std::vector<hg::Profiler::ZoneStats> stats =
+            hg::Profiler::getZoneStats();
+
+        const hg::Profiler::ZoneStats* zs = findZone(stats, "test\"zone");
+        TEST_ASSERT(zs != nullptr);
+        TEST_ASSERT_EQ(zs->lastCalls, 0);
+        TEST_ASSERT_EQ(zs->lastMs, 0.0);
+    }
+
+    // Zones after the last frame are flushed when the trace stops
+    {
+        {
+            const hg::Profiler::ScopedZone zone{"tail"};
+        }
+
+        hg::Profiler::stopTrace();
+        TEST_ASSERT(!hg::Profiler::isTracing());
+
+        const std::string json = readFile(tracePath);
+        TEST_ASSERT(json.starts_with(R"({"traceEvents":[)"));
+        TEST_ASSERT(json.ends_with("]}\n"));
+        TEST_ASSERT(json.find(R"("name":"test\"zone","ph":"X")") !=
+                    std::string::npos);
+        TEST_ASSERT(json.find(R"("name":"worker")") != std::string::npos);
+        TEST_ASSERT(json.find(R"("name":"tail")") != std::string::npos);
+    }
+
+    std::remove(tracePath);
+}
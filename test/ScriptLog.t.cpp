@@ -0,0 +1,54 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/ScriptLog.hpp"
+
+#include "TestUtils.hpp"
+
+#include <string>
+#include <thread>
+
+static void test_capture()
+{
+    std::string buffer;
+
+    {
+        hg::Utils::ScriptLogCapture capture{buffer};
+        hg::Utils::scriptLog("a") << "x " << 1 << '\n';
+
+        {
+            std::string inner;
+            hg::Utils::ScriptLogCapture innerCapture{inner};
+            hg::Utils::scriptLog("b") << "y\n";
+
+            TEST_ASSERT_EQ(inner, "[b] y\n");
+        }
+
+        hg::Utils::scriptLog("c") << "z" << std::endl;
+    }
+
+    TEST_ASSERT_EQ(buffer, "[a] x 1\n[c] z\n");
+
+    // No longer captured.
+    hg::Utils::scriptLog("d") << "logged\n";
+    TEST_ASSERT_EQ(buffer, "[a] x 1\n[c] z\n");
+}
+
+static void test_perThread()
+{
+    std::string buffer;
+    hg::Utils::ScriptLogCapture capture{buffer};
+
+    // Captures only apply to the thread that created them.
+    std::thread{[] { hg::Utils::scriptLog("other") << "logged\n"; }}.join();
+    hg::Utils::scriptLog("this") << "captured\n";
+
+    TEST_ASSERT_EQ(buffer, "[this] captured\n");
+}
+
+int main()
+{
+    test_capture();
+    test_perThread();
+}
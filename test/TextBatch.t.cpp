@@ -0,0 +1,122 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/TextBatch.hpp"
+
+#include "TestUtils.hpp"
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#ifndef SSVOH_HEADLESS_TESTS
+
+[[nodiscard]] static bool sameRect(
+    const sf::FloatRect& a, const sf::FloatRect& b)
+{
+    constexpr float epsilon = 0.001f;
+
+    return std::abs(a.left - b.left) < epsilon &&
+           std::abs(a.top - b.top) < epsilon &&
+           std::abs(a.width - b.width) < epsilon &&
+           std::abs(a.height - b.height) < epsilon;
+}
+
+[[nodiscard]] static bool sameBoundsAsText(hg::Utils::TextBatch& batch,
+    sf::Text& text, const std::string& str)
+{
+    text.setString(str);
+
+    return sameRect(batch.getLocalBounds(text, str), text.getLocalBounds()) &&
+           sameRect(batch.getGlobalBounds(text, str), text.getGlobalBounds());
+}
+
+int main()
+{
+    sf::Font font;
+    TEST_ASSERT(font.loadFromFile("Assets/OpenSquare-Regular.ttf"));
+
+    hg::Utils::TextBatch batch;
+
+    // Layout matches `sf::Text`
+    {
+        sf::Text text{"", font, 30};
+        text.setPosition({12.f, 34.f});
+        text.setScale({1.25f, 1.25f});
+
+        TEST_ASSERT(sameBoundsAsText(batch, text, ""));
+        TEST_ASSERT(sameBoundsAsText(batch, text, "LEVEL SELECTION"));
+        TEST_ASSERT(sameBoundsAsText(batch, text, "AV\tTA  WA\r\nSECOND LINE"));
+
+        text.setCharacterSize(14);
+        text.setLetterSpacing(1.5f);
+        text.setLineSpacing(0.8f);
+        TEST_ASSERT(sameBoundsAsText(batch, text, "PACK\nAUTHOR: SOMEONE"));
+
+        text.setOutlineThickness(2.f);
+        TEST_ASSERT(sameBoundsAsText(batch, text, "123.456"));
+
+        text.setStyle(sf::Text::Bold | sf::Text::Italic);
+        TEST_ASSERT(sameBoundsAsText(batch, text, "BEST: 99.9"));
+    }
+
+    batch.endFrame();
+
+    // Repeated strings are laid out once, textures are drawn once per flush
+    {
+        sf::RenderTexture target;
+        TEST_ASSERT(target.create(256, 256));
+
+        sf::Text small{"", font, 16};
+        sf::Text big{"", font, 32};
+
+        for(int frame = 0; frame < 3; ++frame)
+        {
+            for(int i = 0; i < 50; ++i)
+            {
+                const std::string str = "LEVEL " + std::to_string(i);
+
+                small.setPosition({0.f, static_cast<float>(i)});
+                batch.add(small, str);
+                batch.add(big, str);
+            }
+
+            batch.add(small, "");
+
+            batch.flush(target);
+            batch.endFrame();
+
+            const hg::Utils::TextBatch::Stats& stats =
+                batch.getLastFrameStats();
+
+            TEST_ASSERT_EQ(stats.texts, 101);
+            TEST_ASSERT_EQ(stats.drawCalls, 2);
+            TEST_ASSERT_EQ(stats.layouts, frame == 0 ? 101 : 0);
+        }
+    }
+
+    // Unused runs are evicted
+    {
+        constexpr std::uint64_t frames =
+            2 * hg::Utils::TextBatch::maxIdleFrames;
+
+        for(std::uint64_t i = 0; i < frames; ++i)
+        {
+            batch.endFrame();
+        }
+
+        TEST_ASSERT_EQ(batch.getLastFrameStats().cachedRuns, 0);
+    }
+}
+
+#else
+
+int main()
+{}
+
+#endif
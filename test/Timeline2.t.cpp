@@ -0,0 +1,87 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/Timeline2.hpp"
+
+#include "TestUtils.hpp"
+
+#include <chrono>
+#include <string>
+
+using hg::Utils::timeline2;
+using hg::Utils::timeline2_runner;
+
+int main()
+{
+    const timeline2::time_point start = timeline2::clock::now();
+
+    // Actions run in order, waits suspend the runner
+    {
+        timeline2 t;
+        timeline2_runner r;
+        std::string log;
+
+        t.append_do([&log] { log += 'a'; });
+        t.append_wait_for(std::chrono::seconds(1));
+        t.append_do([&log] { log += 'b'; });
+
+        const auto o0 = r.update(t, start);
+        TEST_ASSERT(o0 == timeline2_runner::outcome::waiting);
+        TEST_ASSERT_EQ(log, "a");
+
+        const auto o1 = r.update(t, start + std::chrono::seconds(2));
+        TEST_ASSERT(o1 == timeline2_runner::outcome::finished);
+        TEST_ASSERT_EQ(log, "ab");
+    }
+
+    // Actions appended while an action is running, across several chunks
+    {
+        timeline2 t;
+        timeline2_runner r;
+        int count = 0;
+
+        t.append_do(
+            [&t, &count, s = std::string(24, 'x')]
+            {
+                for(int i = 0; i < 200; ++i)
+                {
+                    t.append_do([&count] { ++count; });
+                }
+
+                count += static_cast<int>(s.size());
+            });
+
+        const auto o = r.update(t, start);
+        TEST_ASSERT(o == timeline2_runner::outcome::finished);
+        TEST_ASSERT_EQ(count, 24 + 200);
+    }
+
+    // `clear` destroys the captures and the timeline can be refilled
+    {
+        timeline2 t;
+        int value = 0;
+
+        for(int round = 0; round < 3; ++round)
+        {
+            timeline2_runner r;
+
+            for(int i = 0; i < 100; ++i)
+            {
+                t.append_do([&value, s = std::to_string(i)]
+                    { value += static_cast<int>(s.size()); });
+            }
+
+            t.append_wait_until_fn([start] { return start; });
+
+            const auto o = r.update(t, start);
+            TEST_ASSERT(o == timeline2_runner::outcome::finished);
+            TEST_ASSERT_EQ(t.size(), 101);
+
+            t.clear();
+            TEST_ASSERT_EQ(t.size(), 0);
+        }
+
+        TEST_ASSERT_EQ(value, 3 * (10 * 1 + 90 * 2));
+    }
+}
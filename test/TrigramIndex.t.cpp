@@ -0,0 +1,91 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/TrigramIndex.hpp"
+
+#include "TestUtils.hpp"
+
+#include <string>
+#include <vector>
+
+using DocIds = std::vector<hg::Utils::TrigramIndex::DocId>;
+
+[[nodiscard]] static DocIds search(const hg::Utils::TrigramIndex& index,
+    const std::string& query, const std::size_t maxResults = 100)
+{
+    DocIds result;
+    index.search(query, result, maxResults);
+    return result;
+}
+
+int main()
+{
+    hg::Utils::TrigramIndex index;
+
+    // Fields: name, author, pack, description
+    TEST_ASSERT_EQ(index.add({"Hexagon", "Vittorio Romeo", "Cube",
+                       "The original hexagon level"}),
+        0);
+
+    TEST_ASSERT_EQ(
+        index.add({"Hexagoner", "Vittorio Romeo", "Cube", "Harder"}), 1);
+
+    TEST_ASSERT_EQ(index.add({"Apeirogon", "Someone-Else", "Workshop Pack",
+                       "Infinite sides, like a HEXAGON with more sides"}),
+        2);
+
+    TEST_ASSERT_EQ(index.add({"Pi", "Kiwi", "Workshop Pack", "3.14"}), 3);
+
+    index.build();
+    TEST_ASSERT_EQ(index.size(), 4);
+
+    // Case-insensitive, ranked by field and word start, ties in added order
+    TEST_ASSERT(search(index, "hexagon") == (DocIds{0, 1, 2}));
+    TEST_ASSERT(search(index, "HEXAGONER") == (DocIds{1}));
+    TEST_ASSERT(search(index, "xagon") == (DocIds{0, 1, 2}));
+    TEST_ASSERT(search(index, "gon") == (DocIds{0, 1, 2}));
+    TEST_ASSERT(search(index, "agon") == (DocIds{0, 1, 2}));
+
+    // Every word must match, in any field
+    TEST_ASSERT(search(index, "hexagon harder") == (DocIds{1}));
+    TEST_ASSERT(search(index, "romeo cube") == (DocIds{0, 1}));
+    TEST_ASSERT(search(index, "  workshop,   pack  ") == (DocIds{2, 3}));
+    TEST_ASSERT(search(index, "hexagon kiwi").empty());
+
+    // Punctuation separates words
+    TEST_ASSERT(search(index, "someone else") == (DocIds{2}));
+    TEST_ASSERT(search(index, "3.14") == (DocIds{3}));
+
+    // Words shorter than a trigram are verified by scanning
+    TEST_ASSERT(search(index, "pi") == (DocIds{3}));
+    TEST_ASSERT(search(index, "k") == (DocIds{3, 2}));
+    TEST_ASSERT(search(index, "e") == (DocIds{0, 1, 2}));
+
+    // Empty queries and limits
+    TEST_ASSERT(search(index, "").empty());
+    TEST_ASSERT(search(index, " .,; ").empty());
+    TEST_ASSERT(search(index, "zzz").empty());
+    TEST_ASSERT(search(index, "hexagon", 2) == (DocIds{0, 1}));
+    TEST_ASSERT(search(index, "hexagon", 0).empty());
+
+    // Non-ASCII bytes are matched as they are
+    TEST_ASSERT_EQ(index.add({"Caf\xC3\xA9 hexagon", "", "", ""}), 4);
+
+    index.build();
+    TEST_ASSERT(search(index, "caf\xC3\xA9") == (DocIds{4}));
+    TEST_ASSERT(search(index, "CAF\xC3\xA9") == (DocIds{4}));
+    TEST_ASSERT(search(index, "cafe").empty());
+
+    // All trigrams present, but not the whole word
+    TEST_ASSERT_EQ(index.add({"Aaa", "", "", ""}), 5);
+
+    index.build();
+    TEST_ASSERT(search(index, "aaa") == (DocIds{5}));
+    TEST_ASSERT(search(index, "aaaa").empty());
+
+    index.clear();
+    TEST_ASSERT_EQ(index.size(), 0);
+    TEST_ASSERT(search(index, "hexagon").empty());
+    TEST_ASSERT(search(index, "h").empty());
+}
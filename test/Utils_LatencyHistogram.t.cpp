@@ -0,0 +1,43 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Utils/LatencyHistogram.hpp"
+
+#include "TestUtils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+
+int main()
+{
+    hg::Utils::LatencyHistogram h;
+
+    TEST_ASSERT_EQ(h.getCount(), 0);
+    TEST_ASSERT_EQ(h.getPercentileUs(0.5), 0);
+
+    for(std::uint64_t i = 0; i < 99; ++i)
+    {
+        h.record(std::uint64_t{10});
+    }
+
+    h.record(std::chrono::milliseconds{5});
+
+    TEST_ASSERT_EQ(h.getCount(), 100);
+    TEST_ASSERT_EQ(h.getTotalUs(), 99 * 10 + 5000);
+    TEST_ASSERT_EQ(h.getMaxUs(), 5000);
+
+    // 10us falls in the [8, 16) bucket, 5000us in the [4096, 8192) one.
+    TEST_ASSERT_EQ(h.getPercentileUs(0.5), 15);
+    TEST_ASSERT_EQ(h.getPercentileUs(0.99), 15);
+    TEST_ASSERT_EQ(h.getPercentileUs(1.0), 5000);
+
+    std::ostringstream oss;
+    h.print(oss, "test");
+    TEST_ASSERT(oss.str().find("test") != std::string::npos);
+
+    h.reset();
+    TEST_ASSERT_EQ(h.getCount(), 0);
+    TEST_ASSERT_EQ(h.getMaxUs(), 0);
+}
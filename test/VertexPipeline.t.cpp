@@ -0,0 +1,112 @@
+// Copyright (c) 2013-2020 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: https://opensource.org/licenses/AFL-3.0
+
+#include "SSVOpenHexagon/Core/VertexPipeline.hpp"
+
+#include "TestUtils.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+
+[[nodiscard]] static hg::Extrusion3DParams makeParams(const std::size_t depth)
+{
+    return hg::Extrusion3DParams{.depth = depth,
+        .spacing = 1.5f,
+        .perspectiveMult = 1.1f,
+        .effect = 0.5f,
+        .alphaMult = 2.f,
+        .alphaFalloff = 10.f,
+        .sinRot = 0.6f,
+        .cosRot = 0.8f,
+        .pivotColor = sf::Color{10, 20, 30, 200},
+        .wallColor = sf::Color{40, 50, 60, 250},
+        .playerColor = sf::Color{70, 80, 90, 100}};
+}
+
+static void fill(hg::Utils::FastVertexVectorTris& v, const std::size_t n)
+{
+    v.reserve(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const auto f = static_cast<float>(i);
+        v.unsafe_emplace_back(sf::Vector2f{f, -f},
+            sf::Color{1, 2, 3, static_cast<sf::Uint8>(i)},
+            sf::Vector2f{f * 2.f, f * 3.f});
+    }
+}
+
+int main()
+{
+    // Every layer matches a straightforward scalar extrusion, including the
+    // vertices that do not fill a whole vector group.
+    for(std::size_t n = 0; n < 14; ++n)
+    {
+        const hg::Extrusion3DParams params = makeParams(3);
+
+        hg::Utils::FastVertexVectorTris source;
+        fill(source, n);
+
+        hg::Utils::FastVertexVectorTris target;
+        hg::extrude3D(params, params.wallColor, source, target);
+
+        TEST_ASSERT_EQ(target.size(), n * params.depth);
+
+        for(std::size_t j = 0; j < params.depth; ++j)
+        {
+            const auto i = static_cast<float>(params.depth - j - 1);
+            const float offset = params.spacing *
+                                 ((i + 1.f) * params.perspectiveMult) *
+                                 (params.effect * 3.6f) * 1.4f;
+
+            const sf::Uint8 alpha = static_cast<sf::Uint8>(
+                250.f / params.alphaMult - i * params.alphaFalloff);
+
+            for(std::size_t k = 0; k < n; ++k)
+            {
+                const sf::Vertex& src = source[k];
+                const sf::Vertex& dst = target[j * n + k];
+
+                TEST_ASSERT_EQ(
+                    dst.position.x, src.position.x + offset * params.cosRot);
+                TEST_ASSERT_EQ(
+                    dst.position.y, src.position.y + offset * params.sinRot);
+                TEST_ASSERT_EQ(dst.texCoords.x, src.texCoords.x);
+                TEST_ASSERT_EQ(dst.texCoords.y, src.texCoords.y);
+                TEST_ASSERT_EQ(dst.color.r, 40);
+                TEST_ASSERT_EQ(dst.color.b, 60);
+                TEST_ASSERT_EQ(dst.color.a, alpha);
+            }
+        }
+    }
+
+    // Pipelined submissions return the previously submitted frame
+    {
+        hg::VertexPipeline pipeline;
+
+        for(std::size_t frame = 0; frame < 4; ++frame)
+        {
+            hg::FrameVertices& back = pipeline.getBackFrame();
+            back.clear();
+            fill(back.wallQuads, frame + 1);
+            back.extrusion3D = makeParams(2);
+
+            const hg::FrameVertices& ready = pipeline.submitBackFrame();
+
+            TEST_ASSERT_EQ(ready.wallQuads.size(), frame);
+            TEST_ASSERT_EQ(ready.wallQuads3D.size(), frame * 2);
+        }
+
+        hg::FrameVertices& back = pipeline.getBackFrame();
+        back.clear();
+        fill(back.wallQuads, 10);
+
+        const hg::FrameVertices& ready = pipeline.buildBackFrame();
+        TEST_ASSERT_EQ(ready.wallQuads.size(), 10);
+        TEST_ASSERT_EQ(ready.wallQuads3D.size(), 0);
+    }
+}